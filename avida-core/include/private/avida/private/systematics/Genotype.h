@@ -60,6 +60,7 @@ namespace Avida {
     private:
       mutable GenotypeArbiterPtr m_mgr;
       Apto::List<GenotypePtr, Apto::SparseVector>::EntryHandle* m_handle;
+      unsigned long long m_genome_hash;  // set by the arbiter while in the active hash table
       
       Source m_src;
       Genome m_genome;
@@ -125,6 +126,7 @@ namespace Avida {
       
       bool Serialize(ArchivePtr ar) const;
       bool LegacySave(void* df) const;
+      bool LegacySaveProperties(Apto::Array<Apto::String>& names, Apto::Array<Apto::String>& values) const;
 
       void RemoveActiveReference() const;
       
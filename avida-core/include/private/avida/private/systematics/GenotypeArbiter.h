@@ -26,6 +26,7 @@
 
 #include "avida/core/Properties.h"
 #include "avida/data/Provider.h"
+#include "avida/data/ValueBuffer.h"
 #include "avida/environment/Types.h"
 #include "avida/systematics/Arbiter.h"
 
@@ -47,7 +48,7 @@ namespace Avida {
         EVENT_REMOVE_THRESHOLD
       };
       
-      static const int HASH_SIZE = 3203;
+      static const int INITIAL_HASH_SIZE = 4096;  // must be a power of two
       
     private:
       // Config Settings
@@ -55,9 +56,11 @@ namespace Avida {
       bool m_disable_class;
       
       // Internal Data Structures
-      Apto::List<GenotypePtr, Apto::SparseVector> m_active_hash[HASH_SIZE];
+      Apto::Array<Apto::List<GenotypePtr, Apto::SparseVector>, Apto::ManagedPointer> m_active_hash;
+      int m_num_hashed;
       Apto::Array<Apto::List<GenotypePtr, Apto::SparseVector>, Apto::ManagedPointer> m_active_sz;
       Apto::List<GenotypePtr, Apto::SparseVector> m_historic;
+      Apto::Map<GroupID, GenotypePtr> m_genotype_ids;  // every active and historic genotype, by ID
       GenotypePtr m_coalescent;
       int m_best;
       int m_next_id;
@@ -100,6 +103,24 @@ namespace Avida {
       
       int m_dom_id;
       
+      // Inputs to UpdateProvidedValues, captured by SnapshotProvidedValues so that the statistics can be reduced off of
+      // the main thread while classification of the next update proceeds
+      struct GenotypeSample
+      {
+        int abundance;
+        int update_born;
+        int depth;
+        int size;
+        bool threshold;
+      };
+      Apto::Array<GenotypeSample> m_samples;
+      int m_num_samples;
+      
+      int m_provided_tot_genotypes;
+      int m_provided_num_threshold;
+      int m_provided_tot_threshold;
+      int m_provided_coalescent_depth;
+      
       Apto::Array<PropertyID> m_env_action_average;
       Apto::Array<PropertyID> m_env_action_count;
       
@@ -108,14 +129,28 @@ namespace Avida {
       {
         Apto::String description;
         Apto::Functor<Data::PackagePtr, Apto::NullType> GetData;
+        const int* int_value;
+        const double* double_value;
         
-        ProvidedData() { ; }
-        ProvidedData(const Apto::String& desc, Apto::Functor<Data::PackagePtr, Apto::NullType> func)
-          : description(desc), GetData(func) { ; } 
+        ProvidedData() : int_value(NULL), double_value(NULL) { ; }
+        ProvidedData(const Apto::String& desc, Apto::Functor<Data::PackagePtr, Apto::NullType> func, const int& val)
+          : description(desc), GetData(func), int_value(&val), double_value(NULL) { ; }
+        ProvidedData(const Apto::String& desc, Apto::Functor<Data::PackagePtr, Apto::NullType> func, const double& val)
+          : description(desc), GetData(func), int_value(NULL), double_value(&val) { ; }
       };
       Apto::Map<Data::DataID, ProvidedData> m_provided_data;
       mutable Data::ConstDataSetPtr m_provides;
       
+      // Values bound to the data manager's value buffer, written at the end of each UpdateProvidedValues
+      struct BoundValue
+      {
+        Data::ValueSlot slot;
+        const int* int_value;
+        const double* double_value;
+      };
+      Data::ValueBuffer* m_bound_buffer;
+      Apto::Array<BoundValue> m_bound_values;
+      
       
     public:
       GenotypeArbiter(World* world, const RoleID& role, int threshold, bool disable_class = false);
@@ -136,9 +171,12 @@ namespace Avida {
       
       // Data::Provider
       Data::ConstDataSetPtr Provides() const;
+      bool SupportsBackgroundUpdate() const;
+      void SnapshotProvidedValues(Update current_update);
       void UpdateProvidedValues(Update current_update);
       Data::PackagePtr GetProvidedValue(const Data::DataID& data_id) const;
       Apto::String DescribeProvidedValue(const Data::DataID& data_id) const;
+      bool BindProvidedValue(const Data::DataID& data_id, Data::ValueBuffer& buffer, Data::ValueSlot& slot);
       
       
     private:
@@ -157,7 +195,10 @@ namespace Avida {
       template <class T> Data::PackagePtr packageData(const T&) const;
       Data::ProviderPtr activateProvider(World*);
       
-      unsigned int hashGenome(const InstructionSequence& genome) const;
+      static unsigned long long hashGenome(const InstructionSequence& genome);
+      void addToHash(GenotypePtr genotype);
+      void removeFromHash(GenotypePtr genotype);
+      void resizeHash(int size);
       Apto::String nameGenotype(int size);
       
       void removeGenotype(GenotypePtr genotype);
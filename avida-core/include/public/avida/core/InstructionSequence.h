@@ -68,13 +68,74 @@ namespace Avida {
   class InstructionSequence : public GeneticRepresentation
   {
   protected:
-    Apto::Array<Instruction> m_seq;
+    // Site storage, shared by copies of a sequence (genotype, birth chamber entries, organisms and their hardware)
+    // until one of them is modified.  Reading through the const accessors never copies; the non-const accessors first
+    // give the array a buffer of its own.
+    class SiteArray
+    {
+    private:
+      class Buffer : public Apto::RefCountObject<Apto::ThreadSafe>
+      {
+      public:
+        Instruction* sites;
+        int size;
+        
+        LIB_EXPORT inline explicit Buffer(int in_size) : sites((in_size > 0) ? new Instruction[in_size] : NULL), size(in_size) { ; }
+        LIB_EXPORT inline ~Buffer() { delete [] sites; }
+        
+      private:
+        Buffer(const Buffer&); // @not_implemented
+        Buffer& operator=(const Buffer&); // @not_implemented
+      };
+      
+      Apto::SmartPtr<Buffer, Apto::InternalRCObject> m_buf;
+      
+    public:
+      LIB_EXPORT inline explicit SiteArray(int size = 0) : m_buf(new Buffer(size)) { ; }
+      
+      LIB_EXPORT inline int GetSize() const { return m_buf->size; }
+      LIB_EXPORT inline bool IsShared() const { return m_buf->RefCount() != 1; }
+      LIB_EXPORT inline bool IsSameBuffer(const SiteArray& other) const { return m_buf->sites == other.m_buf->sites; }
+      
+      LIB_EXPORT inline const Instruction& operator[](int idx) const { return m_buf->sites[idx]; }
+      LIB_EXPORT inline Instruction& operator[](int idx) { if (IsShared()) reallocate(m_buf->size, true); return m_buf->sites[idx]; }
+      
+      LIB_EXPORT inline void Resize(int new_size) { if (new_size != m_buf->size || IsShared()) reallocate(new_size, true); }
+      LIB_EXPORT inline void ResizeClear(int new_size) { if (new_size != m_buf->size || IsShared()) reallocate(new_size, false); }
+      
+      // Save or restore all sites (see cStateBuffer); saving does not unshare the buffer
+      template <class S> void TransferState(S& state)
+      {
+        int size = m_buf->size;
+        state & size;
+        if (state.IsLoading()) {
+          if (!state.IsOK() || size < 0 || size > state.GetSize()) {
+            state.SetFailed();
+            return;
+          }
+          ResizeClear(size);
+        }
+        for (int i = 0; i < size; i++) state & m_buf->sites[i];
+      }
+      
+    private:
+      LIB_EXPORT void reallocate(int new_size, bool keep_sites);
+    };
+    
+    SiteArray m_seq;
     int m_active_size;
+    mutable unsigned long long m_hash;
+    mutable bool m_hash_valid;
+    unsigned int m_revision;
+    int m_tail_start;                 // First site of the block added by the last growth (see Resize), -1 if untracked
+    unsigned long long m_tail_hash;   // Part of the hash contributed by the sites from m_tail_start on
     
   public:
-    LIB_EXPORT inline InstructionSequence() : m_active_size(0) { ; }
+    LIB_EXPORT inline InstructionSequence()
+      : m_active_size(0), m_hash(0), m_hash_valid(false), m_revision(0), m_tail_start(-1), m_tail_hash(0) { ; }
     LIB_EXPORT InstructionSequence(const InstructionSequence& seq);
-    LIB_EXPORT inline explicit InstructionSequence(int size) : m_seq(size), m_active_size(size) { ; }
+    LIB_EXPORT inline explicit InstructionSequence(int size)
+      : m_seq(size), m_active_size(size), m_hash(0), m_hash_valid(false), m_revision(0), m_tail_start(-1), m_tail_hash(0) { ; }
     LIB_EXPORT explicit InstructionSequence(const Apto::String& str);
     LIB_EXPORT virtual ~InstructionSequence();
     
@@ -82,9 +143,33 @@ namespace Avida {
     // Accessors
     LIB_EXPORT inline int GetSize() const { return m_active_size; }
     
-    LIB_EXPORT inline Instruction& operator[](int idx) { assert(idx >= 0 && idx < m_active_size);  return m_seq[idx]; }
+    LIB_EXPORT inline Instruction& operator[](int idx)
+    {
+      assert(idx >= 0 && idx < m_active_size);
+      sitesChanged();
+      return m_seq[idx];
+    }
     LIB_EXPORT inline const Instruction& operator[](int idx) const { assert(idx >= 0 && idx < m_active_size);  return m_seq[idx]; }
 
+    // Point substitution; unlike writing through operator[], keeps a previously computed hash up to date in O(1)
+    LIB_EXPORT inline void SetInst(int idx, const Instruction& inst)
+    {
+      assert(idx >= 0 && idx < m_active_size);
+      if (m_hash_valid || (m_tail_start >= 0 && idx >= m_tail_start)) replaceSiteHash(idx, m_seq[idx], inst);
+      m_seq[idx] = inst;
+      m_revision++;
+    }
+
+    // Hash of the sequence contents, the sum over all sites of a mixed value of the instruction times B^position
+    // (mod 2^64).  Moving a run of sites only scales its part of the hash by a power of B, so insertions, removals and
+    // resizes adjust a computed hash instead of discarding it, and a crop of the block added by the last growth of the
+    // sequence (an offspring copied into allocated memory) starts out hashed.  Computed on first use and cached until
+    // the sequence is written through the non-const operator[]; equal sequences always have equal hashes.
+    LIB_EXPORT inline unsigned long long GetHash() const { if (!m_hash_valid) computeHash(); return m_hash; }
+
+    // Changes every time the sequence is modified, so that caches derived from its contents can tell they are stale
+    LIB_EXPORT inline unsigned int GetRevision() const { return m_revision; }
+
 
     // GeneticRepresentation Interface
     LIB_EXPORT Apto::String AsString() const;
@@ -136,11 +221,28 @@ namespace Avida {
     static int FindBestOffset(const InstructionSequence& seq1, const InstructionSequence& seq2);
     static int FindSlidingDistance(const InstructionSequence& seq1, const InstructionSequence& seq2);
     static int FindEditDistance(const InstructionSequence& seq1, const InstructionSequence& seq2);
+
+    // Edit distance if it is at most max_distance, otherwise max_distance + 1.  Only the band of the table that could
+    // hold an alignment within the bound is computed, stopping as soon as a whole row of the band exceeds it.
+    static int FindBoundedEditDistance(const InstructionSequence& seq1, const InstructionSequence& seq2, int max_distance);
     
     
   protected:
     LIB_EXPORT virtual void adjustCapacity(int new_size);
     LIB_EXPORT virtual void prepareInsert(int pos, int num_sites);
+
+    LIB_EXPORT inline void sitesChanged() { m_hash_valid = false; m_tail_start = -1; m_revision++; }
+    LIB_EXPORT inline bool hashTracked() const { return m_hash_valid || m_tail_start >= 0; }
+    LIB_EXPORT void computeHash() const;
+
+    // Hash bookkeeping for the manipulation methods, here and in subclasses.  Each takes the hash of the sites that
+    // move (see rangeHash), computed before they are moved, and is only needed while hashTracked().
+    LIB_EXPORT unsigned long long rangeHash(int begin, int end) const;
+    LIB_EXPORT void replaceSiteHash(int idx, const Instruction& old_inst, const Instruction& new_inst);
+    LIB_EXPORT void addSiteHash(int idx, const Instruction& inst);
+    LIB_EXPORT void hashSitesInserted(int pos, int num_sites, unsigned long long shifted);
+    LIB_EXPORT void hashSitesRemoved(int pos, int num_sites, unsigned long long removed, unsigned long long shifted);
+    LIB_EXPORT void hashSitesAppended(int old_size);
   };
 
 
@@ -29,6 +29,7 @@
 #include "avida/core/Types.h"
 #include "avida/core/World.h"
 #include "avida/data/Types.h"
+#include "avida/data/ValueBuffer.h"
 
 
 namespace Avida {
@@ -43,6 +44,16 @@ namespace Avida {
       typedef Apto::Set<Apto::String, Apto::DefaultHashBTree, Apto::Multi> ArgMultiSet;
       typedef Apto::SmartPtr<ArgMultiSet> ArgMultiSetPtr;
       
+      // Compiled value whose provider does not write directly into the value buffer; retrieved once per update
+      struct GatheredValue
+      {
+        ProviderPtr provider;
+        ArgumentedProviderPtr arg_provider;
+        DataID data_id;
+        Argument argument;
+        ValueSlot slot;
+      };
+      
     private:
       World* m_world;
       
@@ -55,6 +66,14 @@ namespace Avida {
       mutable Apto::Mutex m_recorder_mutex;
       Apto::Set<RecorderPtr> m_recorders;
       
+      // Compiled data plan, value slots are resolved as recorders are attached (see Recorder::SupportsIndexedData)
+      ValueBuffer m_values;
+      Apto::Map<DataID, ValueSlot> m_value_slots;
+      Apto::Array<GatheredValue> m_gathered_values;
+      
+      class BackgroundUpdate;
+      BackgroundUpdate* m_background;
+      
       Apto::Array<ProviderPtr> m_active_providers;
       Apto::Array<ArgumentedProviderPtr> m_active_arg_providers;
       Apto::Map<DataID, ProviderPtr> m_active_provider_map;
@@ -79,6 +98,13 @@ namespace Avida {
       LIB_EXPORT bool AttachRecorder(RecorderPtr recorder, bool concurrent_update = false);
       LIB_EXPORT bool DetachRecorder(RecorderPtr recorder);
       
+      // When enabled, updates in which every active provider supports background updates and every recorder supports
+      // background notification are processed on a worker thread, overlapping with the next update.  Anything reading
+      // values delivered to such recorders outside of the notification should first call Synchronize, which waits for
+      // the pending background update (if any) to complete.
+      LIB_EXPORT void SetBackgroundUpdate(bool enabled);
+      LIB_EXPORT void Synchronize();
+      
       LIB_EXPORT bool Register(const DataID& data_id, ProviderActivateFunctor functor);
       LIB_EXPORT bool Register(const DataID& data_id, ArgumentedProviderActivateFunctor functor);
       
@@ -95,6 +121,11 @@ namespace Avida {
       
     public:
       LIB_LOCAL PackagePtr GetCurrentValue(const DataID& data_id) const;
+      
+    private:
+      LIB_LOCAL bool compileValue(const DataID& data_id, ValueSlot& slot);
+      LIB_LOCAL bool canUpdateInBackground() const;
+      LIB_LOCAL void processUpdate(Update current_update, bool background);
     };
     
   };
@@ -48,6 +48,18 @@ namespace Avida {
       LIB_EXPORT virtual Apto::String DescribeProvidedValue(const DataID& data_id) const = 0;
       
       LIB_EXPORT virtual bool SupportsConcurrentUpdate() const;
+      
+      // Direct value output.  A provider able to write data_id straight into the manager's value buffer allocates a slot
+      // in buffer, returns it via slot, and then writes the value on every subsequent UpdateProvidedValues call.  The
+      // default implementation declines, leaving the manager to retrieve the value through GetProvidedValue.
+      LIB_EXPORT virtual bool BindProvidedValue(const DataID& data_id, ValueBuffer& buffer, ValueSlot& slot);
+      
+      // Background updates.  SnapshotProvidedValues is called on the update thread immediately before every
+      // UpdateProvidedValues call, and should copy whatever raw inputs the provider needs.  Providers that return true
+      // from SupportsBackgroundUpdate may then be updated, and have their values retrieved, on a worker thread while the
+      // world continues with the next update; UpdateProvidedValues and GetProvidedValue must only use the snapshot.
+      LIB_EXPORT virtual bool SupportsBackgroundUpdate() const;
+      LIB_EXPORT virtual void SnapshotProvidedValues(Update current_update);
     };
     
     
@@ -44,6 +44,16 @@ namespace Avida {
       LIB_EXPORT virtual ConstDataSetPtr RequestedData() const = 0;
       
       LIB_EXPORT virtual void NotifyData(Update current_update, DataRetrievalFunctor retrieve_data) = 0; 
+      
+      // Indexed data access.  Recorders that support it are handed the value buffer slot of each requested data value
+      // when attached, and are notified through NotifyValues instead of NotifyData on regular updates.
+      LIB_EXPORT virtual bool SupportsIndexedData() const;
+      LIB_EXPORT virtual void BindRequestedData(const DataID& data_id, const ValueSlot& slot);
+      LIB_EXPORT virtual void NotifyValues(Update current_update, const ValueBuffer& values);
+      
+      // Recorders that return true may be notified on a worker thread (see Manager::SetBackgroundUpdate), and must
+      // synchronize access to the values they record themselves.
+      LIB_EXPORT virtual bool SupportsBackgroundNotify() const;
     };
     
   };
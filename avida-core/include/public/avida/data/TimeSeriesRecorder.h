@@ -28,6 +28,7 @@
 #include "apto/core/Array.h"
 #include "avida/core/Types.h"
 #include "avida/data/Recorder.h"
+#include "avida/data/ValueBuffer.h"
 
 
 namespace Avida {
@@ -41,6 +42,7 @@ namespace Avida {
     private:
       DataID m_data_id;
       ConstDataSetPtr m_requested;
+      ValueSlot m_slot;
       
       struct DataEntry;
       Apto::Array<DataEntry, Apto::Smart> m_data;
@@ -52,6 +54,9 @@ namespace Avida {
       // Data::Recorder Interface
       LIB_EXPORT inline ConstDataSetPtr RequestedData() const { return m_requested; }
       LIB_EXPORT void NotifyData(Update current_update, DataRetrievalFunctor retrieve_data);
+      LIB_EXPORT inline bool SupportsIndexedData() const { return true; }
+      LIB_EXPORT inline void BindRequestedData(const DataID&, const ValueSlot& slot) { m_slot = slot; }
+      LIB_EXPORT void NotifyValues(Update current_update, const ValueBuffer& values);
       
       // Value Access
       LIB_EXPORT inline const DataID& RecordedDataID() const { return m_data_id; }
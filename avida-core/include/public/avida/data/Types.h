@@ -38,6 +38,8 @@ namespace Avida {
     class Package;
     class Provider;    
     class Recorder;
+    class ValueBuffer;
+    struct ValueSlot;
 
     
     // Type Declarations
@@ -0,0 +1,129 @@
+/*
+ *  data/ValueBuffer.h
+ *  avida-core
+ *
+ *  Copyright 2012 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AvidaDataValueBuffer_h
+#define AvidaDataValueBuffer_h
+
+#include "apto/core/Array.h"
+#include "apto/core/String.h"
+#include "apto/platform.h"
+#include "avida/data/Types.h"
+
+#include <cassert>
+
+
+namespace Avida {
+  namespace Data {
+    
+    // Data::ValueSlot - location of a single data value within a ValueBuffer
+    // --------------------------------------------------------------------------------------------------------------
+    
+    enum ValueType {
+      VALUE_NONE = 0,
+      VALUE_INT,
+      VALUE_DOUBLE,
+      VALUE_STRING,
+      VALUE_PACKAGE
+    };
+    
+    struct ValueSlot
+    {
+      ValueType type;
+      int index;
+      
+      LIB_EXPORT inline ValueSlot() : type(VALUE_NONE), index(-1) { ; }
+      LIB_EXPORT inline ValueSlot(ValueType in_type, int in_index) : type(in_type), index(in_index) { ; }
+      
+      LIB_EXPORT inline bool IsValid() const { return type != VALUE_NONE; }
+    };
+    
+    
+    // Data::ValueBuffer - typed, column oriented storage for current data values
+    // --------------------------------------------------------------------------------------------------------------
+    //
+    // Slots are allocated when recorders are attached to the data manager.  Thereafter providers write values directly
+    // into their slots and recorders read them back by slot, without any per-update lookup or allocation.  Values that
+    // can only be retrieved as packages (argumented values, providers without direct output) occupy package slots.
+    // Reads convert between types in the same manner as the Package value accessors.
+    
+    class ValueBuffer
+    {
+    private:
+      Apto::Array<int> m_ints;
+      Apto::Array<double> m_doubles;
+      Apto::Array<Apto::String> m_strings;
+      Apto::Array<PackagePtr> m_packages;
+      
+      ValueBuffer(const ValueBuffer&); // @not_implemented
+      ValueBuffer& operator=(const ValueBuffer&); // @not_implemented
+      
+    public:
+      LIB_EXPORT inline ValueBuffer() { ; }
+      LIB_EXPORT ~ValueBuffer();
+      
+      LIB_EXPORT ValueSlot AddInt();
+      LIB_EXPORT ValueSlot AddDouble();
+      LIB_EXPORT ValueSlot AddString();
+      LIB_EXPORT ValueSlot AddPackage();
+      
+      LIB_EXPORT inline int NumValues() const
+      {
+        return m_ints.GetSize() + m_doubles.GetSize() + m_strings.GetSize() + m_packages.GetSize();
+      }
+      
+      LIB_EXPORT inline void SetInt(const ValueSlot& slot, int value)
+      {
+        assert(slot.type == VALUE_INT);
+        m_ints[slot.index] = value;
+      }
+      LIB_EXPORT inline void SetDouble(const ValueSlot& slot, double value)
+      {
+        assert(slot.type == VALUE_DOUBLE);
+        m_doubles[slot.index] = value;
+      }
+      LIB_EXPORT inline void SetString(const ValueSlot& slot, const Apto::String& value)
+      {
+        assert(slot.type == VALUE_STRING);
+        m_strings[slot.index] = value;
+      }
+      LIB_EXPORT void SetPackage(const ValueSlot& slot, PackagePtr value);
+      
+      LIB_EXPORT inline int IntValue(const ValueSlot& slot) const
+      {
+        return (slot.type == VALUE_INT) ? m_ints[slot.index] : convertInt(slot);
+      }
+      LIB_EXPORT inline double DoubleValue(const ValueSlot& slot) const
+      {
+        return (slot.type == VALUE_DOUBLE) ? m_doubles[slot.index] : convertDouble(slot);
+      }
+      LIB_EXPORT bool BoolValue(const ValueSlot& slot) const;
+      LIB_EXPORT Apto::String StringValue(const ValueSlot& slot) const;
+      LIB_EXPORT PackagePtr PackageValue(const ValueSlot& slot) const;
+      
+    private:
+      LIB_EXPORT int convertInt(const ValueSlot& slot) const;
+      LIB_EXPORT double convertDouble(const ValueSlot& slot) const;
+    };
+    
+  };
+};
+
+#endif
@@ -0,0 +1,177 @@
+/*
+ *  output/ColumnarFile.h
+ *  avida-core
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AvidaOutputColumnarFile_h
+#define AvidaOutputColumnarFile_h
+
+#include "apto/platform.h"
+#include "avida/output/Types.h"
+
+#include <iostream>
+#include <string>
+
+
+namespace Avida {
+  namespace Output {
+
+    // Columnar binary data files
+    // --------------------------------------------------------------------------------------------------------------
+    //
+    // A columnar file holds the same table as a text .dat file.  It begins with a 16 byte file header (the magic
+    // "AVIDACOL", a version and flags) followed by a schema record and then any number of data blocks:
+    //
+    //   schema  filetype, format, the exact text header of the equivalent .dat file, and the type and description of
+    //           every column (as given to File::Write / File::WriteColumnDesc)
+    //   block   row count, followed by the values of each column in turn, every column prefixed with its byte size
+    //
+    // Compressed files encode integer columns as zig-zag varint deltas, and double columns as the XOR with the previous
+    // value in the column, storing only the bytes between its leading and trailing zero bytes.  All multi-byte values
+    // are little endian.
+
+    enum ColumnType {
+      COLUMN_INT = 1,
+      COLUMN_DOUBLE = 2,
+      COLUMN_STRING = 3
+    };
+
+
+    // Output::ColumnarWriter - Batches rows in memory and writes them out one block at a time
+    // --------------------------------------------------------------------------------------------------------------
+
+    class ColumnarWriter
+    {
+    private:
+      struct Column
+      {
+        ColumnType type;
+        Apto::String descr;
+        Apto::Array<long long, Apto::Smart> ints;
+        Apto::Array<double, Apto::Smart> doubles;
+        Apto::Array<Apto::String, Apto::Smart> strings;
+      };
+
+      std::ostream* m_out;
+      bool m_compress;
+      int m_block_rows;
+
+      Apto::Array<Column, Apto::ManagedPointer> m_cols;
+      int m_next_col;
+      int m_num_rows;
+
+      std::string m_buffer;
+
+
+      ColumnarWriter(const ColumnarWriter&); // @not_implemented
+      ColumnarWriter& operator=(const ColumnarWriter&); // @not_implemented
+
+    public:
+      LIB_EXPORT ColumnarWriter(bool compress, int block_rows = 4096);
+      LIB_EXPORT ~ColumnarWriter() { ; }
+
+      LIB_EXPORT inline int GetNumColumns() const { return m_cols.GetSize(); }
+
+      // Columns must all be added before Begin is called
+      LIB_EXPORT void AddColumn(ColumnType type, const Apto::String& descr);
+
+      // Writes the file header and schema to out, which must remain open until Finish
+      LIB_EXPORT void Begin(std::ostream& out, const Apto::String& filetype, const Apto::String& format,
+                            const Apto::String& header);
+
+      // Values are assigned to the columns of the current row in order.  Append rejects a value of a different type than
+      // its column or past the last column, and EndRow rejects a row that does not fill every column.  A rejected row
+      // stays pending; the caller must remove it with TakeRow and stop writing columnar.
+      LIB_EXPORT bool Append(long long value);
+      LIB_EXPORT bool Append(double value);
+      LIB_EXPORT bool Append(const char* value);
+      LIB_EXPORT bool EndRow();
+      LIB_EXPORT void TakeRow(std::ostream& out); // Writes out the values of the pending row as text and discards them
+
+      LIB_EXPORT void Flush(); // Writes out all complete rows as a (possibly short) block
+      LIB_EXPORT void Finish() { Flush(); }
+
+    private:
+      LIB_LOCAL void writeBlock();
+    };
+
+
+    // Output::ColumnarReader - Reads back a columnar file block by block
+    // --------------------------------------------------------------------------------------------------------------
+
+    class ColumnarReader
+    {
+    private:
+      struct Column
+      {
+        ColumnType type;
+        Apto::String descr;
+        Apto::Array<long long> ints;
+        Apto::Array<double> doubles;
+        Apto::Array<Apto::String> strings;
+      };
+
+      std::istream& m_in;
+      bool m_compressed;
+      bool m_valid;
+
+      Apto::String m_filetype;
+      Apto::String m_format;
+      Apto::String m_header;
+      Apto::Array<Column, Apto::ManagedPointer> m_cols;
+      int m_num_rows;
+
+
+      ColumnarReader(const ColumnarReader&); // @not_implemented
+      ColumnarReader& operator=(const ColumnarReader&); // @not_implemented
+
+    public:
+      LIB_EXPORT ColumnarReader(std::istream& in);
+      LIB_EXPORT ~ColumnarReader() { ; }
+
+      LIB_EXPORT inline bool IsValid() const { return m_valid; }
+      LIB_EXPORT inline bool IsCompressed() const { return m_compressed; }
+
+      LIB_EXPORT inline const Apto::String& GetFileType() const { return m_filetype; }
+      LIB_EXPORT inline const Apto::String& GetFormat() const { return m_format; }
+      LIB_EXPORT inline const Apto::String& GetHeader() const { return m_header; }
+
+      LIB_EXPORT inline int GetNumColumns() const { return m_cols.GetSize(); }
+      LIB_EXPORT inline ColumnType GetColumnType(int col) const { return m_cols[col].type; }
+      LIB_EXPORT inline const Apto::String& GetColumnDescription(int col) const { return m_cols[col].descr; }
+
+      // Loads the next block, returning false at the end of the file (or if the block is damaged, see IsValid)
+      LIB_EXPORT bool NextBlock();
+
+      LIB_EXPORT inline int GetNumRows() const { return m_num_rows; }
+      LIB_EXPORT inline long long GetInt(int col, int row) const { return m_cols[col].ints[row]; }
+      LIB_EXPORT inline double GetDouble(int col, int row) const { return m_cols[col].doubles[row]; }
+      LIB_EXPORT inline const Apto::String& GetString(int col, int row) const { return m_cols[col].strings[row]; }
+
+      // Writes the file out exactly as the equivalent text .dat file would have been written
+      LIB_EXPORT bool WriteText(std::ostream& out);
+
+    private:
+      LIB_LOCAL bool readSchema();
+    };
+
+  };
+};
+
+#endif
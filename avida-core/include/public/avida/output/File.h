@@ -34,6 +34,9 @@
 namespace Avida {
   namespace Output {
     
+    class ColumnarWriter;
+    
+    
     // Output::Socket - Protocol defining interface for output sockets that can be managed by the output manager
     // --------------------------------------------------------------------------------------------------------------
     
@@ -49,6 +52,12 @@ namespace Avida {
       int m_num_cols;
       
       std::ofstream m_fp;
+      
+      // Columnar output (see Manager::SetColumnarFiles).  A file is stored columnar if its first row is written entirely
+      // through Write and Endl.  Raw stream output, or a later row whose columns differ from the first, converts the
+      // file back to text.
+      ColumnarWriter* m_columnar;
+      bool m_columnar_active;
 
       
     public:
@@ -73,11 +82,12 @@ namespace Avida {
       LIB_EXPORT inline bool Fail() const { return m_fp.fail(); }
       LIB_EXPORT inline bool Good() const { return m_fp.good(); }
       LIB_EXPORT inline bool HeaderDone() { return m_descr_written; }
+      LIB_EXPORT inline bool IsColumnar() const { return m_columnar_active; }
       
       LIB_EXPORT inline bool SetFileType(const Apto::String& ft);
 
       
-      LIB_EXPORT inline std::ofstream& OFStream() { return m_fp; }
+      LIB_EXPORT inline std::ofstream& OFStream() { useText(); return m_fp; }
       
       
       // The following methods output a value into the data file.
@@ -94,10 +104,10 @@ namespace Avida {
       
       // The following methods output a value into the data file anonymously (no column descriptor).
       //  first argument (x, i, data_str, etc.) - the value to write (as double, int, const char *, etc.)
-      LIB_EXPORT inline void WriteAnonymous(double x) { m_fp << x << " "; }
-      LIB_EXPORT inline void WriteAnonymous(int i) { m_fp << i << " "; }
-      LIB_EXPORT inline void WriteAnonymous(long i) { m_fp << i << " "; }
-      LIB_EXPORT inline void WriteAnonymous(const char* data_str) { m_fp << data_str << " "; }
+      LIB_EXPORT inline void WriteAnonymous(double x) { useText(); m_fp << x << " "; }
+      LIB_EXPORT inline void WriteAnonymous(int i) { useText(); m_fp << i << " "; }
+      LIB_EXPORT inline void WriteAnonymous(long i) { useText(); m_fp << i << " "; }
+      LIB_EXPORT inline void WriteAnonymous(const char* data_str) { useText(); m_fp << data_str << " "; }
       
       // The following methods are useful for outputting tables of values with row size x
       LIB_EXPORT void WriteBlockElement(double x, int element, int x_size);
@@ -125,6 +135,11 @@ namespace Avida {
       LIB_EXPORT static FilePtr createWithPath(World* world, Apto::String path, bool append, Feedback* feedback);
 
       LIB_LOCAL File(World* world, const OutputID& output_id, bool append = false);
+      
+      LIB_EXPORT inline void useText() { if (m_columnar) useTextOutput(); }
+      LIB_EXPORT void useTextOutput();
+      LIB_LOCAL void addColumn(const char* descr, const char* format);
+      LIB_LOCAL void beginColumnar();
     };
     
 
@@ -43,6 +43,8 @@ namespace Avida {
       World* m_world;
       
       Apto::String m_output_path;
+      bool m_columnar;
+      bool m_columnar_compress;
       
       mutable Apto::Mutex m_mutex;
       Apto::Map<OutputID, SocketWeakRef> m_sockets;
@@ -55,6 +57,16 @@ namespace Avida {
       LIB_EXPORT inline const Apto::String& OutputPath() const { return m_output_path; }
       
       LIB_EXPORT OutputID OutputIDFromPath(Apto::String path) const;
+      
+      // Tabular files created after this call are stored in the columnar binary format (as <path>.col), optionally
+      // compressed.  See Output::ColumnarFile.h.
+      LIB_EXPORT inline void SetColumnarFiles(bool enabled, bool compress = false)
+      {
+        m_columnar = enabled;
+        m_columnar_compress = compress;
+      }
+      LIB_EXPORT inline bool ColumnarFiles() const { return m_columnar; }
+      LIB_EXPORT inline bool CompressColumnarFiles() const { return m_columnar_compress; }
 
       LIB_EXPORT bool IsOpen(const OutputID& output_id) const;
       LIB_EXPORT bool Close(const OutputID& output_id);
@@ -64,6 +64,12 @@
 
 #include <cmath>
 #include <cerrno>
+#include <ctime>
+#ifdef _WIN32
+#include <sys/timeb.h>
+#else
+#include <sys/time.h>
+#endif
 #include <map>
 #include <algorithm>
 
@@ -72,7 +78,8 @@ class cBioGroup;
 using namespace Avida;
 
 
-#define STATS_OUT_FILE(METHOD, DEFAULT)                                                   /*  1 */ \
+// Each output declares the organism statistics it is written from (see cStats::RequireStats)
+#define STATS_OUT_FILE_USING(METHOD, DEFAULT, STATS)                                      /*  1 */ \
 class cAction ## METHOD : public cAction {                                                /*  2 */ \
 private:                                                                                  /*  3 */ \
 cString m_filename;                                                                     /*  4 */ \
@@ -81,53 +88,58 @@ cAction ## METHOD(cWorld* world, const cString& args, Feedback&) : cAction(world
 {                                                                                       /*  7 */ \
 cString largs(args);                                                                  /*  8 */ \
 if (largs == "") m_filename = #DEFAULT; else m_filename = largs.PopWord();            /*  9 */ \
-}                                                                                       /* 10 */ \
-static const cString GetDescription() { return "Arguments: [string fname=\"" #DEFAULT "\"]"; }  /* 11 */ \
-void Process(cAvidaContext&) { m_world->GetStats().METHOD(m_filename); }            /* 12 */ \
-}                                                                                         /* 13 */ \
+world->GetStats().RequireStats(STATS, #METHOD);                                       /* 10 */ \
+}                                                                                       /* 11 */ \
+static const cString GetDescription() { return "Arguments: [string fname=\"" #DEFAULT "\"]"; }  /* 12 */ \
+void Process(cAvidaContext&) { m_world->GetStats().METHOD(m_filename); }            /* 13 */ \
+}                                                                                         /* 14 */ \
 
-STATS_OUT_FILE(PrintAverageData,            average.dat         );
+#define STATS_OUT_FILE(METHOD, DEFAULT) STATS_OUT_FILE_USING(METHOD, DEFAULT, cStats::STATS_ALL)
+
+STATS_OUT_FILE_USING(PrintEnabledStats,     enabled_stats.dat,  0);
+STATS_OUT_FILE_USING(PrintAllocationData,   allocation.dat,     0);
+STATS_OUT_FILE_USING(PrintAverageData,            average.dat, 0);
 STATS_OUT_FILE(PrintDemeAverageData,        deme_average.dat    );
-STATS_OUT_FILE(PrintErrorData,              error.dat           );
-STATS_OUT_FILE(PrintVarianceData,           variance.dat        );
-STATS_OUT_FILE(PrintCountData,              count.dat           );
+STATS_OUT_FILE_USING(PrintErrorData,              error.dat, 0);
+STATS_OUT_FILE_USING(PrintVarianceData,           variance.dat, 0);
+STATS_OUT_FILE_USING(PrintCountData,              count.dat, 0);
 STATS_OUT_FILE(PrintMessageData,            message.dat         );
 STATS_OUT_FILE(PrintMessageLog,             message_log.dat     );
 STATS_OUT_FILE(PrintRetMessageLog,          retmessage_log.dat  );
 STATS_OUT_FILE(PrintInterruptData,          interrupt.dat       );
-STATS_OUT_FILE(PrintTotalsData,             totals.dat          );
-STATS_OUT_FILE(PrintTasksData,              tasks.dat           );
-STATS_OUT_FILE(PrintThreadsData,            threads.dat         );
-STATS_OUT_FILE(PrintHostTasksData,          host_tasks.dat      );
-STATS_OUT_FILE(PrintParasiteTasksData,      parasite_tasks.dat  );
-STATS_OUT_FILE(PrintTasksExeData,           tasks_exe.dat       );
+STATS_OUT_FILE_USING(PrintTotalsData,             totals.dat, 0);
+STATS_OUT_FILE_USING(PrintTasksData,              tasks.dat, cStats::STATS_TASKS);
+STATS_OUT_FILE_USING(PrintThreadsData,            threads.dat, 0);
+STATS_OUT_FILE_USING(PrintHostTasksData,          host_tasks.dat, cStats::STATS_TASKS);
+STATS_OUT_FILE_USING(PrintParasiteTasksData,      parasite_tasks.dat, cStats::STATS_TASKS);
+STATS_OUT_FILE_USING(PrintTasksExeData,           tasks_exe.dat, cStats::STATS_TASKS);
 STATS_OUT_FILE(PrintNewTasksData,           newtasks.dat	);
 STATS_OUT_FILE(PrintNewReactionData,	    newreactions.dat	);
 STATS_OUT_FILE(PrintNewTasksDataPlus,       newtasksplus.dat	);
-STATS_OUT_FILE(PrintTasksQualData,          tasks_quality.dat   );
-STATS_OUT_FILE(PrintReactionData,           reactions.dat       );
-STATS_OUT_FILE(PrintReactionExeData,        reactions_exe.dat   );
-STATS_OUT_FILE(PrintCurrentReactionData,    cur_reactions.dat   );
-STATS_OUT_FILE(PrintReactionRewardData,     reaction_reward.dat );
-STATS_OUT_FILE(PrintCurrentReactionRewardData,     cur_reaction_reward.dat );
-STATS_OUT_FILE(PrintTimeData,               time.dat            );
-STATS_OUT_FILE(PrintExtendedTimeData,       xtime.dat           );
-STATS_OUT_FILE(PrintMutationRateData,       mutation_rates.dat  );
-STATS_OUT_FILE(PrintDivideMutData,          divide_mut.dat      );
+STATS_OUT_FILE_USING(PrintTasksQualData,          tasks_quality.dat, cStats::STATS_TASKS);
+STATS_OUT_FILE_USING(PrintReactionData,           reactions.dat, cStats::STATS_REACTIONS);
+STATS_OUT_FILE_USING(PrintReactionExeData,        reactions_exe.dat, cStats::STATS_REACTIONS);
+STATS_OUT_FILE_USING(PrintCurrentReactionData,    cur_reactions.dat, cStats::STATS_REACTIONS);
+STATS_OUT_FILE_USING(PrintReactionRewardData,     reaction_reward.dat, cStats::STATS_REACTIONS);
+STATS_OUT_FILE_USING(PrintCurrentReactionRewardData,     cur_reaction_reward.dat, cStats::STATS_REACTIONS);
+STATS_OUT_FILE_USING(PrintTimeData,               time.dat, 0);
+STATS_OUT_FILE_USING(PrintExtendedTimeData,       xtime.dat, 0);
+STATS_OUT_FILE_USING(PrintMutationRateData,       mutation_rates.dat, cStats::STATS_MUTATION_RATES);
+STATS_OUT_FILE_USING(PrintDivideMutData,          divide_mut.dat, cStats::STATS_MUTATION_RATES);
 STATS_OUT_FILE(PrintParasiteData,           parasite.dat        );
-STATS_OUT_FILE(PrintPreyAverageData,        prey_average.dat   );
-STATS_OUT_FILE(PrintPredatorAverageData,    predator_average.dat   );
-STATS_OUT_FILE(PrintTopPredatorAverageData,    top_pred_average.dat   );
-STATS_OUT_FILE(PrintPreyErrorData,          prey_error.dat   );
-STATS_OUT_FILE(PrintPredatorErrorData,      predator_error.dat   );
-STATS_OUT_FILE(PrintTopPredatorErrorData,      top_pred_error.dat   );
-STATS_OUT_FILE(PrintPreyVarianceData,       prey_variance.dat   );
-STATS_OUT_FILE(PrintPredatorVarianceData,   predator_variance.dat   );
-STATS_OUT_FILE(PrintTopPredatorVarianceData,   top_pred_variance.dat   );
+STATS_OUT_FILE_USING(PrintPreyAverageData,        prey_average.dat, cStats::STATS_FORAGE_TARGETS);
+STATS_OUT_FILE_USING(PrintPredatorAverageData,    predator_average.dat, cStats::STATS_FORAGE_TARGETS);
+STATS_OUT_FILE_USING(PrintTopPredatorAverageData,    top_pred_average.dat, cStats::STATS_FORAGE_TARGETS);
+STATS_OUT_FILE_USING(PrintPreyErrorData,          prey_error.dat, cStats::STATS_FORAGE_TARGETS);
+STATS_OUT_FILE_USING(PrintPredatorErrorData,      predator_error.dat, cStats::STATS_FORAGE_TARGETS);
+STATS_OUT_FILE_USING(PrintTopPredatorErrorData,      top_pred_error.dat, cStats::STATS_FORAGE_TARGETS);
+STATS_OUT_FILE_USING(PrintPreyVarianceData,       prey_variance.dat, cStats::STATS_FORAGE_TARGETS);
+STATS_OUT_FILE_USING(PrintPredatorVarianceData,   predator_variance.dat, cStats::STATS_FORAGE_TARGETS);
+STATS_OUT_FILE_USING(PrintTopPredatorVarianceData,   top_pred_variance.dat, cStats::STATS_FORAGE_TARGETS);
 STATS_OUT_FILE(PrintSenseData,              sense.dat           );
 STATS_OUT_FILE(PrintSenseExeData,           sense_exe.dat       );
-STATS_OUT_FILE(PrintInternalTasksData,      in_tasks.dat        );
-STATS_OUT_FILE(PrintInternalTasksQualData,  in_tasks_quality.dat);
+STATS_OUT_FILE_USING(PrintInternalTasksData,      in_tasks.dat, cStats::STATS_TASKS);
+STATS_OUT_FILE_USING(PrintInternalTasksQualData,  in_tasks_quality.dat, cStats::STATS_TASKS);
 STATS_OUT_FILE(PrintSleepData,              sleep.dat           );
 STATS_OUT_FILE(PrintCompetitionData,        competition.dat     );
 STATS_OUT_FILE(PrintDemeReplicationData,    deme_repl.dat       );
@@ -189,12 +201,12 @@ STATS_OUT_FILE(PrintIntrinsicTaskSwitchingCostData, intrinsic_task_switching_cos
 STATS_OUT_FILE(PrintDenData, den_data.dat);
 
 //mating type/male-female stats data
-STATS_OUT_FILE(PrintMaleAverageData,    male_average.dat   );
-STATS_OUT_FILE(PrintFemaleAverageData,    female_average.dat   );
-STATS_OUT_FILE(PrintMaleErrorData, male_error.dat   );
-STATS_OUT_FILE(PrintFemaleErrorData, female_error.dat   );
-STATS_OUT_FILE(PrintMaleVarianceData, male_variance.dat   );
-STATS_OUT_FILE(PrintFemaleVarianceData, female_variance.dat   );
+STATS_OUT_FILE_USING(PrintMaleAverageData,    male_average.dat, cStats::STATS_MATING_TYPES);
+STATS_OUT_FILE_USING(PrintFemaleAverageData,    female_average.dat, cStats::STATS_MATING_TYPES);
+STATS_OUT_FILE_USING(PrintMaleErrorData, male_error.dat, cStats::STATS_MATING_TYPES);
+STATS_OUT_FILE_USING(PrintFemaleErrorData, female_error.dat, cStats::STATS_MATING_TYPES);
+STATS_OUT_FILE_USING(PrintMaleVarianceData, male_variance.dat, cStats::STATS_MATING_TYPES);
+STATS_OUT_FILE_USING(PrintFemaleVarianceData, female_variance.dat, cStats::STATS_MATING_TYPES);
 
 // reputation
 STATS_OUT_FILE(PrintReputationData,         reputation.dat);
@@ -397,6 +409,7 @@ public:
     cString largs(args);
     m_filename = largs.PopWord();
     m_format = largs.PopWord();
+    world->GetStats().RequireStats(cStats::STATS_ALL, "PrintData");
   }
   
   static const cString GetDescription() { return "Arguments: <cString fname> <cString format>"; }
@@ -1075,6 +1088,77 @@ public:
 };
 
 
+/*
+ Instruction throughput benchmark.  Each line records the instructions executed since the previous line, the elapsed
+ (wall clock) time they took and the resulting instructions per second, plus the same for the whole run so far.  Wall
+ time is used so that runs with several UPDATE_THREADS are credited for working in parallel.
+
+ Parameters:
+   filename (string) default: inst_rate.dat
+ */
+class cActionPrintInstructionRate : public cAction
+{
+private:
+  cString m_filename;
+  double m_start_time;
+  double m_last_time;
+  long long m_start_insts;
+  long long m_last_insts;
+  
+  static double wallSeconds()
+  {
+#ifdef _WIN32
+    struct _timeb now;
+    _ftime(&now);
+    return now.time + now.millitm / 1000.0;
+#else
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return now.tv_sec + now.tv_usec / 1000000.0;
+#endif
+  }
+  
+public:
+  cActionPrintInstructionRate(cWorld* world, const cString& args, Feedback&)
+    : cAction(world, args), m_start_time(0.0), m_last_time(0.0), m_start_insts(-1), m_last_insts(0)
+  {
+    cString largs(args);
+    if (largs == "") m_filename = "inst_rate.dat"; else m_filename = largs.PopWord();
+  }
+  
+  static const cString GetDescription() { return "Arguments: [string fname=\"inst_rate.dat\"]"; }
+  
+  void Process(cAvidaContext&)
+  {
+    const double now = wallSeconds();
+    const long long insts = m_world->GetStats().GetTotalExecuted();
+    if (m_start_insts < 0) {
+      // Measure from the first line, so that setting up the world is not counted
+      m_start_insts = m_last_insts = insts;
+      m_start_time = m_last_time = now;
+    }
+    
+    const double secs = now - m_last_time;
+    const double total_secs = now - m_start_time;
+    
+    Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)m_filename);
+    df->WriteComment("Instruction throughput, measured in wall clock time");
+    df->WriteTimeStamp();
+    df->Write(m_world->GetStats().GetUpdate(), "Update");
+    df->Write((double)(insts - m_last_insts), "Instructions Executed Since Last Line");
+    df->Write(secs, "Seconds Since Last Line");
+    df->Write((secs > 0.0) ? (insts - m_last_insts) / secs : 0.0, "Instructions per Second Since Last Line");
+    df->Write((double)(insts - m_start_insts), "Instructions Executed");
+    df->Write(total_secs, "Seconds");
+    df->Write((total_secs > 0.0) ? (insts - m_start_insts) / total_secs : 0.0, "Instructions per Second");
+    df->Endl();
+    
+    m_last_time = now;
+    m_last_insts = insts;
+  }
+};
+
+
 class cActionPrintGenotypeAbundanceHistogram : public cAction
 {
 private:
@@ -5450,6 +5534,8 @@ void RegisterPrintActions(cActionLibrary* action_lib)
   
   
   // Stats Out Files
+  action_lib->Register<cActionPrintEnabledStats>("PrintEnabledStats");
+  action_lib->Register<cActionPrintAllocationData>("PrintAllocationData");
   action_lib->Register<cActionPrintAverageData>("PrintAverageData");
   action_lib->Register<cActionPrintDemeAverageData>("PrintDemeAverageData");
   action_lib->Register<cActionPrintFlowRateTuples>("PrintFlowRateTuples");
@@ -5637,6 +5723,7 @@ void RegisterPrintActions(cActionLibrary* action_lib)
   action_lib->Register<cActionPrintParasiteDepthHistogram>("PrintParasiteDepthHistogram");
   action_lib->Register<cActionPrintHostDepthHistogram>("PrintHostDepthHistogram");
   action_lib->Register<cActionEcho>("Echo");
+  action_lib->Register<cActionPrintInstructionRate>("PrintInstructionRate");
   action_lib->Register<cActionPrintGenotypeAbundanceHistogram>("PrintGenotypeAbundanceHistogram");
   //  action_lib->Register<cActionPrintSpeciesAbundanceHistogram>("PrintSpeciesAbundanceHistogram");
   //  action_lib->Register<cActionPrintLineageTotals>("PrintLineageTotals");
@@ -26,6 +26,7 @@
 #include "cArgContainer.h"
 #include "cArgSchema.h"
 #include "cPopulation.h"
+#include "cPopulationCheckpoint.h"
 #include "cStats.h"
 #include "cStringUtil.h"
 #include "cWorld.h"
@@ -176,6 +177,197 @@ public:
 };
 
 
+/*
+ Writes a binary population checkpoint (see cPopulationCheckpoint) to <filename>-<update>.ckpt.  In addition to the
+ contents of a .spop file, checkpoints record the execution state of each organism, resource levels, scheduler
+ priorities and the position of the event list.  Saving reseeds the random number generator with a fresh seed that is
+ recorded in the checkpoint, so a run restored from it continues exactly as the saving run does.  Only hardware types
+ that can save their execution state may be checkpointed, for others the save fails.
+
+ Parameters:
+   filename (string) default: checkpoint
+   compress (bool) default: 0
+     Run-length encode checkpoint sections
+ */
+class cActionSaveCheckpoint : public cAction
+{
+private:
+  cString m_filename;
+  bool m_compress;
+
+public:
+  cActionSaveCheckpoint(cWorld* world, const cString& args, Feedback& feedback)
+    : cAction(world, args), m_filename("checkpoint"), m_compress(false)
+  {
+    cArgSchema schema(':','=');
+
+    schema.AddEntry("filename", 0, "checkpoint");
+    schema.AddEntry("compress", 0, 0, 1, 0);
+
+    cArgContainer* argc = cArgContainer::Load(args, schema, feedback);
+
+    if (argc) {
+      m_filename = argc->GetString(0);
+      m_compress = argc->GetInt(0);
+    }
+
+    delete argc;
+  }
+
+  static const cString GetDescription() { return "Arguments: [string filename='checkpoint'] [boolean compress=0]"; }
+
+  void Process(cAvidaContext&)
+  {
+    int update = m_world->GetStats().GetUpdate();
+    cString filename = cStringUtil::Stringf("%s-%d.ckpt", (const char*)m_filename, update);
+    if (!m_world->GetPopulation().SaveCheckpoint(filename, m_compress)) {
+      m_world->GetDriver().Feedback().Error("failed to save checkpoint '%s'", (const char*)filename);
+    }
+  }
+};
+
+
+/*
+ Same as SaveCheckpoint, but only takes the in-memory snapshot at the update boundary; encoding and writing the file
+ are done by a background thread while the run continues.  At most CHECKPOINT_MAX_PENDING checkpoints are held in
+ memory at once.  Each file is written under a temporary name, flushed to disk and then renamed, so a crash never
+ leaves a partial checkpoint behind.
+
+ Parameters:
+   filename (string) default: checkpoint
+   compress (bool) default: 0
+     Run-length encode checkpoint sections
+ */
+class cActionSaveCheckpointAsync : public cAction
+{
+private:
+  cString m_filename;
+  bool m_compress;
+
+public:
+  cActionSaveCheckpointAsync(cWorld* world, const cString& args, Feedback& feedback)
+    : cAction(world, args), m_filename("checkpoint"), m_compress(false)
+  {
+    cArgSchema schema(':','=');
+
+    schema.AddEntry("filename", 0, "checkpoint");
+    schema.AddEntry("compress", 0, 0, 1, 0);
+
+    cArgContainer* argc = cArgContainer::Load(args, schema, feedback);
+
+    if (argc) {
+      m_filename = argc->GetString(0);
+      m_compress = argc->GetInt(0);
+    }
+
+    delete argc;
+  }
+
+  static const cString GetDescription() { return "Arguments: [string filename='checkpoint'] [boolean compress=0]"; }
+
+  void Process(cAvidaContext&)
+  {
+    int update = m_world->GetStats().GetUpdate();
+    cString filename = cStringUtil::Stringf("%s-%d.ckpt", (const char*)m_filename, update);
+    m_world->GetPopulation().SaveCheckpointAsync(filename, m_compress);
+  }
+};
+
+
+/*
+ Restores a population from a binary checkpoint.
+
+ Parameters:
+   filename (string)
+   restore_world (bool) default: 1
+     Also restore the update, resources, random number generator and event list position
+   cellid_offset (int) default: 0
+   lineage_offset (int) default: 0
+ */
+class cActionLoadCheckpoint : public cAction
+{
+private:
+  cString m_filename;
+  bool m_restore_world;
+  int m_cellid_offset;
+  int m_lineage_offset;
+
+public:
+  cActionLoadCheckpoint(cWorld* world, const cString& args, Feedback&)
+    : cAction(world, args), m_filename(""), m_restore_world(true), m_cellid_offset(0), m_lineage_offset(0)
+  {
+    cString largs(args);
+    if (largs.GetSize()) m_filename = largs.PopWord();
+    if (largs.GetSize()) m_restore_world = largs.PopWord().AsInt();
+    if (largs.GetSize()) m_cellid_offset = largs.PopWord().AsInt();
+    if (largs.GetSize()) m_lineage_offset = largs.PopWord().AsInt();
+  }
+
+  static const cString GetDescription() { return "Arguments: <cString fname> [bool restore_world=1] [int cellid_offset=0] [int lineage_offset=0]"; }
+
+  void Process(cAvidaContext& ctx)
+  {
+    if (!m_world->GetPopulation().LoadCheckpoint(m_filename, ctx, m_restore_world, m_cellid_offset, m_lineage_offset)) {
+      m_world->GetDriver().Feedback().Error("failed to load checkpoint");
+      m_world->GetDriver().Abort(Avida::INVALID_CONFIG);
+    }
+  }
+};
+
+
+class cActionConvertSpopToCheckpoint : public cAction
+{
+private:
+  cString m_spop_file;
+  cString m_checkpoint_file;
+  bool m_compress;
+
+public:
+  cActionConvertSpopToCheckpoint(cWorld* world, const cString& args, Feedback&)
+    : cAction(world, args), m_compress(false)
+  {
+    cString largs(args);
+    if (largs.GetSize()) m_spop_file = largs.PopWord();
+    if (largs.GetSize()) m_checkpoint_file = largs.PopWord();
+    if (largs.GetSize()) m_compress = largs.PopWord().AsInt();
+  }
+
+  static const cString GetDescription() { return "Arguments: <cString spop_file> <cString checkpoint_file> [bool compress=0]"; }
+
+  void Process(cAvidaContext&)
+  {
+    if (!cPopulationCheckpoint::ConvertFromSpop(m_world, m_spop_file, m_checkpoint_file, m_compress)) {
+      m_world->GetDriver().Feedback().Error("failed to convert '%s' to checkpoint", (const char*)m_spop_file);
+    }
+  }
+};
+
+
+class cActionConvertCheckpointToSpop : public cAction
+{
+private:
+  cString m_checkpoint_file;
+  cString m_spop_file;
+
+public:
+  cActionConvertCheckpointToSpop(cWorld* world, const cString& args, Feedback&) : cAction(world, args)
+  {
+    cString largs(args);
+    if (largs.GetSize()) m_checkpoint_file = largs.PopWord();
+    if (largs.GetSize()) m_spop_file = largs.PopWord();
+  }
+
+  static const cString GetDescription() { return "Arguments: <cString checkpoint_file> <cString spop_file>"; }
+
+  void Process(cAvidaContext&)
+  {
+    if (!cPopulationCheckpoint::ConvertToSpop(m_world, m_checkpoint_file, m_spop_file)) {
+      m_world->GetDriver().Feedback().Error("failed to convert checkpoint '%s'", (const char*)m_checkpoint_file);
+    }
+  }
+};
+
+
 class cActionLoadStructuredSystematicsGroup : public cAction
 {
 private:
@@ -287,6 +479,11 @@ void RegisterSaveLoadActions(cActionLibrary* action_lib)
   action_lib->Register<cActionLoadHostGenotypeList>("LoadHostGenotypeList");
   action_lib->Register<cActionLoadPopulation>("LoadPopulation");
   action_lib->Register<cActionSavePopulation>("SavePopulation");
+  action_lib->Register<cActionLoadCheckpoint>("LoadCheckpoint");
+  action_lib->Register<cActionSaveCheckpoint>("SaveCheckpoint");
+  action_lib->Register<cActionSaveCheckpointAsync>("SaveCheckpointAsync");
+  action_lib->Register<cActionConvertSpopToCheckpoint>("ConvertSpopToCheckpoint");
+  action_lib->Register<cActionConvertCheckpointToSpop>("ConvertCheckpointToSpop");
   action_lib->Register<cActionLoadStructuredSystematicsGroup>("LoadStructuredSystematicsGroup");
   action_lib->Register<cActionSaveStructuredSystematicsGroup>("SaveStructuredSystematicsGroup");
   action_lib->Register<cActionSaveFlameData>("SaveFlameData");
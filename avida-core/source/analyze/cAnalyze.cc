@@ -48,6 +48,7 @@
 #include "cAvidaContext.h"
 #include "cCPUTestInfo.h"
 #include "cEnvironment.h"
+#include "cGenomeDistanceMatrix.h"
 #include "cHardwareBase.h"
 #include "cHardwareManager.h"
 #include "cHardwareStatusPrinter.h"
@@ -3282,6 +3283,58 @@ void cAnalyze::CommandPrintDistances(cString cur_string)
 }
 
 
+// Distances between every pair of genotypes in the current batch, computed on all worker threads and written as a binary
+// matrix (see cGenomeDistanceMatrix for the format).  Arguments: filename, metric (edit, hamming or sliding) and, for
+// edit distance, a bound beyond which distances are only reported as bound + 1.
+void cAnalyze::CommandPrintDistanceMatrix(cString cur_string)
+{
+  cString filename("distance_matrix.dat");
+  if (cur_string.GetSize() != 0) filename = cur_string.PopWord();
+  cString metric_name("edit");
+  if (cur_string.GetSize() != 0) metric_name = cur_string.PopWord();
+  int max_distance = -1;
+  if (cur_string.GetSize() != 0) max_distance = cur_string.PopWord().AsInt();
+  
+  cGenomeDistanceMatrix::eMetric metric;
+  if (!cGenomeDistanceMatrix::MetricFromName((const char*)metric_name, metric)) {
+    cerr << "Error: Unknown distance metric '" << metric_name << "' (edit, hamming or sliding)." << endl;
+    return;
+  }
+  
+  if (m_world->GetVerbosity() >= VERBOSE_ON) {
+    cout << "Calculating " << metric_name << " distance matrix for batch " << cur_batch << endl;
+  } else {
+    cout << "Calculating distance matrix..." << endl;
+  }
+  
+  // Hold on to the sequences until the matrix is done with them
+  Apto::Array<ConstInstructionSequencePtr> seqs;
+  cGenomeDistanceMatrix matrix(metric, max_distance);
+  tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
+  for (cAnalyzeGenotype* genotype = batch_it.Next(); genotype; genotype = batch_it.Next()) {
+    ConstInstructionSequencePtr seq_p;
+    seq_p.DynamicCastFrom(genotype->GetGenome().Representation());
+    if (!seq_p) continue;
+    seqs.Push(seq_p);
+    matrix.AddSequence(genotype->GetID(), *seq_p);
+  }
+  
+  if (!matrix.Calculate(m_jobqueue)) {
+    cerr << "Error: Distance matrix of " << matrix.GetSize() << " genotypes is too large (at most "
+         << cGenomeDistanceMatrix::MAX_SIZE << ")." << endl;
+    return;
+  }
+  
+  const Apto::String path = Avida::Output::Manager::Of(m_world->GetNewWorld())->OutputIDFromPath((const char*)filename);
+  ofstream fout((const char*)path, ios::out | ios::trunc | ios::binary);
+  if (!fout.good()) {
+    cerr << "Error: Unable to open '" << filename << "' for writing." << endl;
+    return;
+  }
+  matrix.Write(fout);
+}
+
+
 // Calculate various stats for trees in population.
 void cAnalyze::CommandPrintTreeStats(cString cur_string)
 {
@@ -4480,6 +4533,128 @@ void cAnalyze::AnalyzeComplexityDelta(cString cur_string)
   }
 }
 
+// Knockout counts for a single genotype, computed on the job queue.  The null instruction must already be active in
+// the genotype's instruction set, since activating it modifies the set.
+class cKnockoutJob
+{
+private:
+  cAnalyzeGenotype* m_genotype;
+  int m_max_knockouts;
+  Instruction m_null_inst;
+  
+public:
+  int dead_count, neg_count, neut_count, pos_count;
+  int pair_dead_count, pair_neg_count, pair_neut_count, pair_pos_count;
+  
+  cKnockoutJob(cAnalyzeGenotype* genotype, int max_knockouts, const Instruction& null_inst)
+    : m_genotype(genotype), m_max_knockouts(max_knockouts), m_null_inst(null_inst)
+    , dead_count(0), neg_count(0), neut_count(0), pos_count(0)
+    , pair_dead_count(0), pair_neg_count(0), pair_neut_count(0), pair_pos_count(0) { ; }
+  
+  void Run(cAvidaContext& ctx);
+};
+
+
+void cKnockoutJob::Run(cAvidaContext& ctx)
+{
+  cWorld* world = m_genotype->GetWorld();
+  
+  // Calculate the stats for the genotype we're working with...
+  m_genotype->Recalculate(ctx);
+  const double base_fitness = m_genotype->GetFitness();
+  
+  const int max_line = m_genotype->GetLength();
+  
+  const Genome& base_genome = m_genotype->GetGenome();
+  ConstInstructionSequencePtr base_seq_p;
+  ConstGeneticRepresentationPtr rep_p = base_genome.Representation();
+  base_seq_p.DynamicCastFrom(rep_p);
+  const InstructionSequence& base_seq = *base_seq_p;
+  
+  Genome mod_genome(base_genome);
+  InstructionSequencePtr mod_seq_p;
+  GeneticRepresentationPtr mod_rep_p = mod_genome.Representation();
+  mod_seq_p.DynamicCastFrom(mod_rep_p);
+  InstructionSequence& mod_seq = *mod_seq_p;
+  
+  // Loop through all the lines of code, testing the removal of each.
+  // -2=lethal, -1=detrimental, 0=neutral, 1=beneficial
+  Apto::Array<int> ko_effect(max_line);
+  for (int line_num = 0; line_num < max_line; line_num++) {
+    // Save a copy of the current instruction and replace it with "NULL"
+    int cur_inst = base_seq[line_num].GetOp();
+    mod_seq[line_num] = m_null_inst;
+    cAnalyzeGenotype ko_genotype(world, mod_genome);
+    ko_genotype.Recalculate(ctx);
+    
+    double ko_fitness = ko_genotype.GetFitness();
+    if (ko_fitness == 0.0) {
+      dead_count++;
+      ko_effect[line_num] = -2;
+    } else if (ko_fitness < base_fitness) {
+      neg_count++;
+      ko_effect[line_num] = -1;
+    } else if (ko_fitness == base_fitness) {
+      neut_count++;
+      ko_effect[line_num] = 0;
+    } else if (ko_fitness > base_fitness) {
+      pos_count++;
+      ko_effect[line_num] = 1;
+    } else {
+      cerr << "ERROR: illegal state in AnalyzeKnockouts()" << endl;
+    }
+    
+    // Reset the mod_genome back to the original sequence.
+    mod_seq[line_num].SetOp(cur_inst);
+  }
+  
+  Apto::Array<int> ko_pair_effect(ko_effect);
+  if (m_max_knockouts > 1) {
+    for (int line1 = 0; line1 < max_line; line1++) {
+      for (int line2 = line1+1; line2 < max_line; line2++) {
+        int cur_inst1 = base_seq[line1].GetOp();
+        int cur_inst2 = base_seq[line2].GetOp();
+        mod_seq[line1] = m_null_inst;
+        mod_seq[line2] = m_null_inst;
+        cAnalyzeGenotype ko_genotype(world, mod_genome);
+        ko_genotype.Recalculate(ctx);
+        
+        double ko_fitness = ko_genotype.GetFitness();
+        
+        // If both individual knockouts are both harmful, but in combination
+        // they are neutral or even beneficial, they should not count as 
+        // information.
+        if (ko_fitness >= base_fitness &&
+            ko_effect[line1] < 0 && ko_effect[line2] < 0) {
+          ko_pair_effect[line1] = 0;
+          ko_pair_effect[line2] = 0;
+        }
+        
+        // If the individual knockouts are both neutral (or beneficial?),
+        // but in combination they are harmful, they are likely redundant
+        // to each other.  For now, count them both as information.
+        if (ko_fitness < base_fitness &&
+            ko_effect[line1] >= 0 && ko_effect[line2] >= 0) {
+          ko_pair_effect[line1] = -1;
+          ko_pair_effect[line2] = -1;
+        }	
+        
+        // Reset the mod_genome back to the original sequence.
+        mod_seq[line1].SetOp(cur_inst1);
+        mod_seq[line2].SetOp(cur_inst2);
+      }
+    }
+  }    
+  
+  for (int i = 0; i < max_line; i++) {
+    if (ko_pair_effect[i] == -2) pair_dead_count++;
+    else if (ko_pair_effect[i] == -1) pair_neg_count++;
+    else if (ko_pair_effect[i] == 0) pair_neut_count++;
+    else if (ko_pair_effect[i] == 1) pair_pos_count++;
+  }
+}
+
+
 void cAnalyze::AnalyzeKnockouts(cString cur_string)
 {
   cout << "Analyzing the effects of knockouts..." << endl;
@@ -4496,127 +4671,36 @@ void cAnalyze::AnalyzeKnockouts(cString cur_string)
   df->WriteTimeStamp();  
   
   
-  // Loop through all of the genotypes in this batch...
+  // Knock out every genotype in this batch on the job queue...
   tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
-  cAnalyzeGenotype * genotype = NULL;
-  while ((genotype = batch_it.Next()) != NULL) {
+  Apto::Array<cKnockoutJob*> jobs(batch[cur_batch].List().GetSize());
+  tAnalyzeJobBatch<cKnockoutJob> jobbatch(m_jobqueue);
+  for (int i = 0; batch_it.Next() != NULL; i++) {
+    cAnalyzeGenotype* genotype = batch_it.Get();
     if (m_world->GetVerbosity() >= VERBOSE_ON) cout << "  Knockout: " << genotype->GetName() << endl;
     
-    // Calculate the stats for the genotype we're working with...
-    genotype->Recalculate(m_ctx);
-    const double base_fitness = genotype->GetFitness();
-    
-    const int max_line = genotype->GetLength();
-    
     const Genome& base_genome = genotype->GetGenome();
-    ConstInstructionSequencePtr base_seq_p;
-    ConstGeneticRepresentationPtr rep_p = base_genome.Representation();
-    base_seq_p.DynamicCastFrom(rep_p);
-    const InstructionSequence& base_seq = *base_seq_p;
-    
-    Genome mod_genome(base_genome);
-    InstructionSequencePtr mod_seq_p;
-    GeneticRepresentationPtr mod_rep_p = mod_genome.Representation();
-    mod_seq_p.DynamicCastFrom(mod_rep_p);
-    InstructionSequence& mod_seq = *mod_seq_p;
-    
     Instruction null_inst = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).ActivateNullInst();
-    
-    // Loop through all the lines of code, testing the removal of each.
-    // -2=lethal, -1=detrimental, 0=neutral, 1=beneficial
-    int dead_count = 0;
-    int neg_count = 0;
-    int neut_count = 0;
-    int pos_count = 0;
-    Apto::Array<int> ko_effect(max_line);
-    for (int line_num = 0; line_num < max_line; line_num++) {
-      // Save a copy of the current instruction and replace it with "NULL"
-      int cur_inst = base_seq[line_num].GetOp();
-      mod_seq[line_num] = null_inst;
-      cAnalyzeGenotype ko_genotype(m_world, mod_genome);
-      ko_genotype.Recalculate(m_ctx);
-      
-      double ko_fitness = ko_genotype.GetFitness();
-      if (ko_fitness == 0.0) {
-        dead_count++;
-        ko_effect[line_num] = -2;
-      } else if (ko_fitness < base_fitness) {
-        neg_count++;
-        ko_effect[line_num] = -1;
-      } else if (ko_fitness == base_fitness) {
-        neut_count++;
-        ko_effect[line_num] = 0;
-      } else if (ko_fitness > base_fitness) {
-        pos_count++;
-        ko_effect[line_num] = 1;
-      } else {
-        cerr << "ERROR: illegal state in AnalyzeKnockouts()" << endl;
-      }
-      
-      // Reset the mod_genome back to the original sequence.
-      mod_seq[line_num].SetOp(cur_inst);
-    }
-    
-    Apto::Array<int> ko_pair_effect(ko_effect);
-    if (max_knockouts > 1) {
-      for (int line1 = 0; line1 < max_line; line1++) {
-      	for (int line2 = line1+1; line2 < max_line; line2++) {
-          int cur_inst1 = base_seq[line1].GetOp();
-          int cur_inst2 = base_seq[line2].GetOp();
-          mod_seq[line1] = null_inst;
-          mod_seq[line2] = null_inst;
-          cAnalyzeGenotype ko_genotype(m_world, mod_genome);
-          ko_genotype.Recalculate(m_ctx);
-          
-          double ko_fitness = ko_genotype.GetFitness();
-          
-          // If both individual knockouts are both harmful, but in combination
-          // they are neutral or even beneficial, they should not count as 
-          // information.
-          if (ko_fitness >= base_fitness &&
-              ko_effect[line1] < 0 && ko_effect[line2] < 0) {
-            ko_pair_effect[line1] = 0;
-            ko_pair_effect[line2] = 0;
-          }
-          
-          // If the individual knockouts are both neutral (or beneficial?),
-          // but in combination they are harmful, they are likely redundant
-          // to each other.  For now, count them both as information.
-          if (ko_fitness < base_fitness &&
-              ko_effect[line1] >= 0 && ko_effect[line2] >= 0) {
-            ko_pair_effect[line1] = -1;
-            ko_pair_effect[line2] = -1;
-          }	
-          
-          // Reset the mod_genome back to the original sequence.
-          mod_seq[line1].SetOp(cur_inst1);
-          mod_seq[line2].SetOp(cur_inst2);
-        }
-      }
-    }    
-    
-    int pair_dead_count = 0;
-    int pair_neg_count = 0;
-    int pair_neut_count = 0;
-    int pair_pos_count = 0;
-    for (int i = 0; i < max_line; i++) {
-      if (ko_pair_effect[i] == -2) pair_dead_count++;
-      else if (ko_pair_effect[i] == -1) pair_neg_count++;
-      else if (ko_pair_effect[i] == 0) pair_neut_count++;
-      else if (ko_pair_effect[i] == 1) pair_pos_count++;
-    }
-    
-    // Output data...
-    df->Write(genotype->GetID(), "Genotype ID");
-    df->Write(dead_count, "Count of lethal knockouts");
-    df->Write(neg_count,  "Count of detrimental knockouts");
-    df->Write(neut_count, "Count of neutral knockouts");
-    df->Write(pos_count,  "Count of beneficial knockouts");
-    df->Write(pair_dead_count, "Count of lethal knockouts after paired knockout tests.");
-    df->Write(pair_neg_count,  "Count of detrimental knockouts after paired knockout tests.");
-    df->Write(pair_neut_count, "Count of neutral knockouts after paired knockout tests.");
-    df->Write(pair_pos_count,  "Count of beneficial knockouts after paired knockout tests.");
+    jobs[i] = new cKnockoutJob(genotype, max_knockouts, null_inst);
+    jobbatch.AddJob(jobs[i], &cKnockoutJob::Run);
+  }
+  jobbatch.RunBatch();
+  
+  // ...and output the data in batch order.
+  batch_it.Reset();
+  for (int i = 0; batch_it.Next() != NULL; i++) {
+    const cKnockoutJob& job = *jobs[i];
+    df->Write(batch_it.Get()->GetID(), "Genotype ID");
+    df->Write(job.dead_count, "Count of lethal knockouts");
+    df->Write(job.neg_count,  "Count of detrimental knockouts");
+    df->Write(job.neut_count, "Count of neutral knockouts");
+    df->Write(job.pos_count,  "Count of beneficial knockouts");
+    df->Write(job.pair_dead_count, "Count of lethal knockouts after paired knockout tests.");
+    df->Write(job.pair_neg_count,  "Count of detrimental knockouts after paired knockout tests.");
+    df->Write(job.pair_neut_count, "Count of neutral knockouts after paired knockout tests.");
+    df->Write(job.pair_pos_count,  "Count of beneficial knockouts after paired knockout tests.");
     df->Endl();
+    delete jobs[i];
   }
 }
 
@@ -6040,6 +6124,61 @@ void cAnalyze::AllComplexityBarriers(cString cur_string)
 
 
 
+// Recalculates a genotype and each of its single site knockouts on the job queue, for CommandMapTasks to write out.
+class cTaskMapJob
+{
+private:
+  cAnalyzeGenotype* m_genotype;
+  cCPUTestInfo m_test_info;
+  Instruction m_null_inst;
+  
+public:
+  cString prev_file;
+  cString next_file;
+  Apto::Array<cAnalyzeGenotype*> knockouts;  // One per site, with that site replaced by the null instruction
+  
+  cTaskMapJob(cAnalyzeGenotype* genotype, const cCPUTestInfo& test_info, const Instruction& null_inst)
+    : m_genotype(genotype), m_test_info(test_info), m_null_inst(null_inst) { ; }
+  ~cTaskMapJob() { for (int i = 0; i < knockouts.GetSize(); i++) delete knockouts[i]; }
+  
+  cAnalyzeGenotype* GetGenotype() { return m_genotype; }
+  
+  void Run(cAvidaContext& ctx);
+};
+
+
+void cTaskMapJob::Run(cAvidaContext& ctx)
+{
+  // Calculate the stats for the genotype we're working with...
+  m_genotype->Recalculate(ctx, &m_test_info);
+  
+  const int max_line = m_genotype->GetLength();
+  const Genome& base_genome = m_genotype->GetGenome();
+  ConstInstructionSequencePtr base_seq_p;
+  ConstGeneticRepresentationPtr rep_p = base_genome.Representation();
+  base_seq_p.DynamicCastFrom(rep_p);
+  const InstructionSequence& base_seq = *base_seq_p;
+  
+  Genome mod_genome(base_genome);
+  InstructionSequencePtr mod_seq_p;
+  GeneticRepresentationPtr mod_rep_p = mod_genome.Representation();
+  mod_seq_p.DynamicCastFrom(mod_rep_p);
+  InstructionSequence& mod_seq = *mod_seq_p;
+  
+  // Loop through all the lines of code, testing the removal of each.
+  knockouts.Resize(max_line);
+  for (int line_num = 0; line_num < max_line; line_num++) {
+    int cur_inst = base_seq[line_num].GetOp();
+    mod_seq[line_num] = m_null_inst;
+    knockouts[line_num] = new cAnalyzeGenotype(m_genotype->GetWorld(), mod_genome);
+    knockouts[line_num]->Recalculate(ctx, &m_test_info);
+    
+    // Reset the mod_genome back to the original sequence.
+    mod_seq[line_num].SetOp(cur_inst);
+  }
+}
+
+
 void cAnalyze::CommandMapTasks(cString cur_string)
 {
   cString msg;  //Use if to construct any messages to send to driver
@@ -6126,220 +6265,225 @@ void cAnalyze::CommandMapTasks(cString cur_string)
   ///////////////////////////////////////////////////////
   // Loop through all of the genotypes in this batch...
   
+  cCPUTestInfo test_info;
+  if (use_manual_inputs)
+    test_info.UseManualInputs(manual_inputs);
+  test_info.SetResourceOptions(use_resources, m_resources);
+  
+  // The genotypes and their knockouts are tested on the job queue a window at a time, and each window's maps are then
+  // written out in batch order.
+  const int window = BatchUtil_JobWindow();
   tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
-  cAnalyzeGenotype * genotype = NULL;
-  while ((genotype = batch_it.Next()) != NULL) {
-    if (m_world->GetVerbosity() >= VERBOSE_ON) cout << "  Mapping " << genotype->GetName() << endl;
-    
-    // Construct this filename...
-    cString filename;
-    if (file_type == FILE_TYPE_TEXT) {
-      filename.Set("%stasksites.%s.dat", static_cast<const char*>(directory), static_cast<const char*>(genotype->GetName()));
-    } else {   //  if (file_type == FILE_TYPE_HTML) {
-      filename.Set("%stasksites.%s.html", static_cast<const char*>(directory), static_cast<const char*>(genotype->GetName()));
-    }
-    Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
-    
-    // Construct linked filenames...
-    cString next_file("");
-    cString prev_file("");
-    if (link_maps == true) {
-      // Check the next genotype on the list...
-      if (batch_it.Next() != NULL) {
-        next_file.Set("tasksites.%s.html", static_cast<const char*>(batch_it.Get()->GetName()));
+  cAnalyzeGenotype* next_genotype = batch_it.Next();
+  while (next_genotype != NULL) {
+    Apto::Array<cTaskMapJob*> jobs;
+    tAnalyzeJobBatch<cTaskMapJob> jobbatch(m_jobqueue);
+    for (; next_genotype != NULL && jobs.GetSize() < window; next_genotype = batch_it.Next()) {
+      const Genome& genome = next_genotype->GetGenome();
+      cInstSet& inst_set = m_world->GetHardwareManager().GetInstSet(genome.Properties().Get("instset").StringValue());
+      cTaskMapJob* job = new cTaskMapJob(next_genotype, test_info, inst_set.ActivateNullInst());
+      
+      // Construct linked filenames...
+      if (link_maps == true) {
+        // Check the next genotype on the list...
+        if (batch_it.Next() != NULL) {
+          job->next_file.Set("tasksites.%s.html", static_cast<const char*>(batch_it.Get()->GetName()));
+        }
+        batch_it.Prev();  // Put the list back where it was...
+        
+        // Check the previous genotype on the list...
+        if (batch_it.Prev() != NULL) {
+          job->prev_file.Set("tasksites.%s.html", static_cast<const char*>(batch_it.Get()->GetName()));
+        }
+        batch_it.Next();  // Put the list back where it was...
       }
-      batch_it.Prev();  // Put the list back where it was...
       
-      // Check the previous genotype on the list...
-      if (batch_it.Prev() != NULL) {
-        prev_file.Set("tasksites.%s.html", static_cast<const char*>(batch_it.Get()->GetName()));
-      }
-      batch_it.Next();  // Put the list back where it was...
+      jobs.Push(job);
+      jobbatch.AddJob(job, &cTaskMapJob::Run);
     }
+    jobbatch.RunBatch();
     
-    // Calculate the stats for the genotype we're working with...
-    cCPUTestInfo test_info;
-    if (use_manual_inputs)
-      test_info.UseManualInputs(manual_inputs);
-    test_info.SetResourceOptions(use_resources, m_resources);
-    genotype->Recalculate(m_ctx, &test_info);
-    
-    // Headers...
-    if (file_type == FILE_TYPE_TEXT) {
-      fp << "-1 "  << batch[cur_batch].Name() << " "
-      << genotype->GetID() << " ";
+    for (int job_num = 0; job_num < jobs.GetSize(); job_num++) {
+      cTaskMapJob& job = *jobs[job_num];
+      cAnalyzeGenotype* genotype = job.GetGenotype();
+      const cString& next_file = job.next_file;
+      const cString& prev_file = job.prev_file;
+      if (m_world->GetVerbosity() >= VERBOSE_ON) cout << "  Mapping " << genotype->GetName() << endl;
       
-      tDataEntryCommand<cAnalyzeGenotype> * data_command = NULL;
-      while ((data_command = output_it.Next()) != NULL) {
-        fp << data_command->GetValue(genotype) << " ";
+      // Construct this filename...
+      cString filename;
+      if (file_type == FILE_TYPE_TEXT) {
+        filename.Set("%stasksites.%s.dat", static_cast<const char*>(directory), static_cast<const char*>(genotype->GetName()));
+      } else {   //  if (file_type == FILE_TYPE_HTML) {
+        filename.Set("%stasksites.%s.html", static_cast<const char*>(directory), static_cast<const char*>(genotype->GetName()));
       }
-      fp << endl;
+      Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
+      ofstream& fp = df->OFStream();
       
-    } else { // if (file_type == FILE_TYPE_HTML) {
-      // Mark file as html
-      fp << "<html>" << endl;
-      
-      // Setup any javascript macros needed...
-      fp << "<head>" << endl;
-      if (link_insts == true) {
-        fp << "<script language=\"javascript\">" << endl
-        << "function Inst(inst_name)" << endl
-        << "{" << endl
-        << "var filename = \"help.\" + inst_name + \".html\";" << endl
-        << "newwin = window.open(filename, 'Instruction', "
-        << "'toolbar=0,status=0,location=0,directories=0,menubar=0,"
-        << "scrollbars=1,height=150,width=300');" << endl
-        << "newwin.focus();" << endl
-        << "}" << endl
-        << "</script>" << endl;
-      }
-      fp << "</head>" << endl;
-      
-      // Setup the body...
-      fp << "<body>" << endl
-      << "<div align=\"center\">" << endl
-      << "<h1 align=\"center\">Run " << batch[cur_batch].Name() << ", ID " << genotype->GetID() << "</h1>" << endl
-      << endl;
+      // Headers...
+      if (file_type == FILE_TYPE_TEXT) {
+        fp << "-1 "  << batch[cur_batch].Name() << " "
+        << genotype->GetID() << " ";
+      
+        tDataEntryCommand<cAnalyzeGenotype> * data_command = NULL;
+        while ((data_command = output_it.Next()) != NULL) {
+          fp << data_command->GetValue(genotype) << " ";
+        }
+        fp << endl;
       
-      // Links?
-      fp << "<table width=90%><tr><td align=left>";
-      if (prev_file != "") fp << "<a href=\"" << prev_file << "\">Prev</a>";
-      else fp << "&nbsp;";
-      fp << "<td align=right>";
-      if (next_file != "") fp << "<a href=\"" << next_file << "\">Next</a>";
-      else fp << "&nbsp;";
-      fp << "</tr></table>" << endl;
+      } else { // if (file_type == FILE_TYPE_HTML) {
+        // Mark file as html
+        fp << "<html>" << endl;
+      
+        // Setup any javascript macros needed...
+        fp << "<head>" << endl;
+        if (link_insts == true) {
+          fp << "<script language=\"javascript\">" << endl
+          << "function Inst(inst_name)" << endl
+          << "{" << endl
+          << "var filename = \"help.\" + inst_name + \".html\";" << endl
+          << "newwin = window.open(filename, 'Instruction', "
+          << "'toolbar=0,status=0,location=0,directories=0,menubar=0,"
+          << "scrollbars=1,height=150,width=300');" << endl
+          << "newwin.focus();" << endl
+          << "}" << endl
+          << "</script>" << endl;
+        }
+        fp << "</head>" << endl;
       
-      // The table
-      fp << "<table border=1 cellpadding=2>" << endl;
+        // Setup the body...
+        fp << "<body>" << endl
+        << "<div align=\"center\">" << endl
+        << "<h1 align=\"center\">Run " << batch[cur_batch].Name() << ", ID " << genotype->GetID() << "</h1>" << endl
+        << endl;
       
-      // The headings...///
-      fp << "<tr><td colspan=3> ";
-      output_it.Reset();
-      while (output_it.Next() != NULL) {
-        fp << "<th>" << output_it.Get()->GetDesc(genotype) << " ";
-      }
-      fp << "</tr>" << endl;
+        // Links?
+        fp << "<table width=90%><tr><td align=left>";
+        if (prev_file != "") fp << "<a href=\"" << prev_file << "\">Prev</a>";
+        else fp << "&nbsp;";
+        fp << "<td align=right>";
+        if (next_file != "") fp << "<a href=\"" << next_file << "\">Next</a>";
+        else fp << "&nbsp;";
+        fp << "</tr></table>" << endl;
       
-      // The base creature...
-      fp << "<tr><th colspan=3>Base Creature";
-      tDataEntryCommand<cAnalyzeGenotype> * data_command = NULL;
-      const cInstSet& is = m_world->GetHardwareManager().GetDefaultInstSet();
-      HashPropertyMap props;
-      cHardwareManager::SetupPropertyMap(props, (const char*)is.GetInstSetName());
-      Genome null_genome(is.GetHardwareType(), props, GeneticRepresentationPtr(new InstructionSequence(1)));
-      cAnalyzeGenotype null_genotype(m_world, null_genome);
-      while ((data_command = output_it.Next()) != NULL) {
-        const cFlexVar cur_value = data_command->GetValue(genotype);
-        const cFlexVar null_value = data_command->GetValue(&null_genotype);
-        int compare = CompareFlexStat(cur_value, null_value, data_command->GetCompareType()); 
-        if (compare > 0) {
-          fp << "<th bgcolor=\"#" << m_world->GetConfig().COLOR_MUT_POS.Get() << "\">";
+        // The table
+        fp << "<table border=1 cellpadding=2>" << endl;
+      
+        // The headings...///
+        fp << "<tr><td colspan=3> ";
+        output_it.Reset();
+        while (output_it.Next() != NULL) {
+          fp << "<th>" << output_it.Get()->GetDesc(genotype) << " ";
         }
-        else  fp << "<th bgcolor=\"#" << m_world->GetConfig().COLOR_MUT_LETHAL.Get() << "\">";
+        fp << "</tr>" << endl;
+      
+        // The base creature...
+        fp << "<tr><th colspan=3>Base Creature";
+        tDataEntryCommand<cAnalyzeGenotype> * data_command = NULL;
+        const cInstSet& is = m_world->GetHardwareManager().GetDefaultInstSet();
+        HashPropertyMap props;
+        cHardwareManager::SetupPropertyMap(props, (const char*)is.GetInstSetName());
+        Genome null_genome(is.GetHardwareType(), props, GeneticRepresentationPtr(new InstructionSequence(1)));
+        cAnalyzeGenotype null_genotype(m_world, null_genome);
+        while ((data_command = output_it.Next()) != NULL) {
+          const cFlexVar cur_value = data_command->GetValue(genotype);
+          const cFlexVar null_value = data_command->GetValue(&null_genotype);
+          int compare = CompareFlexStat(cur_value, null_value, data_command->GetCompareType()); 
+          if (compare > 0) {
+            fp << "<th bgcolor=\"#" << m_world->GetConfig().COLOR_MUT_POS.Get() << "\">";
+          }
+          else  fp << "<th bgcolor=\"#" << m_world->GetConfig().COLOR_MUT_LETHAL.Get() << "\">";
         
-        if (data_command->HasArg("blank") == true) fp << "&nbsp;" << " ";
-        else fp << cur_value << " ";
+          if (data_command->HasArg("blank") == true) fp << "&nbsp;" << " ";
+          else fp << cur_value << " ";
+        }
+        fp << "</tr>" << endl;
       }
-      fp << "</tr>" << endl;
-    }
-    
-    const int max_line = genotype->GetLength();
-    const Genome& base_genome = genotype->GetGenome();
-    ConstInstructionSequencePtr base_seq_p;
-    ConstGeneticRepresentationPtr rep_p = base_genome.Representation();
-    base_seq_p.DynamicCastFrom(rep_p);
-    const InstructionSequence& base_seq = *base_seq_p;
-    
-    Genome mod_genome(base_genome);
-    InstructionSequencePtr mod_seq_p;
-    GeneticRepresentationPtr mod_rep_p = mod_genome.Representation();
-    mod_seq_p.DynamicCastFrom(mod_rep_p);
-    InstructionSequence& mod_seq = *mod_seq_p;
-    
-    // Keep track of the number of failues/successes for attributes...
-    int * col_pass_count = new int[num_cols];
-    int * col_fail_count = new int[num_cols];
-    for (int i = 0; i < num_cols; i++) {
-      col_pass_count[i] = 0;
-      col_fail_count[i] = 0;
-    }
-    
-    cInstSet& is = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue());
-    const Instruction null_inst = is.ActivateNullInst();
-    
-    // Loop through all the lines of code, testing the removal of each.
-    for (int line_num = 0; line_num < max_line; line_num++) {
-      int cur_inst = base_seq[line_num].GetOp();
-      char cur_symbol = base_seq[line_num].GetSymbol()[0]; // hack to work around multichar symbols
       
-      mod_seq[line_num] = null_inst;
-      cAnalyzeGenotype test_genotype(m_world, mod_genome);
-      test_genotype.Recalculate(m_ctx, &test_info);
+      const int max_line = genotype->GetLength();
+      const Genome& base_genome = genotype->GetGenome();
+      ConstInstructionSequencePtr base_seq_p;
+      ConstGeneticRepresentationPtr rep_p = base_genome.Representation();
+      base_seq_p.DynamicCastFrom(rep_p);
+      const InstructionSequence& base_seq = *base_seq_p;
       
-      if (file_type == FILE_TYPE_HTML) fp << "<tr><td align=right>";
-      fp << (line_num + 1) << " ";
-      if (file_type == FILE_TYPE_HTML) fp << "<td align=center>";
-      fp << cur_symbol << " ";
-      if (file_type == FILE_TYPE_HTML) fp << "<td align=center>";
-      if (link_insts == true) {
-        fp << "<a href=\"javascript:Inst('"
-        << is.GetName(cur_inst)
-        << "')\">";
+      // Keep track of the number of failues/successes for attributes...
+      int * col_pass_count = new int[num_cols];
+      int * col_fail_count = new int[num_cols];
+      for (int i = 0; i < num_cols; i++) {
+        col_pass_count[i] = 0;
+        col_fail_count[i] = 0;
       }
-      fp << is.GetName(cur_inst) << " ";
-      if (link_insts == true) fp << "</a>";
       
+      const cInstSet& is = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue());
       
-      // Print the individual columns...
-      output_it.Reset();
-      tDataEntryCommand<cAnalyzeGenotype>* data_command = NULL;
-      int cur_col = 0;
-      while ((data_command = output_it.Next()) != NULL) {
-        const cFlexVar test_value = data_command->GetValue(&test_genotype);
-        int compare = CompareFlexStat(test_value, data_command->GetValue(genotype), data_command->GetCompareType());
+      // Loop through all the lines of code, writing out the effect of the removal of each.
+      for (int line_num = 0; line_num < max_line; line_num++) {
+        int cur_inst = base_seq[line_num].GetOp();
+        char cur_symbol = base_seq[line_num].GetSymbol()[0]; // hack to work around multichar symbols
+        const cAnalyzeGenotype& test_genotype = *job.knockouts[line_num];
+      
+        if (file_type == FILE_TYPE_HTML) fp << "<tr><td align=right>";
+        fp << (line_num + 1) << " ";
+        if (file_type == FILE_TYPE_HTML) fp << "<td align=center>";
+        fp << cur_symbol << " ";
+        if (file_type == FILE_TYPE_HTML) fp << "<td align=center>";
+        if (link_insts == true) {
+          fp << "<a href=\"javascript:Inst('"
+          << is.GetName(cur_inst)
+          << "')\">";
+        }
+        fp << is.GetName(cur_inst) << " ";
+        if (link_insts == true) fp << "</a>";
+      
+      
+        // Print the individual columns...
+        output_it.Reset();
+        tDataEntryCommand<cAnalyzeGenotype>* data_command = NULL;
+        int cur_col = 0;
+        while ((data_command = output_it.Next()) != NULL) {
+          const cFlexVar test_value = data_command->GetValue(&test_genotype);
+          int compare = CompareFlexStat(test_value, data_command->GetValue(genotype), data_command->GetCompareType());
         
-        if (file_type == FILE_TYPE_HTML) {
-          HTMLPrintStat(test_value, fp, compare, data_command->GetHtmlCellFlags(), data_command->GetNull(),
-                        !(data_command->HasArg("blank")));
-        } 
-        else fp << test_value << " ";
+          if (file_type == FILE_TYPE_HTML) {
+            HTMLPrintStat(test_value, fp, compare, data_command->GetHtmlCellFlags(), data_command->GetNull(),
+                          !(data_command->HasArg("blank")));
+          } 
+          else fp << test_value << " ";
         
-        if (compare == -2) col_fail_count[cur_col]++;
-        else if (compare == 2) col_pass_count[cur_col]++;
-        cur_col++;
+          if (compare == -2) col_fail_count[cur_col]++;
+          else if (compare == 2) col_pass_count[cur_col]++;
+          cur_col++;
+        }
+        if (file_type == FILE_TYPE_HTML) fp << "</tr>";
+        fp << endl;
       }
-      if (file_type == FILE_TYPE_HTML) fp << "</tr>";
-      fp << endl;
       
-      // Reset the mod_genome back to the original sequence.
-      mod_seq[line_num].SetOp(cur_inst);
-    }
-    
-    
-    // Construct the final line of the table with all totals...
-    if (file_type == FILE_TYPE_HTML) {
-      fp << "<tr><th colspan=3>Totals";
       
-      for (int i = 0; i < num_cols; i++) {
-        if (col_pass_count[i] > 0) {
-          fp << "<th bgcolor=\"#" << m_world->GetConfig().COLOR_MUT_POS.Get() << "\">" << col_pass_count[i];
-        }
-        else if (col_fail_count[i] > 0) {
-          fp << "<th bgcolor=\"#" << m_world->GetConfig().COLOR_MUT_LETHAL.Get() << "\">" << col_fail_count[i];
+      // Construct the final line of the table with all totals...
+      if (file_type == FILE_TYPE_HTML) {
+        fp << "<tr><th colspan=3>Totals";
+      
+        for (int i = 0; i < num_cols; i++) {
+          if (col_pass_count[i] > 0) {
+            fp << "<th bgcolor=\"#" << m_world->GetConfig().COLOR_MUT_POS.Get() << "\">" << col_pass_count[i];
+          }
+          else if (col_fail_count[i] > 0) {
+            fp << "<th bgcolor=\"#" << m_world->GetConfig().COLOR_MUT_LETHAL.Get() << "\">" << col_fail_count[i];
+          }
+          else fp << "<th>0";
         }
-        else fp << "<th>0";
+        fp << "</tr>" << endl;
+      
+        // And close everything up...
+        fp << "</table>" << endl
+        << "</div>" << endl;
       }
-      fp << "</tr>" << endl;
       
-      // And close everything up...
-      fp << "</table>" << endl
-      << "</div>" << endl;
+      delete [] col_pass_count;
+      delete [] col_fail_count;
+      delete jobs[job_num];
     }
-    
-    delete [] col_pass_count;
-    delete [] col_fail_count;
   }
 }
 
@@ -6997,6 +7141,66 @@ void cAnalyze::CommandAnalyzeRedundancyByInstFailure(cString cur_string)
   }
 }
 
+// Relative fitness of every single site substitution and knockout of a genotype, computed on the job queue for
+// CommandMapMutations to write out.  Substitutions by the site's own instruction are not tested.
+class cMutationMapJob
+{
+private:
+  cAnalyzeGenotype* m_genotype;
+  int m_num_insts;
+  Instruction m_null_inst;
+  Apto::Array<double> m_fitness;  // num_insts + 1 entries per site, the last for the knockout
+  
+public:
+  cMutationMapJob(cAnalyzeGenotype* genotype, int num_insts, const Instruction& null_inst)
+    : m_genotype(genotype), m_num_insts(num_insts), m_null_inst(null_inst) { ; }
+  
+  cAnalyzeGenotype* GetGenotype() const { return m_genotype; }
+  int GetNumInsts() const { return m_num_insts; }
+  double GetFitness(int line_num, int mod_inst) const { return m_fitness[line_num * (m_num_insts + 1) + mod_inst]; }
+  
+  void Run(cAvidaContext& ctx);
+};
+
+
+void cMutationMapJob::Run(cAvidaContext& ctx)
+{
+  // Calculate the stats for the genotype we're working with...
+  m_genotype->Recalculate(ctx);
+  const double base_fitness = m_genotype->GetFitness();
+  const int max_line = m_genotype->GetLength();
+  
+  const Genome& base_genome = m_genotype->GetGenome();
+  ConstInstructionSequencePtr base_seq_p;
+  ConstGeneticRepresentationPtr rep_p = base_genome.Representation();
+  base_seq_p.DynamicCastFrom(rep_p);
+  const InstructionSequence& base_seq = *base_seq_p;
+  
+  Genome mod_genome(base_genome);
+  InstructionSequencePtr mod_seq_p;
+  GeneticRepresentationPtr mod_rep_p = mod_genome.Representation();
+  mod_seq_p.DynamicCastFrom(mod_rep_p);
+  InstructionSequence& seq = *mod_seq_p;
+  
+  m_fitness.Resize(max_line * (m_num_insts + 1));
+  m_fitness.SetAll(0.0);
+  for (int line_num = 0; line_num < max_line; line_num++) {
+    const int cur_inst = base_seq[line_num].GetOp();
+    for (int mod_inst = 0; mod_inst <= m_num_insts; mod_inst++) {
+      if (mod_inst == cur_inst) continue;
+      if (mod_inst == m_num_insts) seq[line_num] = m_null_inst;
+      else seq[line_num].SetOp(mod_inst);
+      cAnalyzeGenotype test_genotype(m_genotype->GetWorld(), mod_genome);
+      test_genotype.Recalculate(ctx);
+      m_fitness[line_num * (m_num_insts + 1) + mod_inst] = test_genotype.GetFitness() / base_fitness;
+    }
+    
+    // Reset the mod_genome back to the original sequence.
+    seq[line_num].SetOp(cur_inst);
+  }
+}
+
+
 void cAnalyze::CommandMapMutations(cString cur_string)
 {
   cout << "Constructing genome mutations maps..." << endl;
@@ -7022,240 +7226,240 @@ void cAnalyze::CommandMapMutations(cString cur_string)
   ///////////////////////////////////////////////////////
   // Loop through all of the genotypes in this batch...
   
+  // The mutants of each genotype are tested on the job queue a window at a time, and each window's maps are then
+  // written out in batch order.
+  const int window = BatchUtil_JobWindow();
   tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
-  cAnalyzeGenotype * genotype = NULL;
-  while ((genotype = batch_it.Next()) != NULL) {
-    if (m_world->GetVerbosity() >= VERBOSE_ON) {
-      cout << "  Creating mutation map for " << genotype->GetName() << endl;
-    }
-    
-    // Construct this filename...
-    cString filename;
-    if (file_type == FILE_TYPE_TEXT) {
-      filename.Set("%smut_map.%s.dat", static_cast<const char*>(directory), static_cast<const char*>(genotype->GetName()));
-    } else {   //  if (file_type == FILE_TYPE_HTML) {
-      filename.Set("%smut_map.%s.html", static_cast<const char*>(directory), static_cast<const char*>(genotype->GetName()));
-    }
-    if (m_world->GetVerbosity() >= VERBOSE_ON) {
-      cout << "  Using filename \"" << filename << "\"" << endl;
-    }
-    Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
-    
-    // Calculate the stats for the genotype we're working with...
-    genotype->Recalculate(m_ctx);
-    const double base_fitness = genotype->GetFitness();
-    const int max_line = genotype->GetLength();
-    
-    const Genome& base_genome = genotype->GetGenome();
-    ConstInstructionSequencePtr base_seq_p;
-    ConstGeneticRepresentationPtr rep_p = base_genome.Representation();
-    base_seq_p.DynamicCastFrom(rep_p);
-    const InstructionSequence& base_seq = *base_seq_p;
-    
-    Genome mod_genome(base_genome);
-    InstructionSequencePtr mod_seq_p;
-    GeneticRepresentationPtr mod_rep_p = mod_genome.Representation();
-    mod_seq_p.DynamicCastFrom(mod_rep_p);
-    InstructionSequence& seq = *mod_seq_p;
-    
-    const cInstSet& inst_set = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue());
-    const int num_insts = inst_set.GetSize();
-    
-    // Headers...
-    if (file_type == FILE_TYPE_TEXT) {
-      fp << "# 1: Genome instruction ID (pre-mutation)" << endl;
-      for (int i = 0; i < num_insts; i++) {
-        fp << "# " << i+1 <<": Fit if mutated to '"
-        << inst_set.GetName(i) << "'" << endl;
-      }
-      fp << "# " << num_insts + 2 << ": Knockout" << endl;
-      fp << "# " << num_insts + 3 << ": Fraction Lethal" << endl;
-      fp << "# " << num_insts + 4 << ": Fraction Detremental" << endl;
-      fp << "# " << num_insts + 5 << ": Fraction Neutral" << endl;
-      fp << "# " << num_insts + 6 << ": Fraction Beneficial" << endl;
-      fp << "# " << num_insts + 7 << ": Average Fitness" << endl;
-      fp << "# " << num_insts + 8 << ": Expected Entropy" << endl;
-      fp << "# " << num_insts + 9 << ": Original Instruction Name" << endl;
-      fp << endl;
+  cAnalyzeGenotype* next_genotype = batch_it.Next();
+  while (next_genotype != NULL) {
+    Apto::Array<cMutationMapJob*> jobs;
+    tAnalyzeJobBatch<cMutationMapJob> jobbatch(m_jobqueue);
+    for (; next_genotype != NULL && jobs.GetSize() < window; next_genotype = batch_it.Next()) {
+      const Genome& genome = next_genotype->GetGenome();
+      cInstSet& inst_set = m_world->GetHardwareManager().GetInstSet(genome.Properties().Get("instset").StringValue());
+      const Instruction null_inst = inst_set.ActivateNullInst();
+      cMutationMapJob* job = new cMutationMapJob(next_genotype, inst_set.GetSize(), null_inst);
+      jobs.Push(job);
+      jobbatch.AddJob(job, &cMutationMapJob::Run);
+    }
+    jobbatch.RunBatch();
+    
+    for (int job_num = 0; job_num < jobs.GetSize(); job_num++) {
+      const cMutationMapJob& job = *jobs[job_num];
+      cAnalyzeGenotype* genotype = job.GetGenotype();
+      if (m_world->GetVerbosity() >= VERBOSE_ON) {
+        cout << "  Creating mutation map for " << genotype->GetName() << endl;
+      }
       
-    } else { // if (file_type == FILE_TYPE_HTML) {
-             // Mark file as html
-      fp << "<html>" << endl;
-      
-      // Setup the body...
-      fp << "<body bgcolor=\"#FFFFFF\"" << endl
-        << " text=\"#000000\"" << endl
-        << " link=\"#0000AA\"" << endl
-        << " alink=\"#0000FF\"" << endl
-        << " vlink=\"#000044\">" << endl
-        << endl
-        << "<h1 align=center>Mutation Map for Run " << batch[cur_batch].Name()
-        << ", ID " << genotype->GetID() << "</h1>" << endl
-        << "<center>" << endl
-        << endl;
+      // Construct this filename...
+      cString filename;
+      if (file_type == FILE_TYPE_TEXT) {
+        filename.Set("%smut_map.%s.dat", static_cast<const char*>(directory), static_cast<const char*>(genotype->GetName()));
+      } else {   //  if (file_type == FILE_TYPE_HTML) {
+        filename.Set("%smut_map.%s.html", static_cast<const char*>(directory), static_cast<const char*>(genotype->GetName()));
+      }
+      if (m_world->GetVerbosity() >= VERBOSE_ON) {
+        cout << "  Using filename \"" << filename << "\"" << endl;
+      }
+      Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
+      ofstream& fp = df->OFStream();
       
-      // The main chart...
-      fp << "<table border=1 cellpadding=2>" << endl;
+      const int max_line = genotype->GetLength();
       
-      // The headings...///
-      fp << "<tr><th>Genome ";
-      for (int i = 0; i < num_insts; i++) {
-        fp << "<th>" << inst_set.GetName(i) << " ";
-      }
-      fp << "<th>Knockout ";
-      fp << "<th>Frac. Lethal ";
-      fp << "<th>Frac. Detremental ";
-      fp << "<th>Frac. Neutral ";
-      fp << "<th>Frac. Beneficial ";
-      fp << "<th>Ave. Fitness ";
-      fp << "<th>Expected Entropy ";
-      fp << "</tr>" << endl << endl;
-    }
-    
-    
-    // Keep track of the number of mutations in each category...
-    int total_dead = 0, total_neg = 0, total_neut = 0, total_pos = 0;
-    double total_fitness = 0.0;
-    Apto::Array<double> col_fitness(num_insts + 1);
-    col_fitness.SetAll(0.0);
-    
-    const Instruction null_inst = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).ActivateNullInst();
-    
-    cString color_string;  // For coloring cells...
-    
-    // Loop through all the lines of code, testing all mutations...
-    for (int line_num = 0; line_num < max_line; line_num++) {
-      int cur_inst = base_seq[line_num].GetOp();
-      char cur_symbol = base_seq[line_num].GetSymbol()[0]; // hack to work around multichar symbols
-      int row_dead = 0, row_neg = 0, row_neut = 0, row_pos = 0;
-      double row_fitness = 0.0;
+      const Genome& base_genome = genotype->GetGenome();
+      ConstInstructionSequencePtr base_seq_p;
+      ConstGeneticRepresentationPtr rep_p = base_genome.Representation();
+      base_seq_p.DynamicCastFrom(rep_p);
+      const InstructionSequence& base_seq = *base_seq_p;
       
-      // Column 1... the original instruction in the geneome.
-      if (file_type == FILE_TYPE_HTML) {
-        fp << "<tr><td align=right>" << inst_set.GetName(cur_inst)
-        << " (" << cur_symbol << ") ";
-      } else {
-        fp << cur_inst << " ";
+      const cInstSet& inst_set = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue());
+      const int num_insts = job.GetNumInsts();
+      
+      // Headers...
+      if (file_type == FILE_TYPE_TEXT) {
+        fp << "# 1: Genome instruction ID (pre-mutation)" << endl;
+        for (int i = 0; i < num_insts; i++) {
+          fp << "# " << i+1 <<": Fit if mutated to '"
+          << inst_set.GetName(i) << "'" << endl;
+        }
+        fp << "# " << num_insts + 2 << ": Knockout" << endl;
+        fp << "# " << num_insts + 3 << ": Fraction Lethal" << endl;
+        fp << "# " << num_insts + 4 << ": Fraction Detremental" << endl;
+        fp << "# " << num_insts + 5 << ": Fraction Neutral" << endl;
+        fp << "# " << num_insts + 6 << ": Fraction Beneficial" << endl;
+        fp << "# " << num_insts + 7 << ": Average Fitness" << endl;
+        fp << "# " << num_insts + 8 << ": Expected Entropy" << endl;
+        fp << "# " << num_insts + 9 << ": Original Instruction Name" << endl;
+        fp << endl;
+        
+      } else { // if (file_type == FILE_TYPE_HTML) {
+               // Mark file as html
+        fp << "<html>" << endl;
+        
+        // Setup the body...
+        fp << "<body bgcolor=\"#FFFFFF\"" << endl
+          << " text=\"#000000\"" << endl
+          << " link=\"#0000AA\"" << endl
+          << " alink=\"#0000FF\"" << endl
+          << " vlink=\"#000044\">" << endl
+          << endl
+          << "<h1 align=center>Mutation Map for Run " << batch[cur_batch].Name()
+          << ", ID " << genotype->GetID() << "</h1>" << endl
+          << "<center>" << endl
+          << endl;
+        
+        // The main chart...
+        fp << "<table border=1 cellpadding=2>" << endl;
+        
+        // The headings...///
+        fp << "<tr><th>Genome ";
+        for (int i = 0; i < num_insts; i++) {
+          fp << "<th>" << inst_set.GetName(i) << " ";
+        }
+        fp << "<th>Knockout ";
+        fp << "<th>Frac. Lethal ";
+        fp << "<th>Frac. Detremental ";
+        fp << "<th>Frac. Neutral ";
+        fp << "<th>Frac. Beneficial ";
+        fp << "<th>Ave. Fitness ";
+        fp << "<th>Expected Entropy ";
+        fp << "</tr>" << endl << endl;
       }
       
-      // Columns 2 to D+1 (the possible mutations)
-      for (int mod_inst = 0; mod_inst < num_insts; mod_inst++) 
-      {
-        if (mod_inst == cur_inst) {
-          if (file_type == FILE_TYPE_HTML) {
-            color_string = "#FFFFFF";
-            fp << "<th bgcolor=\"" << color_string << "\">";
-          }
+      
+      // Keep track of the number of mutations in each category...
+      int total_dead = 0, total_neg = 0, total_neut = 0, total_pos = 0;
+      double total_fitness = 0.0;
+      Apto::Array<double> col_fitness(num_insts + 1);
+      col_fitness.SetAll(0.0);
+      
+      cString color_string;  // For coloring cells...
+      
+      // Loop through all the lines of code, writing out all mutations...
+      for (int line_num = 0; line_num < max_line; line_num++) {
+        int cur_inst = base_seq[line_num].GetOp();
+        char cur_symbol = base_seq[line_num].GetSymbol()[0]; // hack to work around multichar symbols
+        int row_dead = 0, row_neg = 0, row_neut = 0, row_pos = 0;
+        double row_fitness = 0.0;
+        
+        // Column 1... the original instruction in the geneome.
+        if (file_type == FILE_TYPE_HTML) {
+          fp << "<tr><td align=right>" << inst_set.GetName(cur_inst)
+          << " (" << cur_symbol << ") ";
+        } else {
+          fp << cur_inst << " ";
         }
-        else {
-          seq[line_num].SetOp(mod_inst);
-          cAnalyzeGenotype test_genotype(m_world, mod_genome);
-          test_genotype.Recalculate(m_ctx);
-          const double test_fitness = test_genotype.GetFitness() / base_fitness;
-          row_fitness += test_fitness;
-          total_fitness += test_fitness;
-          col_fitness[mod_inst] += test_fitness;
-          
-          // Categorize this mutation...
-          if (test_fitness == 1.0) {           // Neutral Mutation...
-            row_neut++;
-            total_neut++;
-            if (file_type == FILE_TYPE_HTML) color_string = m_world->GetConfig().COLOR_MUT_NEUT.Get();
-          } else if (test_fitness == 0.0) {    // Lethal Mutation...
-            row_dead++;
-            total_dead++;
-            if (file_type == FILE_TYPE_HTML) color_string = m_world->GetConfig().COLOR_MUT_LETHAL.Get();
-          } else if (test_fitness < 1.0) {     // Detrimental Mutation...
-            row_neg++;
-            total_neg++;
-            if (file_type == FILE_TYPE_HTML) color_string = m_world->GetConfig().COLOR_MUT_NEG.Get();
-          } else {                             // Beneficial Mutation...
-            row_pos++;
-            total_pos++;
-            if (file_type == FILE_TYPE_HTML) color_string = m_world->GetConfig().COLOR_MUT_POS.Get();
+        
+        // Columns 2 to D+1 (the possible mutations)
+        for (int mod_inst = 0; mod_inst < num_insts; mod_inst++) 
+        {
+          if (mod_inst == cur_inst) {
+            if (file_type == FILE_TYPE_HTML) {
+              color_string = "#FFFFFF";
+              fp << "<th bgcolor=\"" << color_string << "\">";
+            }
           }
-          
-          // Write out this cell...
-          if (file_type == FILE_TYPE_HTML) {
-            fp << "<th bgcolor=\"" << color_string << "\">";
+          else {
+            const double test_fitness = job.GetFitness(line_num, mod_inst);
+            row_fitness += test_fitness;
+            total_fitness += test_fitness;
+            col_fitness[mod_inst] += test_fitness;
+            
+            // Categorize this mutation...
+            if (test_fitness == 1.0) {           // Neutral Mutation...
+              row_neut++;
+              total_neut++;
+              if (file_type == FILE_TYPE_HTML) color_string = m_world->GetConfig().COLOR_MUT_NEUT.Get();
+            } else if (test_fitness == 0.0) {    // Lethal Mutation...
+              row_dead++;
+              total_dead++;
+              if (file_type == FILE_TYPE_HTML) color_string = m_world->GetConfig().COLOR_MUT_LETHAL.Get();
+            } else if (test_fitness < 1.0) {     // Detrimental Mutation...
+              row_neg++;
+              total_neg++;
+              if (file_type == FILE_TYPE_HTML) color_string = m_world->GetConfig().COLOR_MUT_NEG.Get();
+            } else {                             // Beneficial Mutation...
+              row_pos++;
+              total_pos++;
+              if (file_type == FILE_TYPE_HTML) color_string = m_world->GetConfig().COLOR_MUT_POS.Get();
+            }
+            
+            // Write out this cell...
+            if (file_type == FILE_TYPE_HTML) {
+              fp << "<th bgcolor=\"" << color_string << "\">";
+            }
+            fp << test_fitness << " ";
           }
-          fp << test_fitness << " ";
         }
+        
+        // Column: Knockout
+        const double test_fitness = job.GetFitness(line_num, num_insts);
+        col_fitness[num_insts] += test_fitness;
+        
+        // Categorize this mutation if its in HTML mode (color only)...
+        if (file_type == FILE_TYPE_HTML) {
+          if (test_fitness == 1.0) color_string =  m_world->GetConfig().COLOR_MUT_NEUT.Get();
+          else if (test_fitness == 0.0) color_string = m_world->GetConfig().COLOR_MUT_LETHAL.Get();
+          else if (test_fitness < 1.0) color_string = m_world->GetConfig().COLOR_MUT_NEG.Get();
+          else color_string = m_world->GetConfig().COLOR_MUT_POS.Get();
+          
+          fp << "<th bgcolor=\"" << color_string << "\">";
+        }
+        
+        fp << test_fitness << " ";
+        
+        // Fraction Columns...
+        if (file_type == FILE_TYPE_HTML) fp << "<th bgcolor=\"#" << m_world->GetConfig().COLOR_MUT_LETHAL.Get() << "\">";
+        fp << (double) row_dead / (double) (num_insts-1) << " ";
+        
+        if (file_type == FILE_TYPE_HTML) fp << "<th bgcolor=\"#" << m_world->GetConfig().COLOR_MUT_NEG.Get() << "\">";
+        fp << (double) row_neg / (double) (num_insts-1) << " ";
+        
+        if (file_type == FILE_TYPE_HTML) fp << "<th bgcolor=\"#" << m_world->GetConfig().COLOR_MUT_NEUT.Get() << "\">";
+        fp << (double) row_neut / (double) (num_insts-1) << " ";
+        
+        if (file_type == FILE_TYPE_HTML) fp << "<th bgcolor=\"#" << m_world->GetConfig().COLOR_MUT_POS.Get() << "\">";
+        fp << (double) row_pos / (double) (num_insts-1) << " ";
+        
+        
+        // Column: Average Fitness
+        if (file_type == FILE_TYPE_HTML) fp << "<th>";
+        fp << row_fitness / (double) (num_insts-1) << " ";
+        
+        // Column: Expected Entropy  @CAO Implement!
+        if (file_type == FILE_TYPE_HTML) fp << "<th>";
+        fp << 0.0 << " ";
+        
+        // End this row...
+        if (file_type == FILE_TYPE_HTML) fp << "</tr>";
+        fp << endl;
       }
       
-      // Column: Knockout
-      seq[line_num] = null_inst;
-      cAnalyzeGenotype test_genotype(m_world, mod_genome);
-      test_genotype.Recalculate(m_ctx);
-      const double test_fitness = test_genotype.GetFitness() / base_fitness;
-      col_fitness[num_insts] += test_fitness;
       
-      // Categorize this mutation if its in HTML mode (color only)...
+      // Construct the final line of the table with all totals...
       if (file_type == FILE_TYPE_HTML) {
-        if (test_fitness == 1.0) color_string =  m_world->GetConfig().COLOR_MUT_NEUT.Get();
-        else if (test_fitness == 0.0) color_string = m_world->GetConfig().COLOR_MUT_LETHAL.Get();
-        else if (test_fitness < 1.0) color_string = m_world->GetConfig().COLOR_MUT_NEG.Get();
-        else color_string = m_world->GetConfig().COLOR_MUT_POS.Get();
+        fp << "<tr><th>Totals";
         
-        fp << "<th bgcolor=\"" << color_string << "\">";
-      }
-      
-      fp << test_fitness << " ";
-      
-      // Fraction Columns...
-      if (file_type == FILE_TYPE_HTML) fp << "<th bgcolor=\"#" << m_world->GetConfig().COLOR_MUT_LETHAL.Get() << "\">";
-      fp << (double) row_dead / (double) (num_insts-1) << " ";
-      
-      if (file_type == FILE_TYPE_HTML) fp << "<th bgcolor=\"#" << m_world->GetConfig().COLOR_MUT_NEG.Get() << "\">";
-      fp << (double) row_neg / (double) (num_insts-1) << " ";
-      
-      if (file_type == FILE_TYPE_HTML) fp << "<th bgcolor=\"#" << m_world->GetConfig().COLOR_MUT_NEUT.Get() << "\">";
-      fp << (double) row_neut / (double) (num_insts-1) << " ";
-      
-      if (file_type == FILE_TYPE_HTML) fp << "<th bgcolor=\"#" << m_world->GetConfig().COLOR_MUT_POS.Get() << "\">";
-      fp << (double) row_pos / (double) (num_insts-1) << " ";
-      
-      
-      // Column: Average Fitness
-      if (file_type == FILE_TYPE_HTML) fp << "<th>";
-      fp << row_fitness / (double) (num_insts-1) << " ";
-      
-      // Column: Expected Entropy  @CAO Implement!
-      if (file_type == FILE_TYPE_HTML) fp << "<th>";
-      fp << 0.0 << " ";
-      
-      // End this row...
-      if (file_type == FILE_TYPE_HTML) fp << "</tr>";
-      fp << endl;
-      
-      // Reset the mod_genome back to the original sequence.
-      seq[line_num].SetOp(cur_inst);
+        // Instructions + Knockout
+        for (int i = 0; i <= num_insts; i++) {
+          fp << "<th>" << col_fitness[i] / max_line << " ";
+        }
+        
+        int total_tests = max_line * (num_insts-1);
+        fp << "<th>" << (double) total_dead / (double) total_tests << " ";
+        fp << "<th>" << (double) total_neg / (double) total_tests << " ";
+        fp << "<th>" << (double) total_neut / (double) total_tests << " ";
+        fp << "<th>" << (double) total_pos / (double) total_tests << " ";
+        fp << "<th>" << total_fitness / (double) total_tests << " ";
+        fp << "<th>" << 0.0 << " ";
+        
+        
+        // And close everything up...
+        fp << "</table>" << endl
+          << "</center>" << endl;
+      }    
+      delete jobs[job_num];
     }
-    
-    
-    // Construct the final line of the table with all totals...
-    if (file_type == FILE_TYPE_HTML) {
-      fp << "<tr><th>Totals";
-      
-      // Instructions + Knockout
-      for (int i = 0; i <= num_insts; i++) {
-        fp << "<th>" << col_fitness[i] / max_line << " ";
-      }
-      
-      int total_tests = max_line * (num_insts-1);
-      fp << "<th>" << (double) total_dead / (double) total_tests << " ";
-      fp << "<th>" << (double) total_neg / (double) total_tests << " ";
-      fp << "<th>" << (double) total_neut / (double) total_tests << " ";
-      fp << "<th>" << (double) total_pos / (double) total_tests << " ";
-      fp << "<th>" << total_fitness / (double) total_tests << " ";
-      fp << "<th>" << 0.0 << " ";
-      
-      
-      // And close everything up...
-      fp << "</table>" << endl
-        << "</center>" << endl;
-    }    
   }
 }
 
@@ -8785,6 +8989,66 @@ void cAnalyze::AnalyzeMutationTraceback(cString cur_string)
   delete testcpu;
 }
 
+// Fitness of every single site substitution of a genotype, computed on the job queue for AnalyzeComplexity.
+class cComplexityJob
+{
+private:
+  cAnalyzeGenotype* m_genotype;
+  cCPUTestInfo m_test_info;
+  int m_num_insts;
+  Apto::Array<double> m_fitness;  // num_insts entries per site
+  
+public:
+  cComplexityJob(cAnalyzeGenotype* genotype, const cCPUTestInfo& test_info)
+    : m_genotype(genotype), m_test_info(test_info), m_num_insts(0) { ; }
+  
+  cAnalyzeGenotype* GetGenotype() const { return m_genotype; }
+  int GetNumInsts() const { return m_num_insts; }
+  double GetFitness(int line_num, int mod_inst) const { return m_fitness[line_num * m_num_insts + mod_inst]; }
+  
+  void Run(cAvidaContext& ctx);
+};
+
+
+void cComplexityJob::Run(cAvidaContext& ctx)
+{
+  cWorld* world = m_genotype->GetWorld();
+  
+  // Calculate the stats for the genotype we're working with ...
+  m_genotype->Recalculate(ctx, &m_test_info);
+  const int max_line = m_genotype->GetLength();
+  
+  const Genome& base_genome = m_genotype->GetGenome();
+  ConstInstructionSequencePtr base_seq_p;
+  ConstGeneticRepresentationPtr rep_p = base_genome.Representation();
+  base_seq_p.DynamicCastFrom(rep_p);
+  const InstructionSequence& base_seq = *base_seq_p;
+  
+  Genome mod_genome(base_genome);
+  InstructionSequencePtr mod_seq_p;
+  GeneticRepresentationPtr mod_rep_p = mod_genome.Representation();
+  mod_seq_p.DynamicCastFrom(mod_rep_p);
+  InstructionSequence& seq = *mod_seq_p;
+  
+  m_num_insts = world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).GetSize();
+  
+  // Test fitness of each mutant.
+  m_fitness.Resize(max_line * m_num_insts);
+  for (int line_num = 0; line_num < max_line; line_num++) {
+    const int cur_inst = base_seq[line_num].GetOp();
+    for (int mod_inst = 0; mod_inst < m_num_insts; mod_inst++) {
+      seq[line_num].SetOp(mod_inst);
+      cAnalyzeGenotype test_genotype(world, mod_genome);
+      test_genotype.Recalculate(ctx);
+      m_fitness[line_num * m_num_insts + mod_inst] = test_genotype.GetFitness();
+    }
+    
+    // Reset the mod_genome back to the original sequence.
+    seq[line_num].SetOp(cur_inst);
+  }
+}
+
+
 void cAnalyze::AnalyzeComplexity(cString cur_string)
 {
   cout << "Analyzing genome complexity..." << endl;
@@ -8829,9 +9093,6 @@ void cAnalyze::AnalyzeComplexity(cString cur_string)
   ///////////////////////////////////////////////////////
   // Loop through all of the genotypes in this batch...
   
-  tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
-  cAnalyzeGenotype * genotype = NULL;
-  
   cString lineage_filename;
   if (batch[cur_batch].IsLineage()) {
     lineage_filename.Set("%s%s.complexity.dat", static_cast<const char*>(directory), "lineage");
@@ -8841,132 +9102,134 @@ void cAnalyze::AnalyzeComplexity(cString cur_string)
   Avida::Output::FilePtr lineage_df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)lineage_filename);
   ofstream& lineage_fp = lineage_df->OFStream();
   
-  while ((genotype = batch_it.Next()) != NULL) {
-    if (m_world->GetVerbosity() >= VERBOSE_ON) {
-      cout << "  Analyzing complexity for " << genotype->GetName() << endl;
+  // The mutants of each genotype are tested on the job queue a window at a time, and each window is then written out in
+  // batch order.
+  const int window = BatchUtil_JobWindow();
+  tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
+  cAnalyzeGenotype* next_genotype = batch_it.Next();
+  while (next_genotype != NULL) {
+    Apto::Array<cComplexityJob*> jobs;
+    tAnalyzeJobBatch<cComplexityJob> jobbatch(m_jobqueue);
+    while (next_genotype != NULL && jobs.GetSize() < window) {
+      cCPUTestInfo test_info;
+      test_info.SetResourceOptions(useResources, m_resources, next_genotype->GetUpdateBorn(), m_resource_time_spent_offset);
+      cComplexityJob* job = new cComplexityJob(next_genotype, test_info);
+      jobs.Push(job);
+      jobbatch.AddJob(job, &cComplexityJob::Run);
+      
+      // Always grabs the first one
+      // Skip i-1 times, so that the next one queued is the ith one
+      // where i is the batchFrequency
+      next_genotype = batch_it.Next();
+      for (int count = 0; next_genotype != NULL && count < batchFrequency - 1; count++) {
+        if (m_world->GetVerbosity() >= VERBOSE_ON) {
+          cout << "Skipping: " << next_genotype->GetName() << endl;
+        }
+        next_genotype = batch_it.Next();
+      }
     }
+    jobbatch.RunBatch();
     
-    // Construct this filename...
-    cString filename;
-    filename.Set("%s%s.complexity.dat", static_cast<const char*>(directory), static_cast<const char*>(genotype->GetName()));
-    Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
-    
-    lineage_fp << genotype->GetID() << " ";
-    
-    int updateBorn = -1;
-    updateBorn = genotype->GetUpdateBorn();
-    cCPUTestInfo test_info;
-    test_info.SetResourceOptions(useResources, m_resources, updateBorn, m_resource_time_spent_offset);
-    
-    // Calculate the stats for the genotype we're working with ...
-    genotype->Recalculate(m_ctx, &test_info);
-    cout << genotype->GetFitness() << endl;
-    const int max_line = genotype->GetLength();
-
-    const Genome& base_genome = genotype->GetGenome();
-    ConstInstructionSequencePtr base_seq_p;
-    ConstGeneticRepresentationPtr rep_p = base_genome.Representation();
-    base_seq_p.DynamicCastFrom(rep_p);
-    const InstructionSequence& base_seq = *base_seq_p;
-    
-    Genome mod_genome(base_genome);
-    InstructionSequencePtr mod_seq_p;
-    GeneticRepresentationPtr mod_rep_p = mod_genome.Representation();
-    mod_seq_p.DynamicCastFrom(mod_rep_p);
-    InstructionSequence& seq = *mod_seq_p;
-    
-    const int num_insts = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).GetSize();
-    
-    // Loop through all the lines of code, testing all mutations...
-    Apto::Array<double> test_fitness(num_insts);
-    Apto::Array<double> prob(num_insts);
-    for (int line_num = 0; line_num < max_line; line_num++) {
-      int cur_inst = base_seq[line_num].GetOp();
+    for (int job_num = 0; job_num < jobs.GetSize(); job_num++) {
+      const cComplexityJob& job = *jobs[job_num];
+      cAnalyzeGenotype* genotype = job.GetGenotype();
+      if (m_world->GetVerbosity() >= VERBOSE_ON) {
+        cout << "  Analyzing complexity for " << genotype->GetName() << endl;
+      }
       
-      // Column 1 ... the original instruction in the genome.
-      fp << cur_inst << " ";
+      // Construct this filename...
+      cString filename;
+      filename.Set("%s%s.complexity.dat", static_cast<const char*>(directory), static_cast<const char*>(genotype->GetName()));
+      Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
+      ofstream& fp = df->OFStream();
       
-      // Test fitness of each mutant.
-      for (int mod_inst = 0; mod_inst < num_insts; mod_inst++) {
-        seq[line_num].SetOp(mod_inst);
-        cAnalyzeGenotype test_genotype(m_world, mod_genome);
-        test_genotype.Recalculate(m_ctx);
-        test_fitness[mod_inst] = test_genotype.GetFitness();
-      }
+      lineage_fp << genotype->GetID() << " ";
       
-      // Ajust fitness
-      double cur_inst_fitness = test_fitness[cur_inst];
-      for (int mod_inst = 0; mod_inst < num_insts; mod_inst++) {
-        if (test_fitness[mod_inst] > cur_inst_fitness)
-          test_fitness[mod_inst] = cur_inst_fitness;
-        test_fitness[mod_inst] = test_fitness[mod_inst] / cur_inst_fitness;
-      }
+      cout << genotype->GetFitness() << endl;
+      const int max_line = genotype->GetLength();
       
-      // Calculate probabilities at mut-sel balance
-      double w_bar = 1;
+      const Genome& base_genome = genotype->GetGenome();
+      ConstInstructionSequencePtr base_seq_p;
+      ConstGeneticRepresentationPtr rep_p = base_genome.Representation();
+      base_seq_p.DynamicCastFrom(rep_p);
+      const InstructionSequence& base_seq = *base_seq_p;
       
-      // Normalize fitness values, assert if they are all zero
-      double maxFitness = 0.0;
-      for(int i=0; i<num_insts; i++) {
-        if(test_fitness[i] > maxFitness) {
-          maxFitness = test_fitness[i];
-        }
-      }
+      const int num_insts = job.GetNumInsts();
       
-      if(maxFitness > 0) {
+      // Loop through all the lines of code, using the fitness of all mutations...
+      Apto::Array<double> test_fitness(num_insts);
+      Apto::Array<double> prob(num_insts);
+      for (int line_num = 0; line_num < max_line; line_num++) {
+        int cur_inst = base_seq[line_num].GetOp();
+        
+        // Column 1 ... the original instruction in the genome.
+        fp << cur_inst << " ";
+        
+        // Fitness of each mutant.
+        for (int mod_inst = 0; mod_inst < num_insts; mod_inst++) {
+          test_fitness[mod_inst] = job.GetFitness(line_num, mod_inst);
+        }
+        
+        // Ajust fitness
+        double cur_inst_fitness = test_fitness[cur_inst];
+        for (int mod_inst = 0; mod_inst < num_insts; mod_inst++) {
+          if (test_fitness[mod_inst] > cur_inst_fitness)
+            test_fitness[mod_inst] = cur_inst_fitness;
+          test_fitness[mod_inst] = test_fitness[mod_inst] / cur_inst_fitness;
+        }
+        
+        // Calculate probabilities at mut-sel balance
+        double w_bar = 1;
+        
+        // Normalize fitness values, assert if they are all zero
+        double maxFitness = 0.0;
         for(int i=0; i<num_insts; i++) {
-          test_fitness[i] /= maxFitness;
+          if(test_fitness[i] > maxFitness) {
+            maxFitness = test_fitness[i];
+          }
         }
-      } else {
-        fp << "All zero fitness, ERROR." << endl;
-        continue;
-      }
-      
-      while(1) {
-        double sum = 0.0;
+        
+        if(maxFitness > 0) {
+          for(int i=0; i<num_insts; i++) {
+            test_fitness[i] /= maxFitness;
+          }
+        } else {
+          fp << "All zero fitness, ERROR." << endl;
+          continue;
+        }
+        
+        while(1) {
+          double sum = 0.0;
+          for (int mod_inst = 0; mod_inst < num_insts; mod_inst ++) {
+            prob[mod_inst] = (mut_rate * w_bar) /
+            ((double)num_insts * (w_bar + test_fitness[mod_inst] * mut_rate - test_fitness[mod_inst]));
+            sum = sum + prob[mod_inst];
+          }
+          if ((sum-1.0)*(sum-1.0) <= 0.0001) 
+            break;
+          else
+            w_bar = w_bar - 0.000001;
+        }
+        // Write probability
         for (int mod_inst = 0; mod_inst < num_insts; mod_inst ++) {
-          prob[mod_inst] = (mut_rate * w_bar) /
-          ((double)num_insts * (w_bar + test_fitness[mod_inst] * mut_rate - test_fitness[mod_inst]));
-          sum = sum + prob[mod_inst];
+          fp << prob[mod_inst] << " ";
         }
-        if ((sum-1.0)*(sum-1.0) <= 0.0001) 
-          break;
-        else
-          w_bar = w_bar - 0.000001;
-      }
-      // Write probability
-      for (int mod_inst = 0; mod_inst < num_insts; mod_inst ++) {
-        fp << prob[mod_inst] << " ";
-      }
-      
-      // Calculate complexity
-      double entropy = 0;
-      for (int i = 0; i < num_insts; i ++) {
-        entropy += prob[i] * log((double) 1.0/prob[i]) / log ((double) num_insts);
+        
+        // Calculate complexity
+        double entropy = 0;
+        for (int i = 0; i < num_insts; i ++) {
+          entropy += prob[i] * log((double) 1.0/prob[i]) / log ((double) num_insts);
+        }
+        double complexity = 1 - entropy;
+        fp << complexity << endl;
+        
+        lineage_fp << complexity << " ";
       }
-      double complexity = 1 - entropy;
-      fp << complexity << endl;
       
-      lineage_fp << complexity << " ";
       
-      // Reset the mod_genome back to the original sequence.
-      seq[line_num].SetOp(cur_inst);
-    }
-    
-    
-    lineage_fp << endl;
-    
-    // Always grabs the first one
-    // Skip i-1 times, so that the beginning of the loop will grab the ith one
-    // where i is the batchFrequency
-    for(int count=0; genotype != NULL && count < batchFrequency - 1; count++) {
-      genotype = batch_it.Next();
-      if(genotype != NULL && m_world->GetVerbosity() >= VERBOSE_ON) {
-        cout << "Skipping: " << genotype->GetName() << endl;
-      }
+      lineage_fp << endl;
+      delete jobs[job_num];
     }
-    if(genotype == NULL) { break; }
   }
   
   delete testcpu;
@@ -10258,6 +10521,57 @@ void cAnalyze::BatchDuplicate(cString cur_string)
   batch[batch_to].SetAligned(false);
 }
 
+// Recalculates a single genotype on the job queue.  Each job takes its own copy of the test info, which the test CPU
+// writes its results into.
+class cRecalculateJob
+{
+private:
+  cAnalyzeGenotype* m_genotype;
+  const cCPUTestInfo& m_test_info;
+  int m_num_trials;
+  
+public:
+  cRecalculateJob(cAnalyzeGenotype* genotype, const cCPUTestInfo& test_info, int num_trials)
+    : m_genotype(genotype), m_test_info(test_info), m_num_trials(num_trials) { ; }
+  
+  void Run(cAvidaContext& ctx)
+  {
+    cCPUTestInfo test_info(m_test_info);
+    m_genotype->Recalculate(ctx, &test_info, NULL, m_num_trials);
+  }
+};
+
+
+void cAnalyze::BatchUtil_Recalculate(const cCPUTestInfo& test_info, int num_trials)
+{
+  tList<cAnalyzeGenotype>& genotypes = batch[cur_batch].List();
+  
+  // Run every genotype through the test CPUs in parallel, queued in batch order so each gets the same RNG seed
+  // regardless of which worker runs it...
+  Apto::Array<cRecalculateJob*> jobs(genotypes.GetSize());
+  tAnalyzeJobBatch<cRecalculateJob> jobbatch(m_jobqueue);
+  tListIterator<cAnalyzeGenotype> batch_it(genotypes);
+  for (int i = 0; batch_it.Next() != NULL; i++) {
+    jobs[i] = new cRecalculateJob(batch_it.Get(), test_info, num_trials);
+    jobbatch.AddJob(jobs[i], &cRecalculateJob::Run);
+  }
+  jobbatch.RunBatch();
+  for (int i = 0; i < jobs.GetSize(); i++) delete jobs[i];
+  
+  // ...then, in order, fill in the stats that depend on the parent having been recalculated (such as distance to
+  // parent) wherever the previous genotype is the parent of this one.
+  batch_it.Reset();
+  cAnalyzeGenotype* genotype = NULL;
+  cAnalyzeGenotype* last_genotype = NULL;
+  while ((genotype = batch_it.Next()) != NULL) {
+    if (last_genotype != NULL && genotype->GetParentID() == last_genotype->GetID()) {
+      genotype->CalcParentStats(last_genotype);
+    }
+    last_genotype = genotype;
+  }
+}
+
+
 void cAnalyze::BatchRecalculate(cString cur_string)
 {
   Apto::Array<int> manual_inputs;  // Used only if manual inputs are specified
@@ -10303,21 +10617,7 @@ void cAnalyze::BatchRecalculate(cString cur_string)
     cerr << "warning: " << msg << endl;
   }
   
-  tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
-  cAnalyzeGenotype * genotype = NULL;
-  cAnalyzeGenotype * last_genotype = NULL;
-  while ((genotype = batch_it.Next()) != NULL) {    
-    // If the previous genotype was the parent of this one, pass in a pointer
-    // to it for improved recalculate (such as distance to parent, etc.)
-    if (last_genotype != NULL && genotype->GetParentID() == last_genotype->GetID()) {
-      genotype->Recalculate(m_ctx, &test_info, last_genotype);
-    } else {
-      genotype->Recalculate(m_ctx, &test_info);
-    }
-    last_genotype = genotype;
-  }
-    
-  return;
+  BatchUtil_Recalculate(test_info);
 }
 
 
@@ -10396,21 +10696,7 @@ void cAnalyze::BatchRecalculateWithArgs(cString cur_string)
     cerr << "warning: " << msg << endl;
   }
   
-  tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
-  cAnalyzeGenotype * genotype = NULL;
-  cAnalyzeGenotype * last_genotype = NULL;
-  while ((genotype = batch_it.Next()) != NULL) {    
-    // If the previous genotype was the parent of this one, pass in a pointer
-    // to it for improved recalculate (such as distance to parent, etc.)
-    if (last_genotype != NULL && genotype->GetParentID() == last_genotype->GetID()) {
-      genotype->Recalculate(m_ctx, &test_info, last_genotype, num_trials);
-    } else {
-      genotype->Recalculate(m_ctx, &test_info, NULL, num_trials);
-    }
-    last_genotype = genotype;
-  }
-  
-  return;
+  BatchUtil_Recalculate(test_info, num_trials);
 }
 
 
@@ -11238,6 +11524,7 @@ void cAnalyze::SetupCommandDefLibrary()
   AddLibraryDef("PRINT_PHENOTYPES", &cAnalyze::CommandPrintPhenotypes);
   AddLibraryDef("PRINT_DIVERSITY", &cAnalyze::CommandPrintDiversity);
   AddLibraryDef("PRINT_DISTANCES", &cAnalyze::CommandPrintDistances);
+  AddLibraryDef("PRINT_DISTANCE_MATRIX", &cAnalyze::CommandPrintDistanceMatrix);
   AddLibraryDef("PRINT_TREE_STATS", &cAnalyze::CommandPrintTreeStats);
   AddLibraryDef("PRINT_CUMULATIVE_STEMMINESS", &cAnalyze::CommandPrintCumulativeStemminess);
   AddLibraryDef("PRINT_GAMMA", &cAnalyze::CommandPrintGamma);
@@ -186,6 +186,8 @@ private:
   
   // Batch management...
   int BatchUtil_GetMaxLength(int batch_id = -1);
+  void BatchUtil_Recalculate(const cCPUTestInfo& test_info, int num_trials = 1);
+  int BatchUtil_JobWindow() const { return 4 * (m_jobqueue.GetNumWorkers() + 1); }
   
   // Command helpers...
   void CommandDetail_Header(std::ostream& fp, int format_type,
@@ -242,6 +244,7 @@ private:
   void CommandPrintPhenotypes(cString cur_string);
   void CommandPrintDiversity(cString cur_string);
   void CommandPrintDistances(cString cur_String);
+  void CommandPrintDistanceMatrix(cString cur_string);
   void CommandPrintTreeStats(cString cur_string);
   void CommandPrintCumulativeStemminess(cString cur_string);
   void CommandPrintGamma(cString cur_string);
@@ -43,7 +43,8 @@ cAnalyzeJobQueue::cAnalyzeJobQueue(cWorld* world)
   const int max_workers = world->GetConfig().MAX_CONCURRENCY.Get();
   if (max_workers > 0 && max_workers < m_workers.GetSize()) m_workers.Resize(max_workers);
   
-  m_job_seed_rng = new Apto::RNG::AvidaRNG(world->GetRandom().GetInt(world->GetRandom().MaxSeed()));
+  m_max_seed = world->GetRandom().MaxSeed();
+  m_job_seed_base = world->GetRandom().GetInt(m_max_seed);
   
   if (m_workers.GetSize() > 1) {
     for (int i = 0; i < m_workers.GetSize(); i++) {
@@ -77,8 +78,6 @@ cAnalyzeJobQueue::~cAnalyzeJobQueue()
     m_workers[i]->Join();
     delete m_workers[i];
   }
-  
-  delete m_job_seed_rng;
 }
 
 inline void cAnalyzeJobQueue::queueJob(cAnalyzeJob* job)
@@ -137,7 +136,18 @@ void cAnalyzeJobQueue::singleThreadedJobExecution(cAnalyzeJob* job)
 {
   Apto::RNG::AvidaRNG rng(GetSeedForJob(job->GetID()));
   cAvidaContext ctx(&m_world->GetDriver(), rng);
+  ctx.SetAnalyzeMode();
   job->Run(ctx);
   delete job;
 }
 
+int cAnalyzeJobQueue::GetSeedForJob(int jobid) const
+{
+  // Scramble the job id into the base seed (splitmix64 finalizer) so that neighboring jobs get unrelated streams.  Zero
+  // is avoided, since it asks the RNG for a time based seed.
+  unsigned long long x = (unsigned long long)m_job_seed_base + (unsigned long long)(jobid + 1) * 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  x ^= (x >> 31);
+  return 1 + (int)(x % (unsigned long long)(m_max_seed - 1));
+}
@@ -47,7 +47,8 @@ private:
   cWorld* m_world;
   tList<cAnalyzeJob> m_queue;
   int m_last_jobid;
-  Apto::Random* m_job_seed_rng;
+  int m_job_seed_base;
+  int m_max_seed;
   Apto::Mutex m_mutex;
   Apto::ConditionVariable m_cond;
   Apto::ConditionVariable m_term_cond;
@@ -77,7 +78,12 @@ public:
   void Start();
   void Execute();
   
-  int GetSeedForJob(int jobid) { Apto::MutexAutoLock lock(m_mutex); return m_job_seed_rng->GetInt(m_job_seed_rng->MaxSeed()); }
+  // Jobs are numbered as they are added, so the seed depends only on the order in which jobs were queued and not on which
+  // worker happens to run them; batches queued in batch order therefore recalculate reproducibly at any concurrency.
+  int GetSeedForJob(int jobid) const;
+  
+  // Number of worker threads, zero when jobs are run as they are added
+  int GetNumWorkers() const { return m_workers.GetSize(); }
 };
 
 #endif
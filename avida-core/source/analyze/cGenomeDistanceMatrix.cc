@@ -0,0 +1,125 @@
+/*
+ *  cGenomeDistanceMatrix.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cGenomeDistanceMatrix.h"
+
+#include "tAnalyzeJobBatch.h"
+
+using namespace Avida;
+
+
+static inline void writeInt(std::ostream& out, int value)
+{
+  const unsigned int v = (unsigned int)value;
+  const char bytes[4] = { (char)(v & 0xff), (char)((v >> 8) & 0xff), (char)((v >> 16) & 0xff), (char)((v >> 24) & 0xff) };
+  out.write(bytes, 4);
+}
+
+
+cGenomeDistanceMatrix::cGenomeDistanceMatrix(eMetric metric, int max_distance)
+  : m_metric(metric), m_max_distance((metric == EDIT && max_distance >= 0) ? max_distance : -1)
+{
+}
+
+
+bool cGenomeDistanceMatrix::MetricFromName(const Apto::String& name, eMetric& metric)
+{
+  if (name == "edit" || name == "levenstein") metric = EDIT;
+  else if (name == "hamming") metric = HAMMING;
+  else if (name == "sliding") metric = SLIDING;
+  else return false;
+  return true;
+}
+
+
+int cGenomeDistanceMatrix::Distance(eMetric metric, int max_distance, const InstructionSequence& seq1,
+                                    const InstructionSequence& seq2)
+{
+  switch (metric) {
+    case HAMMING: return InstructionSequence::FindHammingDistance(seq1, seq2);
+    case SLIDING: return InstructionSequence::FindSlidingDistance(seq1, seq2);
+    case EDIT:
+    default:
+      if (max_distance >= 0) return InstructionSequence::FindBoundedEditDistance(seq1, seq2, max_distance);
+      return InstructionSequence::FindEditDistance(seq1, seq2);
+  }
+}
+
+
+void cGenomeDistanceMatrix::AddSequence(int id, const InstructionSequence& seq)
+{
+  m_ids.Push(id);
+  m_seqs.Push(&seq);
+}
+
+
+void cGenomeDistanceMatrix::calculateRow(int row)
+{
+  // Entries right of the diagonal, mirrored below it; no other row writes either half of them
+  const int size = m_seqs.GetSize();
+  m_distances[row * size + row] = 0;
+  for (int col = row + 1; col < size; col++) {
+    const int dist = Distance(m_metric, m_max_distance, *m_seqs[row], *m_seqs[col]);
+    m_distances[row * size + col] = dist;
+    m_distances[col * size + row] = dist;
+  }
+}
+
+
+void cGenomeDistanceMatrix::cRowPair::Calculate(cAvidaContext&)
+{
+  m_matrix->calculateRow(m_row1);
+  if (m_row2 != m_row1) m_matrix->calculateRow(m_row2);
+}
+
+
+bool cGenomeDistanceMatrix::Calculate(cAnalyzeJobQueue& queue)
+{
+  const int size = m_seqs.GetSize();
+  if (size > MAX_SIZE) return false;
+  m_distances.ResizeClear(size * size);
+
+  // Row i has size - i - 1 entries to compute, so pairing it with row size - i - 1 evens out the jobs
+  Apto::Array<cRowPair*> pairs;
+  tAnalyzeJobBatch<cRowPair> jobbatch(queue);
+  for (int row = 0; row < (size + 1) / 2; row++) {
+    cRowPair* pair = new cRowPair(this, row, size - row - 1);
+    pairs.Push(pair);
+    jobbatch.AddJob(pair, &cRowPair::Calculate);
+  }
+  jobbatch.RunBatch();
+
+  for (int i = 0; i < pairs.GetSize(); i++) delete pairs[i];
+  return true;
+}
+
+
+void cGenomeDistanceMatrix::Write(std::ostream& out) const
+{
+  const int size = m_seqs.GetSize();
+
+  out.write("AVDM", 4);
+  writeInt(out, 1);
+  writeInt(out, m_metric);
+  writeInt(out, m_max_distance);
+  writeInt(out, size);
+  for (int i = 0; i < size; i++) writeInt(out, m_ids[i]);
+  for (int i = 0; i < m_distances.GetSize(); i++) writeInt(out, m_distances[i]);
+}
@@ -0,0 +1,97 @@
+/*
+ *  cGenomeDistanceMatrix.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cGenomeDistanceMatrix_h
+#define cGenomeDistanceMatrix_h
+
+#include "apto/core.h"
+#include "avida/core/InstructionSequence.h"
+
+#include <iostream>
+
+class cAnalyzeJobQueue;
+class cAvidaContext;
+
+
+// cGenomeDistanceMatrix
+//
+// All pairwise distances among a set of instruction sequences, computed in parallel on an analyze job queue.  Each job
+// fills two rows of the (symmetric) matrix, one near the top and its partner near the bottom, so that jobs are of equal
+// size and never write the same entries.
+//
+// Write stores the matrix in a simple binary format, all integers 32-bit little-endian:
+//
+//   "AVDM", version (1), metric, max distance (-1 if unbounded), n, n ids, n * n distances (row-major)
+
+class cGenomeDistanceMatrix
+{
+public:
+  enum eMetric { EDIT = 0, HAMMING = 1, SLIDING = 2 };
+
+  // The full n * n matrix is held in one array, indexed by int
+  static const int MAX_SIZE = 46340;
+
+private:
+  class cRowPair
+  {
+  private:
+    cGenomeDistanceMatrix* m_matrix;
+    int m_row1;
+    int m_row2;
+
+  public:
+    cRowPair(cGenomeDistanceMatrix* matrix, int row1, int row2) : m_matrix(matrix), m_row1(row1), m_row2(row2) { ; }
+
+    void Calculate(cAvidaContext& ctx);
+  };
+
+  eMetric m_metric;
+  int m_max_distance;
+  Apto::Array<int> m_ids;
+  Apto::Array<const Avida::InstructionSequence*> m_seqs;  // Owned by the caller until Calculate returns
+  Apto::Array<int> m_distances;
+
+
+  void calculateRow(int row);
+
+  cGenomeDistanceMatrix(); // @not_implemented
+  cGenomeDistanceMatrix(const cGenomeDistanceMatrix&); // @not_implemented
+  cGenomeDistanceMatrix& operator=(const cGenomeDistanceMatrix&); // @not_implemented
+
+public:
+  // A max_distance of zero or more bounds edit distances (see InstructionSequence::FindBoundedEditDistance)
+  cGenomeDistanceMatrix(eMetric metric, int max_distance = -1);
+
+  static bool MetricFromName(const Apto::String& name, eMetric& metric);
+  static int Distance(eMetric metric, int max_distance, const Avida::InstructionSequence& seq1,
+                      const Avida::InstructionSequence& seq2);
+
+  void AddSequence(int id, const Avida::InstructionSequence& seq);
+  int GetSize() const { return m_seqs.GetSize(); }
+
+  // Returns false, calculating nothing, if more than MAX_SIZE sequences have been added
+  bool Calculate(cAnalyzeJobQueue& queue);
+
+  int GetDistance(int i, int j) const { return m_distances[i * m_seqs.GetSize() + j]; }
+
+  void Write(std::ostream& out) const;
+};
+
+#endif
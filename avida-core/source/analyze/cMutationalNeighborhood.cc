@@ -61,7 +61,7 @@ void cMutationalNeighborhood::Process(cAvidaContext& ctx)
 
     if (cur_site < m_base_genome_size) {
       // Create test infrastructure
-      cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+      cTestCPU* testcpu = m_world->GetHardwareManager().AcquireTestCPU(ctx);
       cCPUTestInfo test_info;
       
       // Setup One Step Data
@@ -147,7 +147,7 @@ void cMutationalNeighborhood::Process(cAvidaContext& ctx)
       }
 
       // Cleanup
-      delete testcpu;
+      m_world->GetHardwareManager().ReleaseTestCPU(testcpu);
     }
   } else {
     ProcessInitialize(ctx);
@@ -163,15 +163,15 @@ void cMutationalNeighborhood::Process(cAvidaContext& ctx)
 void cMutationalNeighborhood::ProcessInitialize(cAvidaContext& ctx)
 {
   // Generate base information
-  cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+  cTestCPU* testcpu = m_world->GetHardwareManager().AcquireTestCPU(ctx);
   cCPUTestInfo test_info;
-  testcpu->TestGenome(ctx, test_info, m_base_genome);
+  cGenomeTestCache::sResult result;
+  testcpu->TestGenomeCached(ctx, test_info, m_base_genome, result);
   
-  cPhenotype& phenotype = test_info.GetColonyOrganism()->GetPhenotype();
-  m_base_fitness = test_info.GetColonyFitness();
-  m_base_merit = phenotype.GetMerit().GetDouble();
-  m_base_gestation = phenotype.GetGestationTime();
-  m_base_tasks = phenotype.GetLastTaskCount();
+  m_base_fitness = result.colony_fitness;
+  m_base_merit = result.colony_merit;
+  m_base_gestation = result.colony_gestation_time;
+  m_base_tasks = result.colony_task_counts;
   
   m_neut_min = m_base_fitness * nHardware::FITNESS_NEUTRAL_MIN;
   m_neut_max = m_base_fitness * nHardware::FITNESS_NEUTRAL_MAX;
@@ -179,7 +179,7 @@ void cMutationalNeighborhood::ProcessInitialize(cAvidaContext& ctx)
   // If invalid target supplied, set to the last task
   if (m_target >= m_base_tasks.GetSize() || m_target < 0) m_target = m_base_tasks.GetSize() - 1;
   
-  delete testcpu;
+  m_world->GetHardwareManager().ReleaseTestCPU(testcpu);
 
   // Setup state to begin processing
   m_onestep_point.ResizeClear(m_base_genome_size);
@@ -294,10 +294,11 @@ double cMutationalNeighborhood::ProcessOneStepGenome(cAvidaContext& ctx, cTestCP
                                                      const Genome& mod_genome, sStep& odata, int cur_site)
 {
   // Run the modified genome through the Test CPU
-  testcpu->TestGenome(ctx, test_info, mod_genome);
+  cGenomeTestCache::sResult result;
+  testcpu->TestGenomeCached(ctx, test_info, mod_genome, result);
   
   // Collect the calculated fitness
-  double test_fitness = test_info.GetColonyFitness();
+  double test_fitness = result.colony_fitness;
   
   
   odata.total_fitness += test_fitness;
@@ -322,7 +323,7 @@ double cMutationalNeighborhood::ProcessOneStepGenome(cAvidaContext& ctx, cTestCP
   if (test_fitness >= m_neut_min) odata.site_count[cur_site]++;
   
   if (test_fitness != 0.0) { // Only count tasks if the organism is alive
-    const Apto::Array<int>& cur_tasks = test_info.GetColonyOrganism()->GetPhenotype().GetLastTaskCount();
+    const Apto::Array<int>& cur_tasks = result.colony_task_counts;
     bool knockout = false;
     bool anytask = false;
     for (int i = 0; i < m_base_tasks.GetSize(); i++) {
@@ -504,10 +505,11 @@ double cMutationalNeighborhood::ProcessTwoStepGenome(cAvidaContext& ctx, cTestCP
                                                      const sPendFit& cur, const sPendFit& oth)
 {
   // Run the modified genome through the Test CPU
-  testcpu->TestGenome(ctx, test_info, mod_genome);
+  cGenomeTestCache::sResult result;
+  testcpu->TestGenomeCached(ctx, test_info, mod_genome, result);
   
   // Collect the calculated fitness
-  double test_fitness = test_info.GetColonyFitness();
+  double test_fitness = result.colony_fitness;
   
   tdata.total_fitness += test_fitness;
   tdata.total_sqr_fitness += test_fitness * test_fitness;
@@ -531,7 +533,7 @@ double cMutationalNeighborhood::ProcessTwoStepGenome(cAvidaContext& ctx, cTestCP
   if (test_fitness >= m_neut_min) tdata.site_count[cur.site]++;
   
   if (test_fitness != 0.0) { // Only count tasks if the organism is alive
-    const Apto::Array<int>& cur_tasks = test_info.GetColonyOrganism()->GetPhenotype().GetLastTaskCount();
+    const Apto::Array<int>& cur_tasks = result.colony_task_counts;
     bool knockout = false;
     bool anytask = false;
     for (int i = 0; i < m_base_tasks.GetSize(); i++) {
@@ -26,6 +26,13 @@
 
 #include "AvidaTools.h"
 
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+# include <emmintrin.h>
+# define AVIDA_SSE2_DISTANCE 1
+#endif
+
 using namespace AvidaTools;
 
 
@@ -34,13 +41,86 @@ const double MEMORY_INCREASE_FACTOR = 1.5;
 const double MEMORY_SHRINK_TEST_FACTOR = 4.0;
 
 
+// Sequence Hash
+// --------------------------------------------------------------------------------------------------------------
+//
+// The hash of a sequence is the sum of siteValue(site i) * HASH_BASE^i (mod 2^64).  HASH_BASE is odd, so it has an
+// inverse mod 2^64 and sites can be shifted in either direction by scaling their part of the hash.
+
+static const unsigned long long HASH_BASE = 0x9e3779b97f4a7c15ULL;
+static const int HASH_POWER_TABLE_SIZE = 4096; // Twice the maximum genome length, covering a parent and its offspring
+
+static unsigned long long s_hash_powers[HASH_POWER_TABLE_SIZE];
+static unsigned long long s_hash_inverse_powers[HASH_POWER_TABLE_SIZE];
+static bool s_hash_tables_ready = false; // Zero initialized, so powers are computed directly until the tables are built
+
+static unsigned long long hashBaseInverse()
+{
+  // Newton's iteration doubles the number of correct low bits each step, starting from three (b * b = 1 mod 8)
+  unsigned long long inverse = HASH_BASE;
+  for (int i = 0; i < 5; i++) inverse *= 2 - HASH_BASE * inverse;
+  return inverse;
+}
+
+static unsigned long long hashPower(int exp, bool inverse)
+{
+  assert(exp >= 0);
+  if (s_hash_tables_ready && exp < HASH_POWER_TABLE_SIZE) return inverse ? s_hash_inverse_powers[exp] : s_hash_powers[exp];
+  
+  unsigned long long base = inverse ? hashBaseInverse() : HASH_BASE;
+  unsigned long long result = 1;
+  for (; exp; exp >>= 1) {
+    if (exp & 1) result *= base;
+    base *= base;
+  }
+  return result;
+}
+
+namespace {
+  class HashTableBuilder
+  {
+  public:
+    HashTableBuilder()
+    {
+      const unsigned long long inverse = hashBaseInverse();
+      s_hash_powers[0] = s_hash_inverse_powers[0] = 1;
+      for (int i = 1; i < HASH_POWER_TABLE_SIZE; i++) {
+        s_hash_powers[i] = s_hash_powers[i - 1] * HASH_BASE;
+        s_hash_inverse_powers[i] = s_hash_inverse_powers[i - 1] * inverse;
+      }
+      s_hash_tables_ready = true;
+    }
+  } s_hash_table_builder;
+}
+
+static inline unsigned long long siteValue(const Avida::Instruction& inst)
+{
+  unsigned long long h = (unsigned long long)inst.GetOp() + 0x9e3779b97f4a7c15ULL;
+  h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+  return h ^ (h >> 31);
+}
+
+
+void Avida::InstructionSequence::SiteArray::reallocate(int new_size, bool keep_sites)
+{
+  Apto::SmartPtr<Buffer, Apto::InternalRCObject> buf(new Buffer(new_size));
+  if (keep_sites) {
+    const int num_sites = (new_size < m_buf->size) ? new_size : m_buf->size;
+    for (int i = 0; i < num_sites; i++) buf->sites[i] = m_buf->sites[i];
+  }
+  m_buf = buf;
+}
+
+
 Avida::InstructionSequence::InstructionSequence(const InstructionSequence& seq)
-: GeneticRepresentation(seq), m_seq(seq.GetSize()), m_active_size(seq.GetSize())
+: GeneticRepresentation(seq), m_seq(seq.m_seq), m_active_size(seq.GetSize()), m_hash(seq.m_hash)
+, m_hash_valid(seq.m_hash_valid), m_revision(0), m_tail_start(seq.m_tail_start), m_tail_hash(seq.m_tail_hash)
 {
-  for (int i = 0; i < m_active_size; i++)  m_seq[i] = seq[i];
 }
 
 Avida::InstructionSequence::InstructionSequence(const Apto::String& str)
+  : m_hash(0), m_hash_valid(false), m_revision(0), m_tail_start(-1), m_tail_hash(0)
 {
   m_seq.ResizeClear(str.GetSize());
   int size = 0;
@@ -178,10 +258,12 @@ void Avida::InstructionSequence::prepareInsert(int pos, int num_sites)
   // Re-adjust the size...
   const int old_size = m_active_size;
   const int new_size = m_active_size + num_sites;
+  const unsigned long long shifted = hashTracked() ? rangeHash(pos, old_size) : 0;
   adjustCapacity(new_size);
   
-  // Shift any sites needed...
+  // Shift any sites needed, leaving the new ones for the caller to fill (and add to the hash)
   for (int i = old_size - 1; i >= pos; i--) m_seq[i + num_sites] = m_seq[i];
+  hashSitesInserted(pos, num_sites, shifted);
 }
 
 
@@ -189,10 +271,91 @@ void Avida::InstructionSequence::Copy(int to, int from)
 {
   assert(to   >= 0   && to   < m_active_size);
   assert(from >= 0   && from < m_active_size);
-  m_seq[to] = m_seq[from];
+  SetInst(to, m_seq[from]);
 }
  
 
+void Avida::InstructionSequence::computeHash() const
+{
+  m_hash = rangeHash(0, m_active_size);
+  m_hash_valid = true;
+}
+
+unsigned long long Avida::InstructionSequence::rangeHash(int begin, int end) const
+{
+  unsigned long long hash = 0;
+  unsigned long long power = hashPower(begin, false);
+  for (int i = begin; i < end; i++) {
+    hash += siteValue(m_seq[i]) * power;
+    power *= HASH_BASE;
+  }
+  return hash;
+}
+
+void Avida::InstructionSequence::replaceSiteHash(int idx, const Instruction& old_inst, const Instruction& new_inst)
+{
+  const unsigned long long delta = (siteValue(new_inst) - siteValue(old_inst)) * hashPower(idx, false);
+  if (m_hash_valid) m_hash += delta;
+  if (m_tail_start >= 0 && idx >= m_tail_start) m_tail_hash += delta;
+}
+
+void Avida::InstructionSequence::addSiteHash(int idx, const Instruction& inst)
+{
+  // Fills a site left open by prepareInsert
+  if (!hashTracked()) return;
+  const unsigned long long value = siteValue(inst) * hashPower(idx, false);
+  if (m_hash_valid) m_hash += value;
+  if (m_tail_start >= 0 && idx >= m_tail_start) m_tail_hash += value;
+}
+
+void Avida::InstructionSequence::hashSitesInserted(int pos, int num_sites, unsigned long long shifted)
+{
+  // The sites from pos on moved up by num_sites; the num_sites new ones are not counted until filled (see addSiteHash)
+  m_revision++;
+  const unsigned long long moved = shifted * hashPower(num_sites, false) - shifted;
+  if (m_hash_valid) m_hash += moved;
+  if (m_tail_start >= 0) {
+    if (pos <= m_tail_start) {
+      m_tail_start += num_sites;
+      m_tail_hash *= hashPower(num_sites, false);
+    } else {
+      m_tail_hash += moved;
+    }
+  }
+}
+
+void Avida::InstructionSequence::hashSitesRemoved(int pos, int num_sites, unsigned long long removed,
+                                                  unsigned long long shifted)
+{
+  // The sites [pos, pos + num_sites) are gone and the ones after them moved down by num_sites
+  m_revision++;
+  const unsigned long long moved = shifted * hashPower(num_sites, true) - shifted;
+  if (m_hash_valid) m_hash += moved - removed;
+  if (m_tail_start >= 0) {
+    if (pos + num_sites <= m_tail_start) {
+      m_tail_start -= num_sites;
+      m_tail_hash *= hashPower(num_sites, true);
+    } else if (pos >= m_tail_start) {
+      m_tail_hash += moved - removed;
+    } else {
+      m_tail_start = -1;
+    }
+    if (m_tail_start >= m_active_size) m_tail_start = -1;
+  }
+}
+
+void Avida::InstructionSequence::hashSitesAppended(int old_size)
+{
+  // Sites grown onto the end become the tail, so that cropping them back off (an offspring) needs no rehash
+  m_revision++;
+  if (m_active_size <= old_size) return;
+  const unsigned long long appended = rangeHash(old_size, m_active_size);
+  if (m_hash_valid) m_hash += appended;
+  m_tail_start = old_size;
+  m_tail_hash = appended;
+}
+
+
 // Return the sequence as an alphabetic string
 Apto::String Avida::InstructionSequence::AsString() const
 {
@@ -221,9 +384,12 @@ void Avida::InstructionSequence::Resize(int new_size)
   assert(new_size >= 0);
   
   const int old_size = m_active_size;
+  const unsigned long long removed = (new_size < old_size && hashTracked()) ? rangeHash(new_size, old_size) : 0;
   adjustCapacity(new_size);
   
   for (int i = old_size; i < new_size; i++) m_seq[i].SetOp(0);
+  if (new_size < old_size) hashSitesRemoved(new_size, old_size - new_size, removed, 0);
+  else hashSitesAppended(old_size);
 }
 
 void Avida::InstructionSequence::Insert(int pos, const Instruction& inst)
@@ -233,6 +399,7 @@ void Avida::InstructionSequence::Insert(int pos, const Instruction& inst)
   
   prepareInsert(pos, 1);
   m_seq[pos] = inst;
+  addSiteHash(pos, inst);
 }
 
 void Avida::InstructionSequence::Insert(int pos, const InstructionSequence& seq)
@@ -241,7 +408,10 @@ void Avida::InstructionSequence::Insert(int pos, const InstructionSequence& seq)
   assert(pos <= m_seq.GetSize());
   
   prepareInsert(pos, seq.GetSize());
-  for (int i = 0; i < seq.GetSize(); i++) m_seq[i + pos] = seq[i];
+  for (int i = 0; i < seq.GetSize(); i++) {
+    m_seq[i + pos] = seq[i];
+    addSiteHash(i + pos, seq[i]);
+  }
 }
 
 void Avida::InstructionSequence::Remove(int pos, int num_sites)
@@ -251,8 +421,14 @@ void Avida::InstructionSequence::Remove(int pos, int num_sites)
   assert(pos + num_sites <= m_active_size); // Cannot extend past end of sequence
   
   const int new_size = m_active_size - num_sites;
+  unsigned long long removed = 0, shifted = 0;
+  if (hashTracked()) {
+    removed = rangeHash(pos, pos + num_sites);
+    shifted = rangeHash(pos + num_sites, m_active_size);
+  }
   for (int i = pos; i < new_size; i++) m_seq[i] = m_seq[i + num_sites];
   adjustCapacity(new_size);
+  hashSitesRemoved(pos, num_sites, removed, shifted);
 }
 
 void Avida::InstructionSequence::Replace(int pos, int num_sites, const InstructionSequence& seq)
@@ -268,6 +444,7 @@ void Avida::InstructionSequence::Replace(int pos, int num_sites, const Instructi
   else if (size_change < 0) Remove(pos, -size_change);
   
   // Now just copy everything over!
+  sitesChanged();
   for (int i = 0; i < seq.GetSize(); i++) m_seq[i + pos] = seq[i];
 }
 
@@ -345,11 +522,14 @@ void Avida::InstructionSequence::Rotate(int n)
 
 void Avida::InstructionSequence::operator=(const InstructionSequence& other_seq)
 {
+  // Share the other sequence's sites, copying them only once either sequence is modified
   m_active_size = other_seq.m_active_size;
-  m_seq.ResizeClear(m_active_size);
-  
-  // Now that both code arrays are the same size, copy the other one over
-  for (int i = 0; i < m_active_size; i++) m_seq[i] = other_seq[i];
+  m_seq = other_seq.m_seq;
+  m_hash = other_seq.m_hash;
+  m_hash_valid = other_seq.m_hash_valid;
+  m_tail_start = other_seq.m_tail_start;
+  m_tail_hash = other_seq.m_tail_hash;
+  m_revision++;
 }
 
 
@@ -361,11 +541,15 @@ bool Avida::InstructionSequence::operator==(const GeneticRepresentation& other_s
   // Make sure the sizes are the same.
   if (m_active_size != seq->m_active_size) return false;
   
-  // Then go through line by line.
-  for (int i = 0; i < m_active_size; i++)
-    if (m_seq[i] != (*seq)[i]) return false;
+  // Copies that still share their sites are equal without looking at them
+  if (m_seq.IsSameBuffer(seq->m_seq)) return true;
   
-  return true;
+  // Sequences that have both been hashed can only match if their hashes do
+  if (m_hash_valid && seq->m_hash_valid && m_hash != seq->m_hash) return false;
+  
+  // Equal hashes do not prove the sites equal, so compare them; sites are single bytes, compared as one block
+  if (m_active_size == 0) return true;
+  return memcmp(&m_seq[0], &seq->m_seq[0], m_active_size * sizeof(Instruction)) == 0;
 }
 
 
@@ -436,7 +620,20 @@ Avida::InstructionSequence Avida::InstructionSequence::Crop(int start, int end)
   
   const int out_length = end - start;
   InstructionSequence out_seq(out_length);
-  for (int i = 0; i < out_length; i++) out_seq[i] = m_seq[i+start];
+  for (int i = 0; i < out_length; i++) out_seq.m_seq[i] = m_seq[i+start];
+  
+  // Shift the hash of the cropped sites down to position zero when that is cheaper than rehashing them, taking it
+  // from the tail when the crop lies within it (an offspring cropped from its parent's memory)
+  unsigned long long hash;
+  if (m_tail_start >= 0 && start >= m_tail_start && (start - m_tail_start) + (m_active_size - end) < out_length) {
+    hash = m_tail_hash - rangeHash(m_tail_start, start) - rangeHash(end, m_active_size);
+  } else if (m_hash_valid && start + (m_active_size - end) < out_length) {
+    hash = m_hash - rangeHash(0, start) - rangeHash(end, m_active_size);
+  } else {
+    return out_seq;
+  }
+  out_seq.m_hash = hash * hashPower(start, true);
+  out_seq.m_hash_valid = true;
   
   return out_seq;
 }
@@ -474,6 +671,137 @@ Avida::InstructionSequence Avida::InstructionSequence::Join(const InstructionSeq
 }
 
 
+// Genetic Distance Kernels
+// --------------------------------------------------------------------------------------------------------------
+
+static inline int countBits(unsigned long long v)
+{
+  v = v - ((v >> 1) & 0x5555555555555555ULL);
+  v = (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+  v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return (int)((v * 0x0101010101010101ULL) >> 56);
+}
+
+// Number of positions at which the two runs of sites differ.  Sites are single bytes, so they are compared sixteen (SSE2)
+// or eight (in a 64-bit word) at a time.
+static int countMismatches(const Avida::Instruction* sites1, const Avida::Instruction* sites2, int num_sites)
+{
+  if (sizeof(Avida::Instruction) != 1) {
+    int mismatches = 0;
+    for (int i = 0; i < num_sites; i++) if (sites1[i] != sites2[i]) mismatches++;
+    return mismatches;
+  }
+
+  const unsigned char* bytes1 = reinterpret_cast<const unsigned char*>(sites1);
+  const unsigned char* bytes2 = reinterpret_cast<const unsigned char*>(sites2);
+  int mismatches = 0;
+  int i = 0;
+
+#ifdef AVIDA_SSE2_DISTANCE
+  for (; i + 16 <= num_sites; i += 16) {
+    const __m128i block1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes1 + i));
+    const __m128i block2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes2 + i));
+    const unsigned int equal = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(block1, block2));
+    mismatches += 16 - countBits(equal);
+  }
+#endif
+
+  // A byte of the xor is non-zero exactly where the sites differ; fold each byte's bits down into its low bit
+  for (; i + 8 <= num_sites; i += 8) {
+    unsigned long long word1, word2;
+    memcpy(&word1, bytes1 + i, 8);
+    memcpy(&word2, bytes2 + i, 8);
+    unsigned long long diff = word1 ^ word2;
+    diff |= diff >> 4;
+    diff |= diff >> 2;
+    diff |= diff >> 1;
+    mismatches += countBits(diff & 0x0101010101010101ULL);
+  }
+
+  for (; i < num_sites; i++) if (bytes1[i] != bytes2[i]) mismatches++;
+
+  return mismatches;
+}
+
+
+// Levenshtein distance between the runs text[0..text_size) and pattern[0..pattern_size), both non-empty, using the
+// bit-parallel algorithm of Myers (1999) as extended to multiple words and global alignment by Hyyro (2003).  Each
+// column of the dynamic programming table is held as 64-row blocks of vertical deltas (+1 in pv, -1 in mv), so the
+// table is filled a word at a time rather than a cell at a time.
+static int myersEditDistance(const Avida::Instruction* pattern, int pattern_size, const Avida::Instruction* text, int text_size)
+{
+  typedef unsigned long long Word;
+  const int num_blocks = (pattern_size + 63) / 64;
+  const int last_bit = (pattern_size - 1) % 64;
+  const Word last_mask = (Word)1 << last_bit;
+
+  // Match masks per distinct pattern instruction; row 0 is left all zero for instructions absent from the pattern
+  int symbol_row[256];
+  for (int i = 0; i < 256; i++) symbol_row[i] = 0;
+  int num_rows = 1;
+  for (int i = 0; i < pattern_size; i++) {
+    const int op = pattern[i].GetOp();
+    if (!symbol_row[op]) symbol_row[op] = num_rows++;
+  }
+
+  // Genomes of up to a few thousand sites fit on the stack
+  const int STACK_WORDS = 1024;
+  Word stack_words[STACK_WORDS];
+  Apto::Array<Word> heap_words;
+  const int words_needed = (num_rows + 2) * num_blocks;
+  Word* peq = stack_words;
+  if (words_needed > STACK_WORDS) {
+    heap_words.Resize(words_needed);
+    peq = &heap_words[0];
+  }
+  Word* pv = peq + num_rows * num_blocks;
+  Word* mv = pv + num_blocks;
+
+  for (int i = 0; i < num_rows * num_blocks; i++) peq[i] = 0;
+  for (int i = 0; i < pattern_size; i++) peq[symbol_row[pattern[i].GetOp()] * num_blocks + i / 64] |= (Word)1 << (i % 64);
+  for (int b = 0; b < num_blocks; b++) {
+    pv[b] = ~(Word)0;
+    mv[b] = 0;
+  }
+
+  int score = pattern_size;
+  for (int j = 0; j < text_size; j++) {
+    const Word* eq_col = peq + symbol_row[text[j].GetOp()] * num_blocks;
+
+    // The top row of the table is 0, 1, 2, ...: every column enters the first block with a horizontal delta of +1
+    int hin = 1;
+    for (int b = 0; b < num_blocks; b++) {
+      Word eq = eq_col[b];
+      const Word pv_b = pv[b];
+      const Word mv_b = mv[b];
+      const Word hin_neg = (hin < 0) ? 1 : 0;
+
+      const Word xv = eq | mv_b;
+      eq |= hin_neg;
+      const Word xh = (((eq & pv_b) + pv_b) ^ pv_b) | eq;
+      Word ph = mv_b | ~(xh | pv_b);
+      Word mh = pv_b & xh;
+
+      // Horizontal delta leaving the block: at its last row, or at the last pattern row in the final block
+      const Word out_bit = (b == num_blocks - 1) ? last_mask : ((Word)1 << 63);
+      const int hout = (ph & out_bit) ? 1 : ((mh & out_bit) ? -1 : 0);
+
+      ph <<= 1;
+      mh <<= 1;
+      mh |= hin_neg;
+      if (hin > 0) ph |= 1;
+
+      pv[b] = mh | ~(xv | ph);
+      mv[b] = ph & xv;
+      hin = hout;
+    }
+    score += hin;
+  }
+
+  return score;
+}
+
+
 int Avida::InstructionSequence::FindOverlap(const InstructionSequence& seq1, const InstructionSequence& seq2, int offset)
 {
   assert(offset < seq1.GetSize());
@@ -495,10 +823,8 @@ int Avida::InstructionSequence::FindHammingDistance(const InstructionSequence& s
   
   int hamming_distance = seq1.GetSize() + seq2.GetSize() - 2 * overlap;
   
-  // Cycle through the overlap adding all differences to the distance.
-  for (int i = 0; i < overlap; i++) {
-    if (seq1[start1 + i] != seq2[start2 + i])  hamming_distance++;
-  }
+  // Add all differences within the overlap to the distance.
+  if (overlap > 0) hamming_distance += countMismatches(&seq1[start1], &seq2[start2], overlap);
   
   return hamming_distance;
 }
@@ -564,50 +890,92 @@ int Avida::InstructionSequence::FindEditDistance(const InstructionSequence& seq1
   
   if (test_size1 <= 0 || test_size2 <=0) return abs(test_size1 - test_size2);
   
-  // Now match everything else...
-  int* cur_row  = new int[test_size1];  // The row we are calculating
-  int* prev_row = new int[test_size1];  // The last row we calculated
+  // Now match everything else, a column of 64 sites at a time, using the shorter sequence for the columns.
+  if (test_size1 <= test_size2) {
+    return myersEditDistance(&seq1[match_front], test_size1, &seq2[match_front], test_size2);
+  }
+  return myersEditDistance(&seq2[match_front], test_size2, &seq1[match_front], test_size1);
+}
+
+
+int Avida::InstructionSequence::FindBoundedEditDistance(const InstructionSequence& seq1, const InstructionSequence& seq2,
+                                                        int max_distance)
+{
+  assert(max_distance >= 0);
+  
+  const int size1 = seq1.GetSize();
+  const int size2 = seq2.GetSize();
+  const int min_size = (size1 < size2) ? size1 : size2;
+  const int beyond = max_distance + 1;
   
-  // Initialize the previous row to record the differece from nothing.
-  for (int i = 0; i < test_size1; i++)  prev_row[i] = i + 1;
+  // The length difference alone may rule out the bound.
+  if (abs(size1 - size2) > max_distance) return beyond;
+  if (!min_size) return (size1 > size2) ? size1 : size2;
   
-  // Loop through each subsequent character in the test code
-  for (int i = 0; i < test_size2; i++) {
-    // Initialize the first entry in cur_row.
-    if (seq1[match_front] == seq2[match_front + i]) cur_row[0] = i;
-    else cur_row[0] = (i < prev_row[0]) ? (i+1) : (prev_row[0] + 1);
-    
-    // Move down the cur_row and fill it out.
-    for (int j = 1; j < test_size1; j++) {
-      // If the values are equal, keep the value in the upper left.
-      if (seq1[match_front + j] == seq2[match_front + i]) {
-        cur_row[j] = prev_row[j-1];
-      }
-      
-      // Otherwise, set the current position the the minimal of the three
-      // numbers above (insertion), to the left (deletion), or upper left
-      // (mutation) in the chart, plus one.
-      else {
-        cur_row[j] = (prev_row[j] < prev_row[j-1]) ? prev_row[j] : prev_row[j-1];
-        if (cur_row[j-1] < cur_row[j]) cur_row[j] = cur_row[j-1];
-        cur_row[j]++;
+  // Strip the matching ends, as in FindEditDistance.
+  int match_front = 0, match_end = 0;
+  while (match_front < min_size && seq1[match_front] == seq2[match_front]) match_front++;
+  while (match_end < min_size && seq1[size1 - match_end - 1] == seq2[size2 - match_end - 1]) match_end++;
+  
+  const int rows = size1 - match_front - match_end;
+  const int cols = size2 - match_front - match_end;
+  if (rows <= 0 || cols <= 0) return abs(rows - cols);
+  
+  // Any alignment within the bound stays within max_distance diagonals of the main one, so only that band of each row
+  // is computed (entry k of a row holds column row + k - max_distance).  Values are capped at beyond.
+  const int band = 2 * max_distance + 1;
+  
+  // An entry of the band costs about a quarter of what the bit-parallel algorithm spends on a 64-site word, so wide
+  // bounds are better served by computing the full distance.
+  const Instruction* sites1 = &seq1[match_front];
+  const Instruction* sites2 = &seq2[match_front];
+  if (band > 4 * ((Apto::Min(rows, cols) + 63) / 64)) {
+    const int distance = (rows <= cols) ? myersEditDistance(sites1, rows, sites2, cols) :
+                                          myersEditDistance(sites2, cols, sites1, rows);
+    return (distance > max_distance) ? beyond : distance;
+  }
+  
+  const int STACK_BAND = 256;
+  int stack_rows[2 * STACK_BAND];
+  Apto::Array<int> heap_rows;
+  int* prev_row = stack_rows;
+  if (band > STACK_BAND) {
+    heap_rows.Resize(2 * band);
+    prev_row = &heap_rows[0];
+  }
+  int* cur_row = prev_row + band;
+  
+  // Row 0 is the distance from nothing
+  for (int k = 0; k < band; k++) {
+    const int col = k - max_distance;
+    prev_row[k] = (col < 0) ? beyond : Apto::Min(col, beyond);
+  }
+  
+  for (int i = 1; i <= rows; i++) {
+    int row_min = beyond;
+    for (int k = 0; k < band; k++) {
+      const int col = i + k - max_distance;
+      int value = beyond;
+      if (col == 0) {
+        value = Apto::Min(i, beyond);
+      } else if (col > 0 && col <= cols) {
+        // Diagonal (same k in the previous row), above (k + 1 in the previous row) and left (k - 1 in this row)
+        value = prev_row[k] + ((sites1[i - 1] == sites2[col - 1]) ? 0 : 1);
+        if (k + 1 < band && prev_row[k + 1] + 1 < value) value = prev_row[k + 1] + 1;
+        if (k > 0 && cur_row[k - 1] + 1 < value) value = cur_row[k - 1] + 1;
+        if (value > beyond) value = beyond;
       }
+      cur_row[k] = value;
+      if (value < row_min) row_min = value;
     }
     
-    // Swap cur_row and prev_row. (we only really need to move the cur row
-    // over to prev, but this saves us from having to keep re-allocating
-    // new rows.  We recycle!
+    // Distances never decrease further down the table, so once a whole row is past the bound the answer is too.
+    if (row_min > max_distance) return beyond;
+    
     int* temp_row = cur_row;
     cur_row = prev_row;
     prev_row = temp_row;
   }
   
-  // Now that we are done, return the bottom-right corner of the chart.
-  
-  const int value = prev_row[test_size1 - 1];
-  
-  delete [] cur_row;
-  delete [] prev_row;
-  
-  return value;
+  return prev_row[cols - rows + max_distance];
 }
@@ -22,12 +22,28 @@
 
 #include "cCPUMemory.h"
 
+#include "cNopLabelIndex.h"
+
 using namespace std;
 using namespace Avida;
 
-cCPUMemory::cCPUMemory(const cCPUMemory& in_memory) : InstructionSequence(in_memory), m_flag_array(in_memory.GetSize())
+cCPUMemory::cCPUMemory(const cCPUMemory& in_memory)
+  : InstructionSequence(in_memory), m_flag_array(in_memory.m_flag_array), m_label_index(NULL)
+{
+}
+
+
+cCPUMemory::~cCPUMemory()
+{
+  delete m_label_index;
+}
+
+
+cNopLabelIndex& cCPUMemory::GetLabelIndex(const cInstSet& inst_set) const
 {
-  for (int i = 0; i < m_flag_array.GetSize(); i++) m_flag_array[i] = in_memory.m_flag_array[i];
+  if (!m_label_index) m_label_index = new cNopLabelIndex;
+  m_label_index->Update(*this, inst_set);
+  return *m_label_index;
 }
 
 
@@ -46,11 +62,13 @@ void cCPUMemory::prepareInsert(int pos, int num_sites)
   // Re-adjust the size...
   const int old_size = m_active_size;
   const int new_size = m_active_size + num_sites;
+  const unsigned long long shifted = hashTracked() ? rangeHash(pos, old_size) : 0;
   adjustCapacity(new_size);
   
-  // Shift any sites needed...
+  // Shift any sites needed, leaving the new ones for the caller to fill (and add to the hash)
   for (int i = old_size - 1; i >= pos; i--) m_seq[i + num_sites] = m_seq[i];
   for (int i = old_size - 1; i >= pos; i--) m_flag_array[i + num_sites] = m_flag_array[i];
+  hashSitesInserted(pos, num_sites, shifted);
 }
 
 
@@ -68,12 +86,15 @@ void cCPUMemory::Resize(int new_size)
   assert(new_size >= 0);
 
   const int old_size = m_active_size;
+  const unsigned long long removed = (new_size < old_size && hashTracked()) ? rangeHash(new_size, old_size) : 0;
   adjustCapacity(new_size);
   
   for (int i = old_size; i < new_size; i++) {
     m_seq[i].SetOp(0);
     m_flag_array[i] = 0;
   }
+  if (new_size < old_size) hashSitesRemoved(new_size, old_size - new_size, removed, 0);
+  else hashSitesAppended(old_size);
 }
 
 
@@ -82,9 +103,12 @@ void cCPUMemory::ResizeOld(int new_size)
   assert(new_size >= 0);
 
   const int old_size = m_active_size;
+  const unsigned long long removed = (new_size < old_size && hashTracked()) ? rangeHash(new_size, old_size) : 0;
   adjustCapacity(new_size);
 
   for (int i = old_size; i < new_size; i++) m_flag_array[i] = 0;
+  if (new_size < old_size) hashSitesRemoved(new_size, old_size - new_size, removed, 0);
+  else hashSitesAppended(old_size);
 }
 
 
@@ -95,7 +119,11 @@ void cCPUMemory::Copy(int to, int from)
   assert(from >= 0);
   assert(from < m_seq.GetSize());
   
-  m_seq[to] = m_seq[from];
+  if (to < m_active_size && from < m_active_size) SetInst(to, m_seq[from]);
+  else {
+    m_seq[to] = m_seq[from];
+    sitesChanged();
+  }
   m_flag_array[to] = m_flag_array[from];
 }
 
@@ -107,6 +135,7 @@ void cCPUMemory::Insert(int pos, const Instruction& inst)
 
   prepareInsert(pos, 1);
   m_seq[pos] = inst;
+  addSiteHash(pos, inst);
   m_flag_array[pos] = 0;
 }
 
@@ -118,6 +147,7 @@ void cCPUMemory::Insert(int pos, const InstructionSequence& genome)
   prepareInsert(pos, genome.GetSize());
   for (int i = 0; i < genome.GetSize(); i++) {
     m_seq[i + pos] = genome[i];
+    addSiteHash(i + pos, genome[i]);
     m_flag_array[i + pos] = 0;
   }
 }
@@ -129,11 +159,17 @@ void cCPUMemory::Remove(int pos, int num_sites)
   assert(pos + num_sites <= m_active_size); // Cannot extend past end of genome.
 
   const int new_size = m_active_size - num_sites;
+  unsigned long long removed = 0, shifted = 0;
+  if (hashTracked()) {
+    removed = rangeHash(pos, pos + num_sites);
+    shifted = rangeHash(pos + num_sites, m_active_size);
+  }
   for (int i = pos; i < new_size; i++) {
     m_seq[i] = m_seq[i + num_sites];
     m_flag_array[i] = m_flag_array[i + num_sites];
   }
   adjustCapacity(new_size);
+  hashSitesRemoved(pos, num_sites, removed, shifted);
 }
 
 void cCPUMemory::Replace(int pos, int num_sites, const InstructionSequence& genome)
@@ -149,6 +185,7 @@ void cCPUMemory::Replace(int pos, int num_sites, const InstructionSequence& geno
   else if (size_change < 0) Remove(pos, -size_change);
   
   // Now just copy everything over!
+  sitesChanged();
   for (int i = 0; i < genome.GetSize(); i++) {
     m_seq[i + pos] = genome[i];
     m_flag_array[i + pos] = 0;
@@ -158,24 +195,15 @@ void cCPUMemory::Replace(int pos, int num_sites, const InstructionSequence& geno
 
 void cCPUMemory::operator=(const cCPUMemory& other_memory)
 {
-  adjustCapacity(other_memory.m_active_size);
-  
-  // Fill in the new information...
-  for (int i = 0; i < m_active_size; i++) {
-    m_seq[i] = other_memory.m_seq[i];
-    m_flag_array[i] = other_memory.m_flag_array[i];
-  }
+  // The sites are shared until either memory is modified, the flags are always this memory's own
+  InstructionSequence::operator=(other_memory);
+  m_flag_array = other_memory.m_flag_array;
 }
 
 
 void cCPUMemory::operator=(const InstructionSequence& other_genome)
 {
-  adjustCapacity(other_genome.GetSize());
-  
-  // Fill in the new information...
-  for (int i = 0; i < m_active_size; i++) {
-    m_seq[i] = other_genome[i];
-    m_flag_array[i] = 0;
-  }
+  InstructionSequence::operator=(other_genome);
+  m_flag_array.ResizeClear(m_seq.GetSize());
+  ClearFlags();
 }
-
@@ -25,6 +25,9 @@
 
 #include "avida/core/InstructionSequence.h"
 
+class cInstSet;
+class cNopLabelIndex;
+
 
 class cCPUMemory : public Avida::InstructionSequence
 {
@@ -39,16 +42,19 @@ private:
 	static const unsigned char MASK_UNUSED2  = 0x80; // unused bit
   
   Apto::Array<unsigned char> m_flag_array;
+  mutable cNopLabelIndex* m_label_index;  // Built on the first label search
 
   void adjustCapacity(int new_size);
   void prepareInsert(int pos, int num_sites);
 
 public:
   cCPUMemory(const cCPUMemory& in_memory);
-  cCPUMemory(const InstructionSequence& in_genome) : InstructionSequence(in_genome), m_flag_array(in_genome.GetSize()) { ; }
-  explicit cCPUMemory(int size = 1)  : InstructionSequence(size), m_flag_array(size) { ClearFlags(); }
-  cCPUMemory(const Apto::String& in_string) : InstructionSequence(in_string), m_flag_array(in_string.GetSize()) { ; }
-  ~cCPUMemory() { ; }
+  cCPUMemory(const InstructionSequence& in_genome)
+    : InstructionSequence(in_genome), m_flag_array(m_seq.GetSize()), m_label_index(NULL) { ClearFlags(); }
+  explicit cCPUMemory(int size = 1)  : InstructionSequence(size), m_flag_array(size), m_label_index(NULL) { ClearFlags(); }
+  cCPUMemory(const Apto::String& in_string)
+    : InstructionSequence(in_string), m_flag_array(in_string.GetSize()), m_label_index(NULL) { ; }
+  ~cCPUMemory();
 
   inline bool FlagCopied(int pos) const     { return (MASK_COPIED   & m_flag_array[pos]) != 0; }
   inline bool FlagMutated(int pos) const    { return (MASK_MUTATED  & m_flag_array[pos]) != 0; }
@@ -74,6 +80,7 @@ public:
   
   void Clear()
 	{
+		sitesChanged();
 		for (int i = 0; i < m_active_size; i++) {
 			m_seq[i].SetOp(0);
 			m_flag_array[i] = 0;
@@ -91,6 +98,17 @@ public:
   void Remove(int pos, int num_sites = 1);
   void Replace(int pos, int num_sites, const InstructionSequence& genome);
 
+  // Save or restore all sites and their flags (see cStateBuffer)
+  template <class S> void TransferState(S& state)
+  {
+    m_seq.TransferState(state);
+    state & m_active_size & m_flag_array;
+    sitesChanged();
+  }
+
+  // Index of the labels in this memory as classified by inst_set, brought up to date with any modifications
+  cNopLabelIndex& GetLabelIndex(const cInstSet& inst_set) const;
+
   void operator=(const cCPUMemory& other_memory);
   void operator=(const InstructionSequence& other_genome);
 };
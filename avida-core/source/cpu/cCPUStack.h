@@ -51,6 +51,7 @@ public:
   inline int Top();
   void Flip();
 
+  template <class S> void TransferState(S& state) { state & stack & stack_pointer; }
   void SaveState(std::ostream& fp);
   void LoadState(std::istream & fp);
 };
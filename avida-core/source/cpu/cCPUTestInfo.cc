@@ -24,11 +24,13 @@
 
 #include "cCPUTestInfo.h"
 
+#include "cHardwareManager.h"
 #include "cHardwareTracer.h"
 #include "cInstSet.h"
 #include "cOrganism.h"
 #include "cPhenotype.h"
 #include "cResourceHistory.h"
+#include "cWorld.h"
 
 #include <cassert>
 
@@ -83,7 +85,7 @@ cCPUTestInfo& cCPUTestInfo::operator=(const cCPUTestInfo& test_info)
 cCPUTestInfo::~cCPUTestInfo()
 {
   for (int i = 0; i < generation_tests; i++) {
-    if (org_array[i] != NULL) delete org_array[i];
+    if (org_array[i] != NULL) releaseOrganism(org_array[i]);
   }
 }
 
@@ -98,12 +100,19 @@ void cCPUTestInfo::Clear()
 
   for (int i = 0; i < generation_tests; i++) {
     if (org_array[i] == NULL) break;
-    delete org_array[i];
+    releaseOrganism(org_array[i]);
     org_array[i] = NULL;
   }
 }
  
 
+// Test organisms go back to their world's pool, to be reset in place by the next test rather than freed
+void cCPUTestInfo::releaseOrganism(cOrganism* org)
+{
+  org->GetWorld()->GetHardwareManager().ReleaseTestOrganism(org);
+}
+
+
 double cCPUTestInfo::GetGenotypeFitness()
 {
   if (org_array[0] != NULL) return org_array[0]->GetPhenotype().GetFitness();
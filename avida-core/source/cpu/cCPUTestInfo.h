@@ -74,6 +74,8 @@ private:
   int m_res_update;
   int m_res_cpu_cycle_offset;
 
+  static void releaseOrganism(cOrganism* org);
+
 
 public:
   cCPUTestInfo(int max_tests=nHardware::TEST_CPU_GENERATIONS);
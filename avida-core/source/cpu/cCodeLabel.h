@@ -61,6 +61,8 @@ public:
   inline void Rotate(const int rot, const int base);
 
   inline int GetSize() const { return m_nops.GetSize(); }
+
+  template <class S> void TransferState(S& state) { state & m_nops; }
   
   inline cString AsString() const;
   
@@ -0,0 +1,132 @@
+/*
+ *  cGenomeTestCache.cc
+ *  Avida
+ *
+ *  Copyright 2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "cGenomeTestCache.h"
+
+#include "cCPUTestInfo.h"
+#include "cOrganism.h"
+#include "cPhenotype.h"
+
+
+void cGenomeTestCache::sResult::Set(cCPUTestInfo& test_info)
+{
+  is_viable = test_info.IsViable();
+  fitness = test_info.GetGenotypeFitness();
+  colony_fitness = test_info.GetColonyFitness();
+
+  cPhenotype& phenotype = test_info.GetTestPhenotype();
+  merit = phenotype.GetMerit().GetDouble();
+  copied_size = phenotype.GetCopiedSize();
+  executed_size = phenotype.GetExecutedSize();
+  gestation_time = phenotype.GetGestationTime();
+  task_counts = phenotype.GetLastTaskCount();
+
+  cPhenotype& colony_phenotype = test_info.GetColonyOrganism()->GetPhenotype();
+  colony_merit = colony_phenotype.GetMerit().GetDouble();
+  colony_gestation_time = colony_phenotype.GetGestationTime();
+  colony_task_counts = colony_phenotype.GetLastTaskCount();
+}
+
+
+cGenomeTestCache::cGenomeTestCache(int capacity)
+: m_capacity(capacity), m_head(-1), m_tail(-1), m_hits(0), m_misses(0), m_evictions(0)
+{
+}
+
+
+bool cGenomeTestCache::Lookup(const Apto::String& key, sResult& result)
+{
+  Apto::MutexAutoLock lock(m_mutex);
+
+  int entry = -1;
+  if (!m_index.Get(key, entry)) {
+    m_misses++;
+    return false;
+  }
+
+  m_hits++;
+  if (entry != m_head) {
+    unlink(entry);
+    pushFront(entry);
+  }
+  result = m_entries[entry].result;
+  return true;
+}
+
+
+void cGenomeTestCache::Insert(const Apto::String& key, const sResult& result)
+{
+  if (m_capacity <= 0) return;
+
+  Apto::MutexAutoLock lock(m_mutex);
+
+  // Another thread may have tested the same genome in the meantime
+  int entry = -1;
+  if (m_index.Get(key, entry)) return;
+
+  if (m_entries.GetSize() < m_capacity) {
+    entry = m_entries.GetSize();
+    m_entries.Resize(entry + 1);
+  } else {
+    entry = m_tail;
+    unlink(entry);
+    m_index.Remove(m_entries[entry].key);
+    m_evictions++;
+  }
+
+  m_entries[entry].key = key;
+  m_entries[entry].result = result;
+  pushFront(entry);
+  m_index.Set(key, entry);
+}
+
+
+void cGenomeTestCache::Clear()
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  m_entries.Resize(0);
+  m_index = Apto::Map<Apto::String, int>();
+  m_head = -1;
+  m_tail = -1;
+}
+
+
+void cGenomeTestCache::unlink(int entry)
+{
+  sEntry& e = m_entries[entry];
+  if (e.prev >= 0) m_entries[e.prev].next = e.next;
+  else m_head = e.next;
+  if (e.next >= 0) m_entries[e.next].prev = e.prev;
+  else m_tail = e.prev;
+  e.prev = -1;
+  e.next = -1;
+}
+
+
+void cGenomeTestCache::pushFront(int entry)
+{
+  sEntry& e = m_entries[entry];
+  e.prev = -1;
+  e.next = m_head;
+  if (m_head >= 0) m_entries[m_head].prev = entry;
+  m_head = entry;
+  if (m_tail < 0) m_tail = entry;
+}
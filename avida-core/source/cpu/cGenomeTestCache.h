@@ -0,0 +1,103 @@
+/*
+ *  cGenomeTestCache.h
+ *  Avida
+ *
+ *  Copyright 2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef cGenomeTestCache_h
+#define cGenomeTestCache_h
+
+#include "apto/core.h"
+#include "apto/core/Mutex.h"
+
+class cCPUTestInfo;
+
+
+// cGenomeTestCache
+//
+// Summary results of test CPU evaluations, shared by every cTestCPU of a world.  Entries are keyed by the full genome
+// (hardware type, instruction set and sequence) together with the test options and the state of the environment, see
+// cTestCPU::TestGenomeCached.  Capacity is bounded; once full, the least recently used entry is replaced.  All methods
+// may be called concurrently, e.g. from cAnalyzeJobWorker threads.
+
+class cGenomeTestCache
+{
+public:
+  struct sResult
+  {
+    bool is_viable;
+    double fitness;
+    double colony_fitness;
+    double merit;
+    double colony_merit;
+    int copied_size;
+    int executed_size;
+    int gestation_time;
+    int colony_gestation_time;
+    Apto::Array<int> task_counts;
+    Apto::Array<int> colony_task_counts;
+
+    sResult() : is_viable(false), fitness(0.0), colony_fitness(0.0), merit(0.0), colony_merit(0.0), copied_size(0),
+      executed_size(0), gestation_time(0), colony_gestation_time(0) { ; }
+
+    void Set(cCPUTestInfo& test_info);
+  };
+
+private:
+  struct sEntry
+  {
+    Apto::String key;
+    sResult result;
+    int prev;
+    int next;
+  };
+
+  mutable Apto::Mutex m_mutex;
+  int m_capacity;
+  Apto::Array<sEntry> m_entries;
+  Apto::Map<Apto::String, int> m_index;
+  int m_head;   // most recently used
+  int m_tail;   // least recently used
+  int m_hits;
+  int m_misses;
+  int m_evictions;
+
+  void unlink(int entry);
+  void pushFront(int entry);
+
+
+  cGenomeTestCache(); // @not_implemented
+  cGenomeTestCache(const cGenomeTestCache&); // @not_implemented
+  cGenomeTestCache& operator=(const cGenomeTestCache&); // @not_implemented
+
+public:
+  cGenomeTestCache(int capacity);
+  ~cGenomeTestCache() { ; }
+
+  bool Lookup(const Apto::String& key, sResult& result);
+  void Insert(const Apto::String& key, const sResult& result);
+  void Clear();
+
+  int GetCapacity() const { return m_capacity; }
+  int GetSize() const { Apto::MutexAutoLock lock(m_mutex); return m_entries.GetSize(); }
+  int GetHits() const { Apto::MutexAutoLock lock(m_mutex); return m_hits; }
+  int GetMisses() const { Apto::MutexAutoLock lock(m_mutex); return m_misses; }
+  int GetEvictions() const { Apto::MutexAutoLock lock(m_mutex); return m_evictions; }
+};
+
+#endif
@@ -32,6 +32,7 @@
 #include "cHardwareManager.h"
 #include "cHardwareTracer.h"
 #include "cInstSet.h"
+#include "cNopLabelIndex.h"
 #include "cOrganism.h"
 #include "cPhenotype.h"
 #include "cPopulation.h"
@@ -828,43 +829,25 @@ void cHardwareBCR::FindLabelStart(Head& head, Head& default_pos, bool mark_execu
     return;
   }
   
+  // First 'label' instruction directly followed by the nops of search_label, can be substring of 'label'ed target
+  // - extra NOPs in 'label'ed target are ignored
   cCPUMemory& memory = head.GetMemory();
-  int pos = 0;
+  const int label_start = memory.GetLabelIndex(*m_inst_set).FindFirstLabeled(search_label);
   
-  while (pos < memory.GetSize()) {
-    if (m_inst_set->IsLabel(memory[pos])) { // starting label found
-      pos++;
-      
-      // Check for direct matched label pattern, can be substring of 'label'ed target
-      // - must match all NOPs in search_label
-      // - extra NOPs in 'label'ed target are ignored
-      int size_matched = 0;
-      while (size_matched < search_label.GetSize() && pos < memory.GetSize()) {
-        if (!m_inst_set->IsNop(memory[pos]) || search_label[size_matched] != m_inst_set->GetNopMod(memory[pos])) break;
-        size_matched++;
-        pos++;
-      }
-      
-      // Check that the label matches and has examined the full sequence of nops following the 'label' instruction
-      if (size_matched == search_label.GetSize()) {
-        // Return Head pointed at last NOP of label sequence
-        if (mark_executed) {
-          size_matched++; // Increment size matched so that it includes the label instruction
-          const int start = pos - size_matched;
-          const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get() + 1; // Max label + 1 for the label instruction itself
-          for (int i = 0; i < size_matched && i < max; i++) memory.SetFlagExecuted(start + i);
-        }
-        head.SetPosition(pos - 1);
-        return;
-      }
-      
-      continue; 
-    }
-    pos++;
+  // Return start point if not found
+  if (label_start < 0) {
+    head.Set(default_pos);
+    return;
   }
   
-  // Return start point if not found
-  head.Set(default_pos);
+  if (mark_executed) {
+    const int size_matched = search_label.GetSize() + 1; // Includes the label instruction
+    const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get() + 1; // Max label + 1 for the label instruction itself
+    for (int i = 0; i < size_matched && i < max; i++) memory.SetFlagExecuted(label_start + i);
+  }
+  
+  // Return Head pointed at last NOP of label sequence
+  head.SetPosition(label_start + search_label.GetSize());
 }
 
 void cHardwareBCR::FindNopSequenceStart(Head& head, Head& default_pos, bool mark_executed)
@@ -925,47 +908,29 @@ void cHardwareBCR::FindLabelForward(Head& head, Head& default_pos, bool mark_exe
   
   head.Adjust();
   
-  Head pos(head);
-  pos++;
+  // Next 'label' instruction after the head, wrapping around the memory, that is directly followed by the nops of
+  // search_label (without reaching back to the head)
+  cCPUMemory& memory = head.GetMemory();
+  const int label_start = memory.GetLabelIndex(*m_inst_set).FindLabeledCircular(search_label, head.Position());
   
-  while (pos.Position() != head.Position()) {
-    if (m_inst_set->IsLabel(pos.GetInst())) { // starting label found
-      const int label_start = pos.Position();
-      pos++;
-      
-      // Check for direct matched label pattern, can be substring of 'label'ed target
-      // - must match all NOPs in search_label
-      // - extra NOPs in 'label'ed target are ignored
-      int size_matched = 0;
-      while (size_matched < search_label.GetSize() && pos.Position() != head.Position()) {
-        if (!m_inst_set->IsNop(pos.GetInst()) || search_label[size_matched] != m_inst_set->GetNopMod(pos.GetInst())) break;
-        size_matched++;
-        pos++;
-      }
-      
-      // Check that the label matches and has examined the full sequence of nops following the 'label' instruction
-      if (size_matched == search_label.GetSize()) {
-        pos--;
-        const int found_pos = pos.Position();
-        
-        if (mark_executed) {
-          pos.SetPosition(label_start);
-          const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get() + 1; // Max label + 1 for the label instruction itself
-          for (int i = 0; i < size_matched && i < max; i++, pos++) pos.SetFlagExecuted();
-        }
-        
-        // Return Head pointed at last NOP of label sequence
-        head.SetPosition(found_pos);
-        return;
-      }
-      
-      continue; 
-    }
-    pos++;
+  // Return start point if not found
+  if (label_start < 0) {
+    head.Set(default_pos);
+    return;
   }
   
-  // Return start point if not found
-  head.Set(default_pos);
+  const int found_pos = (label_start + search_label.GetSize()) % memory.GetSize();
+  
+  if (mark_executed) {
+    Head pos(head);
+    pos.SetPosition(label_start);
+    const int size_matched = search_label.GetSize();
+    const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get() + 1; // Max label + 1 for the label instruction itself
+    for (int i = 0; i < size_matched && i < max; i++, pos++) pos.SetFlagExecuted();
+  }
+  
+  // Return Head pointed at last NOP of label sequence
+  head.SetPosition(found_pos);
 }
 
 void cHardwareBCR::FindLabelBackward(Head& head, Head& default_pos, bool mark_executed)
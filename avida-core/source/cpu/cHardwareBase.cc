@@ -34,9 +34,11 @@
 #include "cHeadCPU.h"
 #include "cInstSet.h"
 #include "cOrganism.h"
+#include "cOrganismPool.h"
 #include "cPhenotype.h"
 #include "cPopulation.h"
 #include "cPopulationCell.h"
+#include "cStateBuffer.h"
 #include "cStats.h"
 #include "cTestCPU.h"
 #include "cWorld.h"
@@ -67,6 +69,21 @@ cHardwareBase::cHardwareBase(cWorld* world, cOrganism* in_organism, cInstSet* in
   assert(m_organism != NULL);
 }
 
+void* cHardwareBase::operator new(size_t size, cWorld* world)
+{
+  return world->GetOrganismPool().AllocateHardware(size);
+}
+
+void cHardwareBase::operator delete(void* ptr, cWorld*)
+{
+  cOrganismPool::Free(ptr);
+}
+
+void cHardwareBase::operator delete(void* ptr)
+{
+  cOrganismPool::Free(ptr);
+}
+
 
 void cHardwareBase::Reset(cAvidaContext& ctx)
 {
@@ -127,6 +144,14 @@ void cHardwareBase::ResizeCostArrays(int new_size)
   m_active_thread_post_costs.SetAll(0);
 }
 
+void cHardwareBase::transferBaseState(cStateBuffer& state)
+{
+  // Outstanding instruction costs and extended memory, everything else is derived from the configuration
+  state & m_inst_cost & m_female_cost & m_inst_ft_cost & m_inst_energy_cost & m_inst_res_cost & m_inst_fem_res_cost
+        & m_inst_bonus_cost & m_thread_inst_cost & m_thread_inst_post_cost & m_active_thread_costs
+        & m_active_thread_post_costs & m_task_switching_cost & m_ext_mem;
+}
+
 int cHardwareBase::calcExecutedSize(const int parent_size)
 {
   int executed_size = 0;
@@ -368,7 +393,7 @@ int cHardwareBase::Divide_DoMutations(cAvidaContext& ctx, double mut_multiplier,
   // Divide Mutations
   if (m_organism->TestDivideMut(ctx) && totalMutations < maxmut) {
     const unsigned int mut_line = ctx.GetRandom().GetUInt(offspring_genome.GetSize());
-    offspring_genome[mut_line] = m_inst_set->GetRandomInst(ctx);
+    offspring_genome.SetInst(mut_line, m_inst_set->GetRandomInst(ctx));
     totalMutations++;
   }
   
@@ -379,7 +404,7 @@ int cHardwareBase::Divide_DoMutations(cAvidaContext& ctx, double mut_multiplier,
   {
     if (totalMutations >= maxmut) break;
     const unsigned int mut_line = ctx.GetRandom().GetUInt(offspring_genome.GetSize());
-    offspring_genome[mut_line] = m_inst_set->GetRandomInst(ctx);
+    offspring_genome.SetInst(mut_line, m_inst_set->GetRandomInst(ctx));
     totalMutations++;
   }
   
@@ -438,7 +463,7 @@ int cHardwareBase::Divide_DoMutations(cAvidaContext& ctx, double mut_multiplier,
     if (num_mut > 0 && totalMutations < maxmut) {
       for (int i = 0; i < num_mut && totalMutations < maxmut; i++) {
         int site = ctx.GetRandom().GetUInt(offspring_genome.GetSize());
-        offspring_genome[site] = m_inst_set->GetRandomInst(ctx);
+        offspring_genome.SetInst(site, m_inst_set->GetRandomInst(ctx));
         totalMutations++;
       }
     }
@@ -514,7 +539,7 @@ int cHardwareBase::Divide_DoMutations(cAvidaContext& ctx, double mut_multiplier,
     if (num_mut > 0) {
       for (int i = 0; i < num_mut && totalMutations < maxmut; i++) {
         int site = ctx.GetRandom().GetUInt(memory.GetSize());
-        memory[site] = m_inst_set->GetRandomInst(ctx);
+        memory.SetInst(site, m_inst_set->GetRandomInst(ctx));
         totalMutations++;
       }
     }
@@ -576,7 +601,7 @@ bool cHardwareBase::doUniformMutation(cAvidaContext& ctx, InstructionSequence& g
   
   if (mut < m_inst_set->GetSize()) { // point
     int site = ctx.GetRandom().GetUInt(genome.GetSize());
-    genome[site] = Instruction(mut);
+    genome.SetInst(site, Instruction(mut));
   } else if (mut == m_inst_set->GetSize()) { // delete
     int min_genome_size = m_world->GetConfig().MIN_GENOME_SIZE.Get();
     if (!min_genome_size || min_genome_size < MIN_GENOME_LENGTH) min_genome_size = MIN_GENOME_LENGTH;
@@ -836,7 +861,7 @@ unsigned cHardwareBase::Divide_DoExactMutations(cAvidaContext& ctx, double mut_m
   // Divide Mutations
   if (totalMutations < maxmut) {
     const unsigned int mut_line = ctx.GetRandom().GetUInt(child_genome.GetSize());
-    child_genome[mut_line] = m_inst_set->GetRandomInst(ctx);
+    child_genome.SetInst(mut_line, m_inst_set->GetRandomInst(ctx));
     totalMutations++;
   }
   
@@ -847,7 +872,7 @@ unsigned cHardwareBase::Divide_DoExactMutations(cAvidaContext& ctx, double mut_m
     if (num_mut > 0 && totalMutations < maxmut) {
       for (int i = 0; i < num_mut && totalMutations < maxmut; i++) {
         int site = ctx.GetRandom().GetUInt(child_genome.GetSize());
-        child_genome[site] = m_inst_set->GetRandomInst(ctx);
+        child_genome.SetInst(site, m_inst_set->GetRandomInst(ctx));
         totalMutations++;
         cerr << "Resampling here " << totalMutations << endl;
       }
@@ -1086,84 +1111,86 @@ bool cHardwareBase::Divide_TestFitnessMeasures1(cAvidaContext& ctx)
 
 int cHardwareBase::PointMutate(cAvidaContext& ctx, double override_mut_rate)
 {
-  const int max_genome_size = m_world->GetConfig().MAX_GENOME_SIZE.Get();
-  const int min_genome_size = m_world->GetConfig().MIN_GENOME_SIZE.Get();
-  
   cCPUMemory& memory = GetMemory();
   int totalMutations = 0;
   
-//  const int num_muts = ctx.GetRandom().GetRandBinomial(memory.GetSize(), mut_rate);
-//  
-//  for (int i = 0; i < num_muts; i++) {
-//    const int pos = ctx.GetRandom().GetUInt(memory.GetSize());
-//    memory[pos] = m_inst_set->GetRandomInst(ctx);
-//    memory.SetFlagMutated(pos);
-//    memory.SetFlagPointMut(pos);
-//  }
-
-  
   // Point Substitution Mutations (per site)
   if (m_organism->GetPointMutProb() > 0.0 || override_mut_rate > 0.0) {
     double mut_rate = (override_mut_rate > 0.0) ? override_mut_rate : m_organism->GetPointMutProb();
-    int num_mut = ctx.GetRandom().GetRandBinomial(memory.GetSize(), mut_rate);
-    
-    // If we have lines to mutate...
-    if (num_mut > 0) {
-      for (int i = 0; i < num_mut; i++) {
-        int site = ctx.GetRandom().GetUInt(memory.GetSize());
-        memory[site] = m_inst_set->GetRandomInst(ctx);
-        totalMutations++;
-      }
-    }
+    totalMutations += PointSubstitute(ctx, ctx.GetRandom().GetRandBinomial(memory.GetSize(), mut_rate));
   }
   
   // Point Insert Mutations (per site)
   if (m_organism->GetPointInsProb() > 0.0) {
-    int num_mut = ctx.GetRandom().GetRandBinomial(memory.GetSize(), m_organism->GetPointInsProb());
-    
-    // If would make creature too big, insert up to max_genome_size
-    if (num_mut + memory.GetSize() > max_genome_size) {
-      num_mut = max_genome_size - memory.GetSize();
-    }
-    
-    // If we have lines to insert...
-    if (num_mut > 0) {
-      // Build a sorted list of the sites where mutations occured
-      Apto::Array<int> mut_sites(num_mut);
-      for (int i = 0; i < num_mut; i++) mut_sites[i] = ctx.GetRandom().GetUInt(memory.GetSize() + 1);
-      Apto::QSort(mut_sites);
-      
-      // Actually do the mutations (in reverse sort order)
-      for (int i = mut_sites.GetSize() - 1; i >= 0; i--) {
-        memory.Insert(mut_sites[i], m_inst_set->GetRandomInst(ctx));
-      }
-      
-      totalMutations += num_mut;
-    }
+    totalMutations += PointInsert(ctx, ctx.GetRandom().GetRandBinomial(memory.GetSize(), m_organism->GetPointInsProb()));
   }
   
-  
   // Point Deletion Mutations (per site)
   if (m_organism->GetPointDelProb() > 0) {
-    int num_mut = ctx.GetRandom().GetRandBinomial(memory.GetSize(), m_organism->GetPointDelProb());
-    
-    // If would make creature too small, delete down to min_genome_size
-    if (memory.GetSize() - num_mut < min_genome_size) {
-      num_mut = memory.GetSize() - min_genome_size;
-    }
-    
-    // If we have lines to delete...
-    for (int i = 0; i < num_mut; i++) {
-      int site = ctx.GetRandom().GetUInt(memory.GetSize());
-      memory.Remove(site);
-    }
-    
-    totalMutations += num_mut;
+    totalMutations += PointDelete(ctx, ctx.GetRandom().GetRandBinomial(memory.GetSize(), m_organism->GetPointDelProb()));
   }
   return totalMutations;
 }
 
 
+int cHardwareBase::PointSubstitute(cAvidaContext& ctx, int num_mut)
+{
+  cCPUMemory& memory = GetMemory();
+  
+  for (int i = 0; i < num_mut; i++) {
+    int site = ctx.GetRandom().GetUInt(memory.GetSize());
+    memory.SetInst(site, m_inst_set->GetRandomInst(ctx));
+  }
+  return (num_mut > 0) ? num_mut : 0;
+}
+
+
+int cHardwareBase::PointInsert(cAvidaContext& ctx, int num_mut)
+{
+  const int max_genome_size = m_world->GetConfig().MAX_GENOME_SIZE.Get();
+  cCPUMemory& memory = GetMemory();
+  
+  // If would make creature too big, insert up to max_genome_size
+  if (num_mut + memory.GetSize() > max_genome_size) {
+    num_mut = max_genome_size - memory.GetSize();
+  }
+  
+  // If we have lines to insert...
+  if (num_mut <= 0) return 0;
+  
+  // Build a sorted list of the sites where mutations occured
+  Apto::Array<int> mut_sites(num_mut);
+  for (int i = 0; i < num_mut; i++) mut_sites[i] = ctx.GetRandom().GetUInt(memory.GetSize() + 1);
+  Apto::QSort(mut_sites);
+  
+  // Actually do the mutations (in reverse sort order)
+  for (int i = mut_sites.GetSize() - 1; i >= 0; i--) {
+    memory.Insert(mut_sites[i], m_inst_set->GetRandomInst(ctx));
+  }
+  return num_mut;
+}
+
+
+int cHardwareBase::PointDelete(cAvidaContext& ctx, int num_mut)
+{
+  const int min_genome_size = m_world->GetConfig().MIN_GENOME_SIZE.Get();
+  cCPUMemory& memory = GetMemory();
+  
+  // If would make creature too small, delete down to min_genome_size
+  if (memory.GetSize() - num_mut < min_genome_size) {
+    num_mut = memory.GetSize() - min_genome_size;
+  }
+  
+  // If we have lines to delete...
+  if (num_mut <= 0) return 0;
+  for (int i = 0; i < num_mut; i++) {
+    int site = ctx.GetRandom().GetUInt(memory.GetSize());
+    memory.Remove(site);
+  }
+  return num_mut;
+}
+
+
 
 tBuffer<int>& cHardwareBase::GetInputBuf() 
 { 
@@ -41,6 +41,7 @@ class cCPUMemory;
 class cHeadCPU;
 class cMutation;
 class cOrganism;
+class cStateBuffer;
 class cString;
 class cWorld;
 
@@ -123,6 +124,11 @@ public:
   cHardwareBase(cWorld* world, cOrganism* in_organism, cInstSet* inst_set);
   virtual ~cHardwareBase() { ; }
   
+  // Hardware comes from the world's organism pool (cOrganismPool), so is created with new (world) cHardwareX(...)
+  static void* operator new(size_t size, cWorld* world);
+  static void operator delete(void* ptr, cWorld* world);
+  static void operator delete(void* ptr);
+  
   // interrupt types
   enum interruptTypes {MSG_INTERRUPT = 0, MOVE_INTERRUPT};
   
@@ -142,6 +148,7 @@ public:
   // --------  Helper methods  --------
   virtual int GetType() const = 0;
   virtual bool SupportsSpeculative() const = 0;
+  bool HasAnyCosts() const { return m_has_any_costs; }
   virtual void PrintStatus(std::ostream& fp) = 0;
   virtual void PrintMiniTraceStatus(cAvidaContext& ctx, std::ostream& fp) = 0;
   virtual void PrintMiniTraceSuccess(std::ostream& fp, const int exec_success) = 0;
@@ -217,6 +224,11 @@ public:
     
   // --------  Mutation  --------
   virtual int PointMutate(cAvidaContext& ctx, double override_mut_rate = 0.0);
+  // Apply the given number of point substitutions, insertions or deletions at uniformly chosen sites; insertions and
+  // deletions are limited by MAX_GENOME_SIZE and MIN_GENOME_SIZE.  Each returns the number actually applied.
+  int PointSubstitute(cAvidaContext& ctx, int num_mut);
+  int PointInsert(cAvidaContext& ctx, int num_mut);
+  int PointDelete(cAvidaContext& ctx, int num_mut);
 
   
   // --------  Input/Output Buffers  --------
@@ -226,6 +238,10 @@ public:
   
   // --------  State Transfer  --------
   virtual void InheritState(cHardwareBase&) { ; }
+
+  // Save or restore the complete execution state, for exact restart checkpoints.  Returns false if the hardware type
+  // does not support it, in which case populations using it cannot be checkpointed.
+  virtual bool TransferState(cStateBuffer&) { return false; }
   
   
   // --------  Alarm  --------
@@ -244,6 +260,7 @@ public:
   
 protected:
   void ResizeCostArrays(int new_size);
+  void transferBaseState(cStateBuffer& state);
 
   // --------  Core Execution Methods  --------
   bool SingleProcess_PayPreCosts(cAvidaContext& ctx, const Instruction& cur_inst, const int thread_id);
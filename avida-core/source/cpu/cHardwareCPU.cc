@@ -34,6 +34,7 @@
 #include "cHardwareManager.h"
 #include "cHardwareTracer.h"
 #include "cInstSet.h"
+#include "cNopLabelIndex.h"
 #include "cOrganism.h"
 #include "cOrgMessage.h"
 #include "cPhenotype.h"
@@ -43,6 +44,7 @@
 #include "cReactionLib.h"
 #include "cReactionProcess.h"
 #include "cResource.h"
+#include "cStateBuffer.h"
 #include "cStateGrid.h"
 #include "cStringUtil.h"
 #include "cTestCPU.h"
@@ -781,9 +783,13 @@ cHardwareCPU::cHardwareCPU(cAvidaContext& ctx, cWorld* world, cOrganism* in_orga
   
   m_promoters_enabled = m_world->GetConfig().PROMOTERS_ENABLED.Get();
   m_constitutive_regulation = m_world->GetConfig().CONSTITUTIVE_REGULATION.Get();
+  m_no_promoter_halts = (m_world->GetConfig().NO_ACTIVE_PROMOTER_EFFECT.Get() == 2);
   
   m_slip_read_head = !m_world->GetConfig().SLIP_COPY_MODE.Get();
   
+  m_task_switch_penalty_enabled = (m_world->GetConfig().TASK_SWITCH_PENALTY_TYPE.Get() != 0);
+  m_task_switch_penalty = m_world->GetConfig().TASK_SWITCH_PENALTY.Get();
+  
   // Initialize memory...
   const Genome& in_genome = in_organism->GetGenome();
   ConstInstructionSequencePtr in_seq_p;
@@ -842,9 +848,10 @@ void cHardwareCPU::internalReset()
     m_promoter_index = -1; // Meaning the last promoter was nothing
     m_promoter_offset = 0;
     m_promoters.Resize(0);
-    for (int i=0; i< m_memory.GetSize(); i++)
+    const cCPUMemory& memory = m_memory;  // read only, leaves the sites shared with the genome
+    for (int i=0; i< memory.GetSize(); i++)
     {
-      if (m_memory[i] == promoter_inst)
+      if (memory[i] == promoter_inst)
       {
         int code = Numberate(i-1, -1, m_world->GetConfig().PROMOTER_CODE_SIZE.Get());
         m_promoters.Push( cPromoter(i,code) );
@@ -899,6 +906,49 @@ void cHardwareCPU::cLocalThread::Reset(cHardwareBase* in_hardware, int in_id)
     
 }
 
+void cHardwareCPU::cLocalThread::TransferState(cStateBuffer& state)
+{
+  state & m_id & m_promoter_inst_executed & m_messageTriggerType & reg;
+  for (int i = 0; i < NUM_HEADS; i++) heads[i].TransferState(state);
+  stack.TransferState(state);
+  state & cur_stack & cur_head;
+  read_label.TransferState(state);
+  next_label.TransferState(state);
+}
+
+
+bool cHardwareCPU::TransferState(cStateBuffer& state)
+{
+  transferBaseState(state);
+  m_memory.TransferState(state);
+  m_global_stack.TransferState(state);
+
+  int num_threads = m_threads.GetSize();
+  state & num_threads;
+  if (state.IsLoading()) {
+    if (!state.IsOK() || num_threads < 1) return false;
+    m_threads.Resize(num_threads);
+    for (int i = 0; i < num_threads; i++) m_threads[i].Reset(this, i);
+  }
+  for (int i = 0; i < num_threads; i++) m_threads[i].TransferState(state);
+  state & m_thread_id_chart & m_cur_thread;
+
+  // Execution flags are bit-fields, transfer them through locals
+  bool flags[4] = { m_mal_active, m_advance_ip, m_executedmatchstrings, m_spec_die };
+  state & flags;
+  m_mal_active = flags[0];
+  m_advance_ip = flags[1];
+  m_executedmatchstrings = flags[2];
+  m_spec_die = flags[3];
+
+  state & m_promoter_index & m_promoter_offset & m_promoters;
+  state & m_epigenetic_state & m_epigenetic_saved_reg;
+  m_epigenetic_saved_stack.TransferState(state);
+  state & m_last_cell_data & m_flash_info & m_cycle_counter;
+
+  return state.IsOK();
+}
+
 void cHardwareCPU::SetupMiniTraceFileHeader(Avida::Output::File& df, const int gen_id, const Apto::String& genotype) { (void)df, (void)gen_id, (void)genotype; }
 
 
@@ -927,7 +977,7 @@ bool cHardwareCPU::SingleProcess(cAvidaContext& ctx, bool speculative)
   
   // Count the cpu cycles used
   phenotype.IncCPUCyclesUsed();
-  if (!m_world->GetConfig().NO_CPU_CYCLE_TIME.Get()) phenotype.IncTimeUsed();
+  if (!m_no_cpu_cycle_time) phenotype.IncTimeUsed();
   
   int num_threads = m_threads.GetSize();
   
@@ -955,10 +1005,11 @@ bool cHardwareCPU::SingleProcess(cAvidaContext& ctx, bool speculative)
     // Print the status of this CPU at each step...
     if (m_tracer) m_tracer->TraceHardware(ctx, *this);
     
-    // Find the instruction to be executed
+    // Find the instruction to be executed, along with everything the instruction set knows about it
     const Instruction cur_inst = ip.GetInst();
+    const cInstSet::sInstEntry& entry = m_inst_set->GetInstEntry(cur_inst);
     
-    if (speculative && (m_spec_die || m_inst_set->ShouldStall(cur_inst))) {
+    if (speculative && (m_spec_die || entry.should_stall)) {
       // Speculative instruction reject, flush and return
       m_cur_thread = last_thread;
       phenotype.DecCPUCyclesUsed();
@@ -975,18 +1026,18 @@ bool cHardwareCPU::SingleProcess(cAvidaContext& ctx, bool speculative)
     if (m_constitutive_regulation) Inst_SenseRegulate(ctx); 
     
     // If there are no active promoters and a certain mode is set, then don't execute any further instructions
-    if (m_promoters_enabled && m_world->GetConfig().NO_ACTIVE_PROMOTER_EFFECT.Get() == 2 && m_promoter_index == -1) exec = false;
+    if (m_promoters_enabled && m_no_promoter_halts && m_promoter_index == -1) exec = false;
     
     // Now execute the instruction...
     if (exec == true) {
       // NOTE: This call based on the cur_inst must occur prior to instruction
       //       execution, because this instruction reference may be invalid after
       //       certain classes of instructions (namely divide instructions) @DMB
-      const int time_cost = m_inst_set->GetAddlTimeCost(cur_inst);
+      const int time_cost = entry.addl_time_cost;
       
       // Prob of exec (moved from SingleProcess_PayCosts so that we advance IP after a fail)
-      if (m_inst_set->GetProbFail(cur_inst) > 0.0) {
-        exec = !( ctx.GetRandom().P(m_inst_set->GetProbFail(cur_inst)) );
+      if (entry.prob_fail > 0.0) {
+        exec = !( ctx.GetRandom().P(entry.prob_fail) );
       }
       
       // Flag instruction as executed even if it failed (moved from SingleProcess_ExecuteInst)
@@ -999,7 +1050,7 @@ bool cHardwareCPU::SingleProcess(cAvidaContext& ctx, bool speculative)
       if (m_promoters_enabled) m_threads[m_cur_thread].IncPromoterInstExecuted();
       
       if (exec == true) {
-        if (SingleProcess_ExecuteInst(ctx, cur_inst)) { 
+        if (executeInst(ctx, cur_inst, entry)) { 
           SingleProcess_PayPostResCosts(ctx, cur_inst); 
           SingleProcess_SetPostCPUCosts(ctx, cur_inst, m_cur_thread); 
         }
@@ -1061,33 +1112,37 @@ bool cHardwareCPU::SingleProcess(cAvidaContext& ctx, bool speculative)
 // within a single process, once that function has been finalized.
 bool cHardwareCPU::SingleProcess_ExecuteInst(cAvidaContext& ctx, const Instruction& cur_inst) 
 {
-  // Copy Instruction locally to handle stochastic effects
-  Instruction actual_inst = cur_inst;
-  
-  // Get a pointer to the corresponding method...
-  int inst_idx = m_inst_set->GetLibFunctionIndex(actual_inst);
+  return executeInst(ctx, cur_inst, m_inst_set->GetInstEntry(cur_inst));
+}
+
+// Dispatches on an instruction entry that has already been looked up by the caller
+inline bool cHardwareCPU::executeInst(cAvidaContext& ctx, const Instruction& cur_inst, const cInstSet::sInstEntry& entry)
+{
+  // Keep the op locally, cur_inst may refer to memory that the instruction modifies
+  const int op = cur_inst.GetOp();
+  cPhenotype& phenotype = m_organism->GetPhenotype();
   
   // instruction execution count incremented
-  m_organism->GetPhenotype().IncCurInstCount(actual_inst.GetOp());
+  phenotype.IncCurInstCount(op);
 	
   // And execute it.
-  const bool exec_success = (this->*(m_functions[inst_idx]))(ctx);
+  const bool exec_success = (this->*(m_functions[entry.lib_fun_id]))(ctx);
   
   // NOTE: Organism may be dead now if instruction executed killed it (such as some divides, "die", or "explode")
   
   // Add in a cycle cost for switching which task is performed
-  if (m_world->GetConfig().TASK_SWITCH_PENALTY_TYPE.Get()) {
-    if (m_organism->GetPhenotype().GetNumNewUniqueReactions()) {
-      int cost = m_organism->GetPhenotype().GetNumNewUniqueReactions() * m_world->GetConfig().TASK_SWITCH_PENALTY.Get();
+  if (m_task_switch_penalty_enabled) {
+    if (phenotype.GetNumNewUniqueReactions()) {
+      int cost = phenotype.GetNumNewUniqueReactions() * m_task_switch_penalty;
       IncrementTaskSwitchingCost(cost);
 			
-      m_organism->GetPhenotype().ResetNumNewUniqueReactions();
+      phenotype.ResetNumNewUniqueReactions();
     }
   }
 	
   // Decrement if the instruction was not executed successfully.
   if (exec_success == false) {
-    m_organism->GetPhenotype().DecCurInstCount(actual_inst.GetOp());
+    phenotype.DecCurInstCount(op);
   }
   
   return exec_success;
@@ -1221,6 +1276,18 @@ int cHardwareCPU::FindLabel_Forward(const cCodeLabel & search_label,
 {
   assert (pos < search_genome.GetSize() && pos >= 0);
   
+  if (&search_genome == &m_memory) {
+    // The scan below finds the first occurrence starting at or after pos, except that one starting exactly at pos is
+    // only seen when the run of nops it is in carries on past it.
+    cNopLabelIndex& index = m_memory.GetLabelIndex(*m_inst_set);
+    const int label_size = search_label.GetSize();
+    int found = index.FindNext(search_label, pos);
+    if (found == pos && (found + label_size >= index.GetSize() || !index.IsNop(found + label_size))) {
+      found = index.FindNext(search_label, pos + 1);
+    }
+    return (found >= 0) ? found + label_size : -1;
+  }
+  
   int search_start = pos;
   int label_size = search_label.GetSize();
   bool found_label = false;
@@ -1303,6 +1370,15 @@ int cHardwareCPU::FindLabel_Backward(const cCodeLabel & search_label,
 {
   assert (pos < search_genome.GetSize());
   
+  if (&search_genome == &m_memory) {
+    // The scan below finds the last run of nops (cut off at pos) holding an occurrence, and returns where it ends
+    cNopLabelIndex& index = m_memory.GetLabelIndex(*m_inst_set);
+    const int found = index.FindPrevious(search_label, pos - search_label.GetSize());
+    if (found < 0) return -1;
+    const int run_end = index.GetRunEnd(found);
+    return (run_end < pos) ? run_end : pos;
+  }
+  
   int search_start = pos;
   int label_size = search_label.GetSize();
   bool found_label = false;
@@ -1372,40 +1448,17 @@ int cHardwareCPU::FindLabel_Backward(const cCodeLabel & search_label,
   return pos;
 }
 
-// Search for 'in_label' anywhere in the hardware.
+// Search for 'in_label' anywhere in the hardware: the first occurrence in memory when direction is positive, the last
+// otherwise.  The returned head points at the last nop of the label, or is outside of memory if it was not found.
 cHeadCPU cHardwareCPU::FindLabel(const cCodeLabel & in_label, int direction)
 {
   assert (in_label.GetSize() > 0);
   
-  // IDEALY:
-  // Keep making jumps (in the proper direction) equal to the label
-  // length.  If we are inside of a label, check its size, and see if
-  // any of the sub-labels match properly.
-  // FOR NOW:
-  // Get something which works, no matter how inefficient!!!
+  cNopLabelIndex& index = m_memory.GetLabelIndex(*m_inst_set);
+  const int found = (direction > 0) ? index.FindNext(in_label, 0) : index.FindPrevious(in_label, m_memory.GetSize() - 1);
   
   cHeadCPU temp_head(this);
-  
-  while (temp_head.InMemory()) {
-    // IDEALY: Analyze the label we are in; see if the one we are looking
-    // for could be a sub-label of it.  Skip past it if not.
-    
-    int i;
-    for (i = 0; i < in_label.GetSize(); i++) {
-      if (!m_inst_set->IsNop(temp_head.GetInst()) ||
-          in_label[i] != m_inst_set->GetNopMod(temp_head.GetInst())) {
-        break;
-      }
-    }
-    if (i == GetLabel().GetSize()) {
-      temp_head.AbsJump(i - 1);
-      return temp_head;
-    }
-    
-    temp_head.AbsJump(direction);     // IDEALY: MAKE LARGER JUMPS
-  }
-  
-  temp_head.AbsSet(-1);
+  temp_head.AbsSet((found >= 0) ? found + in_label.GetSize() - 1 : -1);
   return temp_head;
 }
 
@@ -1690,7 +1743,7 @@ bool cHardwareCPU::Allocate_Random(cAvidaContext& ctx, const int old_size, const
   m_memory.Resize(new_size);
   
   for (int i = old_size; i < new_size; i++) {
-    m_memory[i] = m_inst_set->GetRandomInst(ctx);
+    m_memory.SetInst(i, m_inst_set->GetRandomInst(ctx));
   }
   return true;
 }
@@ -3335,8 +3388,9 @@ void cHardwareCPU::Divide_DoTransposons(cAvidaContext& ctx)
   
   // Count the number of transposons that are marked as executed
   int tr_count = 0;
-  for (int i = 0; i < m_memory.GetSize(); i++) {
-    if (m_memory.FlagExecuted(i) && (m_memory[i] == transposon_inst)) tr_count++;
+  const cCPUMemory& memory = m_memory;
+  for (int i = 0; i < memory.GetSize(); i++) {
+    if (memory.FlagExecuted(i) && (memory[i] == transposon_inst)) tr_count++;
   }
   
   for (int i = 0; i < tr_count; i++) {
@@ -8000,8 +8054,9 @@ int cHardwareCPU::Numberate(int _pos, int _dir, int _num_bits)
   j %= m_memory.GetSize();
   assert(j >=0);
   assert(j < m_memory.GetSize());
+  const cCPUMemory& memory = m_memory;
   while (code_size < _num_bits) {
-    unsigned int inst_code = (unsigned int) GetInstSet().GetInstructionCode(m_memory[j]);
+    unsigned int inst_code = (unsigned int) GetInstSet().GetInstructionCode(memory[j]);
     // shift bits in, one by one ... excuse the counter variable pun
     for (int code_on = 0; (code_size < _num_bits) && (code_on < m_world->GetConfig().INST_CODE_LENGTH.Get()); code_on++) {
       if (_dir < 0) {
@@ -49,6 +49,7 @@
 class cInstLib;
 class cInstSet;
 class cOrganism;
+class cStateBuffer;
 
 
 class cHardwareCPU : public cHardwareBase
@@ -94,6 +95,8 @@ protected:
     void ResetPromoterInstExecuted() { m_promoter_inst_executed = 0; }
     void setMessageTriggerType(int value) { m_messageTriggerType = value; }
     int getMessageTriggerType() { return m_messageTriggerType; }
+
+    void TransferState(cStateBuffer& state);
   };
 
 
@@ -124,9 +127,12 @@ protected:
 
     bool m_promoters_enabled:1;
     bool m_constitutive_regulation:1;
+    bool m_no_promoter_halts:1;         // NO_ACTIVE_PROMOTER_EFFECT == 2
 
     bool m_slip_read_head:1;
+    bool m_task_switch_penalty_enabled:1;
   };
+  int m_task_switch_penalty;
 
   // <-- Promoter model
   int m_promoter_index;       //site to begin looking for the next active promoter from
@@ -154,6 +160,7 @@ protected:
 
 
   bool SingleProcess_ExecuteInst(cAvidaContext& ctx, const Instruction& cur_inst);
+  inline bool executeInst(cAvidaContext& ctx, const Instruction& cur_inst, const cInstSet::sInstEntry& entry);
   
   // --------  Stack Manipulation...  --------
   inline void StackPush(int value);
@@ -248,6 +255,7 @@ public:
   // --------  Helper methods  --------
   int GetType() const { return HARDWARE_TYPE_CPU_ORIGINAL; }  
   bool SupportsSpeculative() const { return true; }
+  bool TransferState(cStateBuffer& state);
   void PrintStatus(std::ostream& fp);
   void SetupMiniTraceFileHeader(Avida::Output::File& df, const int gen_id, const Apto::String& genotype);
   void PrintMiniTraceStatus(cAvidaContext& ctx, std::ostream& fp) { (void)ctx, (void)fp; }
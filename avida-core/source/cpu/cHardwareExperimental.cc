@@ -33,6 +33,7 @@
 #include "cHardwareManager.h"
 #include "cHardwareTracer.h"
 #include "cInstSet.h"
+#include "cNopLabelIndex.h"
 #include "cOrganism.h"
 #include "cPhenotype.h"
 #include "cPopulation.h"
@@ -488,8 +489,9 @@ void cHardwareExperimental::internalReset()
     
     m_promoters.Resize(0);
     
-    for (int i=0; i < m_memory.GetSize(); i++) {
-      if (m_inst_set->IsPromoter(m_memory[i])) {
+    const cCPUMemory& memory = m_memory;  // read only, leaves the sites shared with the genome
+    for (int i=0; i < memory.GetSize(); i++) {
+      if (m_inst_set->IsPromoter(memory[i])) {
         int code = Numberate(i - 1, -1, m_world->GetConfig().PROMOTER_CODE_SIZE.Get());
         m_promoters.Push(cPromoter(i, code));
       }
@@ -972,42 +974,22 @@ cHeadCPU cHardwareExperimental::FindLabelStart(bool mark_executed)
   // Make sure the label is of size > 0.
   if (search_label.GetSize() == 0) return ip;
   
+  // First 'label' instruction directly followed by the nops of search_label, can be substring of 'label'ed target
+  // - extra NOPs in 'label'ed target are ignored
   cCPUMemory& memory = m_memory;
-  int pos = 0;
+  const int label_start = memory.GetLabelIndex(*m_inst_set).FindFirstLabeled(search_label);
   
-  while (pos < memory.GetSize()) {
-    if (m_inst_set->IsLabel(memory[pos])) { // starting label found
-      pos++;
-      
-      // Check for direct matched label pattern, can be substring of 'label'ed target
-      // - must match all NOPs in search_label
-      // - extra NOPs in 'label'ed target are ignored
-      int size_matched = 0;
-      while (size_matched < search_label.GetSize() && pos < memory.GetSize()) {
-        if (!m_inst_set->IsNop(memory[pos]) || search_label[size_matched] != m_inst_set->GetNopMod(memory[pos])) break;
-        size_matched++;
-        pos++;
-      }
-      
-      // Check that the label matches and has examined the full sequence of nops following the 'label' instruction
-      if (size_matched == search_label.GetSize()) {
-        // Return Head pointed at last NOP of label sequence
-        if (mark_executed) {
-          size_matched++; // Increment size matched so that it includes the label instruction
-          const int start = pos - size_matched;
-          const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get() + 1; // Max label + 1 for the label instruction itself
-          for (int i = 0; i < size_matched && i < max; i++) memory.SetFlagExecuted(start + i);
-        }
-        return cHeadCPU(this, pos - 1, ip.GetMemSpace());
-      }
-      
-      continue; 
-    }
-    pos++;
+  // Return start point if not found
+  if (label_start < 0) return ip;
+  
+  if (mark_executed) {
+    const int size_matched = search_label.GetSize() + 1; // Includes the label instruction
+    const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get() + 1; // Max label + 1 for the label instruction itself
+    for (int i = 0; i < size_matched && i < max; i++) memory.SetFlagExecuted(label_start + i);
   }
   
-  // Return start point if not found
-  return ip;
+  // Return Head pointed at last NOP of label sequence
+  return cHeadCPU(this, label_start + search_label.GetSize(), ip.GetMemSpace());
 }
 
 cHeadCPU cHardwareExperimental::FindNopSequenceStart(bool mark_executed)
@@ -1061,46 +1043,26 @@ cHeadCPU cHardwareExperimental::FindLabelForward(bool mark_executed)
   // Make sure the label is of size > 0.
   if (search_label.GetSize() == 0) return ip;
   
-  cHeadCPU pos(ip);
-  pos++;
+  // Next 'label' instruction after the IP, wrapping around the genome, that is directly followed by the nops of
+  // search_label (without reaching back to the IP)
+  cCPUMemory& memory = ip.GetMemory();
+  const int label_start = memory.GetLabelIndex(*m_inst_set).FindLabeledCircular(search_label, ip.GetPosition());
   
-  while (pos.GetPosition() != ip.GetPosition()) {
-    if (m_inst_set->IsLabel(pos.GetInst())) { // starting label found
-      const int label_start = pos.GetPosition();
-      pos++;
-      
-      // Check for direct matched label pattern, can be substring of 'label'ed target
-      // - must match all NOPs in search_label
-      // - extra NOPs in 'label'ed target are ignored
-      int size_matched = 0;
-      while (size_matched < search_label.GetSize() && pos.GetPosition() != ip.GetPosition()) {
-        if (!m_inst_set->IsNop(pos.GetInst()) || search_label[size_matched] != m_inst_set->GetNopMod(pos.GetInst())) break;
-        size_matched++;
-        pos++;
-      }
-      
-      // Check that the label matches and has examined the full sequence of nops following the 'label' instruction
-      if (size_matched == search_label.GetSize()) {
-        pos--;
-        const int found_pos = pos.GetPosition();
-        
-        if (mark_executed) {
-          pos.Set(label_start);
-          const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get() + 1; // Max label + 1 for the label instruction itself
-          for (int i = 0; i < size_matched && i < max; i++, pos++) pos.SetFlagExecuted();
-        }
-        
-        // Return Head pointed at last NOP of label sequence
-        return cHeadCPU(this, found_pos, ip.GetMemSpace());
-      }
-      
-      continue; 
-    }
-    pos++;
+  // Return start point if not found
+  if (label_start < 0) return ip;
+  
+  const int found_pos = (label_start + search_label.GetSize()) % memory.GetSize();
+  
+  if (mark_executed) {
+    cHeadCPU pos(ip);
+    pos.Set(label_start);
+    const int size_matched = search_label.GetSize();
+    const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get() + 1; // Max label + 1 for the label instruction itself
+    for (int i = 0; i < size_matched && i < max; i++, pos++) pos.SetFlagExecuted();
   }
   
-  // Return start point if not found
-  return ip;
+  // Return Head pointed at last NOP of label sequence
+  return cHeadCPU(this, found_pos, ip.GetMemSpace());
 }
 
 cHeadCPU cHardwareExperimental::FindLabelBackward(bool mark_executed)
@@ -1463,7 +1425,7 @@ bool cHardwareExperimental::Allocate_Random(cAvidaContext& ctx, const int old_si
   m_memory.Resize(new_size);
   
   for (int i = old_size; i < new_size; i++) {
-    m_memory[i] = m_inst_set->GetRandomInst(ctx);
+    m_memory.SetInst(i, m_inst_set->GetRandomInst(ctx));
   }
   return true;
 }
@@ -2897,9 +2859,10 @@ int cHardwareExperimental::Numberate(int _pos, int _dir, int _num_bits)
   j %= m_memory.GetSize();
   assert(j >=0);
   assert(j < m_memory.GetSize());
+  const cCPUMemory& memory = m_memory;
   while (code_size < _num_bits)
   {
-    unsigned int inst_code = (unsigned int) GetInstSet().GetInstructionCode(m_memory[j]);
+    unsigned int inst_code = (unsigned int) GetInstSet().GetInstructionCode(memory[j]);
     // shift bits in, one by one ... excuse the counter variable pun
     for (int code_on = 0; (code_size < _num_bits) && (code_on < m_world->GetConfig().INST_CODE_LENGTH.Get()); code_on++)
     {
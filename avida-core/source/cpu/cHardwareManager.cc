@@ -26,6 +26,7 @@
 
 #include "cArgContainer.h"
 #include "cArgSchema.h"
+#include "cGenomeTestCache.h"
 #include "cHardwareBCR.h"
 #include "cHardwareCPU.h"
 #include "cHardwareExperimental.h"
@@ -34,25 +35,89 @@
 #include "cHardwareStatusPrinter.h"
 #include "cInitFile.h"
 #include "cInstSet.h"
+#include "cOrganism.h"
 #include "cStringList.h"
 #include "cStringUtil.h"
 #include "cWorld.h"
 
+#include <new>
+
 using namespace Avida;
 
 static const Apto::BasicString<Apto::ThreadSafe> s_prop_id_instset("instset");
 
 cHardwareManager::cHardwareManager(cWorld* world)
-: m_world(world)
+: m_world(world), m_test_cache(NULL), m_test_cpus_idle(0), m_test_cpus_created(0), m_test_cpus_reused(0)
+, m_test_orgs_idle(0), m_test_orgs_created(0), m_test_orgs_reset(0)
 {
   cString filename = world->GetConfig().INST_SET.Get();
   m_is_name_map.Set("(default)", 0);
 
+  const int cache_size = world->GetConfig().TEST_CPU_CACHE_SIZE.Get();
+  if (cache_size > 0) m_test_cache = new cGenomeTestCache(cache_size);
 }
 
 cHardwareManager::~cHardwareManager()
 {
   for (int i = 0; i < m_inst_sets.GetSize(); i++) delete m_inst_sets[i];
+  delete m_test_cache;
+  for (int i = 0; i < m_test_cpus_idle; i++) delete m_test_cpu_pool[i];
+  for (int i = 0; i < m_test_orgs_idle; i++) delete m_test_org_pool[i];
+}
+
+
+cTestCPU* cHardwareManager::AcquireTestCPU(cAvidaContext& ctx)
+{
+  m_test_cpu_mutex.Lock();
+  if (m_test_cpus_idle) {
+    cTestCPU* testcpu = m_test_cpu_pool[--m_test_cpus_idle];
+    m_test_cpus_reused++;
+    m_test_cpu_mutex.Unlock();
+
+    testcpu->Reset();
+    return testcpu;
+  }
+  m_test_cpus_created++;
+  m_test_cpu_mutex.Unlock();
+
+  return new cTestCPU(ctx, m_world);
+}
+
+void cHardwareManager::ReleaseTestCPU(cTestCPU* testcpu)
+{
+  if (!testcpu) return;
+  Apto::MutexAutoLock lock(m_test_cpu_mutex);
+  if (m_test_cpus_idle == m_test_cpu_pool.GetSize()) m_test_cpu_pool.Push(testcpu);
+  else m_test_cpu_pool[m_test_cpus_idle] = testcpu;
+  m_test_cpus_idle++;
+}
+
+cOrganism* cHardwareManager::AcquireTestOrganism(cAvidaContext& ctx, const Genome& genome)
+{
+  const Systematics::Source src(Systematics::DIVISION, "", true);
+
+  m_test_org_mutex.Lock();
+  if (m_test_orgs_idle) {
+    cOrganism* org = m_test_org_pool[--m_test_orgs_idle];
+    m_test_orgs_reset++;
+    m_test_org_mutex.Unlock();
+
+    org->ResetInPlace(ctx, genome, -1, src);
+    return org;
+  }
+  m_test_orgs_created++;
+  m_test_org_mutex.Unlock();
+
+  return new (m_world) cOrganism(m_world, ctx, genome, -1, src);
+}
+
+void cHardwareManager::ReleaseTestOrganism(cOrganism* org)
+{
+  if (!org) return;
+  Apto::MutexAutoLock lock(m_test_org_mutex);
+  if (m_test_orgs_idle == m_test_org_pool.GetSize()) m_test_org_pool.Push(org);
+  else m_test_org_pool[m_test_orgs_idle] = org;
+  m_test_orgs_idle++;
 }
 
 
@@ -237,7 +302,15 @@ bool cHardwareManager::ConvertLegacyInstSetFile(cString filename, cStringList& s
 }
 
 
-cHardwareBase* cHardwareManager::Create(cAvidaContext& ctx, cOrganism* org, const Genome& mg)
+// Builds hardware of type T, in the storage of an existing hardware object when one is given
+template<class T> static cHardwareBase* buildHardware(void* storage, cAvidaContext& ctx, cWorld* world, cOrganism* org,
+                                                      cInstSet* inst_set)
+{
+  if (storage) return ::new (storage) T(ctx, world, org, inst_set);
+  return new (world) T(ctx, world, org, inst_set);
+}
+
+cHardwareBase* cHardwareManager::Create(cAvidaContext& ctx, cOrganism* org, const Genome& mg, cHardwareBase* reuse)
 {
   assert(org != NULL);
 	
@@ -246,31 +319,42 @@ cHardwareBase* cHardwareManager::Create(cAvidaContext& ctx, cOrganism* org, cons
   int inst_set_id = m_is_name_map.GetWithDefault(inst_set_name, -1);
   if (inst_set_id == -1) {
     assert(false);
+    delete reuse;
     return NULL; // No valid instruction set found
   }
   
   cInstSet* inst_set = m_inst_sets[inst_set_id];
   if (inst_set->GetHardwareType() != mg.HardwareType()) {
     assert(false);
+    delete reuse;
     return NULL; // inst_set/hw_type mismatch
   }
   
+  // Hardware of the same type is torn down and rebuilt in its own storage, anything else goes back to the pool
+  void* storage = NULL;
+  if (reuse && reuse->GetType() == inst_set->GetHardwareType()) {
+    reuse->~cHardwareBase();
+    storage = reuse;
+  } else {
+    delete reuse;
+  }
+  
   cHardwareBase* hw = 0;
   switch (inst_set->GetHardwareType()) {
     case HARDWARE_TYPE_CPU_ORIGINAL:
-      hw = new cHardwareCPU(ctx, m_world, org, inst_set);
+      hw = buildHardware<cHardwareCPU>(storage, ctx, m_world, org, inst_set);
       break;
     case HARDWARE_TYPE_CPU_TRANSSMT:
-      hw = new cHardwareTransSMT(ctx, m_world, org, inst_set);
+      hw = buildHardware<cHardwareTransSMT>(storage, ctx, m_world, org, inst_set);
       break;
     case HARDWARE_TYPE_CPU_EXPERIMENTAL:
-      hw = new cHardwareExperimental(ctx, m_world, org, inst_set);
+      hw = buildHardware<cHardwareExperimental>(storage, ctx, m_world, org, inst_set);
       break;
     case HARDWARE_TYPE_CPU_GP8:
-      hw = new cHardwareGP8(ctx, m_world, org, inst_set);
+      hw = buildHardware<cHardwareGP8>(storage, ctx, m_world, org, inst_set);
       break;
     case HARDWARE_TYPE_CPU_BCR:
-      hw = new cHardwareBCR(ctx, m_world, org, inst_set);
+      hw = buildHardware<cHardwareBCR>(storage, ctx, m_world, org, inst_set);
       break;
     default:
       assert(false);
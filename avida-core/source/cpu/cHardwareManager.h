@@ -24,11 +24,14 @@
 
 #include "cTestCPU.h"
 
+#include "apto/core/Mutex.h"
+
 namespace Avida {
   class Genome;
 };
 
 class cAvidaContext;
+class cGenomeTestCache;
 class cHardwareBase;
 class cInstSet;
 class cOrganism;
@@ -46,6 +49,21 @@ private:
   cWorld* m_world;
   Apto::Array<cInstSet*> m_inst_sets;
   Apto::Map<Apto::String, int> m_is_name_map;
+  cGenomeTestCache* m_test_cache;
+
+  // Idle test CPUs, handed out by AcquireTestCPU so that repeated tests do not rebuild them
+  Apto::Mutex m_test_cpu_mutex;
+  Apto::Array<cTestCPU*> m_test_cpu_pool;
+  int m_test_cpus_idle;
+  int m_test_cpus_created;
+  int m_test_cpus_reused;
+
+  // Idle test organisms, rebuilt in place by AcquireTestOrganism instead of being freed and allocated for every test
+  Apto::Mutex m_test_org_mutex;
+  Apto::Array<cOrganism*> m_test_org_pool;
+  int m_test_orgs_idle;
+  int m_test_orgs_created;
+  int m_test_orgs_reset;
 
   
   cHardwareManager(); // @not_implemented
@@ -64,8 +82,23 @@ public:
   bool LoadInstSets(cUserFeedback* feedback = NULL);
   bool ConvertLegacyInstSetFile(cString filename, cStringList& str_list, cUserFeedback* feedback = NULL);
   
-  cHardwareBase* Create(cAvidaContext& ctx, cOrganism* org, const Genome& mg);
+  cHardwareBase* Create(cAvidaContext& ctx, cOrganism* org, const Genome& mg, cHardwareBase* reuse = NULL);
   inline cTestCPU* CreateTestCPU(cAvidaContext& ctx) { return new cTestCPU(ctx, m_world); }
+  cGenomeTestCache* GetTestCache() { return m_test_cache; }
+
+  // Pooled test CPUs.  Every thread acquiring a CPU gets one of its own; it must be returned with ReleaseTestCPU, and
+  // not deleted, once the caller is done testing.
+  cTestCPU* AcquireTestCPU(cAvidaContext& ctx);
+  void ReleaseTestCPU(cTestCPU* testcpu);
+  int GetTestCPUsCreated() const { return m_test_cpus_created; }
+  int GetTestCPUsReused() const { return m_test_cpus_reused; }
+
+  // Pooled test organisms.  An idle organism is reset in place for the new genome, keeping its storage and, when the
+  // hardware type is unchanged, its hardware and memory.  cCPUTestInfo returns its organisms here when it is cleared.
+  cOrganism* AcquireTestOrganism(cAvidaContext& ctx, const Genome& genome);
+  void ReleaseTestOrganism(cOrganism* org);
+  int GetTestOrganismsCreated() const { return m_test_orgs_created; }
+  int GetTestOrganismsReset() const { return m_test_orgs_reset; }
 
   inline bool IsInstSet(const Apto::String& name) const { return m_is_name_map.Has(name); }
   
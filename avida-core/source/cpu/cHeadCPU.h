@@ -69,6 +69,9 @@ public:
   inline void Set(int pos, int ms = 0) { m_position = pos; m_mem_space = ms; Adjust(); }
   inline void SetFullLocation(int loc) { m_position = loc & 0xFFFFFF; m_mem_space = (loc >> 24); Adjust(); }
   inline void Set(const cHeadCPU& in_head) { m_position = in_head.m_position; m_mem_space = in_head.m_mem_space; }
+
+  // Save or restore the head location exactly, without adjusting it (see cStateBuffer)
+  template <class S> void TransferState(S& state) { state & m_position & m_mem_space; }
   inline void AbsSet(int new_pos) { m_position = new_pos; }
 
   inline void Jump(int jump) { m_position += jump; Adjust(); }
@@ -83,7 +86,7 @@ public:
   inline Instruction GetPrevInst() const;
   inline Instruction GetNextInst() const;
 
-  inline void SetInst(const Instruction& value) { GetMemory()[m_position] = value; }
+  inline void SetInst(const Instruction& value) { GetMemory().SetInst(m_position, value); }
   inline void InsertInst(const Instruction& inst) { GetMemory().Insert(m_position, inst); }
   inline void RemoveInst() { GetMemory().Remove(m_position); }
 
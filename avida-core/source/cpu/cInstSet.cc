@@ -105,6 +105,7 @@ Instruction cInstSet::ActivateNullInst()
   
   // Setup the new function...
   m_lib_name_map[inst_id].lib_fun_id = null_fun_id;
+  m_lib_name_map[inst_id].should_stall = m_inst_lib->Get(null_fun_id).ShouldStall();
   m_lib_name_map[inst_id].redundancy = 0;
   m_lib_name_map[inst_id].cost = 0;
   m_lib_name_map[inst_id].ft_cost = 0;
@@ -228,6 +229,7 @@ bool cInstSet::LoadWithStringList(const cStringList& sl, cUserFeedback* feedback
     
     // Setup the new function...
     m_lib_name_map[inst_id].lib_fun_id = fun_id;
+    m_lib_name_map[inst_id].should_stall = m_inst_lib->Get(fun_id).ShouldStall();
     m_lib_name_map[inst_id].redundancy = redundancy;
     m_lib_name_map[inst_id].cost = args->GetInt(0);
     m_lib_name_map[inst_id].ft_cost = args->GetInt(1);
@@ -57,8 +57,11 @@ public:
   int m_hw_type;
   cInstLib* m_inst_lib;
   
+  // Everything known about an instruction of this set, one entry per op.  Hardware execution loops fetch the entry
+  // of the current instruction once (see GetInstEntry) instead of making a separate lookup for each property.
   struct sInstEntry {
     int lib_fun_id;
+    bool should_stall;        // cached from the instruction library, for the execution loop
     int redundancy;           // Weight in instruction set (not impl.)
     int cost;                 // additional time spent to exectute inst within the thread that executed the instruction
     int ft_cost;              // time spent first time exec (in add to cost)
@@ -126,6 +129,7 @@ public:
   double GetBonusCost(const Instruction& inst) const { return m_lib_name_map[inst.GetOp()].bonus_cost; }
   
   int GetLibFunctionIndex(const Instruction& inst) const { return m_lib_name_map[inst.GetOp()].lib_fun_id; }
+  const sInstEntry& GetInstEntry(const Instruction& inst) const { return m_lib_name_map[inst.GetOp()]; }
 
   int GetNopMod(const Instruction& inst) const
   {
@@ -0,0 +1,182 @@
+/*
+ *  cNopLabelIndex.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cNopLabelIndex.h"
+
+#include "cCodeLabel.h"
+#include "cInstSet.h"
+
+using namespace Avida;
+
+
+// Index of the first element of sorted that is not less than value
+static inline int lowerBound(const Apto::Array<int>& sorted, int value)
+{
+  int lo = 0;
+  int hi = sorted.GetSize();
+  while (lo < hi) {
+    const int mid = (lo + hi) / 2;
+    if (sorted[mid] < value) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+
+cNopLabelIndex::~cNopLabelIndex()
+{
+  for (Apto::Map<Apto::String, sLabelSites*>::ValueIterator it = m_labels.Values(); it.Next();) delete *it.Get();
+}
+
+
+void cNopLabelIndex::Update(const InstructionSequence& seq, const cInstSet& inst_set)
+{
+  if (m_valid && m_inst_set == &inst_set && m_revision == seq.GetRevision() && GetSize() == seq.GetSize()) return;
+
+  if (m_inst_set != &inst_set) {
+    m_op_nop_mods.Resize(inst_set.GetSize());
+    m_op_labels.Resize(inst_set.GetSize());
+    for (int op = 0; op < inst_set.GetSize(); op++) {
+      const Instruction inst(op);
+      m_op_nop_mods[op] = inst_set.IsNop(inst) ? inst_set.GetNopMod(inst) : -1;
+      m_op_labels[op] = inst_set.IsLabel(inst);
+    }
+    m_inst_set = &inst_set;
+  }
+
+  Build(seq, m_op_nop_mods, m_op_labels);
+  m_revision = seq.GetRevision();
+}
+
+
+void cNopLabelIndex::Build(const InstructionSequence& seq, const Apto::Array<int>& op_nop_mods,
+                           const Apto::Array<bool>& op_labels)
+{
+  const int size = seq.GetSize();
+  m_nop_mod.Resize(size);
+  m_is_label.Resize(size);
+  m_run_end.Resize(size);
+
+  for (int i = 0; i < size; i++) {
+    const int op = seq[i].GetOp();
+    m_nop_mod[i] = (op < op_nop_mods.GetSize()) ? op_nop_mods[op] : -1;
+    m_is_label[i] = (op < op_labels.GetSize()) && op_labels[op];
+  }
+  for (int i = size - 1; i >= 0; i--) {
+    if (m_nop_mod[i] < 0) m_run_end[i] = -1;
+    else m_run_end[i] = (i + 1 < size && m_nop_mod[i + 1] >= 0) ? m_run_end[i + 1] : i + 1;
+  }
+
+  for (Apto::Map<Apto::String, sLabelSites*>::ValueIterator it = m_labels.Values(); it.Next();) delete *it.Get();
+  m_labels.Clear();
+  m_valid = true;
+}
+
+
+const cNopLabelIndex::sLabelSites& cNopLabelIndex::sites(const cCodeLabel& label)
+{
+  Apto::String key;
+  for (int i = 0; i < label.GetSize(); i++) key += (char)('A' + label[i]);
+
+  sLabelSites* sites = NULL;
+  if (m_labels.Get(key, sites)) return *sites;
+
+  sites = new sLabelSites;
+  const int label_size = label.GetSize();
+  const int size = GetSize();
+  int run_start = 0;
+  while (run_start < size) {
+    if (m_nop_mod[run_start] < 0) {
+      run_start++;
+      continue;
+    }
+
+    const int run_end = m_run_end[run_start];
+    for (int pos = run_start; pos + label_size <= run_end; pos++) {
+      int matches = 0;
+      while (matches < label_size && m_nop_mod[pos + matches] == label[matches]) matches++;
+      if (matches < label_size) continue;
+
+      sites->all.Push(pos);
+      if (pos > 0 && m_is_label[pos - 1]) sites->labeled.Push(pos);
+    }
+    run_start = run_end;
+  }
+
+  m_labels.Set(key, sites);
+  return *sites;
+}
+
+
+bool cNopLabelIndex::matchesWrapped(const cCodeLabel& label, int label_pos, int stop) const
+{
+  const int size = GetSize();
+  int pos = label_pos + 1;
+  for (int i = 0; i < label.GetSize(); i++, pos++) {
+    if (pos >= size) pos -= size;
+    if (pos == stop || m_nop_mod[pos] != label[i]) return false;
+  }
+  return true;
+}
+
+
+int cNopLabelIndex::FindNext(const cCodeLabel& label, int from)
+{
+  const Apto::Array<int>& all = sites(label).all;
+  const int idx = lowerBound(all, from);
+  return (idx < all.GetSize()) ? all[idx] : -1;
+}
+
+
+int cNopLabelIndex::FindPrevious(const cCodeLabel& label, int from)
+{
+  const Apto::Array<int>& all = sites(label).all;
+  const int idx = lowerBound(all, from + 1) - 1;
+  return (idx >= 0) ? all[idx] : -1;
+}
+
+
+int cNopLabelIndex::FindFirstLabeled(const cCodeLabel& label)
+{
+  const Apto::Array<int>& labeled = sites(label).labeled;
+  return (labeled.GetSize()) ? labeled[0] - 1 : -1;
+}
+
+
+int cNopLabelIndex::FindLabeledCircular(const cCodeLabel& label, int start)
+{
+  const int size = GetSize();
+  const int label_size = label.GetSize();
+  const Apto::Array<int>& labeled = sites(label).labeled;
+
+  // Label instructions after start whose nops fit before the end of the sequence...
+  int idx = lowerBound(labeled, start + 2);
+  if (idx < labeled.GetSize()) return labeled[idx] - 1;
+
+  // ...then those whose nops wrap around to the beginning...
+  for (int pos = (start + 1 > size - label_size) ? start + 1 : size - label_size; pos < size; pos++) {
+    if (m_is_label[pos] && matchesWrapped(label, pos, start)) return pos;
+  }
+
+  // ...and finally those before start, whose nops must end before reaching it
+  if (labeled.GetSize() && labeled[0] + label_size <= start) return labeled[0] - 1;
+
+  return -1;
+}
@@ -0,0 +1,96 @@
+/*
+ *  cNopLabelIndex.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cNopLabelIndex_h
+#define cNopLabelIndex_h
+
+#include "apto/core.h"
+#include "avida/core/InstructionSequence.h"
+
+class cCodeLabel;
+class cInstSet;
+
+
+// cNopLabelIndex
+//
+// Index of where each label occurs among the runs of nops of a sequence, used by the hardware label searches.  The
+// occurrences of a label are gathered, in order, the first time it is searched for, after which finding the next or
+// previous one is a binary search.  The index records the sequence revision it was built from (see
+// InstructionSequence::GetRevision), and Update rebuilds it lazily once the sequence has been modified.
+//
+// The queries only report where labels occur; each hardware type keeps its own rules for which occurrence a jump or
+// search lands on, expressed in terms of them.  A cCPUMemory keeps one of these, see cCPUMemory::GetLabelIndex.
+
+class cNopLabelIndex
+{
+private:
+  struct sLabelSites
+  {
+    Apto::Array<int> all;        // Every position at which the label's nops begin, ascending
+    Apto::Array<int> labeled;    // Those immediately preceded by a label instruction
+  };
+
+  const cInstSet* m_inst_set;
+  Apto::Array<int> m_op_nop_mods;
+  Apto::Array<bool> m_op_labels;
+  unsigned int m_revision;
+  bool m_valid;
+
+  Apto::Array<int> m_nop_mod;    // Nop modifier of each site, or -1 if the site is not a nop
+  Apto::Array<bool> m_is_label;  // Whether each site holds a label instruction
+  Apto::Array<int> m_run_end;    // For nop sites, one past the end of the run of nops containing them
+  Apto::Map<Apto::String, sLabelSites*> m_labels;
+
+
+  const sLabelSites& sites(const cCodeLabel& label);
+  bool matchesWrapped(const cCodeLabel& label, int label_pos, int stop) const;
+
+  cNopLabelIndex(const cNopLabelIndex&); // @not_implemented
+  cNopLabelIndex& operator=(const cNopLabelIndex&); // @not_implemented
+
+public:
+  cNopLabelIndex() : m_inst_set(NULL), m_revision(0), m_valid(false) { ; }
+  ~cNopLabelIndex();
+
+  // Brings the index up to date with seq (as classified by inst_set), rebuilding it only if either has changed
+  void Update(const Avida::InstructionSequence& seq, const cInstSet& inst_set);
+
+  // Rebuilds the index from per-opcode tables: the nop modifier of each op (-1 for non-nops) and whether it is a label
+  void Build(const Avida::InstructionSequence& seq, const Apto::Array<int>& op_nop_mods, const Apto::Array<bool>& op_labels);
+
+  inline int GetSize() const { return m_nop_mod.GetSize(); }
+  inline bool IsNop(int pos) const { return m_nop_mod[pos] >= 0; }
+  inline int GetRunEnd(int pos) const { assert(IsNop(pos)); return m_run_end[pos]; }
+
+  // First position at or after from where the label occurs, or -1
+  int FindNext(const cCodeLabel& label, int from);
+
+  // Last position at or before from where the label occurs, or -1
+  int FindPrevious(const cCodeLabel& label, int from);
+
+  // Position of the first label instruction directly followed by the label's nops, or -1
+  int FindFirstLabeled(const cCodeLabel& label);
+
+  // Position of the first label instruction directly followed by the label's nops, searching circularly from the site
+  // after start and stopping at start, which the nops may not reach.  Returns -1 if there is none.
+  int FindLabeledCircular(const cCodeLabel& label, int start);
+};
+
+#endif
@@ -57,11 +57,18 @@ cTestCPU::cTestCPU(cAvidaContext& ctx, cWorld* world)
   InitResources(ctx);
 }  
 
+void cTestCPU::Reset()
+{
+  m_use_manual_inputs = false;
+  m_test_solo_res = -1;
+  m_test_solo_res_lev = 0;
+}
+
  
 void cTestCPU::InitResources(cAvidaContext& ctx, int res_method, cResourceHistory* res, int update, int cpu_cycle_offset)
 {  
   //FOR DEMES
-  m_deme_resource_count.SetSize(0);
+  if (m_deme_resource_count.GetSize()) m_deme_resource_count.SetSize(0);
 
   m_res_method = (eTestCPUResourceMethod)res_method;
   // Make sure it's valid
@@ -94,10 +101,13 @@ void cTestCPU::InitResources(cAvidaContext& ctx, int res_method, cResourceHistor
   const cResourceLib& resource_lib = m_world->GetEnvironment().GetResourceLib();
   assert(resource_lib.GetSize() >= 0);
   
-  // Set the resource count to zero by default
-  m_resource_count.SetSize(resource_lib.GetSize());
-  m_faced_cell_resource_count.SetSize(resource_lib.GetSize());
-  m_cell_resource_count.SetSize(resource_lib.GetSize());
+  // Set the resource count to zero by default.  The counts only need to be rebuilt when the resource library has
+  // changed size since the last test, otherwise the levels are simply cleared in place below.
+  if (m_resource_count.GetSize() != resource_lib.GetSize()) {
+    m_resource_count.SetSize(resource_lib.GetSize());
+    m_faced_cell_resource_count.SetSize(resource_lib.GetSize());
+    m_cell_resource_count.SetSize(resource_lib.GetSize());
+  }
   for (int i = 0; i < resource_lib.GetSize(); i++) {
     m_resource_count.Set(ctx, i, 0.0);
     m_faced_cell_resource_count.Set(ctx, i, 0.0);
@@ -230,6 +240,52 @@ bool cTestCPU::TestGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Gen
   return test_info.is_viable;
 }
 
+bool cTestCPU::TestGenomeCached(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome,
+                                cGenomeTestCache::sResult& result)
+{
+  cGenomeTestCache* cache = m_world->GetHardwareManager().GetTestCache();
+  Apto::String key;
+  const bool cacheable = (cache && buildCacheKey(test_info, genome, key));
+  if (cacheable && cache->Lookup(key, result)) return result.is_viable;
+
+  TestGenome(ctx, test_info, genome);
+  result.Set(test_info);
+  if (cacheable) cache->Insert(key, result);
+
+  return result.is_viable;
+}
+
+bool cTestCPU::buildCacheKey(const cCPUTestInfo& test_info, const Genome& genome, Apto::String& key) const
+{
+  // Only deterministic tests can be shared; random inputs, mutations and traces all depend on the particular run
+  if (test_info.use_random_inputs || test_info.trace_task_order || test_info.m_tracer) return false;
+
+  const cMutationRates& muts = test_info.m_mut_rates;
+  const double mut_total = muts.GetCopyMutProb() + muts.GetCopyInsProb() + muts.GetCopyDelProb() +
+    muts.GetCopyUniformProb() + muts.GetCopySlipProb() + muts.GetDivMutProb() + muts.GetDivInsProb() +
+    muts.GetDivDelProb() + muts.GetDivUniformProb() + muts.GetDivSlipProb() + muts.GetDivTransProb() +
+    muts.GetDivLGTProb() + muts.GetDivideMutProb() + muts.GetDivideInsProb() + muts.GetDivideDelProb() +
+    muts.GetDivideUniformProb() + muts.GetDivideSlipProb() + muts.GetDivideTransProb() + muts.GetDivideLGTProb() +
+    muts.GetParentMutProb() + muts.GetParentInsProb() + muts.GetParentDelProb() + muts.GetPointMutProb() +
+    muts.GetPointInsProb() + muts.GetPointDelProb() + muts.GetDeathProb();
+  if (mut_total > 0.0) return false;
+
+  cString key_str((const char*)genome.AsString());
+  cString options;
+  // Resource histories are keyed by their state ID, which changes with their contents and is never reused by another history
+  options.Set("|%d|%d|%d|%d|%d|%d|%d|%d|%f|%d", test_info.generation_tests, test_info.m_cur_sg,
+              (int)test_info.m_res_method, (test_info.m_res) ? test_info.m_res->GetStateID() : 0, test_info.m_res_update,
+              test_info.m_res_cpu_cycle_offset, m_world->GetEnvironment().GetStateVersion(),
+              m_test_solo_res, m_test_solo_res_lev, m_world->GetConfig().TEST_CPU_TIME_MOD.Get());
+  key_str += options;
+  if (test_info.use_manual_inputs) {
+    for (int i = 0; i < test_info.manual_inputs.GetSize(); i++) key_str += cStringUtil::Stringf(",%d", test_info.manual_inputs[i]);
+  }
+  key = Apto::String((const char*)key_str);
+
+  return true;
+}
+
 bool cTestCPU::TestGenome_Body(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, int cur_depth)
 {
   assert(cur_depth < test_info.generation_tests);
@@ -256,11 +312,11 @@ bool cTestCPU::TestGenome_Body(cAvidaContext& ctx, cCPUTestInfo& test_info, cons
 	
   if (cur_depth > test_info.max_depth) test_info.max_depth = cur_depth;
 
-  // Setup the organism we're working with now.
-  if (test_info.org_array[cur_depth] != NULL) {
-    delete test_info.org_array[cur_depth];
-  }
-  cOrganism* organism = new cOrganism(m_world, ctx, genome, -1, Systematics::Source(Systematics::DIVISION, "", true));
+  // Setup the organism we're working with now.  The organism left at this depth by an earlier generation test is reset
+  // in place, any other comes from the hardware manager's pool of idle test organisms.
+  cOrganism* organism = test_info.org_array[cur_depth];
+  if (organism != NULL) organism->ResetInPlace(ctx, genome, -1, Systematics::Source(Systematics::DIVISION, "", true));
+  else organism = m_world->GetHardwareManager().AcquireTestOrganism(ctx, genome);
   
   // Copy the test mutation rates
   organism->MutationRates().Copy(test_info.MutationRates());
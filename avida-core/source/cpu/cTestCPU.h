@@ -28,6 +28,7 @@
 #include "cString.h"
 #include "cResourceCount.h"
 #include "cCPUTestInfo.h"
+#include "cGenomeTestCache.h"
 #include "cWorld.h"
 
 
@@ -70,6 +71,7 @@ private:
 
   bool ProcessGestation(cAvidaContext& ctx, cCPUTestInfo& test_info, int cur_depth);
   bool TestGenome_Body(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, int cur_depth);
+  bool buildCacheKey(const cCPUTestInfo& test_info, const Genome& genome, Apto::String& key) const;
 
   
   cTestCPU(); // @not_implemented
@@ -86,9 +88,17 @@ private:
 public:
   cTestCPU(cAvidaContext& ctx, cWorld* world);
   ~cTestCPU() { }
+
+  // Restore the settings established by the constructor, used when a pooled test CPU is handed out again
+  void Reset();
   
   bool TestGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome);
   bool TestGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, std::ofstream& out_fp);
+
+  // Like TestGenome, but reuses the summary of an earlier test of the same genome under the same conditions when the
+  // world has a test cache (TEST_CPU_CACHE_SIZE).  On a cache hit test_info is left untouched, only result is valid.
+  bool TestGenomeCached(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome,
+                        cGenomeTestCache::sResult& result);
   
   void PrintGenome(cAvidaContext& ctx, const Genome& genome, cString filename = "", int update = -1, bool for_groups = false, int last_birth_cell = 0, int last_group_id = -1, int last_forager_type = -1);
 
@@ -29,9 +29,72 @@
 #include "avida/data/Provider.h"
 #include "avida/data/Recorder.h"
 
+#include "apto/core/Thread.h"
+
 #include <cassert>
 
 
+// Data::Manager::BackgroundUpdate - worker thread processing at most one update at a time
+// --------------------------------------------------------------------------------------------------------------
+
+class Avida::Data::Manager::BackgroundUpdate : public Apto::Thread
+{
+private:
+  Manager* m_manager;
+  
+  Apto::Mutex m_mutex;
+  Apto::ConditionVariable m_cond;
+  Update m_update;
+  bool m_pending;
+  bool m_terminate;
+  
+  void Run()
+  {
+    m_mutex.Lock();
+    while (true) {
+      while (!m_pending && !m_terminate) m_cond.Wait(m_mutex);
+      if (!m_pending) break;
+      
+      const Update update = m_update;
+      m_mutex.Unlock();
+      m_manager->processUpdate(update, true);
+      m_mutex.Lock();
+      
+      m_pending = false;
+      m_cond.Broadcast();
+    }
+    m_mutex.Unlock();
+  }
+  
+public:
+  BackgroundUpdate(Manager* manager) : m_manager(manager), m_update(0), m_pending(false), m_terminate(false) { ; }
+  
+  void Submit(Update update)
+  {
+    Apto::MutexAutoLock lock(m_mutex);
+    assert(!m_pending);
+    m_update = update;
+    m_pending = true;
+    m_cond.Broadcast();
+  }
+  
+  void Wait()
+  {
+    Apto::MutexAutoLock lock(m_mutex);
+    while (m_pending) m_cond.Wait(m_mutex);
+  }
+  
+  void Terminate()
+  {
+    m_mutex.Lock();
+    m_terminate = true;
+    m_cond.Broadcast();
+    m_mutex.Unlock();
+    Join();
+  }
+};
+
+
 static Avida::WorldFacetPtr DeserializeDataManager(Avida::ArchivePtr)
 {
   // @TODO
@@ -42,13 +105,17 @@ bool Avida::Data::Manager::s_registered_with_facet_factory =
   Avida::WorldFacet::RegisterFacetType(Avida::Reserved::DataManagerFacetID, DeserializeDataManager);
 
 
-Avida::Data::Manager::Manager() : m_world(NULL), m_available(new DataSet)
+Avida::Data::Manager::Manager() : m_world(NULL), m_available(new DataSet), m_background(NULL)
 {
   
 }
 
 Avida::Data::Manager::~Manager()
 {
+  if (m_background) {
+    m_background->Terminate();
+    delete m_background;
+  }
 }
 
 
@@ -125,6 +192,9 @@ bool Avida::Data::Manager::AttachRecorder(RecorderPtr recorder, bool concurrent_
 {
   ConstDataSetPtr requested = recorder->RequestedData();
   
+  // Newly activated providers have no snapshot to be updated from until the next update
+  Synchronize();
+  
   m_rwlock.WriteLock();
   
   // Make sure that all requested data values are available
@@ -295,6 +365,22 @@ bool Avida::Data::Manager::AttachRecorder(RecorderPtr recorder, bool concurrent_
     }
   }
   
+  // Resolve the requested values of indexed recorders to value buffer slots.  The recorder mutex protects the buffer
+  // from being resized while other recorders are reading it.
+  if (recorder->SupportsIndexedData()) {
+    m_recorder_mutex.Lock();
+    for (ConstDataSetIterator it = requested->Begin(); it.Next();) {
+      ValueSlot slot;
+      if (!compileValue(*it.Get(), slot)) {
+        m_recorder_mutex.Unlock();
+        m_rwlock.WriteUnlock();
+        return false;
+      }
+      recorder->BindRequestedData(*it.Get(), slot);
+    }
+    m_recorder_mutex.Unlock();
+  }
+  
   m_rwlock.WriteUnlock();
   
   
@@ -302,6 +388,7 @@ bool Avida::Data::Manager::AttachRecorder(RecorderPtr recorder, bool concurrent_
     for (Apto::Set<ProviderPtr>::Iterator it = provider_set.Begin(); it.Next();) {
       if ((*it.Get())->SupportsConcurrentUpdate()) {
         ProviderPtr provider = (*it.Get());
+        provider->SnapshotProvidedValues(UPDATE_CONCURRENT);
         provider->UpdateProvidedValues(UPDATE_CONCURRENT);
         
         // Invalidate cached entries for this provider
@@ -333,6 +420,24 @@ bool Avida::Data::Manager::DetachRecorder(RecorderPtr recorder)
 }
 
 
+void Avida::Data::Manager::SetBackgroundUpdate(bool enabled)
+{
+  if (enabled && !m_background) {
+    m_background = new BackgroundUpdate(this);
+    m_background->Start();
+  } else if (!enabled && m_background) {
+    m_background->Terminate();
+    delete m_background;
+    m_background = NULL;
+  }
+}
+
+void Avida::Data::Manager::Synchronize()
+{
+  if (m_background) m_background->Wait();
+}
+
+
 bool Avida::Data::Manager::Register(const DataID& data_id, ProviderActivateFunctor functor)
 {
   if (data_id.GetSize() == 0 || data_id[data_id.GetSize() - 1] == ']') return false;
@@ -420,14 +525,61 @@ Avida::WorldFacetID Avida::Data::Manager::UpdateAfter() const
 
 void Avida::Data::Manager::PerformUpdate(Context&, Update current_update)
 {
+  // Only one update may be in flight at a time
+  Synchronize();
+  
   m_current_value_mutex.Lock();
   m_current_values.Clear();
   m_current_value_mutex.Unlock();
   
+  // Providers capture their inputs on the update thread, before the world moves on
+  m_rwlock.ReadLock();
+  for (int i = 0; i < m_active_providers.GetSize(); i++) m_active_providers[i]->SnapshotProvidedValues(current_update);
+  for (int i = 0; i < m_active_arg_providers.GetSize(); i++) {
+    m_active_arg_providers[i]->SnapshotProvidedValues(current_update);
+  }
+  const bool background = (m_background && canUpdateInBackground());
+  m_rwlock.ReadUnlock();
+  
+  if (background) m_background->Submit(current_update);
+  else processUpdate(current_update, false);
+}
+
+bool Avida::Data::Manager::canUpdateInBackground() const
+{
+  for (int i = 0; i < m_active_providers.GetSize(); i++) {
+    if (!m_active_providers[i]->SupportsBackgroundUpdate()) return false;
+  }
+  for (int i = 0; i < m_active_arg_providers.GetSize(); i++) {
+    if (!m_active_arg_providers[i]->SupportsBackgroundUpdate()) return false;
+  }
+  
+  Apto::MutexAutoLock lock(m_recorder_mutex);
+  for (Apto::Set<RecorderPtr>::ConstIterator it = m_recorders.Begin(); it.Next();) {
+    if (!(*it.Get())->SupportsBackgroundNotify()) return false;
+  }
+  return true;
+}
+
+void Avida::Data::Manager::processUpdate(Update current_update, bool background)
+{
   m_rwlock.ReadLock();
   
   // Update all of the active providers
   for (int i = 0; i < m_active_providers.GetSize(); i++) m_active_providers[i]->UpdateProvidedValues(current_update);
+  for (int i = 0; i < m_active_arg_providers.GetSize(); i++) {
+    m_active_arg_providers[i]->UpdateProvidedValues(current_update);
+  }
+  
+  // Fill the compiled values that providers do not write themselves
+  for (int i = 0; i < m_gathered_values.GetSize(); i++) {
+    GatheredValue& gv = m_gathered_values[i];
+    if (gv.arg_provider) {
+      m_values.SetPackage(gv.slot, gv.arg_provider->GetProvidedValueForArgument(gv.data_id, gv.argument));
+    } else {
+      m_values.SetPackage(gv.slot, gv.provider->GetProvidedValue(gv.data_id));
+    }
+  }
   
   // Notify recorders that new data is available
   DataRetrievalFunctor drf(this, &Manager::GetCurrentValue);
@@ -439,7 +591,16 @@ void Avida::Data::Manager::PerformUpdate(Context&, Update current_update)
   m_rwlock.ReadUnlock();
   
   for (Apto::Set<RecorderPtr>::Iterator it = m_recorders.Begin(); it.Next();) {
-    (*it.Get())->NotifyData(current_update, drf);
+    RecorderPtr recorder = *it.Get();
+    
+    // Recorders attached while a background update was in progress wait for the next update
+    if (background && !recorder->SupportsBackgroundNotify()) continue;
+    
+    if (recorder->SupportsIndexedData()) {
+      recorder->NotifyValues(current_update, m_values);
+    } else {
+      recorder->NotifyData(current_update, drf);
+    }
   }
   m_recorder_mutex.Unlock();
 }
@@ -486,3 +647,46 @@ Avida::Data::PackagePtr Avida::Data::Manager::GetCurrentValue(const DataID& data
   return rtn;
 }
 
+
+bool Avida::Data::Manager::compileValue(const DataID& data_id, ValueSlot& slot)
+{
+  // Values already compiled for another recorder share the same slot
+  if (m_value_slots.Get(data_id, slot)) return true;
+  
+  GatheredValue gv;
+  if (data_id[data_id.GetSize() - 1] == ']') {
+    // Find start of argument
+    int start_idx = -1;
+    for (int i = 0; i < data_id.GetSize(); i++) {
+      if (data_id[i] == '[') {
+        start_idx = i + 1;
+        break;
+      }
+    }
+    if (start_idx == -1) return false;  // argument start not found
+    
+    // Separate argument from incoming requested data id
+    gv.argument = data_id.Substring(start_idx, data_id.GetSize() - start_idx - 1);
+    gv.data_id = data_id.Substring(0, start_idx) + "]";
+    if (!m_active_arg_provider_map.Get(gv.data_id, gv.arg_provider)) return false;
+  } else {
+    ProviderPtr provider;
+    if (!m_active_provider_map.Get(data_id, provider)) return false;
+    
+    // Preferably, the provider writes the value into the buffer itself
+    if (provider->BindProvidedValue(data_id, m_values, slot)) {
+      m_value_slots[data_id] = slot;
+      return true;
+    }
+    
+    gv.provider = provider;
+    gv.data_id = data_id;
+  }
+  
+  gv.slot = m_values.AddPackage();
+  m_gathered_values.Push(gv);
+  
+  slot = gv.slot;
+  m_value_slots[data_id] = slot;
+  return true;
+}
@@ -33,6 +33,18 @@ bool Avida::Data::Provider::SupportsConcurrentUpdate() const
   return false;
 }
 
+bool Avida::Data::Provider::BindProvidedValue(const DataID&, ValueBuffer&, ValueSlot&)
+{
+  return false;
+}
+
+bool Avida::Data::Provider::SupportsBackgroundUpdate() const
+{
+  return false;
+}
+
+void Avida::Data::Provider::SnapshotProvidedValues(Update) { ; }
+
 
 Avida::Data::PackagePtr Avida::Data::ArgumentedProvider::GetProvidedValuesForArguments(const DataID& data_id,
                                                                                        ConstArgumentSetPtr args) const
@@ -25,3 +25,18 @@
 #include "avida/data/Recorder.h"
 
 Avida::Data::Recorder::~Recorder() { ; }
+
+
+bool Avida::Data::Recorder::SupportsIndexedData() const
+{
+  return false;
+}
+
+void Avida::Data::Recorder::BindRequestedData(const DataID&, const ValueSlot&) { ; }
+
+void Avida::Data::Recorder::NotifyValues(Update, const ValueBuffer&) { ; }
+
+bool Avida::Data::Recorder::SupportsBackgroundNotify() const
+{
+  return false;
+}
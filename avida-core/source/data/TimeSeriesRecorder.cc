@@ -194,6 +194,52 @@ namespace Avida {
     }
     
     
+    template <>
+    void TimeSeriesRecorder<PackagePtr>::NotifyValues(Update update, const ValueBuffer& values)
+    {
+      if (shouldRecordValue(update)) {
+        m_data.Push(DataEntry(update, values.PackageValue(m_slot)));
+        didRecordValue();
+      }
+    }
+    
+    template <>
+    void TimeSeriesRecorder<bool>::NotifyValues(Update update, const ValueBuffer& values)
+    {
+      if (shouldRecordValue(update)) {
+        m_data.Push(DataEntry(update, values.BoolValue(m_slot)));
+        didRecordValue();
+      }
+    }
+    
+    template <>
+    void TimeSeriesRecorder<int>::NotifyValues(Update update, const ValueBuffer& values)
+    {
+      if (shouldRecordValue(update)) {
+        m_data.Push(DataEntry(update, values.IntValue(m_slot)));
+        didRecordValue();
+      }
+    }
+    
+    template <>
+    void TimeSeriesRecorder<double>::NotifyValues(Update update, const ValueBuffer& values)
+    {
+      if (shouldRecordValue(update)) {
+        m_data.Push(DataEntry(update, values.DoubleValue(m_slot)));
+        didRecordValue();
+      }
+    }
+    
+    template <>
+    void TimeSeriesRecorder<Apto::String>::NotifyValues(Update update, const ValueBuffer& values)
+    {
+      if (shouldRecordValue(update)) {
+        m_data.Push(DataEntry(update, values.StringValue(m_slot)));
+        didRecordValue();
+      }
+    }
+    
+    
     template <>
     Apto::String TimeSeriesRecorder<PackagePtr>::AsString() const
     {
@@ -0,0 +1,117 @@
+/*
+ *  data/ValueBuffer.cc
+ *  avida-core
+ *
+ *  Copyright 2012 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "avida/data/ValueBuffer.h"
+
+#include "apto/core/StringUtils.h"
+#include "avida/data/Package.h"
+
+
+Avida::Data::ValueBuffer::~ValueBuffer() { ; }
+
+
+Avida::Data::ValueSlot Avida::Data::ValueBuffer::AddInt()
+{
+  m_ints.Push(0);
+  return ValueSlot(VALUE_INT, m_ints.GetSize() - 1);
+}
+
+Avida::Data::ValueSlot Avida::Data::ValueBuffer::AddDouble()
+{
+  m_doubles.Push(0.0);
+  return ValueSlot(VALUE_DOUBLE, m_doubles.GetSize() - 1);
+}
+
+Avida::Data::ValueSlot Avida::Data::ValueBuffer::AddString()
+{
+  m_strings.Push("");
+  return ValueSlot(VALUE_STRING, m_strings.GetSize() - 1);
+}
+
+Avida::Data::ValueSlot Avida::Data::ValueBuffer::AddPackage()
+{
+  m_packages.Push(PackagePtr());
+  return ValueSlot(VALUE_PACKAGE, m_packages.GetSize() - 1);
+}
+
+
+void Avida::Data::ValueBuffer::SetPackage(const ValueSlot& slot, PackagePtr value)
+{
+  assert(slot.type == VALUE_PACKAGE);
+  m_packages[slot.index] = value;
+}
+
+
+bool Avida::Data::ValueBuffer::BoolValue(const ValueSlot& slot) const
+{
+  switch (slot.type) {
+    case VALUE_INT:     return m_ints[slot.index] != 0;
+    case VALUE_DOUBLE:  return m_doubles[slot.index] != 0.0;
+    case VALUE_STRING:  return Apto::StrAs(m_strings[slot.index]);
+    case VALUE_PACKAGE: return (m_packages[slot.index]) ? m_packages[slot.index]->BoolValue() : false;
+    default:            return false;
+  }
+}
+
+Apto::String Avida::Data::ValueBuffer::StringValue(const ValueSlot& slot) const
+{
+  switch (slot.type) {
+    case VALUE_INT:     return Apto::AsStr(m_ints[slot.index]);
+    case VALUE_DOUBLE:  return Apto::AsStr(m_doubles[slot.index]);
+    case VALUE_STRING:  return m_strings[slot.index];
+    case VALUE_PACKAGE: return (m_packages[slot.index]) ? m_packages[slot.index]->StringValue() : Apto::String();
+    default:            return Apto::String();
+  }
+}
+
+Avida::Data::PackagePtr Avida::Data::ValueBuffer::PackageValue(const ValueSlot& slot) const
+{
+  switch (slot.type) {
+    case VALUE_INT:     return PackagePtr(new Wrap<int>(m_ints[slot.index]));
+    case VALUE_DOUBLE:  return PackagePtr(new Wrap<double>(m_doubles[slot.index]));
+    case VALUE_STRING:  return PackagePtr(new Wrap<Apto::String>(m_strings[slot.index]));
+    case VALUE_PACKAGE: return m_packages[slot.index];
+    default:            return PackagePtr();
+  }
+}
+
+
+int Avida::Data::ValueBuffer::convertInt(const ValueSlot& slot) const
+{
+  switch (slot.type) {
+    case VALUE_INT:     return m_ints[slot.index];
+    case VALUE_DOUBLE:  return (int)m_doubles[slot.index];
+    case VALUE_STRING:  return Apto::StrAs(m_strings[slot.index]);
+    case VALUE_PACKAGE: return (m_packages[slot.index]) ? m_packages[slot.index]->IntValue() : 0;
+    default:            return 0;
+  }
+}
+
+double Avida::Data::ValueBuffer::convertDouble(const ValueSlot& slot) const
+{
+  switch (slot.type) {
+    case VALUE_INT:     return m_ints[slot.index];
+    case VALUE_DOUBLE:  return m_doubles[slot.index];
+    case VALUE_STRING:  return Apto::StrAs(m_strings[slot.index]);
+    case VALUE_PACKAGE: return (m_packages[slot.index]) ? m_packages[slot.index]->DoubleValue() : 0.0;
+    default:            return 0.0;
+  }
+}
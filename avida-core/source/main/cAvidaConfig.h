@@ -282,6 +282,14 @@ public:
   CONFIG_ADD_VAR(VERBOSITY, int, 1, "0 = No output at all\n1 = Normal output\n2 = Verbose output, detailing progress\n3 = High level of details, as available\n4 = Print Debug Information, as applicable");
   CONFIG_ADD_VAR(RANDOM_SEED, int, -1, "Random number seed (<0 for based on time)");
   CONFIG_ADD_VAR(SPECULATIVE, bool, 1, "Enable speculative execution\n(pre-execute instructions that don't affect other organisms)");
+  CONFIG_ADD_VAR(UPDATE_THREADS, int, 0, "Number of worker threads used to speculatively pre-execute organisms each update\n(0 = disabled, -1 = use all available CPUs)\nRequires SPECULATIVE; results depend on RANDOM_SEED and UPDATE_TILE_SIZE,\nbut not on the number of threads");
+  CONFIG_ADD_VAR(UPDATE_TILE_SIZE, int, 16, "Width and height (in cells) of the world tiles distributed to UPDATE_THREADS");
+  CONFIG_ADD_VAR(RESOURCE_THREADS, int, 1, "Number of threads used to advance spatial resources, in bands of grid rows\n(-1 = use all available CPUs); results do not depend on the number of threads");
+  CONFIG_ADD_VAR(STAT_THREADS, int, 1, "Number of threads used to gather the end of update organism statistics\n(-1 = use all available CPUs); results do not depend on the number of threads");
+  CONFIG_ADD_VAR(STATS_ON_DEMAND, bool, 0, "Only gather the end of update organism statistics (tasks, reactions, mutation rates,\npredator/prey and mating types) used by the requested output files and data\nrecorders; see the PrintEnabledStats action");
+  CONFIG_ADD_VAR(DATA_BACKGROUND_UPDATE, int, 0, "Calculate end of update statistics on a background thread, overlapping with the\nnext update, whenever all active data providers and recorders support it");
+  CONFIG_ADD_VAR(ORGANISM_POOL, bool, 1, "Allocate organisms and their hardware from per-world slab pools, recycling the memory\nand phenotypes of dead organisms for new births (see the PrintAllocationData action)");
+  CONFIG_ADD_VAR(CHECKPOINT_MAX_PENDING, int, 2, "Maximum number of checkpoints from SaveCheckpointAsync waiting to be written;\nthe update loop blocks while this many are in flight");
   CONFIG_ADD_VAR(POPULATION_CAP, int, 0, "Carrying capacity in number of organisms (use 0 for no cap)");
   CONFIG_ADD_VAR(POP_CAP_ELDEST, int, 0, "Carrying capacity in number of organisms (use 0 for no cap). Will kill oldest organism in population, but still use birth method to place new offspring."); 
   
@@ -298,6 +306,7 @@ public:
   // -------- Configuration File config options --------
   CONFIG_ADD_GROUP(CONFIG_FILE_GROUP, "Other configuration Files");
   CONFIG_ADD_VAR(DATA_DIR, cString, "data", "Directory in which config files are found");
+  CONFIG_ADD_VAR(DATA_FORMAT, int, 0, "Format of tabular data files\n0 = Text (.dat)\n1 = Columnar binary (.dat.col), convert to text with avida-dat\n2 = Compressed columnar binary (.dat.col)");
   CONFIG_ADD_VAR(EVENT_FILE, cString, "events.cfg", "File containing list of events during run");
   CONFIG_ADD_VAR(ANALYZE_FILE, cString, "analyze.cfg", "File used for analysis mode");
   CONFIG_ADD_VAR(ENVIRONMENT_FILE, cString, "environment.cfg", "File that describes the environment");
@@ -319,6 +328,7 @@ public:
   CONFIG_ADD_VAR(INST_POINT_MUT_SLOPE, double, 0.0, "Slope for point mutation rate");
   CONFIG_ADD_VAR(INST_POINT_REPAIR_COST, int, 0, "The cost, in cycles, of avoiding mutations when the point-mut instruction is executed");
   CONFIG_ADD_VAR(POINT_MUT_REPAIR_START, int, 0, "The starting condition for repairs (on=1; off=0)");
+  CONFIG_ADD_VAR(POINT_MUT_SKIP_SAMPLING, bool, 1, "Draw point (cosmic ray) mutations for the whole population at once,\nskipping between mutated sites rather than sampling every organism;\n0=per-organism sampling (reproduces earlier runs for a given seed)");
 
   
   CONFIG_ADD_VAR(DIV_MUT_PROB, double, 0.0, "Substitution rate (per site, applied on divide)");
@@ -473,6 +483,7 @@ public:
   CONFIG_ADD_GROUP(MP_GROUP, "Config options for multiple, distributed populations");
   CONFIG_ADD_VAR(ENABLE_MP, int, 0, "Enable multi-process Avida; 0=disabled (default),\n1=enabled.");
   CONFIG_ADD_VAR(MP_SCHEDULING_STYLE, int, 0, "Style of scheduling:\n0=non-MP aware (default)\n1=MP aware, integrated across worlds.");
+  CONFIG_ADD_VAR(MP_MIGRATION_LAG, int, 0, "Number of updates a world may run ahead of the migrants\nsent to it; 0=synchronized on every update (default).\nMP_SCHEDULING_STYLE 1 still synchronizes every update.");
 	
   
   // -------- Deme config options --------
@@ -592,6 +603,7 @@ public:
   CONFIG_ADD_GROUP(GENEOLOGY_GROUP, "Geneology");
   CONFIG_ADD_VAR(THRESHOLD, int, 3, "Number of organisms in a genotype needed for it\n  to be considered viable.");
   CONFIG_ADD_VAR(TEST_CPU_TIME_MOD, int, 20, "Time allocated in test CPUs (multiple of length)");
+  CONFIG_ADD_VAR(TEST_CPU_CACHE_SIZE, int, 0, "Number of test CPU results to keep for reuse by genotype metrics,\n  landscapes and mutational neighborhoods (0 = disabled)");
   
 
   // -------- Organism Network config options --------
@@ -0,0 +1,118 @@
+/*
+ *  cCheckpointWriter.cc
+ *  Avida
+ *
+ *  Copyright 2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cCheckpointWriter.h"
+
+#include "cPopulationCheckpoint.h"
+
+#include <iostream>
+
+using namespace std;
+
+
+cCheckpointWriter::cCheckpointWriter(int max_pending)
+: m_max_pending((max_pending > 0) ? max_pending : 1), m_pending(0), m_terminate(false), m_thread(this)
+{
+  m_thread.Start();
+}
+
+cCheckpointWriter::~cCheckpointWriter()
+{
+  Flush();
+
+  m_mutex.Lock();
+  m_terminate = true;
+  m_mutex.Unlock();
+  m_cond.Signal();
+
+  m_thread.Join();
+
+  // Nobody is left to collect failures of the final writes, report them here rather than losing them
+  Apto::Array<cString> failed;
+  TakeFailures(failed);
+  for (int i = 0; i < failed.GetSize(); i++) cerr << "error: failed to save checkpoint '" << failed[i] << "'" << endl;
+}
+
+
+void cCheckpointWriter::Submit(cPopulationCheckpoint* checkpoint, const cString& filename, bool compress)
+{
+  sPending* pending = new sPending;
+  pending->checkpoint = checkpoint;
+  pending->filename = cString((const char*)filename);  // private copy, cString reference counts are not thread safe
+  pending->compress = compress;
+
+  m_mutex.Lock();
+  while (m_pending >= m_max_pending) m_done_cond.Wait(m_mutex);
+  m_queue.PushRear(pending);
+  m_pending++;
+  m_mutex.Unlock();
+
+  m_cond.Signal();
+}
+
+
+void cCheckpointWriter::Flush()
+{
+  m_mutex.Lock();
+  while (m_pending > 0) m_done_cond.Wait(m_mutex);
+  m_mutex.Unlock();
+}
+
+
+int cCheckpointWriter::GetNumPending()
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  return m_pending;
+}
+
+
+void cCheckpointWriter::TakeFailures(Apto::Array<cString>& failed)
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  failed.Resize(m_failed.GetSize());
+  for (int i = 0; i < m_failed.GetSize(); i++) failed[i] = cString((const char*)m_failed[i]);
+  m_failed.Resize(0);
+}
+
+
+void cCheckpointWriter::cWriterThread::Run()
+{
+  while (1) {
+    m_writer->m_mutex.Lock();
+    while (!m_writer->m_terminate && m_writer->m_queue.GetSize() == 0) m_writer->m_cond.Wait(m_writer->m_mutex);
+    if (m_writer->m_queue.GetSize() == 0) {
+      m_writer->m_mutex.Unlock();
+      break;
+    }
+    sPending* pending = m_writer->m_queue.Pop();
+    m_writer->m_mutex.Unlock();
+
+    const bool ok = pending->checkpoint->Save(pending->filename, pending->compress);
+    const cString filename = pending->filename;
+    delete pending->checkpoint;
+    delete pending;
+
+    m_writer->m_mutex.Lock();
+    if (!ok) m_writer->m_failed.Push(cString((const char*)filename));
+    m_writer->m_pending--;
+    m_writer->m_mutex.Unlock();
+    m_writer->m_done_cond.Broadcast();
+  }
+}
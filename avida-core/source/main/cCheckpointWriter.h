@@ -0,0 +1,95 @@
+/*
+ *  cCheckpointWriter.h
+ *  Avida
+ *
+ *  Copyright 2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cCheckpointWriter_h
+#define cCheckpointWriter_h
+
+#include "apto/core.h"
+#include "apto/core/Thread.h"
+
+#include "cString.h"
+
+class cPopulationCheckpoint;
+
+
+// cCheckpointWriter
+//
+// Background I/O thread for population checkpoints.  Snapshots are taken on the update thread (see
+// cPopulation::BuildCheckpoint) and handed off with Submit; encoding and writing the file then overlap with the
+// following updates.  At most max_pending snapshots are held at once, Submit blocks until one completes when the cap is
+// reached.  Files are written through cPopulationCheckpoint::Save, and so are only ever visible once complete.
+
+class cCheckpointWriter
+{
+private:
+  struct sPending
+  {
+    cPopulationCheckpoint* checkpoint;
+    cString filename;
+    bool compress;
+  };
+
+  class cWriterThread : public Apto::Thread
+  {
+  private:
+    cCheckpointWriter* m_writer;
+
+    void Run();
+
+  public:
+    cWriterThread(cCheckpointWriter* writer) : m_writer(writer) { ; }
+  };
+  friend class cWriterThread;
+
+
+  Apto::Mutex m_mutex;
+  Apto::ConditionVariable m_cond;       // signaled when a checkpoint is submitted
+  Apto::ConditionVariable m_done_cond;  // signaled when a checkpoint has been written
+
+  int m_max_pending;
+  Apto::List<sPending*> m_queue;
+  volatile int m_pending;               // queued plus in progress
+  volatile bool m_terminate;
+  Apto::Array<cString> m_failed;
+
+  cWriterThread m_thread;
+
+
+  cCheckpointWriter(); // @not_implemented
+  cCheckpointWriter(const cCheckpointWriter&); // @not_implemented
+  cCheckpointWriter& operator=(const cCheckpointWriter&); // @not_implemented
+
+public:
+  cCheckpointWriter(int max_pending);
+  ~cCheckpointWriter();  // writes out everything still pending, reporting any failures that were not taken
+
+  // Takes ownership of checkpoint
+  void Submit(cPopulationCheckpoint* checkpoint, const cString& filename, bool compress);
+
+  // Blocks until every submitted checkpoint has been written
+  void Flush();
+
+  int GetNumPending();
+
+  // Filenames of checkpoints that failed to write since the last call
+  void TakeFailures(Apto::Array<cString>& failed);
+};
+
+#endif
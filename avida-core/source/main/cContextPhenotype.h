@@ -40,6 +40,7 @@ public:
   int m_number_tasks;
   int m_number_reactions;
 
+  void SetupCounts(int number_tasks, int number_reactions);
   void AddTaskCounts(int count, Apto::Array<int>& cur_task_count);
   Apto::Array<int>& GetTaskCounts() { return m_cur_task_count; }
   void AddReactionCounts(int count, Apto::Array<int>& cur_task_count);
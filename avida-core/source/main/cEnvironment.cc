@@ -53,11 +53,12 @@ using namespace Avida;
 
 cEnvironment::cEnvironment(cWorld* world) : m_world(world) , m_tasklib(world),
 m_input_size(INPUT_SIZE_DEFAULT), m_output_size(OUTPUT_SIZE_DEFAULT), m_true_rand(false),
-m_use_specific_inputs(false), m_specific_inputs(), m_mask(0), m_hammers(false), m_paths(false)
+m_use_specific_inputs(false), m_specific_inputs(), m_mask(0), m_hammers(false), m_paths(false), m_state_version(0)
 {
   mut_rates.Setup(world);
   if (m_world->GetConfig().DEFAULT_GROUP.Get() != -1) possible_group_ids.insert(m_world->GetConfig().DEFAULT_GROUP.Get());
   pp_fts.Resize(0);
+  BuildTaskPlan();
 }
 
 cEnvironment::~cEnvironment()
@@ -1187,6 +1188,7 @@ bool cEnvironment::LoadLine(cString line, Feedback& feedback)
 /* Routine to read in a line from the enviroment file and hand that line
  line to the approprate routine to process it.                         */
 {
+  m_state_version++;
   cString type = line.PopWord();      // Determine type of this entry.
   type.ToUpper();                     // Make type case insensitive.
 
@@ -1201,6 +1203,7 @@ bool cEnvironment::LoadLine(cString line, Feedback& feedback)
     feedback.Error("unknown environment keyword '%s'", (const char*)type);
     return false;
   }
+  BuildTaskPlan();
 
   if (load_ok == false) {
     feedback.Error("failed in loading '%s'", (const char*)type);
@@ -1311,6 +1314,45 @@ bool cEnvironment::TestInput(cReactionResult&, const tBuffer<int>&, const tBuffe
 }
 
 
+void cEnvironment::BuildTaskPlan()
+{
+  // Logic-ID-only tasks are evaluated up front, against a context that carries nothing but the logic ID
+  tBuffer<int> no_buffer(1);
+  tList<tBuffer<int> > no_buffers;
+  Apto::Array<int, Apto::Smart> no_memory;
+  cTaskContext logic_ctx(NULL, no_buffer, no_buffer, no_buffers, no_buffers, no_memory);
+
+  m_task_plan.ResizeClear(257);
+  for (int logic_id = -1; logic_id < 256; logic_id++) {
+    Apto::Array<sPlannedReaction>& plan = m_task_plan[logic_id + 1];
+    plan.Resize(0);
+    logic_ctx.SetLogicId(logic_id);
+
+    for (int i = 0; i < reaction_lib.GetSize(); i++) {
+      cReaction* cur_reaction = reaction_lib.GetReaction(i);
+      cTaskEntry* cur_task = cur_reaction->GetTask();
+
+      // Phenotypic plasticity bonuses can credit a task that was not performed, so those reactions are always tested
+      bool logic_only = (cur_task != NULL && cur_task->IsLogicIdOnly());
+      tLWConstListIterator<cReactionProcess> proc_it(cur_reaction->GetProcesses());
+      while (logic_only && proc_it.Next() != NULL) {
+        if (proc_it.Get()->GetPhenPlastBonusMethod() != DEFAULT) logic_only = false;
+      }
+
+      sPlannedReaction planned;
+      planned.reaction_id = i;
+      planned.quality = -1.0;
+      if (logic_only) {
+        logic_ctx.SetTaskEntry(cur_task);
+        planned.quality = m_tasklib.TestOutput(logic_ctx);
+        if (planned.quality == 0.0) continue;
+      }
+      plan.Push(planned);
+    }
+  }
+}
+
+
 bool cEnvironment::TestOutput(cAvidaContext& ctx, cReactionResult& result,
                               cTaskContext& taskctx, const Apto::Array<int>& task_count,
                               Apto::Array<int>& reaction_count,
@@ -1326,10 +1368,12 @@ bool cEnvironment::TestOutput(cAvidaContext& ctx, cReactionResult& result,
 
   // Do setup for reaction tests...
   m_tasklib.SetupTests(taskctx);
+  assert(taskctx.GetLogicId() >= -1 && taskctx.GetLogicId() < 256);
 
-  // Loop through all reactions to see if any have been triggered...
-  const int num_reactions = reaction_lib.GetSize();
-  for (int i = 0; i < num_reactions; i++) {
+  // Loop through the reactions that could have been triggered by an output with this logic ID...
+  const Apto::Array<sPlannedReaction>& plan = m_task_plan[taskctx.GetLogicId() + 1];
+  for (int p = 0; p < plan.GetSize(); p++) {
+    const int i = plan[p].reaction_id;
     cReaction* cur_reaction = reaction_lib.GetReaction(i);
     assert(cur_reaction != NULL);
 
@@ -1353,18 +1397,7 @@ bool cEnvironment::TestOutput(cAvidaContext& ctx, cReactionResult& result,
     }
 
     if (context_phenotype != 0) {
-      Apto::Array<int> blank_tasks;
-      Apto::Array<int> blank_reactions;
-      blank_tasks.ResizeClear(task_count.GetSize());
-      for(int count=0;count<task_count.GetSize();count++) {
-        blank_tasks[count] = 0;
-      }
-      blank_reactions.ResizeClear(this->GetReactionLib().GetSize());
-      for(int count=0;count<reaction_count.GetSize();count++) {
-        blank_reactions[count] = 0;
-      }
-      context_phenotype->AddTaskCounts(blank_tasks.GetSize(), blank_tasks);
-      context_phenotype->AddReactionCounts(blank_reactions.GetSize(), blank_reactions);
+      context_phenotype->SetupCounts(task_count.GetSize(), reaction_lib.GetSize());
       int context_task_count = context_phenotype->GetTaskCounts()[task_id];
       if (TestContextRequisites(cur_reaction, context_task_count, context_phenotype->GetReactionCounts(), on_divide) == false) {
         if (!skipProcessing) {  // for those parasites again
@@ -1373,7 +1406,7 @@ bool cEnvironment::TestOutput(cAvidaContext& ctx, cReactionResult& result,
       }
     }
 
-    const double task_quality = m_tasklib.TestOutput(taskctx);
+    const double task_quality = (plan[p].quality >= 0.0) ? plan[p].quality : m_tasklib.TestOutput(taskctx);
     assert(task_quality >= 0.0);
 
     // If this task wasn't performed, move on to the next one.
@@ -1876,6 +1909,7 @@ double cEnvironment::GetReactionValue(int reaction_id)
 
 bool cEnvironment::SetReactionValue(cAvidaContext& ctx, const cString& name, double value)
 {
+  m_state_version++;
   const int num_reactions = reaction_lib.GetSize();
 
   // See if this should be applied to all reactions.
@@ -1917,6 +1951,7 @@ bool cEnvironment::SetReactionValue(cAvidaContext& ctx, const cString& name, dou
 
 bool cEnvironment::SetReactionValueMult(const cString& name, double value_mult)
 {
+  m_state_version++;
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
   found_reaction->MultiplyValue(value_mult);
@@ -1925,6 +1960,7 @@ bool cEnvironment::SetReactionValueMult(const cString& name, double value_mult)
 
 bool cEnvironment::SetReactionInst(const cString& name, cString inst_name)
 {
+  m_state_version++;
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
   found_reaction->ModifyInst(inst_name);
@@ -1933,6 +1969,7 @@ bool cEnvironment::SetReactionInst(const cString& name, cString inst_name)
 
 bool cEnvironment::SetReactionMinTaskCount(const cString& name, int min_count)
 {
+  m_state_version++;
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
   return found_reaction->SetMinTaskCount( min_count );
@@ -1940,6 +1977,7 @@ bool cEnvironment::SetReactionMinTaskCount(const cString& name, int min_count)
 
 bool cEnvironment::SetReactionMaxTaskCount(const cString& name, int max_count)
 {
+  m_state_version++;
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
   return found_reaction->SetMaxTaskCount( max_count );
@@ -1947,6 +1985,7 @@ bool cEnvironment::SetReactionMaxTaskCount(const cString& name, int max_count)
 
 bool cEnvironment::SetReactionMinCount(const cString& name, int reaction_min_count)
 {
+  m_state_version++;
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
   return found_reaction->SetMinReactionCount( reaction_min_count );
@@ -1954,6 +1993,7 @@ bool cEnvironment::SetReactionMinCount(const cString& name, int reaction_min_cou
 
 bool cEnvironment::SetReactionMaxCount(const cString& name, int reaction_max_count)
 {
+  m_state_version++;
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
   return found_reaction->SetMaxReactionCount( reaction_max_count );
@@ -1961,6 +2001,7 @@ bool cEnvironment::SetReactionMaxCount(const cString& name, int reaction_max_cou
 
 bool cEnvironment::SetReactionTask(const cString& name, const cString& task)
 {
+  m_state_version++;
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
 
@@ -1969,6 +2010,7 @@ bool cEnvironment::SetReactionTask(const cString& name, const cString& task)
     if (m_tasklib.GetTask(i).GetName() == task)
     {
       found_reaction->SetTask( m_tasklib.GetTaskReference(i) );
+      BuildTaskPlan();
       return true;
     }
   }
@@ -1978,6 +2020,7 @@ bool cEnvironment::SetReactionTask(const cString& name, const cString& task)
 
 bool cEnvironment::SetResourceInflow(const cString& name, double _inflow )
 {
+  m_state_version++;
   cResource* found_resource = resource_lib.GetResource(name);
   if (found_resource == NULL) return false;
   found_resource->SetInflow( _inflow );
@@ -1986,6 +2029,7 @@ bool cEnvironment::SetResourceInflow(const cString& name, double _inflow )
 
 bool cEnvironment::SetResourceOutflow(const cString& name, double _outflow )
 {
+  m_state_version++;
   cResource* found_resource = resource_lib.GetResource(name);
   if (found_resource == NULL) return false;
   found_resource->SetOutflow( _outflow );
@@ -1994,6 +2038,7 @@ bool cEnvironment::SetResourceOutflow(const cString& name, double _outflow )
 
 bool cEnvironment::ChangeResource(cReaction* reaction, const cString& res, int process_num)
 {
+  m_state_version++;
   cReactionProcess* process = reaction->GetProcess(process_num);
   process->SetResource(m_world->GetEnvironment().GetResourceLib().GetResource(res));
   return true;
@@ -82,6 +82,19 @@ private:
   
   bool m_hammers;
   bool m_paths;
+
+  int m_state_version;  // incremented whenever reactions, resources or inputs change (see cGenomeTestCache)
+  
+  // Reactions to test against an output, in reaction order, for each logic ID it can have (offset by one, so entry 0
+  // is for outputs with no consistent logic ID).  Reactions triggered by a logic-ID-only task are listed just for the
+  // IDs that perform it, along with the quality earned; all others are listed for every ID with a quality of -1, to
+  // be tested as usual.  Rebuilt by BuildTaskPlan whenever reactions are loaded or change task.
+  struct sPlannedReaction
+  {
+    int reaction_id;
+    double quality;
+  };
+  Apto::Array<Apto::Array<sPlannedReaction> > m_task_plan;
   
   cEnvironment(); // @not_implemented
   cEnvironment(const cEnvironment&); // @not_implemented
@@ -96,8 +109,10 @@ public:
 
   // Interaction with the organisms
   void SetupInputs(cAvidaContext& ctx, Apto::Array<int>& input_array, bool random = true) const;
-  void SetSpecificInputs(const Apto::Array<int> in_input_array) { m_use_specific_inputs = true; m_specific_inputs = in_input_array; }
-  void SetSpecificRandomMask(unsigned int mask) { m_mask = mask; }
+  void SetSpecificInputs(const Apto::Array<int> in_input_array)
+    { m_use_specific_inputs = true; m_specific_inputs = in_input_array; m_state_version++; }
+  void SetSpecificRandomMask(unsigned int mask) { m_mask = mask; m_state_version++; }
+  int GetStateVersion() const { return m_state_version; }
   void SwapInputs(cAvidaContext& ctx, Apto::Array<int>& src_input_array, Apto::Array<int>& dest_input_array) const;
 
 
@@ -183,6 +198,8 @@ private:
   bool LoadSetActive(cString desc, Feedback& feedback);
   
   bool LoadGradientResource(cString desc, Feedback& feedback);
+  
+  void BuildTaskPlan();
   double GetTaskProbability(cAvidaContext& ctx, cTaskContext& taskctx,
 
                             const tList<cReactionProcess>& req_proc, bool& force_mark_task) const;
@@ -274,6 +274,40 @@ void cEventList::Sync()
 }
 
 
+void cEventList::GetEventPositions(Apto::Array<int>& triggers, Apto::Array<double>& original_starts,
+                                   Apto::Array<double>& intervals, Apto::Array<double>& starts) const
+{
+  triggers.Resize(0);
+  original_starts.Resize(0);
+  intervals.Resize(0);
+  starts.Resize(0);
+  for (cEventListEntry* entry = m_head; entry != NULL; entry = entry->GetNext()) {
+    triggers.Push(entry->GetTrigger());
+    original_starts.Push(entry->GetOriginalStart());
+    intervals.Push(entry->GetInterval());
+    starts.Push(entry->GetStart());
+  }
+}
+
+
+void cEventList::SetEventPositions(const Apto::Array<int>& triggers, const Apto::Array<double>& original_starts,
+                                   const Apto::Array<double>& intervals, const Apto::Array<double>& starts)
+{
+  Apto::Array<bool> used(triggers.GetSize());
+  used.SetAll(false);
+  
+  for (cEventListEntry* entry = m_head; entry != NULL; entry = entry->GetNext()) {
+    for (int i = 0; i < triggers.GetSize(); i++) {
+      if (used[i] || triggers[i] != entry->GetTrigger() || original_starts[i] != entry->GetOriginalStart() ||
+          intervals[i] != entry->GetInterval()) continue;
+      entry->SetStart(starts[i]);
+      used[i] = true;
+      break;
+    }
+  }
+}
+
+
 void cEventList::SyncEvent(cEventListEntry* entry)
 {
   // Ignore events that are immdeiate
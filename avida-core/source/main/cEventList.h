@@ -111,6 +111,14 @@ public:
   void Process(cAvidaContext& ctx);
   void Sync(); // Get all events caught up.
   
+  // Checkpoint support.  Positions are recorded as (trigger, original start, interval, next start) for every event in
+  // list order.  Restoring matches each live event against the recorded ones, so that an event list reloaded from the
+  // same file resumes where the checkpoint left off; unmatched events are left to Sync.
+  void GetEventPositions(Apto::Array<int>& triggers, Apto::Array<double>& original_starts, Apto::Array<double>& intervals,
+                         Apto::Array<double>& starts) const;
+  void SetEventPositions(const Apto::Array<int>& triggers, const Apto::Array<double>& original_starts,
+                         const Apto::Array<double>& intervals, const Apto::Array<double>& starts);
+  
   void PrintEventList(std::ostream& os = std::cout);
   
   /**
@@ -165,6 +173,7 @@ private:
     
     void NextInterval(){ m_start += m_interval; }
     void Reset() { m_start = m_original_start; }
+    void SetStart(double start) { m_start = start; }
     
     // accessors
     cAction* GetAction() const { assert(m_action != NULL); return m_action; }
@@ -174,6 +183,7 @@ private:
     
     eTriggerType GetTrigger() const { return m_trigger; }
     double GetStart() const { return m_start; }
+    double GetOriginalStart() const { return m_original_start; }
     double GetInterval() const { return m_interval; }
     double GetStop() const { return m_stop; }
     
@@ -129,6 +129,7 @@ public:
 
   void UpdateCount(cAvidaContext& ctx);
   void StateAll();
+  bool SupportsBandedFlow() const { return false; }
   
   void SetGradInitialPlat(double plat_val) { m_initial_plat = plat_val; m_initial = true; }
   void SetGradPeakX(int peakx) { m_peakx = peakx; }
@@ -96,9 +96,10 @@ void cLandscape::Reset(const Genome& in_genome)
 
 double cLandscape::ProcessGenome(cAvidaContext& ctx, cTestCPU* testcpu, Genome& in_genome)
 {
-  testcpu->TestGenome(ctx, m_cpu_test_info, in_genome);
+  cGenomeTestCache::sResult result;
+  testcpu->TestGenomeCached(ctx, m_cpu_test_info, in_genome, result);
   
-  double test_fitness = m_cpu_test_info.GetColonyFitness();
+  double test_fitness = result.colony_fitness;
   
   total_fitness += test_fitness;
   total_sqr_fitness += test_fitness * test_fitness;
@@ -126,12 +127,12 @@ void cLandscape::ProcessBase(cAvidaContext& ctx, cTestCPU* testcpu)
 {
   // Collect info on base creature.
   
-  testcpu->TestGenome(ctx, m_cpu_test_info, base_genome);
+  cGenomeTestCache::sResult result;
+  testcpu->TestGenomeCached(ctx, m_cpu_test_info, base_genome, result);
   
-  cPhenotype & phenotype = m_cpu_test_info.GetColonyOrganism()->GetPhenotype();
-  base_fitness = m_cpu_test_info.GetColonyFitness();
-  base_merit = phenotype.GetMerit().GetDouble();
-  base_gestation = phenotype.GetGestationTime();
+  base_fitness = result.colony_fitness;
+  base_merit = result.colony_merit;
+  base_gestation = result.colony_gestation_time;
   
   peak_fitness = base_fitness;
   peak_genome = base_genome;
@@ -143,7 +144,7 @@ void cLandscape::ProcessBase(cAvidaContext& ctx, cTestCPU* testcpu)
 
 void cLandscape::Process(cAvidaContext& ctx)
 {
-  cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+  cTestCPU* testcpu = m_world->GetHardwareManager().AcquireTestCPU(ctx);
   
   // Get the info about the base creature.
   ProcessBase(ctx, testcpu);
@@ -151,7 +152,7 @@ void cLandscape::Process(cAvidaContext& ctx)
   // Now Process the new creature at the proper distance.
   Process_Body(ctx, testcpu, base_genome, distance, 0);
 
-  delete testcpu;
+  m_world->GetHardwareManager().ReleaseTestCPU(testcpu);
   
   // Calculate the complexity...
   
@@ -200,8 +201,7 @@ void cLandscape::Process_Body(cAvidaContext& ctx, cTestCPU* testcpu, Genome& cur
       
       mod_genome[line_num].SetOp(inst_num);
       if (cur_distance <= 1) {
-        ProcessGenome(ctx, testcpu, mg);
-        if (m_cpu_test_info.GetColonyFitness() >= neut_min) site_count[line_num]++;
+        if (ProcessGenome(ctx, testcpu, mg) >= neut_min) site_count[line_num]++;
       } else {
         Process_Body(ctx, testcpu, mg, cur_distance - 1, line_num + 1);
       }
@@ -219,7 +219,7 @@ void cLandscape::ProcessDump(cAvidaContext& ctx, Avida::Output::File& df)
   df.WriteComment("Detailed dump of the per-site, per-instruction fitness");
   df.WriteComment("values for the entire single-step landscape.");
   
-  cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+  cTestCPU* testcpu = m_world->GetHardwareManager().AcquireTestCPU(ctx);
   
   // Get the info about the base creature.
   ProcessBase(ctx, testcpu);
@@ -257,14 +257,14 @@ void cLandscape::ProcessDump(cAvidaContext& ctx, Avida::Output::File& df)
     mod_genome[line_num].SetOp(cur_inst);
   }
   
-  delete testcpu;
+  m_world->GetHardwareManager().ReleaseTestCPU(testcpu);
 }
 
 
 
 void cLandscape::ProcessDelete(cAvidaContext& ctx)
 {
-  cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+  cTestCPU* testcpu = m_world->GetHardwareManager().AcquireTestCPU(ctx);
 
   // Get the info about the base creature.
   ProcessBase(ctx, testcpu);
@@ -286,17 +286,16 @@ void cLandscape::ProcessDelete(cAvidaContext& ctx)
     int cur_inst = base_seq[line_num].GetOp();
     mod_genome.Remove(line_num);
     mod_seq = mod_genome;
-    ProcessGenome(ctx, testcpu, mg);
-    if (m_cpu_test_info.GetColonyFitness() >= neut_min) site_count[line_num]++;
+    if (ProcessGenome(ctx, testcpu, mg) >= neut_min) site_count[line_num]++;
     mod_genome.Insert(line_num, Instruction(cur_inst));
   }
   
-  delete testcpu;
+  m_world->GetHardwareManager().ReleaseTestCPU(testcpu);
 }
 
 void cLandscape::ProcessInsert(cAvidaContext& ctx)
 {
-  cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+  cTestCPU* testcpu = m_world->GetHardwareManager().AcquireTestCPU(ctx);
 
   // Get the info about the base creature.
   ProcessBase(ctx, testcpu);
@@ -320,25 +319,27 @@ void cLandscape::ProcessInsert(cAvidaContext& ctx)
     for (int inst_num = 0; inst_num < inst_size; inst_num++) {
       mod_genome.Insert(line_num, Instruction(inst_num));
       mod_seq = mod_genome;
-      ProcessGenome(ctx, testcpu, mg);
-      if (m_cpu_test_info.GetColonyFitness() >= neut_min) site_count[line_num]++;
+      if (ProcessGenome(ctx, testcpu, mg) >= neut_min) site_count[line_num]++;
       mod_genome.Remove(line_num);
     }
   }
 
-  delete testcpu;
+  m_world->GetHardwareManager().ReleaseTestCPU(testcpu);
 }
 
 // Prediction for a landscape where n sites are _randomized_.
 void cLandscape::PredictWProcess(cAvidaContext& ctx, Avida::Output::File& df, int update)
 {
-  cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+  cTestCPU* testcpu = m_world->GetHardwareManager().AcquireTestCPU(ctx);
 
   distance = 1;
   
   // Get the info about the base creature.
   ProcessBase(ctx, testcpu);
-  if (base_fitness == 0.0) return;
+  if (base_fitness == 0.0) {
+    m_world->GetHardwareManager().ReleaseTestCPU(testcpu);
+    return;
+  }
   
   BuildFitnessChart(ctx, testcpu);
   const int genome_size = fitness_chart.GetNumRows();
@@ -448,20 +449,23 @@ void cLandscape::PredictWProcess(cAvidaContext& ctx, Avida::Output::File& df, in
   }
   complexity = base_seq.GetSize() - total_entropy;
   
-  delete testcpu;
+  m_world->GetHardwareManager().ReleaseTestCPU(testcpu);
 }
 
 
 // Prediction for a landscape where n sites are _mutated_.
 void cLandscape::PredictNuProcess(cAvidaContext& ctx, Avida::Output::File& df, int update)
 {
-  cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+  cTestCPU* testcpu = m_world->GetHardwareManager().AcquireTestCPU(ctx);
 
   distance = 1;
   
   // Get the info about the base creature.
   ProcessBase(ctx, testcpu);
-  if (base_fitness == 0.0) return;
+  if (base_fitness == 0.0) {
+    m_world->GetHardwareManager().ReleaseTestCPU(testcpu);
+    return;
+  }
   
   BuildFitnessChart(ctx, testcpu);
   const int genome_size = fitness_chart.GetNumRows();
@@ -595,7 +599,7 @@ void cLandscape::PredictNuProcess(cAvidaContext& ctx, Avida::Output::File& df, i
   }
   complexity = base_seq.GetSize() - total_entropy;
   
-  delete testcpu;
+  m_world->GetHardwareManager().ReleaseTestCPU(testcpu);
 }
 
 
@@ -615,7 +619,7 @@ void cLandscape::SampleProcess(cAvidaContext& ctx)
   const InstructionSequence& base_seq = *base_seq_p;
   int genome_size = base_seq.GetSize();
 
-  cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+  cTestCPU* testcpu = m_world->GetHardwareManager().AcquireTestCPU(ctx);
   cInstSet& inst_set = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue());
   
   ProcessBase(ctx, testcpu);
@@ -640,7 +644,7 @@ void cLandscape::SampleProcess(cAvidaContext& ctx)
     mod_seq[line_num] = cur_inst;
   }
   
-  delete testcpu;
+  m_world->GetHardwareManager().ReleaseTestCPU(testcpu);
 }
 
 
@@ -658,7 +662,7 @@ void cLandscape::RandomProcess(cAvidaContext& ctx)
   const InstructionSequence& base_seq = *base_seq_p;
   int genome_size = base_seq.GetSize();
   
-  cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+  cTestCPU* testcpu = m_world->GetHardwareManager().AcquireTestCPU(ctx);
   cInstSet& inst_set = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue());
   ProcessBase(ctx, testcpu);
   
@@ -701,7 +705,7 @@ void cLandscape::RandomProcess(cAvidaContext& ctx)
   
   trials = cur_trial;
 
-  delete testcpu;
+  m_world->GetHardwareManager().ReleaseTestCPU(testcpu);
   
   m_num_found = total_found;
 }
@@ -734,8 +738,7 @@ void cLandscape::BuildFitnessChart(cAvidaContext& ctx, cTestCPU* testcpu)
       }
       
       mod_seq[line_num].SetOp(inst_num);
-      ProcessGenome(ctx, testcpu, mod_genome);
-      fitness_chart(line_num, inst_num) = m_cpu_test_info.GetColonyFitness();
+      fitness_chart(line_num, inst_num) = ProcessGenome(ctx, testcpu, mod_genome);
     }
     
     mod_seq[line_num].SetOp(cur_inst);
@@ -744,11 +747,14 @@ void cLandscape::BuildFitnessChart(cAvidaContext& ctx, cTestCPU* testcpu)
 
 void cLandscape::TestPairs(cAvidaContext& ctx)
 {
-  cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+  cTestCPU* testcpu = m_world->GetHardwareManager().AcquireTestCPU(ctx);
   cInstSet& inst_set = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue());
   
   ProcessBase(ctx, testcpu);
-  if (base_fitness == 0.0) return;
+  if (base_fitness == 0.0) {
+    m_world->GetHardwareManager().ReleaseTestCPU(testcpu);
+    return;
+  }
   
   BuildFitnessChart(ctx, testcpu);
   
@@ -781,16 +787,19 @@ void cLandscape::TestPairs(cAvidaContext& ctx)
     
     TestMutPair(ctx, testcpu, mod_genome, mut_lines[0], mut_lines[1], mut_insts[0], mut_insts[1]);
   }
-  delete testcpu;
+  m_world->GetHardwareManager().ReleaseTestCPU(testcpu);
 }
 
 
 void cLandscape::TestAllPairs(cAvidaContext& ctx)
 {
-  cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+  cTestCPU* testcpu = m_world->GetHardwareManager().AcquireTestCPU(ctx);
 
   ProcessBase(ctx, testcpu);
-  if (base_fitness == 0.0) return;
+  if (base_fitness == 0.0) {
+    m_world->GetHardwareManager().ReleaseTestCPU(testcpu);
+    return;
+  }
   
   BuildFitnessChart(ctx, testcpu);
   
@@ -821,13 +830,13 @@ void cLandscape::TestAllPairs(cAvidaContext& ctx)
     } // line2_num loop
   } // line1_num loop.
   
-  delete testcpu;
+  m_world->GetHardwareManager().ReleaseTestCPU(testcpu);
 }
 
 
 void cLandscape::HillClimb(cAvidaContext& ctx, Avida::Output::File& df)
 {
-  cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+  cTestCPU* testcpu = m_world->GetHardwareManager().AcquireTestCPU(ctx);
   Genome cur_genome(base_genome);
   Genome mg(base_genome);
   InstructionSequencePtr mg_seq_p;
@@ -902,7 +911,7 @@ void cLandscape::HillClimb(cAvidaContext& ctx, Avida::Output::File& df)
     gen++;
   }
 
-  delete testcpu;
+  m_world->GetHardwareManager().ReleaseTestCPU(testcpu);
 }
 
 
@@ -921,8 +930,9 @@ double cLandscape::TestMutPair(cAvidaContext& ctx, cTestCPU* testcpu, Genome& mo
 
   mod_seq[line1] = mut1;
   mod_seq[line2] = mut2;
-  testcpu->TestGenome(ctx, m_cpu_test_info, mod_genome);
-  double combo_fitness = m_cpu_test_info.GetColonyFitness() / base_fitness;
+  cGenomeTestCache::sResult result;
+  testcpu->TestGenomeCached(ctx, m_cpu_test_info, mod_genome, result);
+  double combo_fitness = result.colony_fitness / base_fitness;
   
   mod_seq[line1] = base_seq[line1];
   mod_seq[line2] = base_seq[line2];
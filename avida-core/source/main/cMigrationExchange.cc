@@ -0,0 +1,279 @@
+/*
+ *  cMigrationExchange.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cMigrationExchange.h"
+
+#include "avida/core/InstructionSequence.h"
+
+#include "cHardwareManager.h"
+
+#include <cstring>
+
+
+// cLocalMigrationHub
+// --------------------------------------------------------------------------------------------------------------
+
+class cLocalMigrationHub::cEndpoint : public cMigrationTransport
+{
+private:
+  cLocalMigrationHub* m_hub;
+  int m_id;
+
+public:
+  cEndpoint(cLocalMigrationHub* hub, int world_id) : m_hub(hub), m_id(world_id) { ; }
+
+  int GetWorldID() const { return m_id; }
+  int GetNumWorlds() const { return m_hub->GetNumWorlds(); }
+
+  void Send(int dst_world, int update, Apto::Array<unsigned char>& batch)
+  {
+    sMessage* msg = new sMessage;
+    msg->src = m_id;
+    msg->dst = dst_world;
+    msg->update = update;
+    msg->batch = batch;
+    batch.Resize(0);
+
+    Apto::MutexAutoLock lock(m_hub->m_mutex);
+    m_hub->m_messages.Push(msg);
+    m_hub->m_cond.Broadcast();
+  }
+
+  bool Receive(int src_world, int update, Apto::Array<unsigned char>& batch, bool block)
+  {
+    Apto::MutexAutoLock lock(m_hub->m_mutex);
+    while (!m_hub->take(src_world, m_id, update, batch)) {
+      if (!block) return false;
+      m_hub->m_cond.Wait(m_hub->m_mutex);
+    }
+    return true;
+  }
+};
+
+
+cLocalMigrationHub::cLocalMigrationHub(int num_worlds) : m_endpoints(num_worlds)
+{
+  for (int i = 0; i < num_worlds; i++) m_endpoints[i] = new cEndpoint(this, i);
+}
+
+cLocalMigrationHub::~cLocalMigrationHub()
+{
+  for (int i = 0; i < m_endpoints.GetSize(); i++) delete m_endpoints[i];
+  for (int i = 0; i < m_messages.GetSize(); i++) delete m_messages[i];
+}
+
+
+cMigrationTransport* cLocalMigrationHub::GetTransport(int world_id)
+{
+  return m_endpoints[world_id];
+}
+
+
+bool cLocalMigrationHub::take(int src, int dst, int update, Apto::Array<unsigned char>& batch)
+{
+  for (int i = 0; i < m_messages.GetSize(); i++) {
+    sMessage* msg = m_messages[i];
+    if (msg->src != src || msg->dst != dst || msg->update != update) continue;
+
+    batch = msg->batch;
+    delete msg;
+    m_messages[i] = m_messages[m_messages.GetSize() - 1];
+    m_messages.Resize(m_messages.GetSize() - 1);
+    return true;
+  }
+  return false;
+}
+
+
+// cMigrationExchange
+// --------------------------------------------------------------------------------------------------------------
+//
+// Each migrant is encoded as
+//
+//   hw_type, instset name length, instset name, sequence length, one byte per instruction,
+//   merit (8 bytes), lineage, x, y, generation
+//
+// with every integer (and length) written as a zig-zag varint.
+
+static inline void writeVarint(Apto::Array<unsigned char>& batch, long long value)
+{
+  unsigned long long v = ((unsigned long long)value << 1) ^ (unsigned long long)(value >> 63);
+  while (v >= 0x80) {
+    batch.Push((unsigned char)(v | 0x80));
+    v >>= 7;
+  }
+  batch.Push((unsigned char)v);
+}
+
+static inline bool readVarint(const Apto::Array<unsigned char>& batch, int& pos, long long& value)
+{
+  unsigned long long v = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (pos >= batch.GetSize()) return false;
+    const unsigned char byte = batch[pos++];
+    v |= (unsigned long long)(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      value = (long long)(v >> 1) ^ -(long long)(v & 1);
+      return true;
+    }
+  }
+  return false;
+}
+
+static inline bool readInt(const Apto::Array<unsigned char>& batch, int& pos, int& value)
+{
+  long long v = 0;
+  if (!readVarint(batch, pos, v)) return false;
+  value = (int)v;
+  return true;
+}
+
+
+cMigrationExchange::cMigrationExchange(cMigrationTransport* transport, int max_lag)
+  : m_transport(transport), m_max_lag((max_lag > 0) ? max_lag : 0)
+  , m_outgoing(transport->GetNumWorlds()), m_last_sent(-1), m_next_collect(-1)
+  , m_incoming(transport->GetNumWorlds()), m_received(transport->GetNumWorlds())
+  , m_migrants_sent(0), m_migrants_received(0), m_bytes_sent(0), m_waits(0), m_corrupt_batches(0)
+{
+  if (m_max_lag > transport->GetMaxLag()) m_max_lag = transport->GetMaxLag();
+  m_received.SetAll(false);
+}
+
+
+void cMigrationExchange::encode(Apto::Array<unsigned char>& batch, const sMigrant& migrant)
+{
+  ConstInstructionSequencePtr seq;
+  seq.DynamicCastFrom(migrant.genome.Representation());
+  assert(seq);
+
+  const Apto::String instset = migrant.genome.Properties().Get("instset").StringValue();
+  
+  writeVarint(batch, migrant.genome.HardwareType());
+  writeVarint(batch, instset.GetSize());
+  for (int i = 0; i < instset.GetSize(); i++) batch.Push((unsigned char)instset[i]);
+  writeVarint(batch, seq->GetSize());
+  for (int i = 0; i < seq->GetSize(); i++) batch.Push((unsigned char)(*seq)[i].GetOp());
+  
+  unsigned char merit[sizeof(double)];
+  memcpy(merit, &migrant.merit, sizeof(double));
+  for (int i = 0; i < (int)sizeof(double); i++) batch.Push(merit[i]);
+  
+  writeVarint(batch, migrant.lineage);
+  writeVarint(batch, migrant.x);
+  writeVarint(batch, migrant.y);
+  writeVarint(batch, migrant.generation);
+}
+
+
+bool cMigrationExchange::decode(const Apto::Array<unsigned char>& batch, int& pos, sMigrant& migrant)
+{
+  int hw_type = 0;
+  int instset_size = 0;
+  if (!readInt(batch, pos, hw_type) || !readInt(batch, pos, instset_size)) return false;
+  if (instset_size < 0 || pos + instset_size > batch.GetSize()) return false;
+  Apto::String instset;
+  for (int i = 0; i < instset_size; i++) instset += (char)batch[pos++];
+  
+  int seq_size = 0;
+  if (!readInt(batch, pos, seq_size) || seq_size < 0 || pos + seq_size > batch.GetSize()) return false;
+  InstructionSequencePtr seq(new InstructionSequence(seq_size));
+  for (int i = 0; i < seq_size; i++) (*seq)[i].SetOp(batch[pos++]);
+  
+  if (pos + (int)sizeof(double) > batch.GetSize()) return false;
+  unsigned char merit[sizeof(double)];
+  for (int i = 0; i < (int)sizeof(double); i++) merit[i] = batch[pos++];
+  memcpy(&migrant.merit, merit, sizeof(double));
+  
+  if (!readInt(batch, pos, migrant.lineage) || !readInt(batch, pos, migrant.x) || !readInt(batch, pos, migrant.y) ||
+      !readInt(batch, pos, migrant.generation)) return false;
+  
+  HashPropertyMap props;
+  cHardwareManager::SetupPropertyMap(props, instset);
+  migrant.genome = Genome(hw_type, props, seq);
+  return true;
+}
+
+
+void cMigrationExchange::Add(int dst_world, const sMigrant& migrant)
+{
+  assert(dst_world >= 0 && dst_world < m_outgoing.GetSize());
+  encode(m_outgoing[dst_world], migrant);
+  m_migrants_sent++;
+}
+
+
+void cMigrationExchange::FinishUpdate(int update)
+{
+  assert(update > m_last_sent);
+  if (m_next_collect < 0) m_next_collect = update;
+  
+  // Migrants sent back to this world (only possible in a world of one) are delivered along with everyone else's
+  for (int dst = 0; dst < m_outgoing.GetSize(); dst++) {
+    m_bytes_sent += m_outgoing[dst].GetSize();
+    m_transport->Send(dst, update, m_outgoing[dst]);
+    m_outgoing[dst].Resize(0);
+  }
+  m_last_sent = update;
+}
+
+
+void cMigrationExchange::collect(Apto::Array<sMigrant, Apto::Smart>& arrivals, bool drain)
+{
+  while (m_next_collect >= 0 && m_next_collect <= m_last_sent) {
+    // Wait for stragglers once this world would otherwise run more than the maximum lag ahead of them
+    const bool block = (drain || m_last_sent - m_next_collect >= m_max_lag);
+    
+    bool complete = true;
+    for (int src = 0; src < m_received.GetSize(); src++) {
+      if (m_received[src]) continue;
+      if (!m_transport->Receive(src, m_next_collect, m_incoming[src], false)) {
+        if (!block) {
+          complete = false;
+          continue;
+        }
+        m_waits++;
+        m_transport->Receive(src, m_next_collect, m_incoming[src], true);
+      }
+      m_received[src] = true;
+    }
+    if (!complete) break;
+    
+    for (int src = 0; src < m_incoming.GetSize(); src++) {
+      const Apto::Array<unsigned char>& batch = m_incoming[src];
+      int pos = 0;
+      while (pos < batch.GetSize()) {
+        sMigrant migrant;
+        if (!decode(batch, pos, migrant)) {
+          // The remainder of the batch cannot be framed; keep the migrants decoded so far and count the batch
+          m_corrupt_batches++;
+          break;
+        }
+        migrant.src_world = src;
+        migrant.src_update = m_next_collect;
+        arrivals.Push(migrant);
+        m_migrants_received++;
+      }
+      m_incoming[src].Resize(0);
+    }
+    
+    m_received.SetAll(false);
+    m_next_collect++;
+  }
+}
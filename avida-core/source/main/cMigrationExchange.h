@@ -0,0 +1,177 @@
+/*
+ *  cMigrationExchange.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cMigrationExchange_h
+#define cMigrationExchange_h
+
+#include "apto/core.h"
+#include "avida/core/Genome.h"
+
+#include <climits>
+
+using namespace Avida;
+
+
+// cMigrationTransport
+//
+// Moves batches of encoded migrants between worlds.  Every world sends exactly one batch (possibly empty) to every world,
+// itself included, per update.
+
+class cMigrationTransport
+{
+public:
+  virtual ~cMigrationTransport() { ; }
+
+  virtual int GetWorldID() const = 0;
+  virtual int GetNumWorlds() const = 0;
+
+  // Hands the batch for the given update off to dst_world; the contents of batch are consumed
+  virtual void Send(int dst_world, int update, Apto::Array<unsigned char>& batch) = 0;
+
+  // Retrieves the batch src_world sent for the given update.  Returns false if it has not arrived yet and block is not
+  // set; otherwise waits for it.
+  virtual bool Receive(int src_world, int update, Apto::Array<unsigned char>& batch, bool block) = 0;
+
+  // The largest lag under which the transport can still tell the batches in flight between two worlds apart
+  virtual int GetMaxLag() const { return INT_MAX; }
+};
+
+
+// cLocalMigrationHub
+//
+// An in-process transport connecting the worlds of a single process (each typically run on its own thread), so that
+// multi-world runs can be exercised without MPI or a cluster.  See GetTransport.
+
+class cLocalMigrationHub
+{
+private:
+  class cEndpoint;
+
+  struct sMessage
+  {
+    int src;
+    int dst;
+    int update;
+    Apto::Array<unsigned char> batch;
+  };
+
+  Apto::Mutex m_mutex;
+  Apto::ConditionVariable m_cond;
+  Apto::Array<sMessage*, Apto::Smart> m_messages;
+  Apto::Array<cEndpoint*> m_endpoints;
+
+
+  bool take(int src, int dst, int update, Apto::Array<unsigned char>& batch);
+
+  cLocalMigrationHub(); // @not_implemented
+  cLocalMigrationHub(const cLocalMigrationHub&); // @not_implemented
+  cLocalMigrationHub& operator=(const cLocalMigrationHub&); // @not_implemented
+
+public:
+  cLocalMigrationHub(int num_worlds);
+  ~cLocalMigrationHub();
+
+  int GetNumWorlds() const { return m_endpoints.GetSize(); }
+  cMigrationTransport* GetTransport(int world_id);
+};
+
+
+// cMigrationExchange
+//
+// Collects the organisms migrating out of a world into one compactly encoded batch per destination, exchanges the
+// batches once per update, and hands back the migrants that arrived from other worlds.
+//
+// With a maximum lag of zero, the migrants sent during an update are received by the end of that same update.  A lag
+// of k lets a world run up to k updates ahead: it only waits once it is about to get more than k updates ahead of the
+// migrants it has yet to receive.  Arrivals are always returned grouped by update, then by sending world, then in the
+// order they were sent, so a run does not depend on message timing beyond the choice of lag.  The lag is clamped to the
+// transport's GetMaxLag.
+
+class cMigrationExchange
+{
+public:
+  struct sMigrant
+  {
+    Genome genome;
+    double merit;
+    int lineage;
+    int x;
+    int y;
+    int generation;
+    int src_world;
+    int src_update;
+  };
+
+private:
+  cMigrationTransport* m_transport;
+  int m_max_lag;
+
+  Apto::Array<Apto::Array<unsigned char> > m_outgoing;
+  int m_last_sent;           // Last update whose batches have been sent
+  int m_next_collect;        // Oldest update whose batches have not all been received
+  Apto::Array<Apto::Array<unsigned char> > m_incoming;
+  Apto::Array<bool> m_received;
+
+  long long m_migrants_sent;
+  long long m_migrants_received;
+  long long m_bytes_sent;
+  int m_waits;
+  int m_corrupt_batches;
+
+
+  static void encode(Apto::Array<unsigned char>& batch, const sMigrant& migrant);
+  static bool decode(const Apto::Array<unsigned char>& batch, int& pos, sMigrant& migrant);
+
+  void collect(Apto::Array<sMigrant, Apto::Smart>& arrivals, bool drain);
+
+
+  cMigrationExchange(); // @not_implemented
+  cMigrationExchange(const cMigrationExchange&); // @not_implemented
+  cMigrationExchange& operator=(const cMigrationExchange&); // @not_implemented
+
+public:
+  cMigrationExchange(cMigrationTransport* transport, int max_lag);
+
+  int GetWorldID() const { return m_transport->GetWorldID(); }
+  int GetNumWorlds() const { return m_transport->GetNumWorlds(); }
+  int GetMaxLag() const { return m_max_lag; }
+  int GetLastUpdateSent() const { return m_last_sent; }  // -1 until the first batches are sent
+
+  // Queues a migrant for dst_world, to be sent with the rest of this update's batch
+  void Add(int dst_world, const sMigrant& migrant);
+
+  // Sends this update's batches, one to every world
+  void FinishUpdate(int update);
+
+  // Appends every migrant that can be delivered (blocking as needed to stay within the maximum lag) to arrivals
+  void Collect(Apto::Array<sMigrant, Apto::Smart>& arrivals) { collect(arrivals, false); }
+
+  // Waits for every batch sent to this world up to the last update it finished, appending their migrants to arrivals.
+  // Called once the run is over, so that no batch is left unreceived (and no sending world left waiting on it).
+  void Drain(Apto::Array<sMigrant, Apto::Smart>& arrivals) { collect(arrivals, true); }
+
+  long long GetMigrantsSent() const { return m_migrants_sent; }
+  long long GetMigrantsReceived() const { return m_migrants_received; }
+  long long GetBytesSent() const { return m_bytes_sent; }
+  int GetNumWaits() const { return m_waits; }  // Batches that had to be waited for
+  int GetNumCorruptBatches() const { return m_corrupt_batches; }  // Batches whose migrants could not all be decoded
+};
+
+#endif
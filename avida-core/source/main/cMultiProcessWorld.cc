@@ -28,8 +28,6 @@
 #endif
 
 #if BOOST_IS_AVAILABLE
-#include "avida/core/Sequence.h"
-
 #include "cOrganism.h"
 #include "cPhenotype.h"
 #include "cMerit.h"
@@ -38,12 +36,12 @@
 #include "cPopulationCell.h"
 #include "cMultiProcessWorld.h"
 #include "nGeometry.h"
+#include <list>
 #include <map>
 #include <functional>
 #include <iostream>
 #include <sstream>
 #include <cmath>
-#include <boost/optional.hpp>
 
 using namespace Avida;
 
@@ -52,40 +50,97 @@ using namespace Avida;
 static const char* UPDATE="mean update time [ut]";
 static const char* POSTUPDATE="mean post-update time [post]";
 static const char* CALCUPDATE="mean calc-update time [calc]";
+static const char* MIGRATIONWAITS="migrant batches waited for [waits]";
 
-/*! Message that is sent from one cMultiProcessWorld to another during organism
- migration.
+/*! Migration transport over MPI.
+ 
+ Each batch is a single non-blocking point-to-point message, tagged with the update it
+ was sent in.  Receives probe for the (source, update) pair they are waiting on, so
+ batches from worlds that have run ahead simply wait in MPI until they are needed.
+ 
+ Non-blocking collectives are not used here: with bounded-staleness migration the worlds
+ are at different updates, and collectives must be entered in the same order everywhere.
  */
-struct migration_message {
-	//! Default constructor.
-	migration_message() { }
+class cMPIMigrationTransport : public cMigrationTransport {
+private:
+	//! Tags wrap well within the range MPI guarantees.  The lag is held below this (see GetMaxLag), so
+	//! no two batches in flight between a pair of worlds share a tag.
+	static const int TAG_RANGE = 32768;
 	
-	//! Initializing constructor.
-	migration_message(cOrganism* org, const cPopulationCell& cell, double merit, int lineage)
-	: _merit(merit), _lineage(lineage) {
-		_genome = org->GetGenome().AsString();
-		cell.GetPosition(_x, _y);
-		_generation = org->GetPhenotype().GetGeneration();
+	struct pending_send {
+		MPI_Request request;
+		Apto::Array<unsigned char> buffer;
+	};
+	
+	boost::mpi::communicator& m_comm; //!< Communicator connecting the worlds.
+	std::list<pending_send> m_sends; //!< Sends still in flight, which own their buffers.
+	
+	//! Release the buffers of sends that have completed.
+	void reap_sends() {
+		std::list<pending_send>::iterator i=m_sends.begin();
+		while(i != m_sends.end()) {
+			int done=0;
+			MPI_Test(&i->request, &done, MPI_STATUS_IGNORE);
+			if(done) {
+				i = m_sends.erase(i);
+			} else {
+				++i;
+			}
+		}
 	}
-
-	//! Finish unpacking an organism from this message.
-	void unpack(cOrganism* org) {
-		org->UpdateMerit(cAvidaContext& ctx, _merit);
-		org->GetPhenotype().SetGeneration(_generation);
-	}	
 	
-	//! Serializer, used to (de)marshal organisms for migration.
-	template<class Archive>
-	void serialize(Archive & ar, const unsigned int version) {
-		ar & _genome & _merit & _lineage & _x & _y & _generation;
+public:
+	cMPIMigrationTransport(boost::mpi::communicator& comm) : m_comm(comm) { }
+	
+	/*! Destructor; completes every outstanding send.
+	 
+	 The final exchange in ~cMultiProcessWorld has every batch received before this point.  A send
+	 still unmatched (a world that never reached it) is cancelled rather than waited on forever.
+	 */
+	~cMPIMigrationTransport() {
+		for(std::list<pending_send>::iterator i=m_sends.begin(); i!=m_sends.end(); ++i) {
+			int done=0;
+			MPI_Test(&i->request, &done, MPI_STATUS_IGNORE);
+			if(!done) {
+				MPI_Cancel(&i->request);
+				MPI_Wait(&i->request, MPI_STATUS_IGNORE);
+			}
+		}
 	}
 	
-	std::string _genome; //!< Genome of the migrating organism.
-	double _merit; //!< Merit of this organism in its originating population.
-	int _lineage; //!< Lineage label of this organism in its orginating population.
-	int _x; //!< X-coordinate of the cell from which this migrant originated.
-	int _y; //!< Y-coordinate of the cell from which this migrant originated.
-	int _generation; //!< Generation of this organism.
+	int GetWorldID() const { return m_comm.rank(); }
+	int GetNumWorlds() const { return m_comm.size(); }
+	int GetMaxLag() const { return TAG_RANGE - 1; }
+	
+	void Send(int dst_world, int update, Apto::Array<unsigned char>& batch) {
+		reap_sends();
+		m_sends.push_back(pending_send());
+		pending_send& s = m_sends.back();
+		s.buffer = batch;
+		batch.Resize(0);
+		MPI_Isend(s.buffer.GetSize() ? &s.buffer[0] : NULL, s.buffer.GetSize(), MPI_BYTE, dst_world, update % TAG_RANGE,
+							(MPI_Comm)m_comm, &s.request);
+	}
+	
+	bool Receive(int src_world, int update, Apto::Array<unsigned char>& batch, bool block) {
+		const int tag = update % TAG_RANGE;
+		MPI_Status status;
+		if(block) {
+			MPI_Probe(src_world, tag, (MPI_Comm)m_comm, &status);
+		} else {
+			int arrived=0;
+			MPI_Iprobe(src_world, tag, (MPI_Comm)m_comm, &arrived, &status);
+			if(!arrived) {
+				return false;
+			}
+		}
+		
+		int count=0;
+		MPI_Get_count(&status, MPI_BYTE, &count);
+		batch.Resize(count);
+		MPI_Recv(count ? &batch[0] : NULL, count, MPI_BYTE, src_world, tag, (MPI_Comm)m_comm, MPI_STATUS_IGNORE);
+		return true;
+	}
 };
 
 
@@ -114,7 +169,15 @@ cMultiProcessWorld::cMultiProcessWorld(cAvidaConfig* cfg, const cString& cwd, bo
 , m_universe_dim(0)
 , m_universe_x(0)
 , m_universe_y(0)
-, m_universe_popsize(-1) {
+, m_universe_popsize(-1)
+, m_transport(new cMPIMigrationTransport(worldcomm))
+, m_migration(0) {
+	m_migration = new cMigrationExchange(m_transport, GetConfig().MP_MIGRATION_LAG.Get());
+	if(m_migration->GetMaxLag() < GetConfig().MP_MIGRATION_LAG.Get()) {
+		GetDriver().Feedback().Warning("MP_MIGRATION_LAG %d is more than MPI message tags can keep apart; using %d",
+																	 GetConfig().MP_MIGRATION_LAG.Get(), m_migration->GetMaxLag());
+	}
+	
 	if(GetConfig().BIRTH_METHOD.Get() == POSITION_OFFSPRING_RANDOM) {
 		// there are a couple bugs in spatial that still need to be worked out:
 		// specifically, what to do about size(1) universes?
@@ -132,6 +195,27 @@ cMultiProcessWorld::cMultiProcessWorld(cAvidaConfig* cfg, const cString& cwd, bo
 }
 
 
+/*! Destructor.
+ 
+ Performs a final exchange before the migration transport is torn down: every batch still
+ in flight to this world (up to MP_MIGRATION_LAG updates' worth) is received, and then every
+ world waits for the others to do the same, so that all sends have been matched.  Migrants
+ arriving after the final update can no longer be injected; they are reported instead.
+ */
+cMultiProcessWorld::~cMultiProcessWorld() {
+	if(m_migration->GetLastUpdateSent() >= 0) {
+		Apto::Array<cMigrationExchange::sMigrant, Apto::Smart> arrivals;
+		m_migration->Drain(arrivals);
+		m_mpi_world.barrier();
+		if(arrivals.GetSize() > 0) {
+			GetDriver().Feedback().Warning("%d migrants arrived after the final update and were not injected", arrivals.GetSize());
+		}
+	}
+	delete m_migration;
+	delete m_transport;
+}
+
+
 /*! Migrate this organism to a different world.
  
  If this method is called, it means that this organism is to be migrated to a
@@ -184,9 +268,14 @@ void cMultiProcessWorld::MigrateOrganism(cOrganism* org, const cPopulationCell&
 	assert(dst_world < m_mpi_world.size());
 	assert(dst_world >= 0);
 
-	// the tag is set to the number of messages previously sent; this is to allow
-	// the receiver to sort messages for consistency.
-	m_reqs.push_back(m_mpi_world.isend(dst_world, m_reqs.size(), migration_message(org, cell, merit.GetDouble(), lineage)));
+	// queue the migrant in the batch for its destination; batches are sent in ProcessPostUpdate.
+	cMigrationExchange::sMigrant migrant;
+	migrant.genome = org->GetGenome();
+	migrant.merit = merit.GetDouble();
+	migrant.lineage = lineage;
+	cell.GetPosition(migrant.x, migrant.y);
+	migrant.generation = org->GetPhenotype().GetGeneration();
+	m_migration->Add(dst_world, migrant);
 	
 	// stats tracking:
 	GetStats().OutgoingMigrant(org);
@@ -267,85 +356,61 @@ bool cMultiProcessWorld::IsWorldBoundary(const cPopulationCell& cell) {
  
  \todo What to do about cross-world lineage labels?
  
- \todo At the moment, this method forces synchronization on update boundaries across
- *all* worlds.  This could slow things down quite a bit, so we may need to consider a
- second mode that relaxes consistency in favor of speed.
+ With MP_MIGRATION_LAG set to 0 every world waits here for the migrants sent to it
+ during this update, as in a single synchronized universe.  Larger values let this
+ world run up to that many updates ahead of the migrants it has yet to receive.
  */
 void cMultiProcessWorld::ProcessPostUpdate(cAvidaContext& ctx) {
-	namespace mpi = boost::mpi;
-	using namespace boost;
-	
 	// restart the timer for this method, and get the elapsed time for the past update:
 	m_pf[UPDATE] = m_update_timer.elapsed();
 	m_post_update_timer.restart();
 	
-	// wait until we're sure that this process has sent all its messages:
-	mpi::wait_all(m_reqs.begin(), m_reqs.end());
-	m_reqs.clear();
-	
-	// at this point, we know that *this* process has sent everything.  but, we don't
-	// know if it's *received* everything.  so, we're going to put in a synchronization
-	// barrier, which means that every process must reach the barrier before any are allowed
-	// to proceed.  since we just finished waiting for all communication to complete,
-	// this means that all messages must have been received, too.
-	m_mpi_world.barrier();	
-	
-	// now, receive all the messages, but store them in order by source and tag:
-	typedef std::map<int,migration_message> rx_tag_t;
-	typedef std::map<int,rx_tag_t> rx_src_t;
-	rx_src_t recvd;
-	optional<mpi::status> s = m_mpi_world.iprobe(mpi::any_source,mpi::any_tag);
-	while(s.is_initialized()) {
-		migration_message msg;
-		m_mpi_world.recv(s->source(), s->tag(), msg);
-		recvd[s->source()][s->tag()] = msg;		
-		// any others?
-		s = m_mpi_world.iprobe(mpi::any_source,mpi::any_tag);		
+	// send this update's batches (one to every world, even if empty), then collect
+	// whatever has arrived.  with MP_MIGRATION_LAG 0 this waits for every world's batch
+	// for this update; otherwise only as long as needed to stay within the lag.
+	const int waits = m_migration->GetNumWaits();
+	const int corrupt = m_migration->GetNumCorruptBatches();
+	m_migration->FinishUpdate(GetStats().GetUpdate());
+	Apto::Array<cMigrationExchange::sMigrant, Apto::Smart> arrivals;
+	m_migration->Collect(arrivals);
+	if(m_migration->GetNumCorruptBatches() > corrupt) {
+		GetDriver().Feedback().Error("%d corrupt migrant batch(es) received by update %d; the migrants that could not be decoded were dropped",
+																 m_migration->GetNumCorruptBatches() - corrupt, GetStats().GetUpdate());
 	}
 	
-	// iterate over received messages in-order, injecting genomes into our population:
-	for(rx_src_t::iterator i=recvd.begin(); i!=recvd.end(); ++i) {
-		for(rx_tag_t::iterator j=i->second.begin(); j!=i->second.end(); ++j) {
-			//std::cerr << "**********  INJECTING *********** " << i->first << " " << j->first << std::endl;
-			// ok, add this migrant to the current population
-			migration_message& migrant = j->second;
-			int target_cell=-1;
-			
-			switch(GetConfig().BIRTH_METHOD.Get()) {
-				case POSITION_OFFSPRING_RANDOM: { // spatial
-					// invert the orginating cell
-					migrant._x = GetConfig().WORLD_X.Get() - migrant._x - 1;
-					migrant._y = GetConfig().WORLD_Y.Get() - migrant._y - 1;
-					target_cell = GetConfig().WORLD_Y.Get() * migrant._y + migrant._x;
-					break;
-				}
-				case POSITION_OFFSPRING_FULL_SOUP_RANDOM: { // mass action
-					target_cell = GetRandom().GetInt(GetPopulation().GetSize());
-					break;
-				}
-				default: {
-					GetDriver().RaiseFatalException(-1, "Avida-MP only supports BIRTH_METHODS 0 (POSITION_OFFSPRING_RANDOM) and 4 (POSITION_OFFSPRING_FULL_SOUP_RANDOM).");
-				}
+	// arrivals are ordered by update, source world, and send order, so injection is
+	// deterministic regardless of message timing:
+	for(int i=0; i<arrivals.GetSize(); ++i) {
+		cMigrationExchange::sMigrant& migrant = arrivals[i];
+		int target_cell=-1;
+		
+		switch(GetConfig().BIRTH_METHOD.Get()) {
+			case POSITION_OFFSPRING_RANDOM: { // spatial
+				// invert the orginating cell
+				migrant.x = GetConfig().WORLD_X.Get() - migrant.x - 1;
+				migrant.y = GetConfig().WORLD_Y.Get() - migrant.y - 1;
+				target_cell = GetConfig().WORLD_X.Get() * migrant.y + migrant.x;
+				break;
+			}
+			case POSITION_OFFSPRING_FULL_SOUP_RANDOM: { // mass action
+				target_cell = GetRandom().GetInt(GetPopulation().GetSize());
+				break;
+			}
+			default: {
+				GetDriver().RaiseFatalException(-1, "Avida-MP only supports BIRTH_METHODS 0 (POSITION_OFFSPRING_RANDOM) and 4 (POSITION_OFFSPRING_FULL_SOUP_RANDOM).");
 			}
-			
-			GetPopulation().InjectGenome(target_cell,
-																	 SRC_ORGANISM_RANDOM, // for right now, we'll treat this as a random organism injection
-																	 Genome(cString(migrant._genome.c_str())), // genome unpacked from message
-																	 ctx, migrant._lineage); // lineage label
-			// unpack the rest from the message:
-			migrant.unpack(GetPopulation().GetCell(target_cell).GetOrganism());
-			GetStats().IncomingMigrant(GetPopulation().GetCell(target_cell).GetOrganism());
 		}
+		
+		GetPopulation().InjectGenome(target_cell,
+																 Systematics::Source(Systematics::DUPLICATION, "migrant", true),
+																 migrant.genome, ctx, migrant.lineage);
+		cOrganism* org = GetPopulation().GetCell(target_cell).GetOrganism();
+		org->UpdateMerit(ctx, migrant.merit);
+		org->GetPhenotype().SetGeneration(migrant.generation);
+		GetStats().IncomingMigrant(org);
 	}
+	m_pf[MIGRATIONWAITS] = m_migration->GetNumWaits() - waits;
 	
-	// oh, sweet sanity; make sure that we actually processed all messages.
-	assert(!m_mpi_world.iprobe(mpi::any_source,mpi::any_tag).is_initialized());
-	
-	// finally, we need another barrier down here, in the off chance that one of the
-	// processes is really speedy and manages to migrate another org to this world
-	// before we finished the probe-loop.
-	m_mpi_world.barrier();
-
 	// record profiling stats:
 	m_pf[POSTUPDATE] = m_post_update_timer.elapsed();
 	GetStats().ProfilingData(m_pf);
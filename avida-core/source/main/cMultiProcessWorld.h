@@ -28,6 +28,7 @@
 #include <boost/timer.hpp>
 #include <vector>
 
+#include "cMigrationExchange.h"
 #include "cWorld.h"
 #include "cAvidaConfig.h"
 #include "cStats.h"
@@ -50,7 +51,8 @@ class cMultiProcessWorld : public cWorld
 	protected:
 		boost::mpi::environment& m_mpi_env; //!< MPI environment.
 		boost::mpi::communicator& m_mpi_world; //!< World-wide MPI communicator.
-		std::vector<boost::mpi::request> m_reqs; //!< Requests outstanding since the last ProcessPostUpdate.
+		cMigrationTransport* m_transport; //!< Moves batches of migrants between the worlds of the communicator.
+		cMigrationExchange* m_migration; //!< Batches outgoing migrants by destination, and collects arriving ones.
 		int m_universe_dim; //!< Dimension (x & y) of the universe (number of worlds along the side of a grid of worlds).
 		int m_universe_x; //!< X coordinate of this world.
 		int m_universe_y; //!< Y coordinate of this world.
@@ -69,7 +71,7 @@ class cMultiProcessWorld : public cWorld
 		static cMultiProcessWorld* Initialize(cAvidaConfig* cfg, const cString& cwd, boost::mpi::environment& env, boost::mpi::communicator& worldcomm);
 		
 		//! Destructor.
-		virtual ~cMultiProcessWorld() { }
+		virtual ~cMultiProcessWorld();
 		
 		//! Migrate this organism to a different world.
 		virtual void MigrateOrganism(cOrganism* org, const cPopulationCell& cell,
@@ -0,0 +1,746 @@
+/*
+ *  cOrgStatSweep.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cOrgStatSweep.h"
+
+#include "avida/core/Properties.h"
+#include "avida/private/systematics/GenomeTestMetrics.h"
+
+#include "apto/stat/Accumulator.h"
+
+#include "cAvidaContext.h"
+#include "cEnvironment.h"
+#include "cHardwareBase.h"
+#include "cOrganism.h"
+#include "cPhenotype.h"
+#include "cStats.h"
+#include "cWorld.h"
+
+#include <cfloat>
+#include <climits>
+#include <cmath>
+
+
+static const PropertyID s_prop_id_instset("instset");
+
+// Organisms per chunk when the sweep is threaded; fixed so that the order of the floating point sums (and thus the
+// results) does not depend on the number of threads
+static const int CHUNK_SIZE = 1024;
+
+
+void cOrgStatSweep::sPartial::Reset(int num_tasks, int num_reactions)
+{
+  fitness.Clear();
+  gestation.Clear();
+  merit.Clear();
+  age.Clear();
+  generation.Clear();
+  neutral_metric.Clear();
+  lineage_label.Clear();
+  copy_size.Clear();
+  exe_size.Clear();
+  mem_size.Clear();
+  copy_mut_rate.Clear();
+  log_copy_mut_rate.Clear();
+  div_mut_rate.Clear();
+  log_div_mut_rate.Clear();
+
+  num_breed_true = 0;
+  num_parasites = 0;
+  num_no_birth = 0;
+  num_multi_thread = 0;
+  num_single_thread = 0;
+  num_threads = 0;
+  num_modified = 0;
+
+  max_merit = 0;
+  max_fitness = 0;
+  max_gestation_time = 0;
+  max_genome_length = 0;
+  min_merit = FLT_MAX;
+  min_fitness = FLT_MAX;
+  min_gestation_time = INT_MAX;
+  min_genome_length = INT_MAX;
+
+  task_cur_count.Resize(num_tasks);
+  task_last_count.Resize(num_tasks);
+  task_cur_quality.Resize(num_tasks);
+  task_last_quality.Resize(num_tasks);
+  task_cur_max_quality.Resize(num_tasks);
+  task_last_max_quality.Resize(num_tasks);
+  task_exe_count.Resize(num_tasks);
+  tasks_host_current.Resize(num_tasks);
+  tasks_host_last.Resize(num_tasks);
+  tasks_parasite_current.Resize(num_tasks);
+  tasks_parasite_last.Resize(num_tasks);
+  task_internal_cur_count.Resize(num_tasks);
+  task_internal_last_count.Resize(num_tasks);
+  task_internal_cur_quality.Resize(num_tasks);
+  task_internal_last_quality.Resize(num_tasks);
+  task_internal_cur_max_quality.Resize(num_tasks);
+  task_internal_last_max_quality.Resize(num_tasks);
+
+  task_cur_count.SetAll(0);
+  task_last_count.SetAll(0);
+  task_cur_quality.SetAll(0);
+  task_last_quality.SetAll(0);
+  task_cur_max_quality.SetAll(0);
+  task_last_max_quality.SetAll(0);
+  task_exe_count.SetAll(0);
+  tasks_host_current.SetAll(0);
+  tasks_host_last.SetAll(0);
+  tasks_parasite_current.SetAll(0);
+  tasks_parasite_last.SetAll(0);
+  task_internal_cur_count.SetAll(0);
+  task_internal_last_count.SetAll(0);
+  task_internal_cur_quality.SetAll(0);
+  task_internal_last_quality.SetAll(0);
+  task_internal_cur_max_quality.SetAll(0);
+  task_internal_last_max_quality.SetAll(0);
+
+  reaction_cur_count.Resize(num_reactions);
+  reaction_last_count.Resize(num_reactions);
+  reaction_cur_add_reward.Resize(num_reactions);
+  reaction_last_add_reward.Resize(num_reactions);
+  reaction_exe_count.Resize(num_reactions);
+
+  reaction_cur_count.SetAll(0);
+  reaction_last_count.SetAll(0);
+  reaction_cur_add_reward.SetAll(0);
+  reaction_last_add_reward.SetAll(0);
+  reaction_exe_count.SetAll(0);
+
+  for (int i = 0; i < NUM_FT; i++) {
+    ft_fitness[i].Clear();
+    ft_gestation[i].Clear();
+    ft_merit[i].Clear();
+    ft_age[i].Clear();
+    ft_generation[i].Clear();
+  }
+  attacks.Clear();
+  kills.Clear();
+  for (int i = 0; i < NUM_MT; i++) {
+    mt_fitness[i].Clear();
+    mt_gestation[i].Clear();
+    mt_merit[i].Clear();
+    mt_age[i].Clear();
+    mt_generation[i].Clear();
+  }
+}
+
+
+// Starts from the current values in stats, which carry over those that are not cleared each update (e.g. the task and
+// reaction execution counts)
+void cOrgStatSweep::sPartial::Load(cStats& stats)
+{
+  fitness = stats.SumFitness();
+  gestation = stats.SumGestation();
+  merit = stats.SumMerit();
+  age = stats.SumCreatureAge();
+  generation = stats.SumGeneration();
+  neutral_metric = stats.SumNeutralMetric();
+  lineage_label = stats.SumLineageLabel();
+  copy_size = stats.SumCopySize();
+  exe_size = stats.SumExeSize();
+  mem_size = stats.SumMemSize();
+  copy_mut_rate = stats.SumCopyMutRate();
+  log_copy_mut_rate = stats.SumLogCopyMutRate();
+  div_mut_rate = stats.SumDivMutRate();
+  log_div_mut_rate = stats.SumLogDivMutRate();
+
+  task_cur_count = stats.task_cur_count;
+  task_last_count = stats.task_last_count;
+  task_cur_quality = stats.task_cur_quality;
+  task_last_quality = stats.task_last_quality;
+  task_cur_max_quality = stats.task_cur_max_quality;
+  task_last_max_quality = stats.task_last_max_quality;
+  task_exe_count = stats.task_exe_count;
+  tasks_host_current = stats.tasks_host_current;
+  tasks_host_last = stats.tasks_host_last;
+  tasks_parasite_current = stats.tasks_parasite_current;
+  tasks_parasite_last = stats.tasks_parasite_last;
+  task_internal_cur_count = stats.task_internal_cur_count;
+  task_internal_last_count = stats.task_internal_last_count;
+  task_internal_cur_quality = stats.task_internal_cur_quality;
+  task_internal_last_quality = stats.task_internal_last_quality;
+  task_internal_cur_max_quality = stats.task_internal_cur_max_quality;
+  task_internal_last_max_quality = stats.task_internal_last_max_quality;
+
+  reaction_cur_count = stats.m_reaction_cur_count;
+  reaction_last_count = stats.m_reaction_last_count;
+  reaction_cur_add_reward = stats.m_reaction_cur_add_reward;
+  reaction_last_add_reward = stats.m_reaction_last_add_reward;
+  reaction_exe_count = stats.m_reaction_exe_count;
+
+  ft_fitness[FT_PREY] = stats.SumPreyFitness();
+  ft_gestation[FT_PREY] = stats.SumPreyGestation();
+  ft_merit[FT_PREY] = stats.SumPreyMerit();
+  ft_age[FT_PREY] = stats.SumPreyCreatureAge();
+  ft_generation[FT_PREY] = stats.SumPreyGeneration();
+  ft_fitness[FT_PRED] = stats.SumPredFitness();
+  ft_gestation[FT_PRED] = stats.SumPredGestation();
+  ft_merit[FT_PRED] = stats.SumPredMerit();
+  ft_age[FT_PRED] = stats.SumPredCreatureAge();
+  ft_generation[FT_PRED] = stats.SumPredGeneration();
+  ft_fitness[FT_TOP_PRED] = stats.SumTopPredFitness();
+  ft_gestation[FT_TOP_PRED] = stats.SumTopPredGestation();
+  ft_merit[FT_TOP_PRED] = stats.SumTopPredMerit();
+  ft_age[FT_TOP_PRED] = stats.SumTopPredCreatureAge();
+  ft_generation[FT_TOP_PRED] = stats.SumTopPredGeneration();
+  attacks = stats.SumAttacks();
+  kills = stats.SumKills();
+
+  mt_fitness[MT_MALE] = stats.SumMaleFitness();
+  mt_gestation[MT_MALE] = stats.SumMaleGestation();
+  mt_merit[MT_MALE] = stats.SumMaleMerit();
+  mt_age[MT_MALE] = stats.SumMaleCreatureAge();
+  mt_generation[MT_MALE] = stats.SumMaleGeneration();
+  mt_fitness[MT_FEMALE] = stats.SumFemaleFitness();
+  mt_gestation[MT_FEMALE] = stats.SumFemaleGestation();
+  mt_merit[MT_FEMALE] = stats.SumFemaleMerit();
+  mt_age[MT_FEMALE] = stats.SumFemaleCreatureAge();
+  mt_generation[MT_FEMALE] = stats.SumFemaleGeneration();
+}
+
+
+void cOrgStatSweep::sPartial::Merge(const sPartial& other)
+{
+  fitness.Merge(other.fitness);
+  gestation.Merge(other.gestation);
+  merit.Merge(other.merit);
+  age.Merge(other.age);
+  generation.Merge(other.generation);
+  neutral_metric.Merge(other.neutral_metric);
+  lineage_label.Merge(other.lineage_label);
+  copy_size.Merge(other.copy_size);
+  exe_size.Merge(other.exe_size);
+  mem_size.Merge(other.mem_size);
+  copy_mut_rate.Merge(other.copy_mut_rate);
+  log_copy_mut_rate.Merge(other.log_copy_mut_rate);
+  div_mut_rate.Merge(other.div_mut_rate);
+  log_div_mut_rate.Merge(other.log_div_mut_rate);
+
+  num_breed_true += other.num_breed_true;
+  num_parasites += other.num_parasites;
+  num_no_birth += other.num_no_birth;
+  num_multi_thread += other.num_multi_thread;
+  num_single_thread += other.num_single_thread;
+  num_threads += other.num_threads;
+  num_modified += other.num_modified;
+
+  if (other.max_merit > max_merit) max_merit = other.max_merit;
+  if (other.max_fitness > max_fitness) max_fitness = other.max_fitness;
+  if (other.max_gestation_time > max_gestation_time) max_gestation_time = other.max_gestation_time;
+  if (other.max_genome_length > max_genome_length) max_genome_length = other.max_genome_length;
+  if (other.min_merit < min_merit) min_merit = other.min_merit;
+  if (other.min_fitness < min_fitness) min_fitness = other.min_fitness;
+  if (other.min_gestation_time < min_gestation_time) min_gestation_time = other.min_gestation_time;
+  if (other.min_genome_length < min_genome_length) min_genome_length = other.min_genome_length;
+
+  for (int j = 0; j < task_cur_count.GetSize(); j++) {
+    task_cur_count[j] += other.task_cur_count[j];
+    task_last_count[j] += other.task_last_count[j];
+    task_cur_quality[j] += other.task_cur_quality[j];
+    task_last_quality[j] += other.task_last_quality[j];
+    if (other.task_cur_max_quality[j] > task_cur_max_quality[j]) task_cur_max_quality[j] = other.task_cur_max_quality[j];
+    if (other.task_last_max_quality[j] > task_last_max_quality[j]) task_last_max_quality[j] = other.task_last_max_quality[j];
+    task_exe_count[j] += other.task_exe_count[j];
+    tasks_host_current[j] += other.tasks_host_current[j];
+    tasks_host_last[j] += other.tasks_host_last[j];
+    tasks_parasite_current[j] += other.tasks_parasite_current[j];
+    tasks_parasite_last[j] += other.tasks_parasite_last[j];
+    task_internal_cur_count[j] += other.task_internal_cur_count[j];
+    task_internal_last_count[j] += other.task_internal_last_count[j];
+    task_internal_cur_quality[j] += other.task_internal_cur_quality[j];
+    task_internal_last_quality[j] += other.task_internal_last_quality[j];
+    if (other.task_internal_cur_max_quality[j] > task_internal_cur_max_quality[j]) {
+      task_internal_cur_max_quality[j] = other.task_internal_cur_max_quality[j];
+    }
+    if (other.task_internal_last_max_quality[j] > task_internal_last_max_quality[j]) {
+      task_internal_last_max_quality[j] = other.task_internal_last_max_quality[j];
+    }
+  }
+
+  for (int j = 0; j < reaction_cur_count.GetSize(); j++) {
+    reaction_cur_count[j] += other.reaction_cur_count[j];
+    reaction_last_count[j] += other.reaction_last_count[j];
+    reaction_cur_add_reward[j] += other.reaction_cur_add_reward[j];
+    reaction_last_add_reward[j] += other.reaction_last_add_reward[j];
+    reaction_exe_count[j] += other.reaction_exe_count[j];
+  }
+
+  for (int i = 0; i < NUM_FT; i++) {
+    ft_fitness[i].Merge(other.ft_fitness[i]);
+    ft_gestation[i].Merge(other.ft_gestation[i]);
+    ft_merit[i].Merge(other.ft_merit[i]);
+    ft_age[i].Merge(other.ft_age[i]);
+    ft_generation[i].Merge(other.ft_generation[i]);
+  }
+  attacks.Merge(other.attacks);
+  kills.Merge(other.kills);
+  for (int i = 0; i < NUM_MT; i++) {
+    mt_fitness[i].Merge(other.mt_fitness[i]);
+    mt_gestation[i].Merge(other.mt_gestation[i]);
+    mt_merit[i].Merge(other.mt_merit[i]);
+    mt_age[i].Merge(other.mt_age[i]);
+    mt_generation[i].Merge(other.mt_generation[i]);
+  }
+}
+
+
+void cOrgStatSweep::sPartial::Store(cStats& stats) const
+{
+  stats.SumFitness() = fitness;
+  stats.SumGestation() = gestation;
+  stats.SumMerit() = merit;
+  stats.SumCreatureAge() = age;
+  stats.SumGeneration() = generation;
+  stats.SumNeutralMetric() = neutral_metric;
+  stats.SumLineageLabel() = lineage_label;
+  stats.SumCopySize() = copy_size;
+  stats.SumExeSize() = exe_size;
+  stats.SumMemSize() = mem_size;
+  stats.SumCopyMutRate() = copy_mut_rate;
+  stats.SumLogCopyMutRate() = log_copy_mut_rate;
+  stats.SumDivMutRate() = div_mut_rate;
+  stats.SumLogDivMutRate() = log_div_mut_rate;
+
+  stats.SetBreedTrueCreatures(num_breed_true);
+  stats.SetNumNoBirthCreatures(num_no_birth);
+  stats.SetNumParasites(num_parasites);
+  stats.SetNumSingleThreadCreatures(num_single_thread);
+  stats.SetNumMultiThreadCreatures(num_multi_thread);
+  stats.SetNumThreads(num_threads);
+  stats.SetNumModified(num_modified);
+
+  stats.SetMaxMerit(max_merit.GetDouble());
+  stats.SetMaxFitness(max_fitness);
+  stats.SetMaxGestationTime(max_gestation_time);
+  stats.SetMaxGenomeLength(max_genome_length);
+  stats.SetMinMerit(min_merit.GetDouble());
+  stats.SetMinFitness(min_fitness);
+  stats.SetMinGestationTime(min_gestation_time);
+  stats.SetMinGenomeLength(min_genome_length);
+
+  stats.task_cur_count = task_cur_count;
+  stats.task_last_count = task_last_count;
+  stats.task_cur_quality = task_cur_quality;
+  stats.task_last_quality = task_last_quality;
+  stats.task_cur_max_quality = task_cur_max_quality;
+  stats.task_last_max_quality = task_last_max_quality;
+  stats.task_exe_count = task_exe_count;
+  stats.tasks_host_current = tasks_host_current;
+  stats.tasks_host_last = tasks_host_last;
+  stats.tasks_parasite_current = tasks_parasite_current;
+  stats.tasks_parasite_last = tasks_parasite_last;
+  stats.task_internal_cur_count = task_internal_cur_count;
+  stats.task_internal_last_count = task_internal_last_count;
+  stats.task_internal_cur_quality = task_internal_cur_quality;
+  stats.task_internal_last_quality = task_internal_last_quality;
+  stats.task_internal_cur_max_quality = task_internal_cur_max_quality;
+  stats.task_internal_last_max_quality = task_internal_last_max_quality;
+
+  stats.m_reaction_cur_count = reaction_cur_count;
+  stats.m_reaction_last_count = reaction_last_count;
+  stats.m_reaction_cur_add_reward = reaction_cur_add_reward;
+  stats.m_reaction_last_add_reward = reaction_last_add_reward;
+  stats.m_reaction_exe_count = reaction_exe_count;
+
+  stats.SumPreyFitness() = ft_fitness[FT_PREY];
+  stats.SumPreyGestation() = ft_gestation[FT_PREY];
+  stats.SumPreyMerit() = ft_merit[FT_PREY];
+  stats.SumPreyCreatureAge() = ft_age[FT_PREY];
+  stats.SumPreyGeneration() = ft_generation[FT_PREY];
+  stats.SumPredFitness() = ft_fitness[FT_PRED];
+  stats.SumPredGestation() = ft_gestation[FT_PRED];
+  stats.SumPredMerit() = ft_merit[FT_PRED];
+  stats.SumPredCreatureAge() = ft_age[FT_PRED];
+  stats.SumPredGeneration() = ft_generation[FT_PRED];
+  stats.SumTopPredFitness() = ft_fitness[FT_TOP_PRED];
+  stats.SumTopPredGestation() = ft_gestation[FT_TOP_PRED];
+  stats.SumTopPredMerit() = ft_merit[FT_TOP_PRED];
+  stats.SumTopPredCreatureAge() = ft_age[FT_TOP_PRED];
+  stats.SumTopPredGeneration() = ft_generation[FT_TOP_PRED];
+  stats.SumAttacks() = attacks;
+  stats.SumKills() = kills;
+
+  stats.SumMaleFitness() = mt_fitness[MT_MALE];
+  stats.SumMaleGestation() = mt_gestation[MT_MALE];
+  stats.SumMaleMerit() = mt_merit[MT_MALE];
+  stats.SumMaleCreatureAge() = mt_age[MT_MALE];
+  stats.SumMaleGeneration() = mt_generation[MT_MALE];
+  stats.SumFemaleFitness() = mt_fitness[MT_FEMALE];
+  stats.SumFemaleGestation() = mt_gestation[MT_FEMALE];
+  stats.SumFemaleMerit() = mt_merit[MT_FEMALE];
+  stats.SumFemaleCreatureAge() = mt_age[MT_FEMALE];
+  stats.SumFemaleGeneration() = mt_generation[MT_FEMALE];
+}
+
+
+void cOrgStatSweep::Run(cAvidaContext& ctx, const Apto::Array<cOrganism*, Apto::Smart>& orgs,
+                        const Apto::Array<cPopulationOrgStatProviderPtr>& providers)
+{
+  cStats& stats = m_world->GetStats();
+  cAvidaConfig& config = m_world->GetConfig();
+
+  m_ctx = &ctx;
+  m_orgs = &orgs;
+  m_providers = &providers;
+
+  // Only gather the statistics that are in use (see cStats::RequireStats)
+  m_task_stats = stats.ShouldCollectStats(cStats::STATS_TASKS);
+  m_reaction_stats = stats.ShouldCollectStats(cStats::STATS_REACTIONS);
+  m_mut_rate_stats = stats.ShouldCollectStats(cStats::STATS_MUTATION_RATES);
+  m_ft_stats = (config.PRED_PREY_SWITCH.Get() == -2 || config.PRED_PREY_SWITCH.Get() > -1) &&
+    stats.ShouldCollectStats(cStats::STATS_FORAGE_TARGETS);
+  m_mt_stats = config.MATING_TYPES.Get() && stats.ShouldCollectStats(cStats::STATS_MATING_TYPES);
+  m_env_test_stats = stats.ShouldCollectEnvTestStats();
+
+  // Clear out organism sums...
+  stats.SumFitness().Clear();
+  stats.SumGestation().Clear();
+  stats.SumMerit().Clear();
+  stats.SumCreatureAge().Clear();
+  stats.SumGeneration().Clear();
+  stats.SumNeutralMetric().Clear();
+  stats.SumLineageLabel().Clear();
+  stats.SumCopyMutRate().Clear();
+  stats.SumDivMutRate().Clear();
+  stats.SumCopySize().Clear();
+  stats.SumExeSize().Clear();
+  stats.SumMemSize().Clear();
+
+  stats.ZeroTasks();
+  stats.ZeroReactions();
+
+  if (m_ft_stats) {
+    stats.SumPreyFitness().Clear();
+    stats.SumPreyGestation().Clear();
+    stats.SumPreyMerit().Clear();
+    stats.SumPreyCreatureAge().Clear();
+    stats.SumPreyGeneration().Clear();
+
+    stats.SumPredFitness().Clear();
+    stats.SumPredGestation().Clear();
+    stats.SumPredMerit().Clear();
+    stats.SumPredCreatureAge().Clear();
+    stats.SumPredGeneration().Clear();
+
+    stats.SumTopPredFitness().Clear();
+    stats.SumTopPredGestation().Clear();
+    stats.SumTopPredMerit().Clear();
+    stats.SumTopPredCreatureAge().Clear();
+    stats.SumTopPredGeneration().Clear();
+
+    stats.SumAttacks().Clear();
+    stats.SumKills().Clear();
+
+    stats.ZeroFTInst();
+    stats.ZeroGroupAttackInst();
+  }
+
+  if (m_mt_stats) {
+    stats.SumMaleFitness().Clear();
+    stats.SumMaleGestation().Clear();
+    stats.SumMaleMerit().Clear();
+    stats.SumMaleCreatureAge().Clear();
+    stats.SumMaleGeneration().Clear();
+
+    stats.SumFemaleFitness().Clear();
+    stats.SumFemaleGestation().Clear();
+    stats.SumFemaleMerit().Clear();
+    stats.SumFemaleCreatureAge().Clear();
+    stats.SumFemaleGeneration().Clear();
+
+    stats.ZeroMTInst();
+  }
+
+  for (int osp_idx = 0; osp_idx < providers.GetSize(); osp_idx++) providers[osp_idx]->UpdateReset();
+
+
+  const int num_orgs = orgs.GetSize();
+  m_chunk_size = CHUNK_SIZE;
+  const int num_chunks = (num_orgs + m_chunk_size - 1) / m_chunk_size;
+  const bool threaded = (m_band_pool && m_band_threads > 1 && num_chunks > 1);
+
+  // Partial 0 is kept even for an empty population, so that the stats still receive the cleared values
+  const int num_partials = Apto::Max(num_chunks, 1);
+  if (m_partials.GetSize() < num_partials) m_partials.Resize(num_partials);
+  const int num_tasks = m_world->GetEnvironment().GetNumTasks();
+  const int num_reactions = m_world->GetEnvironment().GetNumReactions();
+  for (int i = 0; i < num_partials; i++) m_partials[i].Reset(num_tasks, num_reactions);
+  m_partials[0].Load(stats);
+
+  // Ordered reductions run alongside the serial pass, or ahead of the chunks when threaded (before the ages change)
+  const bool ordered = (providers.GetSize() > 0 || m_ft_stats || m_mt_stats || m_env_test_stats);
+  m_inline_ordered = (ordered && !threaded);
+  if (ordered && threaded) {
+    for (int i = 0; i < num_orgs; i++) processOrdered(orgs[i]);
+  }
+
+  if (threaded) m_band_pool->Run(*this, num_chunks, 0, m_band_threads);
+  else if (num_chunks > 0) ProcessBand(0, num_chunks);
+
+  for (int i = 1; i < num_chunks; i++) m_partials[0].Merge(m_partials[i]);
+  m_partials[0].Store(stats);
+
+  m_ctx = NULL;
+  m_orgs = NULL;
+  m_providers = NULL;
+}
+
+
+void cOrgStatSweep::ProcessBand(int chunk_begin, int chunk_end)
+{
+  const int num_orgs = m_orgs->GetSize();
+  for (int chunk = chunk_begin; chunk < chunk_end; chunk++) {
+    sPartial& partial = m_partials[chunk];
+    const int org_end = Apto::Min((chunk + 1) * m_chunk_size, num_orgs);
+    for (int i = chunk * m_chunk_size; i < org_end; i++) {
+      cOrganism* organism = (*m_orgs)[i];
+      if (m_inline_ordered) processOrdered(organism);
+      processOrganism(partial, organism);
+    }
+  }
+}
+
+
+// Handles the reductions that must see the organisms in population order, on the calling thread
+void cOrgStatSweep::processOrdered(cOrganism* organism)
+{
+  cStats& stats = m_world->GetStats();
+
+  for (int osp_idx = 0; osp_idx < m_providers->GetSize(); osp_idx++) {
+    (*m_providers)[osp_idx]->HandleOrganism(organism);
+  }
+
+  const cPhenotype& phenotype = organism->GetPhenotype();
+
+  if (m_env_test_stats) {
+    Systematics::GroupPtr genotype = organism->SystematicsGroup("genotype");
+    Systematics::GenomeTestMetricsPtr metrics(Systematics::GenomeTestMetrics::GetMetrics(m_world, *m_ctx, genotype));
+    const Apto::Array<int>& test_task_counts = metrics->GetTaskCounts();
+
+    for (int j = 0; j < m_world->GetEnvironment().GetNumTasks(); j++) if (test_task_counts[j] > 0) stats.AddTestTask(j);
+  }
+
+  if (!m_ft_stats && !m_mt_stats) return;
+
+  const cString inst_set((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
+
+  if (m_ft_stats) {
+    if (organism->IsPreyFT()) {
+      Apto::Array<Apto::Stat::Accumulator<int> >& prey_inst_exe_counts = stats.InstPreyExeCountsForInstSet(inst_set);
+      for (int j = 0; j < phenotype.GetLastInstCount().GetSize(); j++) {
+        prey_inst_exe_counts[j].Add(phenotype.GetLastInstCount()[j]);
+      }
+      Apto::Array<Apto::Stat::Accumulator<int> >& prey_from_sensor_exec_counts = stats.InstPreyFromSensorExeCountsForInstSet(inst_set);
+      for (int j = 0; j < phenotype.GetLastFromSensorInstCount().GetSize(); j++) {
+        prey_from_sensor_exec_counts[j].Add(phenotype.GetLastFromSensorInstCount()[j]);
+      }
+    }
+    else if (organism->IsPredFT()) {
+      Apto::Array<Apto::Stat::Accumulator<int> >& pred_inst_exe_counts = stats.InstPredExeCountsForInstSet(inst_set);
+      for (int j = 0; j < phenotype.GetLastInstCount().GetSize(); j++) {
+        pred_inst_exe_counts[j].Add(phenotype.GetLastInstCount()[j]);
+      }
+      Apto::Array<Apto::Stat::Accumulator<int> >& pred_from_sensor_exec_counts = stats.InstPredFromSensorExeCountsForInstSet(inst_set);
+      for (int j = 0; j < phenotype.GetLastFromSensorInstCount().GetSize(); j++) {
+        pred_from_sensor_exec_counts[j].Add(phenotype.GetLastFromSensorInstCount()[j]);
+      }
+      Apto::Array<cString>& att_inst = stats.GetGroupAttackInsts(inst_set);
+      for (int k = 0; k < att_inst.GetSize(); k++) {
+        Apto::Array<Apto::Stat::Accumulator<int> >& group_attack_inst_exe_counts = stats.ExecCountsForGroupAttackInst(inst_set, att_inst[k]);
+        for (int j = 0; j < phenotype.GetLastGroupAttackInstCount()[k].GetSize(); j++) {
+          group_attack_inst_exe_counts[j].Add(phenotype.GetLastGroupAttackInstCount()[k][j]);
+        }
+      }
+    }
+    else {
+      Apto::Array<Apto::Stat::Accumulator<int> >& tpred_inst_exe_counts = stats.InstTopPredExeCountsForInstSet(inst_set);
+      for (int j = 0; j < phenotype.GetLastInstCount().GetSize(); j++) {
+        tpred_inst_exe_counts[j].Add(phenotype.GetLastInstCount()[j]);
+      }
+      Apto::Array<Apto::Stat::Accumulator<int> >& tpred_from_sensor_exec_counts = stats.InstTopPredFromSensorExeCountsForInstSet(inst_set);
+      for (int j = 0; j < phenotype.GetLastFromSensorInstCount().GetSize(); j++) {
+        tpred_from_sensor_exec_counts[j].Add(phenotype.GetLastFromSensorInstCount()[j]);
+      }
+      Apto::Array<cString>& att_inst = stats.GetGroupAttackInsts(inst_set);
+      for (int k = 0; k < att_inst.GetSize(); k++) {
+        Apto::Array<Apto::Stat::Accumulator<int> >& group_attack_inst_exe_counts = stats.ExecCountsForGroupAttackInst(inst_set, att_inst[k]);
+        for (int j = 0; j < phenotype.GetLastTopPredGroupAttackInstCount()[k].GetSize(); j++) {
+          group_attack_inst_exe_counts[j].Add(phenotype.GetLastTopPredGroupAttackInstCount()[k][j]);
+        }
+      }
+    }
+  }
+
+  if (m_mt_stats) {
+    if (phenotype.GetMatingType() == MATING_TYPE_MALE) {
+      Apto::Array<Apto::Stat::Accumulator<int> >& male_inst_exe_counts = stats.InstMaleExeCountsForInstSet(inst_set);
+      for (int j = 0; j < phenotype.GetLastInstCount().GetSize(); j++) {
+        male_inst_exe_counts[j].Add(phenotype.GetLastInstCount()[j]);
+      }
+    }
+    else if (phenotype.GetMatingType() == MATING_TYPE_FEMALE) {
+      Apto::Array<Apto::Stat::Accumulator<int> >& female_inst_exe_counts = stats.InstFemaleExeCountsForInstSet(inst_set);
+      for (int j = 0; j < phenotype.GetLastInstCount().GetSize(); j++) {
+        female_inst_exe_counts[j].Add(phenotype.GetLastInstCount()[j]);
+      }
+    }
+  }
+}
+
+
+// Reduces a single organism into partial; only reads the organism (apart from its age) so chunks may run concurrently
+void cOrgStatSweep::processOrganism(sPartial& partial, cOrganism* organism)
+{
+  cPhenotype& phenotype = organism->GetPhenotype();
+  const cMerit cur_merit = phenotype.GetMerit();
+  const double cur_fitness = phenotype.GetFitness();
+  const int cur_gestation_time = phenotype.GetGestationTime();
+  const int cur_genome_length = phenotype.GetGenomeLength();
+
+  partial.fitness.Add(cur_fitness);
+  partial.merit.Add(cur_merit.GetDouble());
+  partial.gestation.Add(cur_gestation_time);
+  partial.age.Add(phenotype.GetAge());
+  partial.generation.Add(phenotype.GetGeneration());
+  partial.neutral_metric.Add(phenotype.GetNeutralMetric());
+  partial.lineage_label.Add(organism->GetLineageLabel());
+  if (m_mut_rate_stats) {
+    partial.copy_mut_rate.Push(organism->MutationRates().GetCopyMutProb());
+    partial.log_copy_mut_rate.Push(log(organism->MutationRates().GetCopyMutProb()));
+    partial.div_mut_rate.Push(organism->MutationRates().GetDivMutProb() / phenotype.GetDivType());
+    partial.log_div_mut_rate.Push(log(organism->MutationRates().GetDivMutProb() / phenotype.GetDivType()));
+  }
+  partial.copy_size.Add(phenotype.GetCopiedSize());
+  partial.exe_size.Add(phenotype.GetExecutedSize());
+
+  if (cur_merit > partial.max_merit) partial.max_merit = cur_merit;
+  if (cur_fitness > partial.max_fitness) partial.max_fitness = cur_fitness;
+  if (cur_gestation_time > partial.max_gestation_time) partial.max_gestation_time = cur_gestation_time;
+  if (cur_genome_length > partial.max_genome_length) partial.max_genome_length = cur_genome_length;
+
+  if (cur_merit < partial.min_merit) partial.min_merit = cur_merit;
+  if (cur_fitness < partial.min_fitness) partial.min_fitness = cur_fitness;
+  if (cur_gestation_time < partial.min_gestation_time) partial.min_gestation_time = cur_gestation_time;
+  if (cur_genome_length < partial.min_genome_length) partial.min_genome_length = cur_genome_length;
+
+  // Test what tasks this creatures has completed.
+  const int num_tasks = (m_task_stats) ? partial.task_cur_count.GetSize() : 0;
+  for (int j = 0; j < num_tasks; j++) {
+    if (phenotype.GetCurTaskCount()[j] > 0) {
+      const double quality = phenotype.GetCurTaskQuality()[j];
+      partial.task_cur_count[j]++;
+      partial.task_cur_quality[j] += quality;
+      if (quality > partial.task_cur_max_quality[j]) partial.task_cur_max_quality[j] = quality;
+    }
+
+    if (phenotype.GetLastTaskCount()[j] > 0) {
+      const double quality = phenotype.GetLastTaskQuality()[j];
+      partial.task_last_count[j]++;
+      partial.task_last_quality[j] += quality;
+      if (quality > partial.task_last_max_quality[j]) partial.task_last_max_quality[j] = quality;
+      partial.task_exe_count[j] += phenotype.GetLastTaskCount()[j];
+    }
+
+    if (phenotype.GetCurHostTaskCount()[j] > 0) partial.tasks_host_current[j]++;
+    if (phenotype.GetLastHostTaskCount()[j] > 0) partial.tasks_host_last[j]++;
+    if (phenotype.GetCurParasiteTaskCount()[j] > 0) partial.tasks_parasite_current[j]++;
+    if (phenotype.GetLastParasiteTaskCount()[j] > 0) partial.tasks_parasite_last[j]++;
+
+    if (phenotype.GetCurInternalTaskCount()[j] > 0) {
+      const double quality = phenotype.GetCurInternalTaskQuality()[j];
+      partial.task_internal_cur_count[j]++;
+      partial.task_internal_cur_quality[j] += quality;
+      if (quality > partial.task_internal_cur_max_quality[j]) partial.task_internal_cur_max_quality[j] = quality;
+    }
+
+    if (phenotype.GetLastInternalTaskCount()[j] > 0) {
+      const double quality = phenotype.GetLastInternalTaskQuality()[j];
+      partial.task_internal_last_count[j]++;
+      partial.task_internal_last_quality[j] += quality;
+      if (quality > partial.task_internal_last_max_quality[j]) partial.task_internal_last_max_quality[j] = quality;
+    }
+  }
+
+  // Record what add bonuses this organism garnered for different reactions
+  const int num_reactions = (m_reaction_stats) ? partial.reaction_cur_count.GetSize() : 0;
+  for (int j = 0; j < num_reactions; j++) {
+    if (phenotype.GetCurReactionCount()[j] > 0) {
+      partial.reaction_cur_count[j]++;
+      partial.reaction_cur_add_reward[j] += phenotype.GetCurReactionAddReward()[j];
+    }
+
+    if (phenotype.GetLastReactionCount()[j] > 0) {
+      partial.reaction_last_count[j]++;
+      partial.reaction_exe_count[j] += phenotype.GetLastReactionCount()[j];
+      partial.reaction_last_add_reward[j] += phenotype.GetLastReactionAddReward()[j];
+    }
+  }
+
+  // Increment the counts for all qualities the organism has...
+  partial.num_parasites += organism->GetNumParasites();
+  if (phenotype.ParentTrue()) partial.num_breed_true++;
+  if (phenotype.GetNumDivides() == 0) partial.num_no_birth++;
+  if (phenotype.IsMultiThread()) partial.num_multi_thread++;
+  else partial.num_single_thread++;
+
+  if (phenotype.IsModified()) partial.num_modified++;
+
+  cHardwareBase& hardware = organism->GetHardware();
+  partial.mem_size.Add(hardware.GetMemory().GetSize());
+  partial.num_threads += hardware.GetNumThreads();
+
+  // Increment the age of this organism.
+  phenotype.IncAge();
+
+  // The forage target and mating type breakdowns have always been taken after the age increment
+  if (m_ft_stats) {
+    int ft = FT_TOP_PRED;
+    if (organism->IsPreyFT()) ft = FT_PREY;
+    else if (organism->IsPredFT()) ft = FT_PRED;
+
+    partial.ft_fitness[ft].Add(cur_fitness);
+    partial.ft_gestation[ft].Add(cur_gestation_time);
+    partial.ft_merit[ft].Add(cur_merit.GetDouble());
+    partial.ft_age[ft].Add(phenotype.GetAge());
+    partial.ft_generation[ft].Add(phenotype.GetGeneration());
+    if (ft != FT_PREY) {
+      partial.attacks.Add(phenotype.GetLastAttacks());
+      partial.kills.Add(phenotype.GetLastKills());
+    }
+  }
+
+  if (m_mt_stats) {
+    int mt = -1;
+    if (phenotype.GetMatingType() == MATING_TYPE_MALE) mt = MT_MALE;
+    else if (phenotype.GetMatingType() == MATING_TYPE_FEMALE) mt = MT_FEMALE;
+
+    if (mt >= 0) {
+      partial.mt_fitness[mt].Add(cur_fitness);
+      partial.mt_gestation[mt].Add(cur_gestation_time);
+      partial.mt_merit[mt].Add(cur_merit.GetDouble());
+      partial.mt_age[mt].Add(phenotype.GetAge());
+      partial.mt_generation[mt].Add(phenotype.GetGeneration());
+    }
+  }
+}
@@ -0,0 +1,175 @@
+/*
+ *  cOrgStatSweep.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cOrgStatSweep_h
+#define cOrgStatSweep_h
+
+#include "apto/core.h"
+
+#include "cDoubleSum.h"
+#include "cMerit.h"
+#include "cPopulation.h"
+#include "cRowBandPool.h"
+#include "cRunningStats.h"
+
+class cAvidaContext;
+class cOrganism;
+class cStats;
+class cWorld;
+
+
+// cOrgStatSweep
+//
+// Gathers the per-organism statistics at the end of each update in a single pass over the live organisms, incrementing
+// organism ages along the way.  The organisms are split into fixed size chunks, each reduced into its own partial sums,
+// and the partials are then merged in chunk order.  The chunks are the same whether they are processed serially or by
+// the world's shared cRowBandPool, so the results do not depend on the number of threads.
+//
+// Statistics groups that no output has asked for (see cStats::RequireStats) are skipped.
+//
+// Instruction count accumulators and the org stat providers cannot be merged, so they are handed each organism in
+// population order on the calling thread (inline with the serial pass, or just ahead of the threaded one).
+
+class cOrgStatSweep : public cRowBandPool::cJob
+{
+private:
+  enum { FT_PREY = 0, FT_PRED, FT_TOP_PRED, NUM_FT };
+  enum { MT_MALE = 0, MT_FEMALE, NUM_MT };
+
+  struct sPartial
+  {
+    cDoubleSum fitness;
+    cDoubleSum gestation;
+    cDoubleSum merit;
+    cDoubleSum age;
+    cDoubleSum generation;
+    cDoubleSum neutral_metric;
+    cDoubleSum lineage_label;
+    cDoubleSum copy_size;
+    cDoubleSum exe_size;
+    cDoubleSum mem_size;
+    cRunningStats copy_mut_rate;
+    cRunningStats log_copy_mut_rate;
+    cRunningStats div_mut_rate;
+    cRunningStats log_div_mut_rate;
+
+    int num_breed_true;
+    int num_parasites;
+    int num_no_birth;
+    int num_multi_thread;
+    int num_single_thread;
+    int num_threads;
+    int num_modified;
+
+    cMerit max_merit;
+    double max_fitness;
+    int max_gestation_time;
+    int max_genome_length;
+    cMerit min_merit;
+    double min_fitness;
+    int min_gestation_time;
+    int min_genome_length;
+
+    Apto::Array<int> task_cur_count;
+    Apto::Array<int> task_last_count;
+    Apto::Array<double> task_cur_quality;
+    Apto::Array<double> task_last_quality;
+    Apto::Array<double> task_cur_max_quality;
+    Apto::Array<double> task_last_max_quality;
+    Apto::Array<int> task_exe_count;
+    Apto::Array<int> tasks_host_current;
+    Apto::Array<int> tasks_host_last;
+    Apto::Array<int> tasks_parasite_current;
+    Apto::Array<int> tasks_parasite_last;
+    Apto::Array<int> task_internal_cur_count;
+    Apto::Array<int> task_internal_last_count;
+    Apto::Array<double> task_internal_cur_quality;
+    Apto::Array<double> task_internal_last_quality;
+    Apto::Array<double> task_internal_cur_max_quality;
+    Apto::Array<double> task_internal_last_max_quality;
+
+    Apto::Array<int> reaction_cur_count;
+    Apto::Array<int> reaction_last_count;
+    Apto::Array<double> reaction_cur_add_reward;
+    Apto::Array<double> reaction_last_add_reward;
+    Apto::Array<int> reaction_exe_count;
+
+    // Forage target (prey, predator, top predator) and mating type (male, female) breakdowns
+    cDoubleSum ft_fitness[NUM_FT];
+    cDoubleSum ft_gestation[NUM_FT];
+    cDoubleSum ft_merit[NUM_FT];
+    cDoubleSum ft_age[NUM_FT];
+    cDoubleSum ft_generation[NUM_FT];
+    cDoubleSum attacks;
+    cDoubleSum kills;
+    cDoubleSum mt_fitness[NUM_MT];
+    cDoubleSum mt_gestation[NUM_MT];
+    cDoubleSum mt_merit[NUM_MT];
+    cDoubleSum mt_age[NUM_MT];
+    cDoubleSum mt_generation[NUM_MT];
+
+    void Reset(int num_tasks, int num_reactions);
+    void Load(cStats& stats);
+    void Merge(const sPartial& other);
+    void Store(cStats& stats) const;
+  };
+
+  cWorld* m_world;
+  cAvidaContext* m_ctx;
+  const Apto::Array<cOrganism*, Apto::Smart>* m_orgs;
+  const Apto::Array<cPopulationOrgStatProviderPtr>* m_providers;
+  cRowBandPool* m_band_pool;
+  int m_band_threads;
+
+  bool m_task_stats;
+  bool m_reaction_stats;
+  bool m_mut_rate_stats;
+  bool m_ft_stats;
+  bool m_mt_stats;
+  bool m_env_test_stats;
+  bool m_inline_ordered;
+  int m_chunk_size;
+
+  Apto::Array<sPartial, Apto::ManagedPointer> m_partials;
+
+
+  void processOrdered(cOrganism* organism);
+  void processOrganism(sPartial& partial, cOrganism* organism);
+
+
+  cOrgStatSweep(); // @not_implemented
+  cOrgStatSweep(const cOrgStatSweep&); // @not_implemented
+  cOrgStatSweep& operator=(const cOrgStatSweep&); // @not_implemented
+
+public:
+  cOrgStatSweep(cWorld* world)
+    : m_world(world), m_ctx(NULL), m_orgs(NULL), m_providers(NULL), m_band_pool(NULL), m_band_threads(0) { ; }
+
+  // Process the chunks on up to num_threads workers of pool (NULL or a single thread processes them serially)
+  void SetBandPool(cRowBandPool* pool, int num_threads) { m_band_pool = pool; m_band_threads = num_threads; }
+
+  // Replaces the organism statistics in cStats with those of the given organisms, and increments each organism's age
+  void Run(cAvidaContext& ctx, const Apto::Array<cOrganism*, Apto::Smart>& orgs,
+           const Apto::Array<cPopulationOrgStatProviderPtr>& providers);
+
+  void ProcessBand(int chunk_begin, int chunk_end);
+};
+
+#endif
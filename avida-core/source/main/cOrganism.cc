@@ -32,8 +32,10 @@
 #include "cHardwareBase.h"
 #include "cHardwareManager.h"
 #include "cInstSet.h"
+#include "cOrganismPool.h"
 #include "cOrgSensor.h"
 #include "cPopulationCell.h"
+#include "cStateBuffer.h"
 #include "cStateGrid.h"
 #include "cStringUtil.h"
 #include "cTaskContext.h"
@@ -44,6 +46,7 @@
 #include <algorithm>
 #include <iomanip>
 #include <iterator>
+#include <new>
 #include <utility>
 
 using namespace std;
@@ -145,9 +148,11 @@ void cOrganism::Initialize()
 // Creation Policies
 // --------------------------------------------------------------------------------------------------------------
 
-cOrganism::cOrganism(cWorld* world, cAvidaContext& ctx, const Genome& genome, int parent_generation, Systematics::Source src)
+cOrganism::cOrganism(cWorld* world, cAvidaContext& ctx, const Genome& genome, int parent_generation, Systematics::Source src,
+                     cHardwareBase* reuse_hardware)
   : m_world(world)
-  , m_phenotype(world, parent_generation, world->GetHardwareManager().GetInstSet(genome.Properties().Get(s_ext_prop_name_instset).StringValue()).GetNumNops())
+  , m_phenotype_stash(world->GetOrganismPool().GetPhenotypeStash())
+  , m_phenotype(*m_phenotype_stash->Acquire(world, parent_generation, world->GetHardwareManager().GetInstSet(genome.Properties().Get(s_ext_prop_name_instset).StringValue()).GetNumNops()))
   , m_src(src)
   , m_initial_genome(genome)
   , m_interface(NULL)
@@ -209,11 +214,23 @@ cOrganism::cOrganism(cWorld* world, cAvidaContext& ctx, const Genome& genome, in
 	// initializing this here because it may be needed during hardware creation:
 	m_id = m_world->GetStats().GetTotCreatures();
   
-  m_hardware = m_world->GetHardwareManager().Create(ctx, this, genome);
+  m_hardware = m_world->GetHardwareManager().Create(ctx, this, genome, reuse_hardware);
   
   initialize(ctx);
 }
 
+void cOrganism::ResetInPlace(cAvidaContext& ctx, const Genome& genome, int parent_generation, Systematics::Source src)
+{
+  // The genome may belong to this organism (its own or its offspring's), so take a copy before tearing it down
+  const Genome new_genome(genome);
+  cWorld* world = m_world;
+  cHardwareBase* hardware = m_hardware;
+  m_hardware = NULL;
+  
+  this->~cOrganism();
+  ::new (this) cOrganism(world, ctx, new_genome, parent_generation, src, hardware);
+}
+
 void cOrganism::initialize(cAvidaContext& ctx)
 {
   m_phenotype.SetInstSetSize(m_hardware->GetInstSet().GetSize());
@@ -257,11 +274,40 @@ cOrganism::~cOrganism()
   delete m_org_display;
   delete m_queued_display_data;
   if (m_string_map) delete m_string_map;
+  m_phenotype_stash->Return(&m_phenotype);
+}
+
+void* cOrganism::operator new(size_t size, cWorld* world)
+{
+  return world->GetOrganismPool().AllocateOrganism(size);
+}
+
+void cOrganism::operator delete(void* ptr, cWorld*)
+{
+  cOrganismPool::Free(ptr);
+}
+
+void cOrganism::operator delete(void* ptr)
+{
+  cOrganismPool::Free(ptr);
 }
 
 
 const PropertyMap& cOrganism::Properties() const { return m_prop_map; }
 
+bool cOrganism::TransferState(cStateBuffer& state)
+{
+  state & m_input_pointer;
+  m_input_buf.TransferState(state);
+  m_output_buf.TransferState(state);
+  m_received_messages.TransferState(state);
+  state & m_cur_sg & m_sent_value & m_sent_active & m_test_receive_pos & m_gradient_movement & m_pher_drop
+        & frac_energy_donating & m_max_executed & m_is_sleeping;
+
+  m_phenotype.TransferState(state);
+  return m_hardware->TransferState(state) && state.IsOK();
+}
+
 void cOrganism::SetOrgInterface(cAvidaContext& ctx, cOrgInterface* org_interface)
 {
   delete m_interface;
@@ -30,6 +30,7 @@
 
 #include "cCPUMemory.h"
 #include "cMutationRates.h"
+#include "cOrganismPool.h"
 #include "cPhenotype.h"
 #include "cOrgInterface.h"
 #include "cOrgMessage.h"
@@ -51,6 +52,7 @@ class cEnvironment;
 class cHardwareBase;
 class cInstSet;
 class cLineage;
+class cStateBuffer;
 class cStateGrid;
 
 struct sOrgDisplay;
@@ -63,7 +65,8 @@ class cOrganism : public Systematics::Unit
 private:
   cWorld* m_world;
   cHardwareBase* m_hardware;              // The actual machinery running this organism.
-  cPhenotype m_phenotype;                 // Descriptive attributes of organism.
+  cOrganismPool::cPhenotypeStash* m_phenotype_stash;  // Where m_phenotype came from, and goes back to
+  cPhenotype& m_phenotype;                // Descriptive attributes of organism.
   Systematics::Source m_src;
   
   const Genome m_initial_genome;         // Initial genome; can never be changed!
@@ -114,9 +117,19 @@ private:
   cOrganism& operator=(const cOrganism&); // @not_implemented
 
 public:
-  cOrganism(cWorld* world, cAvidaContext& ctx, const Genome& genome, int parent_generation, Systematics::Source src);
+  cOrganism(cWorld* world, cAvidaContext& ctx, const Genome& genome, int parent_generation, Systematics::Source src,
+            cHardwareBase* reuse_hardware = NULL);
   ~cOrganism();
   
+  // Tears this organism down and rebuilds it in its own storage for a new genome, reusing the hardware when its type is
+  // unchanged.  Only for organisms nothing else holds a reference to, such as the test CPU's (see cHardwareManager).
+  void ResetInPlace(cAvidaContext& ctx, const Genome& genome, int parent_generation, Systematics::Source src);
+  
+  // Organisms come from the world's organism pool (cOrganismPool), so are created with new (world) cOrganism(...)
+  static void* operator new(size_t size, cWorld* world);
+  static void operator delete(void* ptr, cWorld* world);
+  static void operator delete(void* ptr);
+  
   static void Initialize();
   
   
@@ -145,11 +158,16 @@ public:
   void NewTrial();
 
   // --------  Accessor Methods  --------
+  cWorld* GetWorld() const { return m_world; }
   const Genome& GetGenome() const { return m_initial_genome; }
   const cPhenotype& GetPhenotype() const { return m_phenotype; }
   cPhenotype& GetPhenotype() { return m_phenotype; }
   void SetPhenotype(cPhenotype& _in_phenotype) { m_phenotype = _in_phenotype; }
 
+  // Save or restore the execution state of the organism, its phenotype and hardware, for exact restart checkpoints.
+  // Returns false if the hardware does not support it.
+  bool TransferState(cStateBuffer& state);
+
   const cMutationRates& MutationRates() const { return m_mut_rates; }
   cMutationRates& MutationRates() { return m_mut_rates; }
 
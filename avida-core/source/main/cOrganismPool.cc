@@ -0,0 +1,156 @@
+/*
+ *  cOrganismPool.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cOrganismPool.h"
+
+#include "cPhenotype.h"
+
+#include <cassert>
+
+
+cOrganismPool::~cOrganismPool()
+{
+  // Organisms still referenced elsewhere (systematics, pending data updates) keep their slabs alive until freed
+  if (m_organisms) m_organisms->Release();
+  for (int i = 0; i < m_hardware.GetSize(); i++) m_hardware[i]->Release();
+  m_phenotypes->Release();
+}
+
+
+void* cOrganismPool::AllocateOrganism(size_t size)
+{
+  if (!m_enabled) return cSlabPool::AllocateUnpooled(size);
+  
+  {
+    Apto::MutexAutoLock lock(m_mutex);
+    if (!m_organisms) m_organisms = new cSlabPool(size);
+  }
+  if (m_organisms->GetObjectSize() != size) return cSlabPool::AllocateUnpooled(size);
+  
+  return m_organisms->Allocate();
+}
+
+
+void* cOrganismPool::AllocateHardware(size_t size)
+{
+  if (!m_enabled) return cSlabPool::AllocateUnpooled(size);
+  
+  cSlabPool* pool = NULL;
+  {
+    Apto::MutexAutoLock lock(m_mutex);
+    for (int i = 0; i < m_hardware.GetSize(); i++) {
+      if (m_hardware[i]->GetObjectSize() == size) {
+        pool = m_hardware[i];
+        break;
+      }
+    }
+    if (!pool) {
+      pool = new cSlabPool(size);
+      m_hardware.Push(pool);
+    }
+  }
+  
+  return pool->Allocate();
+}
+
+
+void cOrganismPool::addStats(sStats& stats, const cSlabPool* pool)
+{
+  stats.allocated += pool->GetNumAllocated();
+  stats.recycled += pool->GetNumRecycled();
+  stats.live += pool->GetNumLive();
+  stats.peak_live += pool->GetPeakLive();
+  stats.slabs += pool->GetNumSlabs();
+  stats.bytes_reserved += pool->GetBytesReserved();
+}
+
+
+cOrganismPool::sStats cOrganismPool::GetOrganismStats()
+{
+  sStats stats = { 0, 0, 0, 0, 0, 0 };
+  Apto::MutexAutoLock lock(m_mutex);
+  if (m_organisms) addStats(stats, m_organisms);
+  return stats;
+}
+
+
+cOrganismPool::sStats cOrganismPool::GetHardwareStats()
+{
+  sStats stats = { 0, 0, 0, 0, 0, 0 };
+  Apto::MutexAutoLock lock(m_mutex);
+  for (int i = 0; i < m_hardware.GetSize(); i++) addStats(stats, m_hardware[i]);
+  return stats;
+}
+
+
+cOrganismPool::cPhenotypeStash::~cPhenotypeStash()
+{
+  assert(m_num_out == 0);
+  for (int i = 0; i < m_num_idle; i++) delete m_idle[i];
+}
+
+
+void cOrganismPool::cPhenotypeStash::Release()
+{
+  bool destroy = false;
+  {
+    Apto::MutexAutoLock lock(m_mutex);
+    m_released = true;
+    destroy = (m_num_out == 0);
+  }
+  if (destroy) delete this;
+}
+
+
+cPhenotype* cOrganismPool::cPhenotypeStash::Acquire(cWorld* world, int parent_generation, int num_nops)
+{
+  cPhenotype* phenotype = NULL;
+  {
+    Apto::MutexAutoLock lock(m_mutex);
+    m_num_out++;
+    if (m_num_idle) {
+      phenotype = m_idle[--m_num_idle];
+      m_num_recycled++;
+    }
+  }
+  
+  if (!phenotype) return new cPhenotype(world, parent_generation, num_nops);
+  phenotype->Recycle(parent_generation, num_nops);
+  return phenotype;
+}
+
+
+void cOrganismPool::cPhenotypeStash::Return(cPhenotype* phenotype)
+{
+  bool destroy = false;
+  {
+    Apto::MutexAutoLock lock(m_mutex);
+    m_num_out--;
+    if (m_enabled && !m_released) {
+      if (m_num_idle == m_idle.GetSize()) m_idle.Push(phenotype);
+      else m_idle[m_num_idle] = phenotype;
+      m_num_idle++;
+      phenotype = NULL;
+    }
+    destroy = (m_released && m_num_out == 0);
+  }
+  delete phenotype;
+  if (destroy) delete this;
+}
@@ -0,0 +1,122 @@
+/*
+ *  cOrganismPool.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cOrganismPool_h
+#define cOrganismPool_h
+
+#include "apto/core.h"
+
+#include "cSlabPool.h"
+
+#include <cstddef>
+
+class cPhenotype;
+class cWorld;
+
+
+// cOrganismPool
+//
+// The per-world allocator behind cOrganism and cHardwareBase operator new.  Organisms share one slab pool, and each
+// hardware class gets a pool of its own (keyed by object size), so the blocks of dead organisms are recycled by the
+// next births rather than going back and forth to the heap.  The phenotypes of dead organisms are kept as well, with
+// their task, reaction and instruction count arrays still allocated, and handed to the next births (see
+// cPhenotype::Recycle).  With pooling disabled the objects are still tagged so that operator delete can tell them apart,
+// but come straight from the heap, and every organism constructs a phenotype of its own.
+
+class cOrganismPool
+{
+public:
+  struct sStats
+  {
+    long long allocated;
+    long long recycled;
+    int live;
+    int peak_live;
+    int slabs;
+    long long bytes_reserved;
+  };
+
+  // Organisms hold on to the stash their phenotype came from, which, like the slab pools, stays around after the
+  // world has released it until the last of those phenotypes has been returned
+  class cPhenotypeStash
+  {
+  private:
+    const bool m_enabled;
+
+    Apto::Mutex m_mutex;
+    Apto::Array<cPhenotype*> m_idle;
+    int m_num_idle;
+    int m_num_out;
+    bool m_released;
+    long long m_num_recycled;
+
+
+    cPhenotypeStash(); // @not_implemented
+    cPhenotypeStash(const cPhenotypeStash&); // @not_implemented
+    cPhenotypeStash& operator=(const cPhenotypeStash&); // @not_implemented
+
+    ~cPhenotypeStash();
+
+  public:
+    cPhenotypeStash(bool enabled)
+      : m_enabled(enabled), m_num_idle(0), m_num_out(0), m_released(false), m_num_recycled(0) { ; }
+
+    void Release();
+
+    cPhenotype* Acquire(cWorld* world, int parent_generation, int num_nops);
+    void Return(cPhenotype* phenotype);
+
+    long long GetNumRecycled() { Apto::MutexAutoLock lock(m_mutex); return m_num_recycled; }
+  };
+
+private:
+  const bool m_enabled;
+
+  Apto::Mutex m_mutex;
+  cSlabPool* m_organisms;
+  Apto::Array<cSlabPool*, Apto::Smart> m_hardware;
+  cPhenotypeStash* m_phenotypes;
+
+
+  static void addStats(sStats& stats, const cSlabPool* pool);
+
+
+  cOrganismPool(); // @not_implemented
+  cOrganismPool(const cOrganismPool&); // @not_implemented
+  cOrganismPool& operator=(const cOrganismPool&); // @not_implemented
+
+public:
+  cOrganismPool(bool enabled) : m_enabled(enabled), m_organisms(NULL), m_phenotypes(new cPhenotypeStash(enabled)) { ; }
+  ~cOrganismPool();
+
+  inline bool IsEnabled() const { return m_enabled; }
+
+  void* AllocateOrganism(size_t size);
+  void* AllocateHardware(size_t size);
+  static inline void Free(void* ptr) { cSlabPool::Free(ptr); }
+
+  inline cPhenotypeStash* GetPhenotypeStash() { return m_phenotypes; }
+
+  sStats GetOrganismStats();
+  sStats GetHardwareStats();
+  long long GetPhenotypesRecycled() { return m_phenotypes->GetNumRecycled(); }
+};
+
+#endif
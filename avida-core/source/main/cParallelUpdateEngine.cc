@@ -0,0 +1,148 @@
+/*
+ *  cParallelUpdateEngine.cc
+ *  Avida
+ *
+ *  Copyright 2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cParallelUpdateEngine.h"
+
+#include "cAvidaContext.h"
+#include "cHardwareBase.h"
+#include "cPopulation.h"
+#include "cPopulationCell.h"
+#include "cStats.h"
+#include "cWorld.h"
+
+
+// Matches the speculative depth used by cPopulation::ProcessStepSpeculative
+static const int MAX_SPECULATIVE_DEPTH = 32;
+
+
+cParallelUpdateEngine::cParallelUpdateEngine(cWorld* world, int num_threads)
+: m_world(world), m_population(world->GetPopulation()), m_pool(world->GetPopulation().GetBandPool())
+{
+  buildTiles(world->GetConfig().UPDATE_TILE_SIZE.Get());
+
+  m_tile_rng.Resize(m_tiles.GetSize());
+  m_tile_ctx.Resize(m_tiles.GetSize());
+  m_tile_spec.Resize(m_tiles.GetSize());
+  for (int i = 0; i < m_tiles.GetSize(); i++) {
+    m_tile_rng[i] = new Apto::RNG::AvidaRNG(0);
+    m_tile_ctx[i] = new cAvidaContext(&world->GetDriver(), m_tile_rng[i]);
+    m_tile_spec[i] = 0;
+  }
+
+  m_num_threads = Apto::Min(cRowBandPool::ThreadsFor(num_threads), m_tiles.GetSize());
+  if (m_num_threads < 1) m_num_threads = 1;
+}
+
+cParallelUpdateEngine::~cParallelUpdateEngine()
+{
+  for (int i = 0; i < m_tiles.GetSize(); i++) {
+    delete m_tile_ctx[i];
+    delete m_tile_rng[i];
+  }
+}
+
+
+bool cParallelUpdateEngine::IsSupported(cWorld* world)
+{
+  cAvidaConfig& cfg = world->GetConfig();
+
+  // Pre-execution relies upon speculative execution, which must not be able to trigger a divide from within the tile
+  if (!cfg.SPECULATIVE.Get() || cfg.THREAD_SLICING_METHOD.Get() == 1) return false;
+  if (cfg.IMPLICIT_REPRO_TIME.Get() || cfg.IMPLICIT_REPRO_CPU_CYCLES.Get() || cfg.IMPLICIT_REPRO_BONUS.Get() ||
+      cfg.IMPLICIT_REPRO_END.Get() || cfg.IMPLICIT_REPRO_ENERGY.Get()) return false;
+
+  // Per-update point mutations modify genomes between updates, outside of the scheduler
+  const double point_mut_prob = cfg.POINT_MUT_PROB.Get() + cfg.POINT_INS_PROB.Get() + cfg.POINT_DEL_PROB.Get() +
+                                cfg.DIV_LGT_PROB.Get();
+  if (point_mut_prob > 0.0) return false;
+
+  return true;
+}
+
+
+void cParallelUpdateEngine::PreExecute(cAvidaContext& ctx)
+{
+  // Reseed each tile from the world stream in tile order, independent of the thread that will end up processing it
+  Apto::Random& rng = ctx.GetRandom();
+  for (int i = 0; i < m_tiles.GetSize(); i++) m_tile_rng[i]->ResetSeed(rng.GetInt(rng.MaxSeed()));
+
+  // Tiles are claimed one at a time, Run returns once all of them have been processed
+  cTileJob job(this);
+  m_pool->Run(job, m_tiles.GetSize(), 1, m_num_threads);
+
+  // Commit per-tile statistics in tile order
+  cStats& stats = m_world->GetStats();
+  for (int i = 0; i < m_tiles.GetSize(); i++) if (m_tile_spec[i]) stats.AddSpeculative(m_tile_spec[i]);
+}
+
+
+void cParallelUpdateEngine::buildTiles(int tile_size)
+{
+  const int world_x = m_population.GetWorldX();
+  const int world_y = m_population.GetWorldY();
+  if (tile_size < 1) tile_size = 1;
+
+  const int tiles_x = (world_x + tile_size - 1) / tile_size;
+  const int tiles_y = (world_y + tile_size - 1) / tile_size;
+  m_tiles.ResizeClear(tiles_x * tiles_y);
+
+  for (int ty = 0; ty < tiles_y; ty++) {
+    for (int tx = 0; tx < tiles_x; tx++) {
+      Apto::Array<int>& tile = m_tiles[ty * tiles_x + tx];
+      const int max_x = (tx + 1) * tile_size < world_x ? (tx + 1) * tile_size : world_x;
+      const int max_y = (ty + 1) * tile_size < world_y ? (ty + 1) * tile_size : world_y;
+      for (int y = ty * tile_size; y < max_y; y++) {
+        for (int x = tx * tile_size; x < max_x; x++) tile.Push(y * world_x + x);
+      }
+    }
+  }
+}
+
+
+void cParallelUpdateEngine::processTile(int tile_id)
+{
+  cAvidaContext& ctx = *m_tile_ctx[tile_id];
+  const Apto::Array<int>& tile = m_tiles[tile_id];
+
+  int spec_total = 0;
+  for (int i = 0; i < tile.GetSize(); i++) {
+    cPopulationCell& cell = m_population.GetCell(tile[i]);
+
+    // Cells with outstanding credit from a previous update are left alone, the scheduler has yet to consume it
+    if (!cell.IsOccupied() || cell.GetSpeculativeState()) continue;
+
+    // Instruction costs may touch shared resources and deme state, leave these organisms to the serial loop
+    cHardwareBase* hw = cell.GetHardware();
+    if (!hw->SupportsSpeculative() || hw->HasAnyCosts()) continue;
+
+    int spec_count = 0;
+    while (spec_count < MAX_SPECULATIVE_DEPTH && hw->SingleProcess(ctx, true)) spec_count++;
+    cell.SetSpeculativeState(spec_count);
+    spec_total += spec_count;
+  }
+
+  m_tile_spec[tile_id] = spec_total;
+}
+
+
+void cParallelUpdateEngine::cTileJob::ProcessBand(int tile_begin, int tile_end)
+{
+  for (int tile_id = tile_begin; tile_id < tile_end; tile_id++) m_engine->processTile(tile_id);
+}
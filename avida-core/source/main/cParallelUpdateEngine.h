@@ -0,0 +1,93 @@
+/*
+ *  cParallelUpdateEngine.h
+ *  Avida
+ *
+ *  Copyright 2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cParallelUpdateEngine_h
+#define cParallelUpdateEngine_h
+
+#include "apto/core.h"
+#include "apto/rng.h"
+
+#include "cRowBandPool.h"
+
+class cAvidaContext;
+class cPopulation;
+class cWorld;
+
+
+// cParallelUpdateEngine
+//
+// Partitions the cell grid into square tiles and, at the start of each update, speculatively pre-executes the organisms
+// in every tile on a pool of worker threads.  Only instructions that do not affect other organisms (see
+// cInstSet::ShouldStall) are run in this phase.  Everything else -- births, resource and message traffic -- is left to
+// the serial scheduler loop in cPopulation::ProcessStepSpeculative, which consumes the pre-executed credit and acts as the
+// commit barrier for all cross-cell side effects.
+//
+// Each tile owns a private random number stream that is reseeded from the world RNG in tile order at the beginning of
+// every update, so a given RANDOM_SEED and UPDATE_TILE_SIZE always reproduce the same trajectory, regardless of the
+// number of threads or how tiles get distributed among them.
+
+class cParallelUpdateEngine
+{
+private:
+  class cTileJob : public cRowBandPool::cJob
+  {
+  private:
+    cParallelUpdateEngine* m_engine;
+
+  public:
+    cTileJob(cParallelUpdateEngine* engine) : m_engine(engine) { ; }
+    void ProcessBand(int tile_begin, int tile_end);
+  };
+  friend class cTileJob;
+
+
+  cWorld* m_world;
+  cPopulation& m_population;
+
+  Apto::Array<Apto::Array<int> > m_tiles;
+  Apto::Array<Apto::RNG::AvidaRNG*> m_tile_rng;
+  Apto::Array<cAvidaContext*> m_tile_ctx;
+  Apto::Array<int> m_tile_spec;     // speculative instructions executed in each tile during the current update
+
+  cRowBandPool* m_pool;             // The world's pool (see cPopulation::GetBandPool), of which up to m_num_threads are used
+  int m_num_threads;
+
+
+  void buildTiles(int tile_size);
+  void processTile(int tile_id);
+
+
+  cParallelUpdateEngine(); // @not_implemented
+  cParallelUpdateEngine(const cParallelUpdateEngine&); // @not_implemented
+  cParallelUpdateEngine& operator=(const cParallelUpdateEngine&); // @not_implemented
+
+public:
+  cParallelUpdateEngine(cWorld* world, int num_threads);
+  ~cParallelUpdateEngine();
+
+  static bool IsSupported(cWorld* world);
+
+  int GetNumTiles() const { return m_tiles.GetSize(); }
+  int GetNumThreads() const { return m_num_threads; }
+
+  void PreExecute(cAvidaContext& ctx);
+};
+
+#endif
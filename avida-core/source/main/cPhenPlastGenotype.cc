@@ -47,7 +47,7 @@ cPhenPlastGenotype::~cPhenPlastGenotype()
 
 void cPhenPlastGenotype::Process(cCPUTestInfo& test_info, cWorld* world, cAvidaContext& ctx)
 {
-  cTestCPU* test_cpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+  cTestCPU* test_cpu = m_world->GetHardwareManager().AcquireTestCPU(ctx);
 
   if (m_num_trials > 1) test_info.UseRandomInputs(true);
   
@@ -106,7 +106,7 @@ void cPhenPlastGenotype::Process(cCPUTestInfo& test_info, cWorld* world, cAvidaC
     ++uit;
   }
   
-  if (test_cpu) delete test_cpu;
+  m_world->GetHardwareManager().ReleaseTestCPU(test_cpu);
 }
 
 
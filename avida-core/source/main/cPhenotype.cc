@@ -27,6 +27,7 @@
 #include "cDeme.h"
 #include "cOrganism.h"
 #include "cReactionResult.h"
+#include "cStateBuffer.h"
 #include "cTaskState.h"
 #include "cWorld.h"
 #include "tList.h"
@@ -113,6 +114,163 @@ cPhenotype::~cPhenotype()
 }
 
 
+template <class T> static inline void recycleArray(Apto::Array<T>& arr, int size)
+{
+  if (arr.GetSize() != size) arr.ResizeClear(size);
+  arr.SetAll(T());
+}
+
+void cPhenotype::Recycle(int parent_generation, int num_nops)
+{
+  // Follows the constructor.  Arrays the constructor leaves empty are emptied, except for the instruction and group
+  // attack counts, which are zeroed and left for SetInstSetSize and SetGroupAttackInstSetSize to size as before.
+  const int num_tasks = m_world->GetEnvironment().GetNumTasks();
+  const int num_resources = m_world->GetEnvironment().GetResourceLib().GetSize();
+  const int num_reactions = m_world->GetEnvironment().GetReactionLib().GetSize();
+  const int sense_size = m_world->GetStats().GetSenseSize();
+  
+  initialized = false;
+  merit = cMerit();
+  energy_store = 0.0;
+  recycleArray(cur_task_count, num_tasks);
+  recycleArray(cur_para_tasks, num_tasks);
+  recycleArray(cur_host_tasks, num_tasks);
+  recycleArray(cur_internal_task_count, num_tasks);
+  recycleArray(eff_task_count, num_tasks);
+  recycleArray(cur_task_quality, num_tasks);
+  recycleArray(cur_task_value, num_tasks);
+  recycleArray(cur_internal_task_quality, num_tasks);
+  recycleArray(cur_rbins_total, num_resources);
+  recycleArray(cur_rbins_avail, num_resources);
+  recycleArray(cur_reaction_count, num_reactions);
+  recycleArray(first_reaction_cycles, num_reactions);
+  recycleArray(first_reaction_execs, num_reactions);
+  recycleArray(cur_stolen_reaction_count, num_reactions);
+  recycleArray(cur_reaction_add_reward, num_reactions);
+  cur_inst_count.SetAll(0);
+  cur_from_sensor_count.SetAll(0);
+  cur_from_message_count.SetAll(0);
+  for (int i = 0; i < cur_group_attack_count.GetSize(); i++) cur_group_attack_count[i].SetAll(0);
+  for (int i = 0; i < cur_top_pred_group_attack_count.GetSize(); i++) cur_top_pred_group_attack_count[i].SetAll(0);
+  recycleArray(cur_killed_targets, 0);
+  recycleArray(cur_sense_count, sense_size);
+  recycleArray(sensed_resources, num_resources);
+  recycleArray(cur_task_time, num_tasks);
+  for (Apto::Map<void*, cTaskState*>::ValueIterator it = m_task_states.Values(); it.Next();) delete *it.Get();
+  m_task_states.Clear();
+  recycleArray(cur_trial_fitnesses, 0);
+  recycleArray(cur_trial_bonuses, 0);
+  recycleArray(cur_trial_times_used, 0);
+  m_tolerance_immigrants.Clear();
+  m_tolerance_offspring_own.Clear();
+  m_tolerance_offspring_others.Clear();
+  recycleArray(m_intolerances, (m_world->GetConfig().TOLERANCE_VARIATIONS.Get() > 0) ? 1 : 3);
+  mating_type = MATING_TYPE_JUVENILE;
+  mate_preference = MATE_PREFERENCE_RANDOM;
+  cur_mating_display_a = 0;
+  cur_mating_display_b = 0;
+  delete m_reaction_result;
+  m_reaction_result = NULL;
+  
+  recycleArray(last_task_count, num_tasks);
+  recycleArray(last_para_tasks, num_tasks);
+  recycleArray(last_host_tasks, num_tasks);
+  recycleArray(last_internal_task_count, num_tasks);
+  recycleArray(last_task_quality, num_tasks);
+  recycleArray(last_task_value, num_tasks);
+  recycleArray(last_internal_task_quality, num_tasks);
+  recycleArray(last_rbins_total, num_resources);
+  recycleArray(last_rbins_avail, num_resources);
+  recycleArray(last_collect_spec_counts, 0);
+  recycleArray(last_reaction_count, num_reactions);
+  recycleArray(last_reaction_add_reward, num_reactions);
+  last_inst_count.SetAll(0);
+  last_from_sensor_count.SetAll(0);
+  last_from_message_count.SetAll(0);
+  recycleArray(last_sense_count, sense_size);
+  for (int i = 0; i < last_group_attack_count.GetSize(); i++) last_group_attack_count[i].SetAll(0);
+  for (int i = 0; i < last_top_pred_group_attack_count.GetSize(); i++) last_top_pred_group_attack_count[i].SetAll(0);
+  recycleArray(last_killed_targets, 0);
+  last_mating_display_a = 0;
+  last_mating_display_b = 0;
+  
+  generation = 0;
+  fault_desc = "";
+  birth_cell_id = 0;
+  av_birth_cell_id = 0;
+  birth_group_id = 0;
+  birth_forager_type = -1;
+  recycleArray(testCPU_inst_count, 0);
+  last_task_id = -1;
+  num_new_unique_reactions = 0;
+  res_consumed = 0;
+  is_germ_cell = m_world->GetConfig().DEMES_ORGS_START_IN_GERM.Get();
+  last_task_time = 0;
+  recycleArray(is_donor_locus, 0);
+  recycleArray(is_donor_locus_last, 0);
+  
+  if (parent_generation >= 0) {
+    generation = parent_generation;
+    if (m_world->GetConfig().GENERATION_INC_METHOD.Get() != GENERATION_INC_BOTH) generation++;
+  }
+  
+  int collect_spec_size = 0;
+  if (num_resources > 0 && num_nops > 0) {
+    double most_nops_needed = ceil(log((double)num_resources) / log((double)num_nops));
+    collect_spec_size = int((pow((double)num_nops, most_nops_needed + 1.0) - 1.0) / ((double)num_nops - 1.0));
+  }
+  recycleArray(cur_collect_spec_counts, collect_spec_size);
+}
+
+
+void cPhenotype::TransferState(cStateBuffer& state)
+{
+  // Sections follow the member declarations.  The states of stateful tasks, tolerance histories and the cached reaction
+  // result are not part of the saved state.
+  state & merit & executionRatio & energy_store & genome_length & bonus_instruction_count & copied_size & executed_size
+        & gestation_time & gestation_start & fitness & div_type;
+  state & cur_bonus & cur_energy_bonus & energy_tobe_applied & energy_testament & energy_received_buffer
+        & total_energy_donated & total_energy_received & total_energy_applied & num_energy_requests
+        & num_energy_donations & num_energy_receptions & num_energy_applications & cur_num_errors & cur_num_donates
+        & cur_task_count & cur_para_tasks & cur_host_tasks & cur_internal_task_count & eff_task_count & cur_task_quality
+        & cur_task_value & cur_internal_task_quality & cur_rbins_total & cur_rbins_avail & cur_collect_spec_counts
+        & cur_reaction_count & first_reaction_cycles & first_reaction_execs & cur_stolen_reaction_count
+        & cur_reaction_add_reward & cur_inst_count & cur_from_sensor_count & cur_group_attack_count
+        & cur_top_pred_group_attack_count & cur_killed_targets & cur_attacks & cur_kills & cur_sense_count
+        & sensed_resources & cur_task_time & cur_trial_fitnesses & cur_trial_bonuses & cur_trial_times_used
+        & cur_from_message_count & trial_time_used & trial_cpu_cycles_used & m_intolerances
+        & last_child_germline_propensity & mating_type & mate_preference & cur_mating_display_a & cur_mating_display_b;
+  state & last_merit_base & last_bonus & last_energy_bonus & last_num_errors & last_num_donates & last_task_count
+        & last_para_tasks & last_host_tasks & last_internal_task_count & last_task_quality & last_task_value
+        & last_internal_task_quality & last_rbins_total & last_rbins_avail & last_collect_spec_counts
+        & last_reaction_count & last_reaction_add_reward & last_inst_count & last_from_sensor_count & last_sense_count
+        & last_group_attack_count & last_top_pred_group_attack_count & last_killed_targets & last_attacks & last_kills
+        & last_from_message_count & last_fitness & last_cpu_cycles_used & cur_child_germline_propensity
+        & last_mating_display_a & last_mating_display_b;
+  state & num_divides_failed & num_divides & generation & cpu_cycles_used & time_used & num_execs & age & fault_desc
+        & neutral_metric & life_fitness & exec_time_born & gmu_exec_time_born & birth_update & birth_cell_id
+        & av_birth_cell_id & birth_group_id & birth_forager_type & testCPU_inst_count & last_task_id
+        & num_new_unique_reactions & res_consumed & is_germ_cell & last_task_time;
+  state & to_die & to_delete & make_random_resource & is_injected & is_clone & is_donor_cur & is_donor_last
+        & is_donor_rand & is_donor_rand_last & is_donor_null & is_donor_null_last & is_donor_kin & is_donor_kin_last
+        & is_donor_edit & is_donor_edit_last & is_donor_gbg & is_donor_gbg_last & is_donor_truegb & is_donor_truegb_last
+        & is_donor_threshgb & is_donor_threshgb_last & is_donor_quanta_threshgb & is_donor_quanta_threshgb_last
+        & is_donor_shadedgb & is_donor_shadedgb_last & is_donor_locus & is_donor_locus_last & is_energy_requestor
+        & is_energy_donor & is_energy_receiver & has_used_donated_energy & has_open_energy_request
+        & num_thresh_gb_donations & num_thresh_gb_donations_last & num_quanta_thresh_gb_donations
+        & num_quanta_thresh_gb_donations_last & num_shaded_gb_donations & num_shaded_gb_donations_last
+        & num_donations_locus & num_donations_locus_last & is_receiver & is_receiver_last & is_receiver_rand
+        & is_receiver_kin & is_receiver_kin_last & is_receiver_edit & is_receiver_edit_last & is_receiver_gbg
+        & is_receiver_truegb & is_receiver_truegb_last & is_receiver_threshgb & is_receiver_threshgb_last
+        & is_receiver_quanta_threshgb & is_receiver_quanta_threshgb_last & is_receiver_shadedgb
+        & is_receiver_shadedgb_last & is_receiver_gb_same_locus & is_receiver_gb_same_locus_last & is_modifier
+        & is_modified & is_fertile & is_mutated & is_multi_thread & parent_true & parent_sex & parent_cross_num
+        & born_parent_group & kaboom_executed & kaboom_executed2;
+  state & copy_true & divide_sex & mate_select_id & cross_num & child_fertile & last_child_fertile & child_copied_size;
+  state & permanent_germline_propensity;
+}
+
+
 cPhenotype::cPhenotype(const cPhenotype& in_phen) : m_reaction_result(NULL)
 {
   *this = in_phen;
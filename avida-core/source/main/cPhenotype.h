@@ -68,6 +68,7 @@ class cTaskContext;
 class cTaskState;
 class cPhenPlastSummary;
 class cReactionResult;
+class cStateBuffer;
 
 using namespace Avida;
 
@@ -322,6 +323,12 @@ public:
   cPhenotype(const cPhenotype&); 
   cPhenotype& operator=(const cPhenotype&); 
   ~cPhenotype();
+
+  // Reset a dead organism's phenotype to a newly constructed one for the next birth, keeping its array storage
+  void Recycle(int parent_generation, int num_nops);
+
+  // Save or restore the complete phenotype, for exact restart checkpoints
+  void TransferState(cStateBuffer& state);
   
   enum energy_levels {ENERGY_LEVEL_LOW = 0, ENERGY_LEVEL_MEDIUM, ENERGY_LEVEL_HIGH};
 	
@@ -0,0 +1,130 @@
+/*
+ *  cPointMutationScheduler.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cPointMutationScheduler.h"
+
+#include "cAvidaContext.h"
+#include "cCPUMemory.h"
+#include "cHardwareBase.h"
+#include "cOrganism.h"
+#include "cPopulation.h"
+#include "cPopulationCell.h"
+#include "cWorld.h"
+
+#include <cmath>
+
+
+// cSiteSkipSampler
+// --------------------------------------------------------------------------------------------------------------
+
+void cSiteSkipSampler::SetProbability(double prob)
+{
+  if (prob == m_prob) return;
+
+  m_prob = prob;
+  m_log_miss = (prob > 0.0 && prob < 1.0) ? log(1.0 - prob) : 0.0;
+  m_gap = -1.0;
+}
+
+
+void cSiteSkipSampler::drawGap(Apto::Random& rng)
+{
+  if (m_prob >= 1.0) {
+    m_gap = 0.0;
+    return;
+  }
+
+  // Number of misses before the next hit, Geometric(p); the uniform is taken from (0, 1] so the log is finite
+  m_gap = floor(log(1.0 - rng.GetDouble()) / m_log_miss);
+}
+
+
+int cSiteSkipSampler::Hits(Apto::Random& rng, int sites)
+{
+  if (m_prob <= 0.0 || sites <= 0) return 0;
+
+  if (m_gap < 0.0) drawGap(rng);
+
+  int hits = 0;
+  double remaining = sites;
+  while (m_gap < remaining) {
+    hits++;
+    remaining -= m_gap + 1.0;
+    drawGap(rng);
+  }
+  m_gap -= remaining;
+
+  return hits;
+}
+
+
+// cPointMutationScheduler
+// --------------------------------------------------------------------------------------------------------------
+
+int cPointMutationScheduler::Run(cAvidaContext& ctx)
+{
+  cPopulation& population = m_world->GetPopulation();
+  int total = 0;
+
+  if (!m_world->GetConfig().POINT_MUT_SKIP_SAMPLING.Get()) {
+    for (int i = 0; i < population.GetSize(); i++) {
+      if (population.GetCell(i).IsOccupied()) {
+        cOrganism* organism = population.GetCell(i).GetOrganism();
+        int num_mut = organism->GetHardware().PointMutate(ctx);
+        organism->IncPointMutations(num_mut);
+        total += num_mut;
+      }
+    }
+    return total;
+  }
+
+  m_sub.SetProbability(m_world->GetConfig().POINT_MUT_PROB.Get());
+  m_ins.SetProbability(m_world->GetConfig().POINT_INS_PROB.Get());
+  m_del.SetProbability(m_world->GetConfig().POINT_DEL_PROB.Get());
+
+  Apto::Random& rng = ctx.GetRandom();
+  const Apto::Array<cOrganism*, Apto::Smart>& live_orgs = population.GetLiveOrgList();
+  for (int i = 0; i < live_orgs.GetSize(); i++) {
+    cOrganism* organism = live_orgs[i];
+    cHardwareBase& hardware = organism->GetHardware();
+
+    int num_mut = 0;
+    if (organism->GetPointMutProb() != m_sub.GetProbability() || organism->GetPointInsProb() != m_ins.GetProbability() ||
+        organism->GetPointDelProb() != m_del.GetProbability()) {
+      num_mut = hardware.PointMutate(ctx);
+    } else {
+      // Substitutions leave the length unchanged; deletions are drawn over the genome as it stands after insertions
+      const int size = hardware.GetMemory().GetSize();
+      const int num_sub = m_sub.Hits(rng, size);
+      const int num_ins = m_ins.Hits(rng, size);
+      if (num_sub) num_mut += hardware.PointSubstitute(ctx, num_sub);
+      if (num_ins) num_mut += hardware.PointInsert(ctx, num_ins);
+      const int num_del = m_del.Hits(rng, hardware.GetMemory().GetSize());
+      if (num_del) num_mut += hardware.PointDelete(ctx, num_del);
+    }
+
+    if (num_mut) {
+      organism->IncPointMutations(num_mut);
+      total += num_mut;
+    }
+  }
+
+  return total;
+}
@@ -0,0 +1,87 @@
+/*
+ *  cPointMutationScheduler.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cPointMutationScheduler_h
+#define cPointMutationScheduler_h
+
+#include "apto/rng.h"
+
+class cAvidaContext;
+class cWorld;
+
+
+// cSiteSkipSampler
+//
+// Decides which sites of a long stream are hit by independent events of a fixed per-site probability by drawing the
+// geometric gaps between hits, rather than one trial per site.  Hits consumes the next block of sites and returns how
+// many of them were hit, so the count for any block of n sites is Binomial(n, p), independent of every other block.
+
+class cSiteSkipSampler
+{
+private:
+  double m_prob;
+  double m_log_miss;    // log(1 - p)
+  double m_gap;         // Sites left to skip before the next hit, or -1 if none has been drawn
+
+  void drawGap(Apto::Random& rng);
+
+public:
+  cSiteSkipSampler() : m_prob(0.0), m_log_miss(0.0), m_gap(-1.0) { ; }
+
+  // Changing the probability discards the pending gap
+  void SetProbability(double prob);
+  double GetProbability() const { return m_prob; }
+
+  int Hits(Apto::Random& rng, int sites);
+};
+
+
+// cPointMutationScheduler
+//
+// Applies the per-update point (cosmic ray) substitutions, insertions and deletions to the whole population.  The live
+// organisms' genomes are treated as one concatenated stream of sites, and each mutation type skips from one hit to the
+// next with a cSiteSkipSampler, so random numbers are only drawn for mutations that actually occur.  Each organism
+// still receives a binomially distributed number of each kind of mutation at uniformly chosen sites, exactly as
+// cHardwareBase::PointMutate would give it.
+//
+// Organisms whose point mutation rates differ from the configured ones (inherited or otherwise altered rates) are
+// mutated individually through PointMutate.  With POINT_MUT_SKIP_SAMPLING disabled every organism is.
+
+class cPointMutationScheduler
+{
+private:
+  cWorld* m_world;
+  cSiteSkipSampler m_sub;
+  cSiteSkipSampler m_ins;
+  cSiteSkipSampler m_del;
+
+
+  cPointMutationScheduler(); // @not_implemented
+  cPointMutationScheduler(const cPointMutationScheduler&); // @not_implemented
+  cPointMutationScheduler& operator=(const cPointMutationScheduler&); // @not_implemented
+
+public:
+  cPointMutationScheduler(cWorld* world) : m_world(world) { ; }
+
+  // Mutates the population for one update, returning the total number of mutations applied
+  int Run(cAvidaContext& ctx);
+};
+
+#endif
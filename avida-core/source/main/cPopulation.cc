@@ -44,20 +44,26 @@
 
 #include "cAvidaContext.h"
 #include "cCPUTestInfo.h"
+#include "cCheckpointWriter.h"
 #include "cCodeLabel.h"
 #include "cDemePlaceholderUnit.h"
 #include "cEnvironment.h"
+#include "cEventList.h"
 #include "cHardwareBase.h"
 #include "cHardwareManager.h"
 #include "cInitFile.h"
 #include "cInstSet.h"
 #include "cMigrationMatrix.h"   
+#include "cOrgStatSweep.h"
 #include "cOrganism.h"
 #include "cParasite.h"
 #include "cPhenotype.h"
 #include "cPopulationCell.h"
+#include "cPopulationCheckpoint.h"
 #include "cResource.h"
 #include "cResourceCount.h"
+#include "cRowBandPool.h"
+#include "cStateBuffer.h"
 #include "cStats.h"
 #include "cTestCPU.h"
 #include "cTopology.h"
@@ -265,6 +271,9 @@ public:
 cPopulation::cPopulation(cWorld* world)  
 : m_world(world)
 , m_scheduler(NULL)
+, m_band_pool(NULL)
+, m_stat_sweep(NULL)
+, m_checkpoint_writer(NULL)
 , birth_chamber(world)
 , print_mini_trace_genomes(false)
 , use_micro_traces(false)
@@ -275,6 +284,7 @@ cPopulation::cPopulation(cWorld* world)
 , num_prey_organisms(0)
 , num_pred_organisms(0)
 , num_top_pred_organisms(0)
+, m_deme_clock(0.0)
 , sync_events(false)
 , m_hgt_resid(-1)
 {
@@ -290,6 +300,11 @@ cPopulation::cPopulation(cWorld* world)
   assert(!((m_world->GetConfig().DEMES_ORGANISM_PLACEMENT.Get()==0) && (m_world->GetConfig().DEMES_ORGANISM_FACING.Get()==1)
            && (m_world->GetConfig().WORLD_GEOMETRY.Get()==1)));
   
+  // One pool of worker threads, sized for the most threads asked of any pass, serves all of them
+  m_band_pool = new cRowBandPool(Apto::Max(Apto::Max(cRowBandPool::ThreadsFor(m_world->GetConfig().UPDATE_THREADS.Get()),
+                                                     cRowBandPool::ThreadsFor(m_world->GetConfig().RESOURCE_THREADS.Get())),
+                                           cRowBandPool::ThreadsFor(m_world->GetConfig().STAT_THREADS.Get())));
+  
   // Incompatible deme replication strategies:
   assert(!(m_world->GetConfig().DEMES_REPLICATE_SIZE.Get() && (m_world->GetConfig().DEMES_PROB_ORG_TRANSFER.Get()>0.0)));
   assert(!(m_world->GetConfig().DEMES_USE_GERMLINE.Get() && (m_world->GetConfig().DEMES_PROB_ORG_TRANSFER.Get()>0.0)));
@@ -415,11 +430,21 @@ void cPopulation::SetupCellGrid()
   cResourceCount tmp_res_count(resource_lib.GetSize() - num_deme_res);
   resource_count = tmp_res_count;
   resource_count.ResizeSpatialGrids(world_x, world_y);
+
+  const int resource_threads = cRowBandPool::ThreadsFor(m_world->GetConfig().RESOURCE_THREADS.Get());
+  if (resource_threads > 1) resource_count.SetBandPool(m_band_pool, resource_threads);
+
+  delete m_stat_sweep;
+  m_stat_sweep = new cOrgStatSweep(m_world);
+  const int stat_threads = cRowBandPool::ThreadsFor(m_world->GetConfig().STAT_THREADS.Get());
+  if (stat_threads > 1) m_stat_sweep->SetBandPool(m_band_pool, stat_threads);
   
+  m_deme_clock = 0.0;
   for(int i = 0; i < GetNumDemes(); i++) {
     cResourceCount tmp_deme_res_count(num_deme_res);
     GetDeme(i).SetDemeResourceCount(tmp_deme_res_count);
     GetDeme(i).ResizeSpatialGrids(deme_size_x, deme_size_y);
+    GetDeme(i).GetDemeResources().AttachClock(&m_deme_clock);
   }
   
   
@@ -603,7 +628,10 @@ bool cPopulation::IsValidArgument(const Data::DataID& data_id, Data::Argument ar
 cPopulation::~cPopulation()
 {
   for (int i = 0; i < cell_array.GetSize(); i++) delete cell_array[i].GetOrganism(); 
+  delete m_checkpoint_writer;  // waits for any checkpoints still being written
   delete m_scheduler;
+  delete m_stat_sweep;
+  delete m_band_pool;
 }
 
 
@@ -611,7 +639,9 @@ inline void cPopulation::AdjustSchedule(const cPopulationCell& cell, const cMeri
 {
   const int deme_id = cell.GetDemeID();
   const cDeme& deme = deme_array[deme_id];
-  m_scheduler->AdjustPriority(cell.GetID(), deme.HasDemeMerit() ? (merit.GetDouble() * deme.GetDemeMerit().GetDouble()) : merit.GetDouble());
+  const double priority = deme.HasDemeMerit() ? (merit.GetDouble() * deme.GetDemeMerit().GetDouble()) : merit.GetDouble();
+  m_schedule_priority[cell.GetID()] = priority;
+  m_scheduler->AdjustPriority(cell.GetID(), priority);
 }
 
 
@@ -911,7 +941,7 @@ bool cPopulation::ActivateOffspring(cAvidaContext& ctx, const Genome& offspring_
         int pc_phenotype = m_world->GetConfig().PRECALC_PHENOTYPE.Get();
         if (pc_phenotype) {
           cCPUTestInfo test_info;
-          cTestCPU* test_cpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+          cTestCPU* test_cpu = m_world->GetHardwareManager().AcquireTestCPU(ctx);
           test_info.UseManualInputs(parent_cell.GetInputs()); // Test using what the environment will be
           Genome mg(parent_organism->GetGenome().HardwareType(),
                     parent_organism->GetGenome().Properties(),
@@ -927,7 +957,7 @@ bool cPopulation::ActivateOffspring(cAvidaContext& ctx, const Genome& offspring_
             parent_phenotype.SetTestCPUInstCount(test_info.GetTestPhenotype().GetLastInstCount());
           }
           parent_phenotype.SetFitness(parent_phenotype.GetMerit().CalcFitness(parent_phenotype.GetGestationTime())); // Update fitness
-          delete test_cpu;
+          m_world->GetHardwareManager().ReleaseTestCPU(test_cpu);
         }
       }
       AdjustSchedule(parent_cell, parent_phenotype.GetMerit());
@@ -1326,7 +1356,7 @@ bool cPopulation::ActivateOrganism(cAvidaContext& ctx, cOrganism* in_organism, c
   int pc_phenotype = m_world->GetConfig().PRECALC_PHENOTYPE.Get();
   if (pc_phenotype){
     cCPUTestInfo test_info;
-    cTestCPU* test_cpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+    cTestCPU* test_cpu = m_world->GetHardwareManager().AcquireTestCPU(ctx);
     test_info.UseManualInputs(target_cell.GetInputs()); // Test using what the environment will be
     Genome mg(in_organism->GetGenome().HardwareType(),
               in_organism->GetGenome().Properties(),
@@ -1338,7 +1368,7 @@ bool cPopulation::ActivateOrganism(cAvidaContext& ctx, cOrganism* in_organism, c
     if (pc_phenotype & 2)
       in_organism->GetPhenotype().SetGestationTime(test_info.GetTestPhenotype().GetGestationTime());
     in_organism->GetPhenotype().SetFitness(in_organism->GetPhenotype().GetMerit().CalcFitness(in_organism->GetPhenotype().GetGestationTime()));
-    delete test_cpu;
+    m_world->GetHardwareManager().ReleaseTestCPU(test_cpu);
   }
   // Update the archive...
   
@@ -5714,10 +5744,9 @@ void cPopulation::ProcessStep(cAvidaContext& ctx, double step_size, int cell_id)
   m_world->GetStats().IncExecuted();
   resource_count.Update(step_size);
   
-  // These must be done even if there is only one deme.
-  for(int i = 0; i < GetNumDemes(); i++) {
-    GetDeme(i).Update(step_size);
-  }
+  // These must be done even if there is only one deme.  All deme resource counts share m_deme_clock and
+  // catch up with it lazily the next time they are accessed.
+  m_deme_clock += step_size;
   
   cDeme & deme = GetDeme(GetCell(cell_id).GetDemeID());
   deme.IncTimeUsed(merit);
@@ -5761,7 +5790,7 @@ void cPopulation::ProcessStepSpeculative(cAvidaContext& ctx, double step_size, i
   
   // Deme specific
   if (GetNumDemes() > 1) {
-    for(int i = 0; i < GetNumDemes(); i++) GetDeme(i).Update(step_size);
+    m_deme_clock += step_size;
     
     cDeme& deme = GetDeme(GetCell(cell_id).GetDemeID());
     deme.IncTimeUsed(cur_org->GetPhenotype().GetMerit().GetDouble());
@@ -5837,379 +5866,12 @@ void cPopulation::UpdateDemeStats(cAvidaContext& ctx) {
 
 void cPopulation::UpdateOrganismStats(cAvidaContext& ctx) 
 {
-  // Loop through all the cells getting stats and doing calculations
-  // which must be done on a creature by creature basis.
-  
-  cStats& stats = m_world->GetStats();
-  
-  // Clear out organism sums...
-  stats.SumFitness().Clear();
-  stats.SumGestation().Clear();
-  stats.SumMerit().Clear();
-  stats.SumCreatureAge().Clear();
-  stats.SumGeneration().Clear();
-  stats.SumNeutralMetric().Clear();
-  stats.SumLineageLabel().Clear();
-  stats.SumCopyMutRate().Clear();
-  stats.SumDivMutRate().Clear();
-  stats.SumCopySize().Clear();
-  stats.SumExeSize().Clear();
-  stats.SumMemSize().Clear();
-  
-  stats.ZeroTasks();
-  stats.ZeroReactions();
-  
-  for (int osp_idx = 0; osp_idx < m_org_stat_providers.GetSize(); osp_idx++) m_org_stat_providers[osp_idx]->UpdateReset();
-
-  // Counts...
-  int num_breed_true = 0;
-  int num_parasites = 0;
-  int num_no_birth = 0;
-  int num_multi_thread = 0;
-  int num_single_thread = 0;
-  int num_threads = 0;
-  int num_modified = 0;
-  
-  // Maximums...
-  cMerit max_merit(0);
-  double max_fitness = 0;
-  int max_gestation_time = 0;
-  int max_genome_length = 0;
-  
-  // Minimums...
-  cMerit min_merit(FLT_MAX);
-  double min_fitness = FLT_MAX;
-  int min_gestation_time = INT_MAX;
-  int min_genome_length = INT_MAX;
-  
-  for (int i = 0; i < live_org_list.GetSize(); i++) {  
-    cOrganism* organism = live_org_list[i];
-    
-    for (int osp_idx = 0; osp_idx < m_org_stat_providers.GetSize(); osp_idx++) {
-      m_org_stat_providers[osp_idx]->HandleOrganism(organism);
-    }
-    
-    const cPhenotype& phenotype = organism->GetPhenotype();
-    const cMerit cur_merit = phenotype.GetMerit();
-    const double cur_fitness = phenotype.GetFitness();
-    const int cur_gestation_time = phenotype.GetGestationTime();
-    const int cur_genome_length = phenotype.GetGenomeLength();
-    
-    Apto::Array<Apto::Stat::Accumulator<int> >& from_message_exec_counts = stats.InstFromMessageExeCountsForInstSet((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
-    for (int j = 0; j < phenotype.GetLastFromMessageInstCount().GetSize(); j++) {
-      from_message_exec_counts[j].Add(organism->GetPhenotype().GetLastFromMessageInstCount()[j]);
-    }
-
-    stats.SumFitness().Add(cur_fitness);
-    stats.SumMerit().Add(cur_merit.GetDouble());
-    stats.SumGestation().Add(phenotype.GetGestationTime());
-    stats.SumCreatureAge().Add(phenotype.GetAge());
-    stats.SumGeneration().Add(phenotype.GetGeneration());
-    stats.SumNeutralMetric().Add(phenotype.GetNeutralMetric());
-    stats.SumLineageLabel().Add(organism->GetLineageLabel());
-    stats.SumCopyMutRate().Push(organism->MutationRates().GetCopyMutProb());
-    stats.SumLogCopyMutRate().Push(log(organism->MutationRates().GetCopyMutProb()));
-    stats.SumDivMutRate().Push(organism->MutationRates().GetDivMutProb() / organism->GetPhenotype().GetDivType());
-    stats.SumLogDivMutRate().Push(log(organism->MutationRates().GetDivMutProb() / organism->GetPhenotype().GetDivType()));
-    stats.SumCopySize().Add(phenotype.GetCopiedSize());
-    stats.SumExeSize().Add(phenotype.GetExecutedSize());
-    
-    if (cur_merit > max_merit) max_merit = cur_merit;
-    if (cur_fitness > max_fitness) max_fitness = cur_fitness;
-    if (cur_gestation_time > max_gestation_time) max_gestation_time = cur_gestation_time;
-    if (cur_genome_length > max_genome_length) max_genome_length = cur_genome_length;
-    
-    if (cur_merit < min_merit) min_merit = cur_merit;
-    if (cur_fitness < min_fitness) min_fitness = cur_fitness;
-    if (cur_gestation_time < min_gestation_time) min_gestation_time = cur_gestation_time;
-    if (cur_genome_length < min_genome_length) min_genome_length = cur_genome_length;
-    
-    // Test what tasks this creatures has completed.
-    for (int j = 0; j < m_world->GetEnvironment().GetNumTasks(); j++) {
-      if (phenotype.GetCurTaskCount()[j] > 0) {
-        stats.AddCurTask(j);
-        stats.AddCurTaskQuality(j, phenotype.GetCurTaskQuality()[j]);
-      }
-      
-      if (phenotype.GetLastTaskCount()[j] > 0) {
-        stats.AddLastTask(j);
-        stats.AddLastTaskQuality(j, phenotype.GetLastTaskQuality()[j]);
-        stats.IncTaskExeCount(j, phenotype.GetLastTaskCount()[j]);
-      }
-      
-      if (phenotype.GetCurHostTaskCount()[j] > 0) {
-        stats.AddCurHostTask(j);
-      }
-      
-      if (phenotype.GetLastHostTaskCount()[j] > 0) {
-        stats.AddLastHostTask(j);
-      }
-      
-      if (phenotype.GetCurParasiteTaskCount()[j] > 0) {
-        stats.AddCurParasiteTask(j);
-      }
-      
-      if (phenotype.GetLastParasiteTaskCount()[j] > 0) {
-        stats.AddLastParasiteTask(j);
-      }
-      
-      if (phenotype.GetCurInternalTaskCount()[j] > 0) {
-        stats.AddCurInternalTask(j);
-        stats.AddCurInternalTaskQuality(j, phenotype.GetCurInternalTaskQuality()[j]);
-      }
-      
-      if (phenotype.GetLastInternalTaskCount()[j] > 0) {
-        stats.AddLastInternalTask(j);
-        stats.AddLastInternalTaskQuality(j, phenotype.GetLastInternalTaskQuality()[j]);
-      }
-    }
-
-    if (stats.ShouldCollectEnvTestStats()) {
-      Systematics::GroupPtr genotype = organism->SystematicsGroup("genotype");
-      Systematics::GenomeTestMetricsPtr metrics(Systematics::GenomeTestMetrics::GetMetrics(m_world, ctx, genotype));
-      const Apto::Array<int>& test_task_counts = metrics->GetTaskCounts();
-      
-      for (int j = 0; j < m_world->GetEnvironment().GetNumTasks(); j++) if (test_task_counts[j] > 0) stats.AddTestTask(j);
-    }
-    
-    
-    // Record what add bonuses this organism garnered for different reactions
-    for (int j = 0; j < m_world->GetEnvironment().GetNumReactions(); j++) {
-      if (phenotype.GetCurReactionCount()[j] > 0) {
-        stats.AddCurReaction(j);
-        stats.AddCurReactionAddReward(j, phenotype.GetCurReactionAddReward()[j]);
-      }
-      
-      if (phenotype.GetLastReactionCount()[j] > 0) {
-        stats.AddLastReaction(j);
-        stats.IncReactionExeCount(j, phenotype.GetLastReactionCount()[j]);
-        stats.AddLastReactionAddReward(j, phenotype.GetLastReactionAddReward()[j]);
-      }
-    }
-    
-    // Test what resource combinations this creature has sensed
-    for (int j = 0; j < stats.GetSenseSize(); j++) {
-      if (phenotype.GetLastSenseCount()[j] > 0) {
-        stats.AddLastSense(j);
-        stats.IncLastSenseExeCount(j, phenotype.GetLastSenseCount()[j]);
-      }
-    }
-    
-    // Increment the counts for all qualities the organism has...
-    num_parasites += organism->GetNumParasites();
-    if (phenotype.ParentTrue()) num_breed_true++;
-    if (phenotype.GetNumDivides() == 0) num_no_birth++;
-    if (phenotype.IsMultiThread()) num_multi_thread++;
-    else num_single_thread++;
-    
-    if (phenotype.IsModified()) num_modified++;
-    
-    cHardwareBase& hardware = organism->GetHardware();
-    stats.SumMemSize().Add(hardware.GetMemory().GetSize());
-    num_threads += hardware.GetNumThreads();
-    
-    // Increment the age of this organism.
-    organism->GetPhenotype().IncAge();
-  }
-  
-  stats.SetBreedTrueCreatures(num_breed_true);
-  stats.SetNumNoBirthCreatures(num_no_birth);
-  stats.SetNumParasites(num_parasites);
-  stats.SetNumSingleThreadCreatures(num_single_thread);
-  stats.SetNumMultiThreadCreatures(num_multi_thread);
-  stats.SetNumThreads(num_threads);
-  stats.SetNumModified(num_modified);
-  
-  stats.SetMaxMerit(max_merit.GetDouble());
-  stats.SetMaxFitness(max_fitness);
-  stats.SetMaxGestationTime(max_gestation_time);
-  stats.SetMaxGenomeLength(max_genome_length);
-  
-  stats.SetMinMerit(min_merit.GetDouble());
-  stats.SetMinFitness(min_fitness);
-  stats.SetMinGestationTime(min_gestation_time);
-  stats.SetMinGenomeLength(min_genome_length);
+  // Gather the per-organism stats (and increment organism ages) in a single pass over the live organisms
+  m_stat_sweep->Run(ctx, live_org_list, m_org_stat_providers);
   
   resource_count.UpdateGlobalResources(ctx);   
 }
 
-void cPopulation::UpdateFTOrgStats(cAvidaContext&) 
-{
-  // Get per-org stats seperately for pred and prey
-  cStats& stats = m_world->GetStats();
-  
-  // Clear out organism sums...
-  stats.SumPreyFitness().Clear();
-  stats.SumPreyGestation().Clear();
-  stats.SumPreyMerit().Clear();
-  stats.SumPreyCreatureAge().Clear();
-  stats.SumPreyGeneration().Clear();
-  
-  stats.SumPredFitness().Clear();
-  stats.SumPredGestation().Clear();
-  stats.SumPredMerit().Clear();
-  stats.SumPredCreatureAge().Clear();
-  stats.SumPredGeneration().Clear();
-  
-  stats.SumTopPredFitness().Clear();
-  stats.SumTopPredGestation().Clear();
-  stats.SumTopPredMerit().Clear();
-  stats.SumTopPredCreatureAge().Clear();
-  stats.SumTopPredGeneration().Clear();
-  
-  stats.SumAttacks().Clear();
-  stats.SumKills().Clear();
-
-  //  stats.ZeroFTReactions();   ****
-  
-  stats.ZeroFTInst();
-  stats.ZeroGroupAttackInst();
-  
-  for (int i = 0; i < live_org_list.GetSize(); i++) {
-    cOrganism* organism = live_org_list[i];
-    const cPhenotype& phenotype = organism->GetPhenotype();
-    const cMerit cur_merit = phenotype.GetMerit();
-    const double cur_fitness = phenotype.GetFitness();
-    
-    if (organism->IsPreyFT()) {
-      stats.SumPreyFitness().Add(cur_fitness);
-      stats.SumPreyGestation().Add(phenotype.GetGestationTime());
-      stats.SumPreyMerit().Add(cur_merit.GetDouble());
-      stats.SumPreyCreatureAge().Add(phenotype.GetAge());
-      stats.SumPreyGeneration().Add(phenotype.GetGeneration());
-      
-      Apto::Array<Apto::Stat::Accumulator<int> >& prey_inst_exe_counts = stats.InstPreyExeCountsForInstSet((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
-      for (int j = 0; j < phenotype.GetLastInstCount().GetSize(); j++) {
-        prey_inst_exe_counts[j].Add(organism->GetPhenotype().GetLastInstCount()[j]);
-      }
-      Apto::Array<Apto::Stat::Accumulator<int> >& prey_from_sensor_exec_counts = stats.InstPreyFromSensorExeCountsForInstSet((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
-      for (int j = 0; j < phenotype.GetLastFromSensorInstCount().GetSize(); j++) {
-        prey_from_sensor_exec_counts[j].Add(organism->GetPhenotype().GetLastFromSensorInstCount()[j]);
-      }
-    }
-    else if (organism->IsPredFT()) {
-      stats.SumPredFitness().Add(cur_fitness);
-      stats.SumPredGestation().Add(phenotype.GetGestationTime());
-      stats.SumPredMerit().Add(cur_merit.GetDouble());
-      stats.SumPredCreatureAge().Add(phenotype.GetAge());
-      stats.SumPredGeneration().Add(phenotype.GetGeneration());
-      stats.SumAttacks().Add(phenotype.GetLastAttacks());
-      stats.SumKills().Add(phenotype.GetLastKills());
-
-      Apto::Array<Apto::Stat::Accumulator<int> >& pred_inst_exe_counts = stats.InstPredExeCountsForInstSet((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
-      for (int j = 0; j < phenotype.GetLastInstCount().GetSize(); j++) {
-        pred_inst_exe_counts[j].Add(organism->GetPhenotype().GetLastInstCount()[j]);
-      }
-
-      Apto::Array<Apto::Stat::Accumulator<int> >& pred_from_sensor_exec_counts = stats.InstPredFromSensorExeCountsForInstSet((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
-      for (int j = 0; j < phenotype.GetLastFromSensorInstCount().GetSize(); j++) {
-        pred_from_sensor_exec_counts[j].Add(organism->GetPhenotype().GetLastFromSensorInstCount()[j]);
-      }
-
-      Apto::Array<cString> att_inst = m_world->GetStats().GetGroupAttackInsts((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
-      for (int k = 0; k < att_inst.GetSize(); k++) {
-        Apto::Array<Apto::Stat::Accumulator<int> >& group_attack_inst_exe_counts = stats.ExecCountsForGroupAttackInst((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue(), att_inst[k]);
-        for (int j = 0; j < phenotype.GetLastGroupAttackInstCount()[k].GetSize(); j++) {
-          group_attack_inst_exe_counts[j].Add(organism->GetPhenotype().GetLastGroupAttackInstCount()[k][j]);
-        }
-      }
-    }
-    else {
-      stats.SumTopPredFitness().Add(cur_fitness);
-      stats.SumTopPredGestation().Add(phenotype.GetGestationTime());
-      stats.SumTopPredMerit().Add(cur_merit.GetDouble());
-      stats.SumTopPredCreatureAge().Add(phenotype.GetAge());
-      stats.SumTopPredGeneration().Add(phenotype.GetGeneration());
-      stats.SumAttacks().Add(phenotype.GetLastAttacks());
-      stats.SumKills().Add(phenotype.GetLastKills());
-     
-      Apto::Array<Apto::Stat::Accumulator<int> >& tpred_inst_exe_counts = stats.InstTopPredExeCountsForInstSet((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
-      for (int j = 0; j < phenotype.GetLastInstCount().GetSize(); j++) {
-        tpred_inst_exe_counts[j].Add(organism->GetPhenotype().GetLastInstCount()[j]);
-      }
-      Apto::Array<Apto::Stat::Accumulator<int> >& tpred_from_sensor_exec_counts = stats.InstTopPredFromSensorExeCountsForInstSet((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
-      for (int j = 0; j < phenotype.GetLastFromSensorInstCount().GetSize(); j++) {
-        tpred_from_sensor_exec_counts[j].Add(organism->GetPhenotype().GetLastFromSensorInstCount()[j]);
-      }
-      Apto::Array<cString> att_inst = m_world->GetStats().GetGroupAttackInsts((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
-      for (int k = 0; k < att_inst.GetSize(); k++) {
-        Apto::Array<Apto::Stat::Accumulator<int> >& group_attack_inst_exe_counts = stats.ExecCountsForGroupAttackInst((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue(), att_inst[k]);
-        for (int j = 0; j < phenotype.GetLastTopPredGroupAttackInstCount()[k].GetSize(); j++) {
-          group_attack_inst_exe_counts[j].Add(organism->GetPhenotype().GetLastTopPredGroupAttackInstCount()[k][j]);
-        }
-      }
-    }
-    
-    // Record what add bonuses this organism garnered for different reactions
-    /*    for (int j = 0; j < m_world->GetEnvironment().GetNumReactions(); j++) {
-     if (phenotype.GetCurReactionCount()[j] > 0) {
-     stats.AddCurReaction(j);
-     stats.AddCurReactionAddReward(j, phenotype.GetCurReactionAddReward()[j]);
-     }
-     
-     if (phenotype.GetLastReactionCount()[j] > 0) {
-     stats.AddLastReaction(j);
-     stats.IncReactionExeCount(j, phenotype.GetLastReactionCount()[j]);
-     stats.AddLastReactionAddReward(j, phenotype.GetLastReactionAddReward()[j]);
-     }
-     }*/
-    
-  }
-}
-
-void cPopulation::UpdateMaleFemaleOrgStats(cAvidaContext& ctx)
-{
-  // Get per-org stats seperately for males and females
-  cStats& stats = m_world->GetStats();
-  
-  // Clear out organism sums...
-  stats.SumMaleFitness().Clear();
-  stats.SumMaleGestation().Clear();
-  stats.SumMaleMerit().Clear();
-  stats.SumMaleCreatureAge().Clear();
-  stats.SumMaleGeneration().Clear();
-  
-  stats.SumFemaleFitness().Clear();
-  stats.SumFemaleGestation().Clear();
-  stats.SumFemaleMerit().Clear();
-  stats.SumFemaleCreatureAge().Clear();
-  stats.SumFemaleGeneration().Clear();
-  
-  stats.ZeroMTInst();
-  
-  for (int i = 0; i < live_org_list.GetSize(); i++) {  
-    cOrganism* organism = live_org_list[i];
-    const cPhenotype& phenotype = organism->GetPhenotype();
-    const cMerit cur_merit = phenotype.GetMerit();
-    const double cur_fitness = phenotype.GetFitness();
-    
-    if(organism->GetPhenotype().GetMatingType() == MATING_TYPE_MALE) {
-      stats.SumMaleFitness().Add(cur_fitness);
-      stats.SumMaleGestation().Add(phenotype.GetGestationTime());
-      stats.SumMaleMerit().Add(cur_merit.GetDouble());
-      stats.SumMaleCreatureAge().Add(phenotype.GetAge());
-      stats.SumMaleGeneration().Add(phenotype.GetGeneration());
-      
-      Apto::Array<Apto::Stat::Accumulator<int> >& male_inst_exe_counts = stats.InstMaleExeCountsForInstSet((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
-      for (int j = 0; j < phenotype.GetLastInstCount().GetSize(); j++) {
-        male_inst_exe_counts[j].Add(organism->GetPhenotype().GetLastInstCount()[j]);
-      }
-    }
-    else if (organism->GetPhenotype().GetMatingType() == MATING_TYPE_FEMALE) {
-      stats.SumFemaleFitness().Add(cur_fitness);
-      stats.SumFemaleGestation().Add(phenotype.GetGestationTime());
-      stats.SumFemaleMerit().Add(cur_merit.GetDouble());
-      stats.SumFemaleCreatureAge().Add(phenotype.GetAge());
-      stats.SumFemaleGeneration().Add(phenotype.GetGeneration());
-      
-      Apto::Array<Apto::Stat::Accumulator<int> >& female_inst_exe_counts = stats.InstFemaleExeCountsForInstSet((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
-      for (int j = 0; j < phenotype.GetLastInstCount().GetSize(); j++) {
-        female_inst_exe_counts[j].Add(organism->GetPhenotype().GetLastInstCount()[j]);
-      }
-    }
-  }
-}
-
 void cPopulation::UpdateResStats(cAvidaContext& ctx) 
 {
   cStats& stats = m_world->GetStats();
@@ -6234,14 +5896,18 @@ void cPopulation::ProcessPostUpdate(cAvidaContext& ctx)
   
   UpdateDemeStats(ctx); 
   UpdateOrganismStats(ctx);
-  if (m_world->GetConfig().PRED_PREY_SWITCH.Get() == -2 || m_world->GetConfig().PRED_PREY_SWITCH.Get() > -1) {
-    UpdateFTOrgStats(ctx);
-  }
-  if (m_world->GetConfig().MATING_TYPES.Get()) {
-    UpdateMaleFemaleOrgStats(ctx);
-  }
   
   for (int i = 0; i < deme_array.GetSize(); i++) deme_array[i].ProcessUpdate(ctx);   
+  
+  ResetDemeClock();
+}
+
+// Fold the elapsed time into every deme and restart the shared clock, keeping its magnitude (and round off) bounded
+void cPopulation::ResetDemeClock()
+{
+  for (int i = 0; i < deme_array.GetSize(); i++) deme_array[i].GetDemeResources().SyncClock();
+  m_deme_clock = 0.0;
+  for (int i = 0; i < deme_array.GetSize(); i++) deme_array[i].GetDemeResources().AttachClock(&m_deme_clock);
 }
 
 void cPopulation::ProcessUpdateCellActions(cAvidaContext& ctx)
@@ -6844,6 +6510,16 @@ bool cPopulation::LoadPopulation(const cString& filename, cAvidaContext& ctx, in
     }
   }
   
+  return injectLoadedGenotypes(ctx, genotypes, structured, filename, cellid_offset, lineage_offset, load_groups,
+                               load_birth_cells, load_rebirth, load_parent_dat, traceq);
+}
+
+
+bool cPopulation::injectLoadedGenotypes(cAvidaContext& ctx, Apto::Array<sTmpGenotype, Apto::ManagedPointer>& genotypes,
+                                        bool structured, const cString& filename, int cellid_offset, int lineage_offset,
+                                        bool load_groups, bool load_birth_cells, bool load_rebirth, bool load_parent_dat,
+                                        int traceq)
+{
   // Sort genotypes in descending order according to their id_num
   Apto::QSort(genotypes);
   
@@ -6899,7 +6575,7 @@ bool cPopulation::LoadPopulation(const cString& filename, cAvidaContext& ctx, in
       
       assert(tmp.bg->Properties().Has("genome"));
       Genome mg(tmp.bg->Properties().Get("genome"));
-      cOrganism* new_organism = new cOrganism(m_world, ctx, mg, -1, Systematics::Source(Systematics::DIVISION, (const char*)filename, true));
+      cOrganism* new_organism = new (m_world) cOrganism(m_world, ctx, mg, -1, Systematics::Source(Systematics::DIVISION, (const char*)filename, true));
       
       // Setup the phenotype...
       cPhenotype& phenotype = new_organism->GetPhenotype();
@@ -7018,6 +6694,302 @@ bool cPopulation::LoadPopulation(const cString& filename, cAvidaContext& ctx, in
   return true;
 }
 
+
+bool cPopulation::BuildCheckpoint(cPopulationCheckpoint& checkpoint)
+{
+  cAvidaContext& ctx = m_world->GetDefaultContext();
+  checkpoint.SetUpdate(m_world->GetStats().GetUpdate());
+  checkpoint.SetWorldSize(world_x, world_y);
+
+  // Genotype rows are added the first time a genotype is encountered, keyed by systematics id
+  Apto::Map<int, int> genotype_idx;
+  Apto::Map<int, int> parasite_idx;
+  Apto::Array<Apto::String> names;
+  Apto::Array<Apto::String> values;
+  int columns[cPopulationCheckpoint::NUM_CELL_COLUMNS];
+
+  for (int cell = 0; cell < cell_array.GetSize(); cell++) {
+    if (!cell_array[cell].IsOccupied()) continue;
+    cOrganism* org = cell_array[cell].GetOrganism();
+
+    const Apto::Array<Systematics::UnitPtr>& parasites = org->GetParasites();
+    for (int p = 0; p < parasites.GetSize(); p++) {
+      Systematics::GroupPtr pg = parasites[p]->SystematicsGroup("genotype");
+      if (pg == NULL) continue;
+
+      int idx = -1;
+      if (!parasite_idx.Get(pg->ID(), idx)) {
+        if (!pg->LegacySaveProperties(names, values)) continue;
+        idx = checkpoint.AddGenotype(names, values, true);
+        parasite_idx.Set(pg->ID(), idx);
+      }
+      const int parasite_columns[cPopulationCheckpoint::NUM_CELL_COLUMNS] = { cell, 0, -1, -1, -1, 0, -1, -1, -1, 0 };
+      checkpoint.AddCell(idx, parasite_columns, 1.0, 0.0);
+    }
+
+    Systematics::GroupPtr genotype = org->SystematicsGroup("genotype");
+    if (genotype == NULL) continue;
+
+    int idx = -1;
+    if (!genotype_idx.Get(genotype->ID(), idx)) {
+      if (!genotype->LegacySaveProperties(names, values)) continue;
+      idx = checkpoint.AddGenotype(names, values);
+      genotype_idx.Set(genotype->ID(), idx);
+    }
+
+    cPhenotype& phenotype = org->GetPhenotype();
+    columns[cPopulationCheckpoint::CELL_ID] = cell;
+    columns[cPopulationCheckpoint::CELL_GEST_OFFSET] = phenotype.GetCPUCyclesUsed();
+    columns[cPopulationCheckpoint::CELL_LINEAGE] = org->GetLineageLabel();
+    columns[cPopulationCheckpoint::CELL_GROUP_ID] = (org->HasOpinion()) ? org->GetOpinion().first : -1;
+    columns[cPopulationCheckpoint::CELL_FORAGER_TYPE] = org->GetForageTarget();
+    columns[cPopulationCheckpoint::CELL_BIRTH_CELL] = phenotype.GetBirthCell();
+    columns[cPopulationCheckpoint::CELL_AVATAR_CELL] = org->GetOrgInterface().GetAVCellID();
+    columns[cPopulationCheckpoint::CELL_AV_BCELL] = phenotype.GetAVBirthCell();
+    columns[cPopulationCheckpoint::CELL_PARENT_FT] = org->GetParentFT();
+    columns[cPopulationCheckpoint::CELL_PARENT_IS_TEACH] = (org->HadParentTeacher()) ? 1 : 0;
+    checkpoint.AddCell(idx, columns, org->GetParentMerit(), phenotype.GetMerit().GetDouble());
+
+    // A checkpoint that restarts some organisms from their genomes would not continue the run, refuse to build one
+    cStateBuffer state;
+    if (!org->TransferState(state)) {
+      m_world->GetDriver().Feedback().Error("hardware type %d does not support checkpoints, organism in cell %d cannot be saved",
+                                            org->GetHardware().GetType(), cell);
+      return false;
+    }
+    checkpoint.SetCellState(state.GetData(), state.GetSize());
+  }
+
+  // Resources
+  const Apto::Array<double>& levels = resource_count.GetResources(ctx);
+  const Apto::Array<Apto::Array<double> >& spatial_levels = resource_count.GetSpatialRes(ctx);
+  Apto::Array<int> spatial(levels.GetSize());
+  Apto::Array<Apto::Array<double> > spatial_copy(levels.GetSize());
+  for (int i = 0; i < levels.GetSize(); i++) {
+    spatial[i] = resource_count.IsSpatialResource(i) ? 1 : 0;
+    if (spatial[i]) spatial_copy[i] = spatial_levels[i];
+  }
+  checkpoint.SetResources(levels, spatial, spatial_copy);
+
+  // The generator state itself is opaque, so draw a fresh seed and continue the run from it.  The scheduler carries its
+  // own generator and position, rebuild it from the new seed so that the saving run and a restored run schedule
+  // identically.  Priorities are saved as rebuilt, as they may include deme merits that are not checkpointed.
+  Apto::Random& rng = m_world->GetRandom();
+  const int seed = rng.GetInt(rng.MaxSeed());
+  rng.ResetSeed(seed);
+  checkpoint.SetRNGSeed(seed);
+  rebuildScheduler();
+  checkpoint.SetSchedulePriorities(m_schedule_priority);
+
+  Apto::Array<int> triggers;
+  Apto::Array<double> original_starts, intervals, starts;
+  m_world->GetEventsList()->GetEventPositions(triggers, original_starts, intervals, starts);
+  checkpoint.SetEvents(triggers, original_starts, intervals, starts);
+
+  return true;
+}
+
+
+bool cPopulation::SaveCheckpoint(const cString& filename, bool compress)
+{
+  cPopulationCheckpoint checkpoint;
+  if (!BuildCheckpoint(checkpoint)) return false;
+  return checkpoint.Save(cPopulationCheckpoint::OutputPath(m_world, filename), compress);
+}
+
+
+void cPopulation::SaveCheckpointAsync(const cString& filename, bool compress)
+{
+  if (!m_checkpoint_writer) m_checkpoint_writer = new cCheckpointWriter(m_world->GetConfig().CHECKPOINT_MAX_PENDING.Get());
+
+  // Report failures of earlier writes, the writer thread cannot do so itself
+  Apto::Array<cString> failed;
+  m_checkpoint_writer->TakeFailures(failed);
+  for (int i = 0; i < failed.GetSize(); i++) {
+    m_world->GetDriver().Feedback().Error("failed to save checkpoint '%s'", (const char*)failed[i]);
+  }
+
+  cPopulationCheckpoint* checkpoint = new cPopulationCheckpoint;
+  if (!BuildCheckpoint(*checkpoint)) {
+    delete checkpoint;
+    m_world->GetDriver().Feedback().Error("failed to save checkpoint '%s'", (const char*)filename);
+    return;
+  }
+  m_checkpoint_writer->Submit(checkpoint, cPopulationCheckpoint::OutputPath(m_world, filename), compress);
+}
+
+
+void cPopulation::FlushCheckpoints()
+{
+  if (!m_checkpoint_writer) return;
+  m_checkpoint_writer->Flush();
+
+  Apto::Array<cString> failed;
+  m_checkpoint_writer->TakeFailures(failed);
+  for (int i = 0; i < failed.GetSize(); i++) {
+    m_world->GetDriver().Feedback().Error("failed to save checkpoint '%s'", (const char*)failed[i]);
+  }
+}
+
+
+bool cPopulation::LoadCheckpoint(const cString& filename, cAvidaContext& ctx, bool restore_world, int cellid_offset,
+                                 int lineage_offset)
+{
+  // The checkpoint may still be queued for writing in the background
+  FlushCheckpoints();
+
+  cPopulationCheckpointView view;
+  if (!view.Open(cPopulationCheckpoint::InputPath(m_world, filename))) return false;
+
+  // Clear out the population, unless an offset is being used
+  if (cellid_offset == 0) {
+    for (int i = 0; i < cell_array.GetSize(); i++) KillOrganism(cell_array[i], ctx);
+  }
+
+  // Gather the resident rows of each (host) genotype
+  Apto::Array<Apto::Array<int> > rows(view.GetNumGenotypes());
+  const int* row_genotype = view.GetCellGenotypes();
+  for (int row = 0; row < view.GetNumCells(); row++) {
+    if (!view.IsParasite(row_genotype[row])) rows[row_genotype[row]].Push(row);
+  }
+
+  const int* cell_ids = view.GetCellColumn(cPopulationCheckpoint::CELL_ID);
+  const int* gest_offsets = view.GetCellColumn(cPopulationCheckpoint::CELL_GEST_OFFSET);
+  const int* lineages = view.GetCellColumn(cPopulationCheckpoint::CELL_LINEAGE);
+  const int* group_ids = view.GetCellColumn(cPopulationCheckpoint::CELL_GROUP_ID);
+  const int* forager_types = view.GetCellColumn(cPopulationCheckpoint::CELL_FORAGER_TYPE);
+  const int* avatar_cells = view.GetCellColumn(cPopulationCheckpoint::CELL_AVATAR_CELL);
+  const int* parent_fts = view.GetCellColumn(cPopulationCheckpoint::CELL_PARENT_FT);
+  const int* parent_teach = view.GetCellColumn(cPopulationCheckpoint::CELL_PARENT_IS_TEACH);
+  const double* parent_merits = view.GetCellParentMerits();
+
+  int num_hosts = 0;
+  for (int g = 0; g < view.GetNumGenotypes(); g++) if (!view.IsParasite(g)) num_hosts++;
+
+  Apto::Array<sTmpGenotype, Apto::ManagedPointer> genotypes(num_hosts);
+  bool load_groups = false;
+  for (int g = 0, host = 0; g < view.GetNumGenotypes(); g++) {
+    if (view.IsParasite(g)) continue;
+
+    sTmpGenotype& tmp = genotypes[host++];
+    tmp.props = Apto::SmartPtr<Apto::Map<Apto::String, Apto::String> >(new Apto::Map<Apto::String, Apto::String>);
+    for (int f = 0; f < view.GetNumFields(); f++) tmp.props->Set(view.GetFieldName(f), view.GetField(g, f));
+    tmp.props->Set("parent_merit", "");
+    tmp.id_num = Apto::StrAs(tmp.props->Get("id"));
+    tmp.num_cpus = rows[g].GetSize();
+
+    for (int i = 0; i < rows[g].GetSize(); i++) {
+      const int row = rows[g][i];
+      tmp.cells.Push(cell_ids[row]);
+      tmp.offsets.Push(gest_offsets[row]);
+      tmp.lineage_labels.Push(lineages[row]);
+      tmp.group_ids.Push(group_ids[row]);
+      tmp.forager_types.Push(forager_types[row]);
+      tmp.avatar_cells.Push(avatar_cells[row]);
+      tmp.parent_ft.Push(parent_fts[row]);
+      tmp.parent_teacher.Push(parent_teach[row] != 0);
+      tmp.parent_merit.Push(parent_merits[row]);
+      if (group_ids[row] != -1) load_groups = true;
+    }
+  }
+
+  if (!injectLoadedGenotypes(ctx, genotypes, true, filename, cellid_offset, lineage_offset, load_groups, false, false, true,
+                             0)) {
+    return false;
+  }
+
+  // Restore the exact merit of every organism, in place of the gestation offset estimate used for .spop files
+  if (view.HasSection(cPopulationCheckpoint::SECTION_PHENOTYPES) && !m_world->GetConfig().ENERGY_ENABLED.Get()) {
+    const double* merits = view.GetCellMerits();
+    for (int row = 0; row < view.GetNumCells(); row++) {
+      if (view.IsParasite(row_genotype[row]) || merits[row] <= 0.0) continue;
+      const int cell_id = cell_ids[row] + cellid_offset;
+      if (cell_id < 0 || cell_id >= cell_array.GetSize() || !cell_array[cell_id].IsOccupied()) continue;
+      cPhenotype& phenotype = cell_array[cell_id].GetOrganism()->GetPhenotype();
+      phenotype.SetMerit(cMerit(merits[row]));
+      AdjustSchedule(cell_array[cell_id], phenotype.GetMerit());
+    }
+  }
+
+  // Restore saved execution state, after which organisms resume mid-gestation exactly where they were checkpointed
+  if (view.HasSection(cPopulationCheckpoint::SECTION_STATE)) {
+    for (int row = 0; row < view.GetNumCells(); row++) {
+      int size = 0;
+      const char* data = view.GetCellState(row, size);
+      if (view.IsParasite(row_genotype[row]) || !data) continue;
+      const int cell_id = cell_ids[row] + cellid_offset;
+      if (cell_id < 0 || cell_id >= cell_array.GetSize() || !cell_array[cell_id].IsOccupied()) continue;
+
+      cStateBuffer state(data, size);
+      cOrganism* org = cell_array[cell_id].GetOrganism();
+      if (!org->TransferState(state)) {
+        m_world->GetDriver().Feedback().Error("unable to restore the execution state of cell %d from '%s'", cell_id,
+                                              (const char*)filename);
+        return false;
+      }
+      AdjustSchedule(cell_array[cell_id], org->GetPhenotype().GetMerit());
+    }
+  }
+
+  if (!restore_world) return true;
+
+  m_world->GetStats().SetCurrentUpdate(view.GetUpdate());
+
+  // Resources are only restored into an identically configured environment
+  const cResourceCount& resources = resource_count;
+  if (view.GetNumResources() == resources.GetSize()) {
+    Apto::Array<double> cell_levels(resource_count.GetSize());
+    cell_levels.SetAll(0.0);
+    bool restore_spatial = true;
+    for (int i = 0; i < view.GetNumResources(); i++) {
+      if (view.IsSpatialResource(i) != resources.IsSpatialResource(i)) {
+        restore_spatial = false;
+      } else if (!view.IsSpatialResource(i)) {
+        resource_count.Set(ctx, i, view.GetResource(i));
+      } else if (resources.GetSpatialResource(i).GetSize() != view.GetNumResourceCells()) {
+        restore_spatial = false;
+      }
+    }
+    for (int cell_id = 0; restore_spatial && cell_id < view.GetNumResourceCells(); cell_id++) {
+      for (int i = 0; i < view.GetNumResources(); i++) {
+        cell_levels[i] = (view.IsSpatialResource(i)) ? view.GetSpatialResource(i)[cell_id] : 0.0;
+      }
+      resource_count.SetCellResources(cell_id, cell_levels);
+    }
+  }
+
+  // Reseed exactly as the saving run did and rebuild the scheduler from that seed, then put back the saved priorities
+  int seed = 0;
+  if (view.GetVersion() == 2) {
+    m_world->GetDriver().Feedback().Error("'%s' holds raw generator state (checkpoint version 2), which is no longer supported",
+                                          (const char*)filename);
+    return false;
+  }
+  if (view.GetRNGSeed(seed)) {
+    m_world->GetRandom().ResetSeed(seed);
+    rebuildScheduler();
+    if (view.GetNumSchedulePriorities() == cell_array.GetSize()) {
+      const double* priorities = view.GetSchedulePriorities();
+      for (int i = 0; i < cell_array.GetSize(); i++) {
+        m_schedule_priority[i] = priorities[i];
+        m_scheduler->AdjustPriority(i, priorities[i]);
+      }
+    }
+  }
+
+  if (view.HasSection(cPopulationCheckpoint::SECTION_EVENTS)) {
+    Apto::Array<int> triggers;
+    Apto::Array<double> original_starts, intervals, starts;
+    view.GetEvents(triggers, original_starts, intervals, starts);
+    m_world->GetEventsList()->SetEventPositions(triggers, original_starts, intervals, starts);
+
+    // Event positions are exact, no need to fast forward them to the restored update
+    sync_events = false;
+  }
+
+  return true;
+}
+
 /**
  * This function loads a genome from a given file, and initializes
  * a cpu with it.
@@ -7311,6 +7283,9 @@ void cPopulation::ResetInputs(cAvidaContext& ctx)
 
 void cPopulation::BuildTimeSlicer()
 {
+  m_schedule_priority.Resize(cell_array.GetSize());
+  m_schedule_priority.SetAll(0.0);
+
   switch (m_world->GetConfig().SLICING_METHOD.Get()) {
     case SLICE_CONSTANT:
       m_scheduler = new Apto::Scheduler::RoundRobin(cell_array.GetSize());
@@ -7344,6 +7319,17 @@ void cPopulation::BuildTimeSlicer()
 }
 
 
+void cPopulation::rebuildScheduler()
+{
+  delete m_scheduler;
+  m_scheduler = NULL;
+  BuildTimeSlicer();
+  for (int i = 0; i < cell_array.GetSize(); i++) {
+    if (cell_array[i].IsOccupied()) AdjustSchedule(cell_array[i], cell_array[i].GetOrganism()->GetPhenotype().GetMerit());
+  }
+}
+
+
 void cPopulation::FindEmptyCell(tList<cPopulationCell> & cell_list,
                                 tList<cPopulationCell> & found_list)
 {
@@ -7366,7 +7352,7 @@ void cPopulation::InjectClone(int cell_id, cOrganism& orig_org, Systematics::Sou
   
   cAvidaContext& ctx = m_world->GetDefaultContext();
   
-  cOrganism* new_organism = new cOrganism(m_world, ctx, orig_org.GetGenome(), orig_org.GetPhenotype().GetGeneration(), src);
+  cOrganism* new_organism = new (m_world) cOrganism(m_world, ctx, orig_org.GetGenome(), orig_org.GetPhenotype().GetGeneration(), src);
   Systematics::UnitPtr unit(new_organism);
   new_organism->AddReference(); // creating new smart pointer to new_organism, explicitly add reference
   
@@ -7430,7 +7416,7 @@ void cPopulation::CompeteOrganisms_ConstructOffspring(int cell_id, cOrganism& pa
   Genome child_genome = parent.OffspringGenome();
   parent.GetHardware().Divide_TestFitnessMeasures(ctx);
   parent.OffspringGenome() = save_child;
-  cOrganism* new_organism = new cOrganism(m_world, ctx, child_genome, parent.GetPhenotype().GetGeneration(), Systematics::Source(Systematics::DUPLICATION, ""));
+  cOrganism* new_organism = new (m_world) cOrganism(m_world, ctx, child_genome, parent.GetPhenotype().GetGeneration(), Systematics::Source(Systematics::DUPLICATION, ""));
   
   // Classify the offspring
   Systematics::ConstParentGroupsPtr pgrps(new Systematics::ConstParentGroups(1));
@@ -7473,7 +7459,7 @@ void cPopulation::InjectGenome(int cell_id, Systematics::Source src, const Genom
   }
   
   
-  cOrganism* new_organism = new cOrganism(m_world, ctx, genome, -1, src);
+  cOrganism* new_organism = new (m_world) cOrganism(m_world, ctx, genome, -1, src);
   
   // Setup the phenotype...
   cPhenotype& phenotype = new_organism->GetPhenotype();
@@ -44,6 +44,11 @@ class cEnvironment;
 class cLineage;
 class cOrganism;
 class cPopulationCell;
+class cCheckpointWriter;
+class cPopulationCheckpoint;
+class cOrgStatSweep;
+class cRowBandPool;
+struct sTmpGenotype;
 
 using namespace Avida;
 
@@ -66,9 +71,13 @@ private:
   // Components...
   cWorld* m_world;
   Apto::PriorityScheduler* m_scheduler;                // Handles allocation of CPU cycles
+  Apto::Array<double> m_schedule_priority;             // Priority last given to each cell in m_scheduler
   Apto::Array<cPopulationCell> cell_array;  // Local cells composing the population
   Apto::Array<int> empty_cell_id_array;     // Used for PREFER_EMPTY birth methods
   cResourceCount resource_count;       // Global resources available
+  cRowBandPool* m_band_pool;           // Worker threads shared by every banded pass of this world (see cRowBandPool)
+  cOrgStatSweep* m_stat_sweep;         // Gathers the per-organism stats at the end of each update
+  cCheckpointWriter* m_checkpoint_writer; // Background writer for SaveCheckpointAsync (created on first use)
   cBirthChamber birth_chamber;         // Global birth chamber.
   //Keeps track of which organisms are in which group.
   Apto::Map<int, Apto::Array<cOrganism*, Apto::Smart> > m_group_list;
@@ -112,6 +121,7 @@ private:
   int num_top_pred_organisms;
   
   Apto::Array<cDeme> deme_array;            // Deme structure of the population.
+  double m_deme_clock;                      // Update time elapsed this update, shared lazily by all deme resource counts
  
   // Outside interactions...
   bool sync_events;   // Do we need to sync up the event list with population?
@@ -279,6 +289,12 @@ public:
   bool LoadStructuredSystematicsGroup(cAvidaContext& ctx, const Systematics::RoleID& role, const cString& filename);
   bool LoadPopulation(const cString& filename, cAvidaContext& ctx, int cellid_offset=0, int lineage_offset=0,
                       bool load_groups = false, bool load_birth_cells = false, bool load_avatars = false, bool load_rebirth = false, bool load_parent_dat = false, int traceq = 0);
+  bool BuildCheckpoint(cPopulationCheckpoint& checkpoint);
+  bool SaveCheckpoint(const cString& filename, bool compress = false);
+  void SaveCheckpointAsync(const cString& filename, bool compress = false);
+  void FlushCheckpoints();
+  bool LoadCheckpoint(const cString& filename, cAvidaContext& ctx, bool restore_world = true, int cellid_offset = 0,
+                      int lineage_offset = 0);
   bool SaveFlameData(const cString& filename);
   
   void SetMiniTraceQueue(Apto::Array<int, Apto::Smart> new_queue, const bool print_genomes, const bool print_reacs, const bool use_micro = false);
@@ -330,6 +346,7 @@ public:
   void SetResource(cAvidaContext& ctx, const cString res_name, double new_level);
   double GetResource(cAvidaContext& ctx, int id) const { return resource_count.Get(ctx, id); }
   cResourceCount& GetResourceCount() { return resource_count; }
+  cRowBandPool* GetBandPool() { return m_band_pool; }
   void SetResourceInflow(const cString res_name, double new_level);
   void SetResourceOutflow(const cString res_name, double new_level);
   
@@ -452,6 +469,8 @@ private:
   void SetupCellGrid();
   void ClearCellGrid();
   void BuildTimeSlicer(); // Build the schedule object
+  void rebuildScheduler(); // Rebuild the schedule object from the current organism merits
+  void ResetDemeClock();
   
   // Methods to place offspring in the population.
   cPopulationCell& PositionOffspring(cPopulationCell& parent_cell, cAvidaContext& ctx, bool parent_ok = true); 
@@ -468,8 +487,6 @@ private:
   // Update statistics collecting...
   void UpdateDemeStats(cAvidaContext& ctx); 
   void UpdateOrganismStats(cAvidaContext& ctx); 
-  void UpdateFTOrgStats(cAvidaContext& ctx); 
-  void UpdateMaleFemaleOrgStats(cAvidaContext& ctx);
   
   void InjectClone(int cell_id, cOrganism& orig_org, Systematics::Source src);
   void CompeteOrganisms_ConstructOffspring(int cell_id, cOrganism& parent);
@@ -492,6 +509,9 @@ private:
   inline void AdjustSchedule(const cPopulationCell& cell, const cMerit& merit);
   
   bool LoadGenotypeList(const cString& filename, cAvidaContext& ctx, Apto::Array<GeneticRepresentationPtr>& list_obj);
+  bool injectLoadedGenotypes(cAvidaContext& ctx, Apto::Array<sTmpGenotype, Apto::ManagedPointer>& genotypes, bool structured,
+                             const cString& filename, int cellid_offset, int lineage_offset, bool load_groups,
+                             bool load_birth_cells, bool load_rebirth, bool load_parent_dat, int traceq);
 };
 
 #endif
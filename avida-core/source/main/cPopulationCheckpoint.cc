@@ -0,0 +1,902 @@
+/*
+ *  cPopulationCheckpoint.cc
+ *  Avida
+ *
+ *  Copyright 2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cPopulationCheckpoint.h"
+
+#include "avida/output/File.h"
+#include "avida/output/Manager.h"
+
+#include "apto/core/FileSystem.h"
+#include "apto/platform.h"
+
+#include "cInitFile.h"
+#include "cStringList.h"
+#include "cStringUtil.h"
+#include "cWorld.h"
+
+#include <cstdio>
+#include <cstring>
+
+#if APTO_PLATFORM(WINDOWS)
+# include <io.h>
+# include <windows.h>
+#else
+extern "C" {
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+}
+#endif
+
+using namespace Avida;
+
+
+static const char CHECKPOINT_MAGIC[8] = { 'A', 'V', 'I', 'D', 'A', 'C', 'K', 'P' };
+static const unsigned int CHECKPOINT_BYTE_ORDER = 0x01020304;
+static const unsigned int SECTION_FLAG_RLE = 0x1;
+static const int MAX_SECTION_ID = cPopulationCheckpoint::MAX_SECTION_ID;
+static const int MAX_SECTION_SIZE = cPopulationCheckpoint::MAX_SECTION_SIZE;
+
+struct sFileHeader
+{
+  char magic[8];
+  unsigned int byte_order;
+  unsigned int version;
+  unsigned int num_sections;
+  unsigned int reserved;
+};
+
+struct sSectionEntry
+{
+  unsigned int id;
+  unsigned int flags;
+  long long offset;
+  long long stored_size;
+  long long size;
+};
+
+
+static const char* s_cell_column_names[cPopulationCheckpoint::NUM_CELL_COLUMNS] = {
+  "cells", "gest_offset", "lineage", "group_id", "forager_type", "birth_cell", "avatar_cell", "av_bcell", "parent_ft",
+  "parent_is_teach"
+};
+
+static const char* s_cell_column_descs[cPopulationCheckpoint::NUM_CELL_COLUMNS] = {
+  "Occupied Cell IDs", "Gestation (CPU) Cycle Offsets", "Lineage Label", "Current Group IDs", "Current Forager Types",
+  "Birth Cells", "Current Avatar Cell Locations", "Avatar Birth Cell", "Parent forager type", "Was Parent a Teacher"
+};
+
+// Values used for cell columns that a .spop file does not supply, matching those written by cPopulation::SavePopulation
+static const int s_cell_column_defaults[cPopulationCheckpoint::NUM_CELL_COLUMNS] = { 0, 0, 0, -1, -1, 0, -1, -1, -1, 0 };
+
+static const char* s_parent_merit_name = "parent_merit";
+
+
+// Descriptions of the genotype columns written by Systematics::Genotype::LegacySave
+static const char* legacyFieldDescription(const char* name)
+{
+  static const char* const descs[][2] = {
+    { "id", "ID" }, { "src", "Source" }, { "src_args", "Source Args" }, { "parents", "Parent ID(s)" },
+    { "num_units", "Number of currently living organisms" },
+    { "total_units", "Total number of organisms that ever existed" }, { "length", "Genome Length" },
+    { "merit", "Average Merit" }, { "gest_time", "Average Gestation Time" }, { "fitness", "Average Fitness" },
+    { "gen_born", "Generation Born" }, { "update_born", "Update Born" },
+    { "update_deactivated", "Update Deactivated" }, { "depth", "Phylogenetic Depth" },
+    { "hw_type", "Hardware Type ID" }, { "inst_set", "Inst Set Name" }, { "sequence", "Genome Sequence" }
+  };
+  for (unsigned int i = 0; i < sizeof(descs) / sizeof(descs[0]); i++) if (strcmp(name, descs[i][0]) == 0) return descs[i][1];
+  return name;
+}
+
+
+// cSectionBuffer
+//
+// Growable byte buffer used to assemble a section before it is written.  Every array appended is padded to a multiple
+// of 8 bytes, so that all columns within a section remain naturally aligned.
+
+class cSectionBuffer
+{
+private:
+  Apto::Array<char> m_data;
+  int m_size;
+  bool m_overflow;
+
+  bool reserve(long long bytes)
+  {
+    if (m_overflow || m_size + bytes > MAX_SECTION_SIZE) {
+      m_overflow = true;
+      return false;
+    }
+    if (m_size + bytes <= m_data.GetSize()) return true;
+    long long new_size = (m_data.GetSize()) ? m_data.GetSize() : 256;
+    while (new_size < m_size + bytes) new_size *= 2;
+    if (new_size > MAX_SECTION_SIZE) new_size = MAX_SECTION_SIZE;
+    m_data.Resize((int)new_size);
+    return true;
+  }
+
+public:
+  cSectionBuffer() : m_size(0), m_overflow(false) { ; }
+
+  int GetSize() const { return m_size; }
+  const char* GetData() const { return (m_size) ? &m_data[0] : NULL; }
+
+  // Set once an append would have grown the section beyond MAX_SECTION_SIZE; everything after it is dropped
+  bool HasOverflowed() const { return m_overflow; }
+
+  void Append(const void* data, long long bytes)
+  {
+    if (!bytes || !reserve(bytes)) return;
+    memcpy(&m_data[m_size], data, (size_t)bytes);
+    m_size += (int)bytes;
+  }
+
+  void Align()
+  {
+    const int pad = (8 - (m_size % 8)) % 8;
+    if (!pad || !reserve(pad)) return;
+    for (int i = 0; i < pad; i++) m_data[m_size++] = 0;
+  }
+
+  void AppendInts(int a, int b) { int pair[2] = { a, b }; Append(pair, sizeof(pair)); }
+  void AppendInts(const Apto::Array<int>& arr)
+  {
+    if (arr.GetSize()) Append(&arr[0], (long long)arr.GetSize() * sizeof(int));
+    Align();
+  }
+  void AppendDoubles(const Apto::Array<double>& arr)
+  {
+    if (arr.GetSize()) Append(&arr[0], (long long)arr.GetSize() * sizeof(double));
+    Align();
+  }
+};
+
+
+// Word oriented run-length coding.  The stream is a sequence of runs, each introduced by a 32-bit header; a header with
+// the high bit set is followed by a single word that is repeated (header & 0x7fffffff) times, otherwise it is followed
+// by that many literal words.  Section sizes are always a multiple of 8 bytes, hence of the word size.
+
+static void encodeRuns(const char* src, int size, cSectionBuffer& out)
+{
+  const unsigned int* words = reinterpret_cast<const unsigned int*>(src);
+  const int num_words = size / 4;
+
+  int i = 0;
+  while (i < num_words) {
+    int run = 1;
+    while (i + run < num_words && words[i + run] == words[i]) run++;
+
+    if (run >= 3) {
+      unsigned int header = 0x80000000u | (unsigned int)run;
+      out.Append(&header, 4);
+      out.Append(&words[i], 4);
+      i += run;
+      continue;
+    }
+
+    // Collect literals until the next run worth encoding
+    int lit = 0;
+    while (i + lit < num_words) {
+      if (i + lit + 2 < num_words && words[i + lit] == words[i + lit + 1] && words[i + lit] == words[i + lit + 2]) break;
+      lit++;
+    }
+    unsigned int header = (unsigned int)lit;
+    out.Append(&header, 4);
+    out.Append(&words[i], lit * 4);
+    i += lit;
+  }
+  out.Align();
+}
+
+static bool decodeRuns(const char* src, long long stored_size, char* dest, long long size)
+{
+  const unsigned int* in = reinterpret_cast<const unsigned int*>(src);
+  const long long in_words = stored_size / 4;
+  unsigned int* out = reinterpret_cast<unsigned int*>(dest);
+  const long long out_words = size / 4;
+
+  long long ip = 0;
+  long long op = 0;
+  while (ip < in_words && op < out_words) {
+    const unsigned int header = in[ip++];
+    const long long count = header & 0x7fffffff;
+    if (op + count > out_words) return false;
+    if (header & 0x80000000u) {
+      if (ip >= in_words) return false;
+      const unsigned int value = in[ip++];
+      for (long long i = 0; i < count; i++) out[op++] = value;
+    } else {
+      if (ip + count > in_words) return false;
+      memcpy(&out[op], &in[ip], count * 4);
+      ip += count;
+      op += count;
+    }
+  }
+  return op == out_words;
+}
+
+
+
+const char* cPopulationCheckpoint::CellColumnName(int col)
+{
+  return (col >= 0 && col < NUM_CELL_COLUMNS) ? s_cell_column_names[col] : "";
+}
+
+
+cPopulationCheckpoint::cPopulationCheckpoint()
+: m_update(0), m_world_x(0), m_world_y(0), m_cell_state_total(0), m_cell_state_overflow(false)
+, m_has_rng(false), m_rng_seed(0)
+{
+}
+
+
+int cPopulationCheckpoint::AddGenotype(const Apto::Array<Apto::String>& names, const Apto::Array<Apto::String>& values,
+                                       bool parasite)
+{
+  assert(names.GetSize() == values.GetSize());
+  // Strings are copied rather than shared, so that a finished checkpoint can be handed to another thread
+  if (!m_parasite.GetSize()) {
+    m_field_names.Resize(names.GetSize());
+    for (int i = 0; i < names.GetSize(); i++) m_field_names[i] = Apto::String((const char*)names[i]);
+  }
+  assert(names.GetSize() == m_field_names.GetSize());
+
+  for (int i = 0; i < m_field_names.GetSize(); i++) {
+    m_field_values.Push(Apto::String((i < values.GetSize()) ? (const char*)values[i] : ""));
+  }
+  m_parasite.Push(parasite ? 1 : 0);
+
+  return m_parasite.GetSize() - 1;
+}
+
+
+void cPopulationCheckpoint::AddCell(int genotype_idx, const int* columns, double parent_merit, double merit)
+{
+  assert(genotype_idx >= 0 && genotype_idx < m_parasite.GetSize());
+  m_cell_genotype.Push(genotype_idx);
+  for (int col = 0; col < NUM_CELL_COLUMNS; col++) m_cell_columns[col].Push(columns[col]);
+  m_cell_parent_merit.Push(parent_merit);
+  m_cell_merit.Push(merit);
+  m_cell_state_size.Push(0);
+}
+
+
+void cPopulationCheckpoint::SetCellState(const char* data, int size)
+{
+  assert(m_cell_state_size.GetSize() && m_cell_state_size[m_cell_state_size.GetSize() - 1] == 0);
+  if (m_cell_state_overflow || (long long)m_cell_state_total + size > MAX_SECTION_SIZE) {
+    m_cell_state_overflow = true;
+    return;
+  }
+  if (m_cell_state_total + size > m_cell_state.GetSize()) {
+    long long new_size = (m_cell_state.GetSize()) ? m_cell_state.GetSize() : 4096;
+    while (new_size < m_cell_state_total + size) new_size *= 2;
+    if (new_size > MAX_SECTION_SIZE) new_size = MAX_SECTION_SIZE;
+    m_cell_state.Resize((int)new_size);
+  }
+  if (size) memcpy(&m_cell_state[m_cell_state_total], data, size);
+  m_cell_state_total += size;
+  m_cell_state_size[m_cell_state_size.GetSize() - 1] = size;
+}
+
+
+void cPopulationCheckpoint::SetResources(const Apto::Array<double>& levels, const Apto::Array<int>& spatial,
+                                         const Apto::Array<Apto::Array<double> >& spatial_levels)
+{
+  m_resources = levels;
+  m_resource_spatial = spatial;
+  m_spatial_resources = spatial_levels;
+}
+
+
+void cPopulationCheckpoint::SetEvents(const Apto::Array<int>& triggers, const Apto::Array<double>& original_starts,
+                                      const Apto::Array<double>& intervals, const Apto::Array<double>& starts)
+{
+  m_event_triggers = triggers;
+  m_event_original_starts = original_starts;
+  m_event_intervals = intervals;
+  m_event_starts = starts;
+}
+
+
+bool cPopulationCheckpoint::Save(const cString& filename, bool compress) const
+{
+  cSectionBuffer sections[MAX_SECTION_ID];
+
+  // Meta
+  sections[SECTION_META].AppendInts(m_update, m_world_x);
+  sections[SECTION_META].AppendInts(m_world_y, 0);
+
+  // Genotypes - string table holding the field names followed by the values of every genotype
+  {
+    cSectionBuffer& sec = sections[SECTION_GENOTYPES];
+    const int num_fields = m_field_names.GetSize();
+    sec.AppendInts(m_parasite.GetSize(), num_fields);
+    sec.AppendInts(m_parasite);
+
+    Apto::Array<int> offsets(num_fields + m_field_values.GetSize());
+    cSectionBuffer strings;
+    for (int i = 0; i < offsets.GetSize(); i++) {
+      const Apto::String& str = (i < num_fields) ? m_field_names[i] : m_field_values[i - num_fields];
+      offsets[i] = strings.GetSize();
+      strings.Append((const char*)str, str.GetSize() + 1);
+    }
+    strings.Align();
+    sec.AppendInts(offsets);
+    sec.Append(strings.GetData(), strings.GetSize());
+  }
+
+  // Cells
+  {
+    cSectionBuffer& sec = sections[SECTION_CELLS];
+    sec.AppendInts(m_cell_genotype.GetSize(), 0);
+    sec.AppendInts(m_cell_genotype);
+    for (int col = 0; col < NUM_CELL_COLUMNS; col++) sec.AppendInts(m_cell_columns[col]);
+    sec.AppendDoubles(m_cell_parent_merit);
+  }
+
+  // Phenotypes
+  sections[SECTION_PHENOTYPES].AppendInts(m_cell_merit.GetSize(), 0);
+  sections[SECTION_PHENOTYPES].AppendDoubles(m_cell_merit);
+
+  // Resources
+  {
+    cSectionBuffer& sec = sections[SECTION_RESOURCES];
+    Apto::Array<int> spatial_idx(m_resources.GetSize());
+    int next_spatial = 0;
+    int num_cells = 0;
+    for (int i = 0; i < spatial_idx.GetSize(); i++) {
+      spatial_idx[i] = (i < m_resource_spatial.GetSize() && m_resource_spatial[i]) ? next_spatial++ : -1;
+      if (spatial_idx[i] >= 0) num_cells = m_spatial_resources[i].GetSize();
+    }
+    sec.AppendInts(m_resources.GetSize(), num_cells);
+    sec.AppendInts(spatial_idx);
+    sec.AppendDoubles(m_resources);
+    for (int i = 0; i < spatial_idx.GetSize(); i++) {
+      if (spatial_idx[i] < 0) continue;
+      assert(m_spatial_resources[i].GetSize() == num_cells);
+      sec.AppendDoubles(m_spatial_resources[i]);
+    }
+  }
+
+  // RNG
+  if (m_has_rng) sections[SECTION_RNG].AppendInts(m_rng_seed, 0);
+
+  // Schedule
+  if (m_schedule_priorities.GetSize()) {
+    sections[SECTION_SCHEDULE].AppendInts(m_schedule_priorities.GetSize(), 0);
+    sections[SECTION_SCHEDULE].AppendDoubles(m_schedule_priorities);
+  }
+
+  // Events
+  {
+    cSectionBuffer& sec = sections[SECTION_EVENTS];
+    sec.AppendInts(m_event_triggers.GetSize(), 0);
+    sec.AppendInts(m_event_triggers);
+    sec.AppendDoubles(m_event_original_starts);
+    sec.AppendDoubles(m_event_intervals);
+    sec.AppendDoubles(m_event_starts);
+  }
+
+
+  // State - cell offsets into a single blob, only written if any state was attached
+  if (m_cell_state_total) {
+    cSectionBuffer& sec = sections[SECTION_STATE];
+    Apto::Array<int> offsets(m_cell_state_size.GetSize() + 1);
+    offsets[0] = 0;
+    for (int i = 0; i < m_cell_state_size.GetSize(); i++) offsets[i + 1] = offsets[i] + m_cell_state_size[i];
+    sec.AppendInts(m_cell_state_size.GetSize(), 0);
+    sec.AppendInts(offsets);
+    sec.Append(&m_cell_state[0], m_cell_state_total);
+    sec.Align();
+  }
+
+
+  // Sections beyond MAX_SECTION_SIZE cannot be represented, refuse to write a truncated checkpoint
+  if (m_cell_state_overflow) return false;
+  for (int id = 1; id < MAX_SECTION_ID; id++) if (sections[id].HasOverflowed()) return false;
+
+  // Encode sections, keeping the raw form whenever run-length coding does not pay off
+  cSectionBuffer encoded[MAX_SECTION_ID];
+  sSectionEntry entries[MAX_SECTION_ID];
+  int num_sections = 0;
+  for (int id = 1; id < MAX_SECTION_ID; id++) {
+    if (!sections[id].GetSize()) continue;
+    sSectionEntry& entry = entries[num_sections++];
+    entry.id = id;
+    entry.flags = 0;
+    entry.size = sections[id].GetSize();
+    entry.stored_size = entry.size;
+    if (compress) {
+      encodeRuns(sections[id].GetData(), sections[id].GetSize(), encoded[id]);
+      if (!encoded[id].HasOverflowed() && encoded[id].GetSize() < sections[id].GetSize()) {
+        entry.flags = SECTION_FLAG_RLE;
+        entry.stored_size = encoded[id].GetSize();
+      }
+    }
+  }
+
+  sFileHeader header;
+  memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+  header.byte_order = CHECKPOINT_BYTE_ORDER;
+  header.version = VERSION;
+  header.num_sections = num_sections;
+  header.reserved = 0;
+
+  long long offset = sizeof(sFileHeader) + num_sections * sizeof(sSectionEntry);
+  for (int i = 0; i < num_sections; i++) {
+    entries[i].offset = offset;
+    offset += entries[i].stored_size;
+  }
+
+  // Write to a temporary file that is flushed to disk and then renamed into place, so that an interrupted write never
+  // leaves a partial checkpoint under the final name
+  const cString tmp_filename = filename + ".tmp";
+  FILE* fp = fopen(tmp_filename, "wb");
+  if (!fp) return false;
+
+  bool ok = (fwrite(&header, sizeof(header), 1, fp) == 1);
+  if (ok && num_sections) ok = (fwrite(entries, sizeof(sSectionEntry), num_sections, fp) == (size_t)num_sections);
+  for (int i = 0; ok && i < num_sections; i++) {
+    const cSectionBuffer& buf = (entries[i].flags & SECTION_FLAG_RLE) ? encoded[entries[i].id] : sections[entries[i].id];
+    ok = (fwrite(buf.GetData(), 1, buf.GetSize(), fp) == (size_t)buf.GetSize());
+  }
+
+  if (ok) ok = (fflush(fp) == 0);
+#if APTO_PLATFORM(WINDOWS)
+  if (ok) ok = (_commit(_fileno(fp)) == 0);
+#else
+  if (ok) ok = (fsync(fileno(fp)) == 0);
+#endif
+  if (fclose(fp) != 0) ok = false;
+
+#if APTO_PLATFORM(WINDOWS)
+  if (ok) ok = (MoveFileExA(tmp_filename, filename, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0);
+#else
+  if (ok) ok = (rename(tmp_filename, filename) == 0);
+#endif
+  if (!ok) remove(tmp_filename);
+  return ok;
+}
+
+
+cString cPopulationCheckpoint::OutputPath(cWorld* world, const cString& filename)
+{
+  return cString((const char*)Avida::Output::Manager::Of(world->GetNewWorld())->OutputIDFromPath((const char*)filename));
+}
+
+
+cString cPopulationCheckpoint::InputPath(cWorld* world, const cString& filename)
+{
+  return cString(Apto::FileSystem::GetAbsolutePath(Apto::String(filename), Apto::String(world->GetWorkingDir())));
+}
+
+
+bool cPopulationCheckpoint::ConvertFromSpop(cWorld* world, const cString& spop_file, const cString& checkpoint_file,
+                                            bool compress)
+{
+  cInitFile input_file(spop_file, world->GetWorkingDir());
+  if (!input_file.WasOpened()) return false;
+
+  // Split the .spop columns into genotype fields and per-cell lists
+  const cStringList& format = input_file.GetFormat();
+  Apto::Array<Apto::String> names;
+  for (int i = 0; i < format.GetSize(); i++) {
+    const cString name = format.GetLine(i);
+    bool is_cell_column = (name == s_parent_merit_name);
+    for (int col = 0; col < NUM_CELL_COLUMNS; col++) if (name == s_cell_column_names[col]) is_cell_column = true;
+    if (!is_cell_column) names.Push((const char*)name);
+  }
+
+  cPopulationCheckpoint checkpoint;
+  int u_cell_id = 0;
+  for (int line_id = 0; line_id < input_file.GetNumLines(); line_id++) {
+    Apto::SmartPtr<Apto::Map<Apto::String, Apto::String> > props = input_file.GetLineAsDict(line_id);
+
+    Apto::Array<Apto::String> values(names.GetSize());
+    for (int i = 0; i < names.GetSize(); i++) values[i] = props->GetWithDefault(names[i], "");
+
+    // Parasite entries carry cells, but no gestation offsets
+    cString cellstr(props->GetWithDefault("cells", ""));
+    const bool parasite = cellstr.GetSize() && !props->GetWithDefault("gest_offset", "").GetSize();
+    const int genotype_idx = checkpoint.AddGenotype(names, values, parasite);
+
+    // Loads "num_units" preferrentially, but will fall back to "num_cpus" if present
+    int num_units = Apto::StrAs(props->GetWithDefault("num_units", props->GetWithDefault("num_cpus", "0")));
+    double merit = Apto::StrAs(props->GetWithDefault("merit", "0"));
+
+    // Pull apart each comma separated cell list
+    Apto::Array<Apto::Array<int> > lists(NUM_CELL_COLUMNS);
+    for (int col = 0; col < NUM_CELL_COLUMNS; col++) {
+      cString liststr(props->GetWithDefault(s_cell_column_names[col], ""));
+      while (liststr.GetSize()) lists[col].Push(liststr.Pop(',').AsInt());
+    }
+    Apto::Array<double> parent_merits;
+    cString meritstr(props->GetWithDefault(s_parent_merit_name, ""));
+    while (meritstr.GetSize()) parent_merits.Push(meritstr.Pop(',').AsDouble());
+
+    const int num_cells = (lists[CELL_ID].GetSize()) ? lists[CELL_ID].GetSize() : num_units;
+    for (int cell_i = 0; cell_i < num_cells; cell_i++) {
+      int columns[NUM_CELL_COLUMNS];
+      for (int col = 0; col < NUM_CELL_COLUMNS; col++) {
+        columns[col] = (cell_i < lists[col].GetSize()) ? lists[col][cell_i] : s_cell_column_defaults[col];
+      }
+      // Unstructured files place organisms in consecutive cells, as cPopulation::LoadPopulation does
+      if (!lists[CELL_ID].GetSize()) columns[CELL_ID] = u_cell_id++;
+      const double parent_merit = (cell_i < parent_merits.GetSize()) ? parent_merits[cell_i] : 1.0;
+      checkpoint.AddCell(genotype_idx, columns, parent_merit, merit);
+    }
+  }
+
+  return checkpoint.Save(OutputPath(world, checkpoint_file), compress);
+}
+
+
+bool cPopulationCheckpoint::ConvertToSpop(cWorld* world, const cString& checkpoint_file, const cString& spop_file)
+{
+  cPopulationCheckpointView view;
+  if (!view.Open(InputPath(world, checkpoint_file))) return false;
+
+  // Gather the rows belonging to each genotype
+  Apto::Array<Apto::Array<int> > rows(view.GetNumGenotypes());
+  const int* row_genotype = view.GetCellGenotypes();
+  for (int row = 0; row < view.GetNumCells(); row++) rows[row_genotype[row]].Push(row);
+
+  Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(world->GetNewWorld(), (const char*)spop_file);
+  df->SetFileType("genotype_data");
+  df->WriteComment("Structured Population Save");
+  df->WriteTimeStamp();
+
+  // Genotypes with resident organisms come first, followed by historic genotypes (as in SavePopulation)
+  for (int pass = 0; pass < 2; pass++) {
+    for (int g = 0; g < view.GetNumGenotypes(); g++) {
+      if ((pass == 0) != (rows[g].GetSize() > 0)) continue;
+
+      for (int f = 0; f < view.GetNumFields(); f++) {
+        df->Write(view.GetField(g, f), legacyFieldDescription(view.GetFieldName(f)), view.GetFieldName(f));
+      }
+
+      if (pass == 0) {
+        for (int col = 0; col < NUM_CELL_COLUMNS; col++) {
+          const int* column = view.GetCellColumn(col);
+          cString liststr;
+          for (int i = 0; i < rows[g].GetSize(); i++) {
+            liststr += cStringUtil::Stringf((i) ? ",%d" : "%d", column[rows[g][i]]);
+          }
+          if (col == CELL_GEST_OFFSET && view.IsParasite(g)) liststr = "";
+          df->Write(liststr, s_cell_column_descs[col], s_cell_column_names[col]);
+        }
+        const double* parent_merit = view.GetCellParentMerits();
+        cString meritstr;
+        for (int i = 0; i < rows[g].GetSize(); i++) {
+          meritstr += cStringUtil::Stringf((i) ? ",%f" : "%f", parent_merit[rows[g][i]]);
+        }
+        df->Write(meritstr, "Parent Merit", s_parent_merit_name);
+      }
+      df->Endl();
+    }
+  }
+
+  return true;
+}
+
+
+
+cPopulationCheckpointView::cPopulationCheckpointView()
+: m_map(NULL), m_map_size(0), m_version(0)
+{
+  for (int i = 0; i < MAX_SECTION_ID; i++) m_expanded[i] = NULL;
+  close();
+}
+
+
+void cPopulationCheckpointView::close()
+{
+  if (m_map) {
+#if APTO_PLATFORM(WINDOWS)
+    delete [] m_map;
+#else
+    munmap(const_cast<char*>(m_map), m_map_size);
+#endif
+  }
+  m_map = NULL;
+  m_map_size = 0;
+  m_version = 0;
+
+  for (int i = 0; i < MAX_SECTION_ID; i++) {
+    delete m_expanded[i];
+    m_expanded[i] = NULL;
+    m_sections[i] = sSection();
+  }
+
+  m_num_genotypes = 0;
+  m_num_fields = 0;
+  m_num_cells = 0;
+  m_cell_state_offsets = NULL;
+  m_cell_state = NULL;
+  m_num_resources = 0;
+  m_num_resource_cells = 0;
+  m_num_schedule_priorities = 0;
+  m_schedule_priorities = NULL;
+  m_num_events = 0;
+}
+
+
+bool cPopulationCheckpointView::Open(const cString& filename)
+{
+  close();
+
+#if APTO_PLATFORM(WINDOWS)
+  FILE* fp = fopen(filename, "rb");
+  if (!fp) return false;
+  fseek(fp, 0, SEEK_END);
+  m_map_size = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+  char* buffer = new char[m_map_size];
+  const bool read_ok = (fread(buffer, 1, m_map_size, fp) == (size_t)m_map_size);
+  fclose(fp);
+  m_map = buffer;
+  if (!read_ok) {
+    close();
+    return false;
+  }
+#else
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0) return false;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(sFileHeader)) {
+    ::close(fd);
+    return false;
+  }
+  void* addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (addr == MAP_FAILED) return false;
+  m_map = static_cast<const char*>(addr);
+  m_map_size = st.st_size;
+#endif
+
+  const sFileHeader* header = reinterpret_cast<const sFileHeader*>(m_map);
+  if (m_map_size < (long long)sizeof(sFileHeader) || memcmp(header->magic, CHECKPOINT_MAGIC, sizeof(header->magic)) != 0 ||
+      header->byte_order != CHECKPOINT_BYTE_ORDER || header->version > (unsigned int)cPopulationCheckpoint::VERSION ||
+      m_map_size < (long long)(sizeof(sFileHeader) + header->num_sections * sizeof(sSectionEntry))) {
+    close();
+    return false;
+  }
+  m_version = header->version;
+
+  const sSectionEntry* entries = reinterpret_cast<const sSectionEntry*>(m_map + sizeof(sFileHeader));
+  for (unsigned int i = 0; i < header->num_sections; i++) {
+    const sSectionEntry& entry = entries[i];
+    if (entry.offset < 0 || entry.stored_size < 0 || entry.offset + entry.stored_size > m_map_size) {
+      close();
+      return false;
+    }
+    if (entry.id == 0 || entry.id >= (unsigned int)MAX_SECTION_ID) continue;  // unknown to this version
+
+    sSection& section = m_sections[entry.id];
+    section.size = entry.size;
+    if (entry.flags & SECTION_FLAG_RLE) {
+      if (entry.size > MAX_SECTION_SIZE) {
+        close();
+        return false;
+      }
+      m_expanded[entry.id] = new Apto::Array<char>((int)entry.size);
+      if (!entry.size || !decodeRuns(m_map + entry.offset, entry.stored_size, &(*m_expanded[entry.id])[0], entry.size)) {
+        close();
+        return false;
+      }
+      section.data = &(*m_expanded[entry.id])[0];
+    } else {
+      section.data = m_map + entry.offset;
+    }
+  }
+
+  if (!parseSections()) {
+    close();
+    return false;
+  }
+  return true;
+}
+
+
+// Walks a section in the same order cSectionBuffer assembled it, verifying that every array fits
+class cSectionReader
+{
+private:
+  const char* m_data;
+  long long m_size;
+  long long m_pos;
+  bool m_ok;
+
+public:
+  cSectionReader(const char* data, long long size) : m_data(data), m_size(size), m_pos(0), m_ok(data != NULL) { ; }
+
+  bool IsOK() const { return m_ok; }
+
+  const void* Take(long long bytes)
+  {
+    const long long padded = (bytes + 7) & ~7LL;
+    if (!m_ok || bytes < 0 || m_pos + padded > m_size) {
+      m_ok = false;
+      return NULL;
+    }
+    const void* ptr = m_data + m_pos;
+    m_pos += padded;
+    return ptr;
+  }
+
+  const int* TakeInts(long long count) { return static_cast<const int*>(Take(count * sizeof(int))); }
+  const double* TakeDoubles(long long count) { return static_cast<const double*>(Take(count * sizeof(double))); }
+};
+
+
+bool cPopulationCheckpointView::parseSections()
+{
+  if (!HasSection(cPopulationCheckpoint::SECTION_META) || m_sections[cPopulationCheckpoint::SECTION_META].size < 16) {
+    return false;
+  }
+
+  if (HasSection(cPopulationCheckpoint::SECTION_GENOTYPES)) {
+    const sSection& sec = m_sections[cPopulationCheckpoint::SECTION_GENOTYPES];
+    cSectionReader reader(sec.data, sec.size);
+    const int* counts = reader.TakeInts(2);
+    if (!counts || counts[0] < 0 || counts[1] < 0) return false;
+    m_num_genotypes = counts[0];
+    m_num_fields = counts[1];
+    m_parasite = reader.TakeInts(m_num_genotypes);
+    m_string_offsets = reinterpret_cast<const unsigned int*>(reader.TakeInts(m_num_fields + (long long)m_num_genotypes * m_num_fields));
+    if (!reader.IsOK()) return false;
+    m_strings = reinterpret_cast<const char*>(m_string_offsets) + (((m_num_fields + (long long)m_num_genotypes * m_num_fields) * 4 + 7) & ~7LL);
+
+    // Every string must be terminated within the section
+    const long long string_bytes = sec.size - (m_strings - sec.data);
+    if (string_bytes < 0 || (string_bytes > 0 && m_strings[string_bytes - 1] != '\0')) return false;
+    for (long long i = 0; i < m_num_fields + (long long)m_num_genotypes * m_num_fields; i++) {
+      if (m_string_offsets[i] >= string_bytes) return false;
+    }
+  }
+
+  if (HasSection(cPopulationCheckpoint::SECTION_CELLS)) {
+    const sSection& sec = m_sections[cPopulationCheckpoint::SECTION_CELLS];
+    cSectionReader reader(sec.data, sec.size);
+    const int* counts = reader.TakeInts(2);
+    if (!counts || counts[0] < 0) return false;
+    m_num_cells = counts[0];
+    m_cell_genotype = reader.TakeInts(m_num_cells);
+    for (int col = 0; col < cPopulationCheckpoint::NUM_CELL_COLUMNS; col++) m_cell_columns[col] = reader.TakeInts(m_num_cells);
+    m_cell_parent_merit = reader.TakeDoubles(m_num_cells);
+    if (!reader.IsOK()) return false;
+    for (int i = 0; i < m_num_cells; i++) if (m_cell_genotype[i] < 0 || m_cell_genotype[i] >= m_num_genotypes) return false;
+  }
+
+  if (HasSection(cPopulationCheckpoint::SECTION_PHENOTYPES)) {
+    const sSection& sec = m_sections[cPopulationCheckpoint::SECTION_PHENOTYPES];
+    cSectionReader reader(sec.data, sec.size);
+    const int* counts = reader.TakeInts(2);
+    if (!counts || counts[0] != m_num_cells) return false;
+    m_cell_merit = reader.TakeDoubles(m_num_cells);
+    if (!reader.IsOK()) return false;
+  }
+
+  if (HasSection(cPopulationCheckpoint::SECTION_STATE)) {
+    const sSection& sec = m_sections[cPopulationCheckpoint::SECTION_STATE];
+    cSectionReader reader(sec.data, sec.size);
+    const int* counts = reader.TakeInts(2);
+    if (!counts || counts[0] != m_num_cells) return false;
+    m_cell_state_offsets = reader.TakeInts(m_num_cells + 1);
+    if (!reader.IsOK()) return false;
+    m_cell_state = reinterpret_cast<const char*>(m_cell_state_offsets) + (((m_num_cells + 1) * 4 + 7) & ~7LL);
+    const long long state_bytes = sec.size - (m_cell_state - sec.data);
+    if (m_cell_state_offsets[0] != 0) return false;
+    for (int i = 0; i < m_num_cells; i++) {
+      if (m_cell_state_offsets[i + 1] < m_cell_state_offsets[i] || m_cell_state_offsets[i + 1] > state_bytes) return false;
+    }
+  }
+
+  if (HasSection(cPopulationCheckpoint::SECTION_RESOURCES)) {
+    const sSection& sec = m_sections[cPopulationCheckpoint::SECTION_RESOURCES];
+    cSectionReader reader(sec.data, sec.size);
+    const int* counts = reader.TakeInts(2);
+    if (!counts || counts[0] < 0 || counts[1] < 0) return false;
+    m_num_resources = counts[0];
+    m_num_resource_cells = counts[1];
+    m_resource_spatial = reader.TakeInts(m_num_resources);
+    m_resources = reader.TakeDoubles(m_num_resources);
+    if (!reader.IsOK()) return false;
+    int num_spatial = 0;
+    for (int i = 0; i < m_num_resources; i++) if (m_resource_spatial[i] >= 0) num_spatial++;
+    m_spatial_resources = reader.TakeDoubles((long long)num_spatial * m_num_resource_cells);
+    if (!reader.IsOK() && num_spatial) return false;
+  }
+
+  if (HasSection(cPopulationCheckpoint::SECTION_SCHEDULE)) {
+    const sSection& sec = m_sections[cPopulationCheckpoint::SECTION_SCHEDULE];
+    cSectionReader reader(sec.data, sec.size);
+    const int* counts = reader.TakeInts(2);
+    if (!counts || counts[0] < 0) return false;
+    m_num_schedule_priorities = counts[0];
+    m_schedule_priorities = reader.TakeDoubles(m_num_schedule_priorities);
+    if (!reader.IsOK() && m_num_schedule_priorities) return false;
+  }
+
+  if (HasSection(cPopulationCheckpoint::SECTION_EVENTS)) {
+    const sSection& sec = m_sections[cPopulationCheckpoint::SECTION_EVENTS];
+    cSectionReader reader(sec.data, sec.size);
+    const int* counts = reader.TakeInts(2);
+    if (!counts || counts[0] < 0) return false;
+    m_num_events = counts[0];
+    m_event_triggers = reader.TakeInts(m_num_events);
+    m_event_original_starts = reader.TakeDoubles(m_num_events);
+    m_event_intervals = reader.TakeDoubles(m_num_events);
+    m_event_starts = reader.TakeDoubles(m_num_events);
+    if (!reader.IsOK() && m_num_events) return false;
+  }
+
+  return true;
+}
+
+
+int cPopulationCheckpointView::GetUpdate() const
+{
+  return reinterpret_cast<const int*>(m_sections[cPopulationCheckpoint::SECTION_META].data)[0];
+}
+
+int cPopulationCheckpointView::GetWorldX() const
+{
+  return reinterpret_cast<const int*>(m_sections[cPopulationCheckpoint::SECTION_META].data)[1];
+}
+
+int cPopulationCheckpointView::GetWorldY() const
+{
+  return reinterpret_cast<const int*>(m_sections[cPopulationCheckpoint::SECTION_META].data)[2];
+}
+
+
+const char* cPopulationCheckpointView::GetField(int genotype, const char* name) const
+{
+  for (int f = 0; f < m_num_fields; f++) if (strcmp(GetFieldName(f), name) == 0) return GetField(genotype, f);
+  return NULL;
+}
+
+
+bool cPopulationCheckpointView::GetRNGSeed(int& seed) const
+{
+  if (m_version == 2 || !HasSection(cPopulationCheckpoint::SECTION_RNG) ||
+      m_sections[cPopulationCheckpoint::SECTION_RNG].size < (long long)sizeof(int)) return false;
+  seed = reinterpret_cast<const int*>(m_sections[cPopulationCheckpoint::SECTION_RNG].data)[0];
+  return true;
+}
+
+
+void cPopulationCheckpointView::GetEvents(Apto::Array<int>& triggers, Apto::Array<double>& original_starts,
+                                          Apto::Array<double>& intervals, Apto::Array<double>& starts) const
+{
+  triggers.Resize(m_num_events);
+  original_starts.Resize(m_num_events);
+  intervals.Resize(m_num_events);
+  starts.Resize(m_num_events);
+  for (int i = 0; i < m_num_events; i++) {
+    triggers[i] = m_event_triggers[i];
+    original_starts[i] = m_event_original_starts[i];
+    intervals[i] = m_event_intervals[i];
+    starts[i] = m_event_starts[i];
+  }
+}
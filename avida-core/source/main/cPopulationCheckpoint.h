@@ -0,0 +1,291 @@
+/*
+ *  cPopulationCheckpoint.h
+ *  Avida
+ *
+ *  Copyright 2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cPopulationCheckpoint_h
+#define cPopulationCheckpoint_h
+
+#include "apto/core.h"
+
+#include "cString.h"
+
+class cWorld;
+
+
+// cPopulationCheckpoint
+//
+// Binary, versioned population checkpoint.  A file consists of a fixed header and section directory followed by 8-byte
+// aligned sections:
+//
+//   META        update, world dimensions
+//   GENOTYPES   one row per genotype, holding the same fields as a .spop line, as offsets into a string table
+//   CELLS       one row per resident organism; genotype index, cell id, gestation offset, lineage, ... stored by column
+//   PHENOTYPES  current merit of every resident organism, in CELLS row order
+//   RESOURCES   global resource levels and the per-cell amounts of every spatial resource
+//   RNG         seed the world random number generator was reset to when the checkpoint was taken
+//   EVENTS      next trigger value of every event in the event list
+//   STATE       execution state of every resident organism (phenotype, hardware), in CELLS row order
+//   SCHEDULE    priority of every cell in the scheduler
+//
+// Every section is assembled in memory and written with a single sequential write.  Sections may optionally be stored
+// run-length encoded, which collapses the long runs of identical values typical of the cell columns (-1 group ids,
+// sparse populations, etc.).  Uncompressed files are read back by mapping them into memory; the column and string
+// accessors of cPopulationCheckpointView then point directly into the mapping.
+//
+// Checkpoints are built and read independently of cPopulation, which allows conversion to and from .spop files without
+// constructing a world population (see ConvertToSpop and ConvertFromSpop).
+
+class cPopulationCheckpoint
+{
+public:
+  // Version 1 files hold no scheduler priorities.  Version 2 files hold raw generator state, which is no longer read.
+  static const int VERSION = 3;
+
+  enum eSection {
+    SECTION_META = 1,
+    SECTION_GENOTYPES,
+    SECTION_CELLS,
+    SECTION_PHENOTYPES,
+    SECTION_RESOURCES,
+    SECTION_RNG,
+    SECTION_EVENTS,
+    SECTION_STATE,
+    SECTION_SCHEDULE
+  };
+  static const int MAX_SECTION_ID = SECTION_SCHEDULE + 1;
+
+  // Sections are assembled and expanded in int sized buffers, Save fails for any section that would exceed this size
+  static const int MAX_SECTION_SIZE = 0x7ffffff8;
+
+  // Integer cell columns, named after the corresponding .spop fields
+  enum eCellColumn {
+    CELL_ID = 0,
+    CELL_GEST_OFFSET,
+    CELL_LINEAGE,
+    CELL_GROUP_ID,
+    CELL_FORAGER_TYPE,
+    CELL_BIRTH_CELL,
+    CELL_AVATAR_CELL,
+    CELL_AV_BCELL,
+    CELL_PARENT_FT,
+    CELL_PARENT_IS_TEACH,
+    NUM_CELL_COLUMNS
+  };
+
+  static const char* CellColumnName(int col);
+
+private:
+  int m_update;
+  int m_world_x;
+  int m_world_y;
+
+  Apto::Array<Apto::String> m_field_names;
+  Apto::Array<Apto::String> m_field_values;  // row major, one row of m_field_names.GetSize() values per genotype
+  Apto::Array<int> m_parasite;
+
+  Apto::Array<int> m_cell_genotype;
+  Apto::Array<int> m_cell_columns[NUM_CELL_COLUMNS];
+  Apto::Array<double> m_cell_parent_merit;
+  Apto::Array<double> m_cell_merit;
+  Apto::Array<int> m_cell_state_size;
+  Apto::Array<char> m_cell_state;
+  int m_cell_state_total;
+  bool m_cell_state_overflow;
+
+  Apto::Array<double> m_resources;
+  Apto::Array<int> m_resource_spatial;
+  Apto::Array<Apto::Array<double> > m_spatial_resources;
+
+  bool m_has_rng;
+  int m_rng_seed;
+  Apto::Array<double> m_schedule_priorities;
+
+  Apto::Array<int> m_event_triggers;
+  Apto::Array<double> m_event_original_starts;
+  Apto::Array<double> m_event_intervals;
+  Apto::Array<double> m_event_starts;
+
+
+  cPopulationCheckpoint(const cPopulationCheckpoint&); // @not_implemented
+  cPopulationCheckpoint& operator=(const cPopulationCheckpoint&); // @not_implemented
+
+public:
+  cPopulationCheckpoint();
+  ~cPopulationCheckpoint() { ; }
+
+  void SetUpdate(int update) { m_update = update; }
+  void SetWorldSize(int world_x, int world_y) { m_world_x = world_x; m_world_y = world_y; }
+
+  // Genotypes must all supply the same fields, in the same order; the first genotype added establishes them
+  int AddGenotype(const Apto::Array<Apto::String>& names, const Apto::Array<Apto::String>& values, bool parasite = false);
+
+  // Adds a resident organism of genotype genotype_idx (as returned by AddGenotype); columns holds NUM_CELL_COLUMNS values
+  void AddCell(int genotype_idx, const int* columns, double parent_merit, double merit);
+
+  // Attaches saved execution state (see cOrganism::TransferState) to the most recently added cell
+  void SetCellState(const char* data, int size);
+
+  void SetResources(const Apto::Array<double>& levels, const Apto::Array<int>& spatial,
+                    const Apto::Array<Apto::Array<double> >& spatial_levels);
+  void SetRNGSeed(int seed) { m_has_rng = true; m_rng_seed = seed; }
+  void SetSchedulePriorities(const Apto::Array<double>& priorities) { m_schedule_priorities = priorities; }
+  void SetEvents(const Apto::Array<int>& triggers, const Apto::Array<double>& original_starts,
+                 const Apto::Array<double>& intervals, const Apto::Array<double>& starts);
+
+  int GetNumGenotypes() const { return m_parasite.GetSize(); }
+  int GetNumCells() const { return m_cell_genotype.GetSize(); }
+
+  // Fails without writing anything if a section exceeds MAX_SECTION_SIZE
+  bool Save(const cString& filename, bool compress) const;
+
+
+  // Resolve checkpoint paths the same way as .spop files; output relative to the data directory, input relative to the
+  // working directory
+  static cString OutputPath(cWorld* world, const cString& filename);
+  static cString InputPath(cWorld* world, const cString& filename);
+
+  // Converts between the binary format and .spop text.  Cell columns absent from a .spop file are stored as defaults
+  // (-1 for cell references, 0 otherwise) and the merit of each organism is taken from its genotype.
+  static bool ConvertFromSpop(cWorld* world, const cString& spop_file, const cString& checkpoint_file, bool compress);
+  static bool ConvertToSpop(cWorld* world, const cString& checkpoint_file, const cString& spop_file);
+};
+
+
+// cPopulationCheckpointView
+//
+// Read-only view of a checkpoint file.  Uncompressed sections are accessed in place within the mapped file; compressed
+// sections are expanded into private buffers when the file is opened.
+
+class cPopulationCheckpointView
+{
+private:
+  struct sSection
+  {
+    const char* data;
+    long long size;
+
+    sSection() : data(NULL), size(0) { ; }
+  };
+
+  const char* m_map;
+  long long m_map_size;
+  int m_version;
+  Apto::Array<char>* m_expanded[cPopulationCheckpoint::MAX_SECTION_ID];
+  sSection m_sections[cPopulationCheckpoint::MAX_SECTION_ID];
+
+  // Parsed section headers
+  int m_num_genotypes;
+  int m_num_fields;
+  const int* m_parasite;
+  const unsigned int* m_string_offsets;
+  const char* m_strings;
+
+  int m_num_cells;
+  const int* m_cell_genotype;
+  const int* m_cell_columns[cPopulationCheckpoint::NUM_CELL_COLUMNS];
+  const double* m_cell_parent_merit;
+  const double* m_cell_merit;
+  const int* m_cell_state_offsets;
+  const char* m_cell_state;
+
+  int m_num_resources;
+  int m_num_resource_cells;
+  const int* m_resource_spatial;
+  const double* m_resources;
+  const double* m_spatial_resources;
+
+
+  int m_num_schedule_priorities;
+  const double* m_schedule_priorities;
+
+  int m_num_events;
+  const int* m_event_triggers;
+  const double* m_event_original_starts;
+  const double* m_event_intervals;
+  const double* m_event_starts;
+
+
+  bool parseSections();
+  void close();
+
+  cPopulationCheckpointView(const cPopulationCheckpointView&); // @not_implemented
+  cPopulationCheckpointView& operator=(const cPopulationCheckpointView&); // @not_implemented
+
+public:
+  cPopulationCheckpointView();
+  ~cPopulationCheckpointView() { close(); }
+
+  bool Open(const cString& filename);
+  bool IsOpen() const { return m_map != NULL; }
+
+  bool HasSection(int section) const
+  {
+    return section > 0 && section < cPopulationCheckpoint::MAX_SECTION_ID && m_sections[section].data != NULL;
+  }
+
+  int GetVersion() const { return m_version; }
+
+  int GetUpdate() const;
+  int GetWorldX() const;
+  int GetWorldY() const;
+
+  int GetNumGenotypes() const { return m_num_genotypes; }
+  int GetNumFields() const { return m_num_fields; }
+  const char* GetFieldName(int field) const { return m_strings + m_string_offsets[field]; }
+  const char* GetField(int genotype, int field) const
+  {
+    return m_strings + m_string_offsets[m_num_fields + genotype * m_num_fields + field];
+  }
+  const char* GetField(int genotype, const char* name) const;
+  bool IsParasite(int genotype) const { return m_parasite[genotype] != 0; }
+
+  int GetNumCells() const { return m_num_cells; }
+  const int* GetCellGenotypes() const { return m_cell_genotype; }
+  const int* GetCellColumn(int col) const { return m_cell_columns[col]; }
+  const double* GetCellParentMerits() const { return m_cell_parent_merit; }
+  const double* GetCellMerits() const { return m_cell_merit; }
+
+  // Saved execution state of a cell, or NULL if none was recorded
+  const char* GetCellState(int row, int& size) const
+  {
+    size = (m_cell_state_offsets) ? m_cell_state_offsets[row + 1] - m_cell_state_offsets[row] : 0;
+    return (size) ? m_cell_state + m_cell_state_offsets[row] : NULL;
+  }
+
+  int GetNumResources() const { return m_num_resources; }
+  int GetNumResourceCells() const { return m_num_resource_cells; }
+  bool IsSpatialResource(int res_id) const { return m_resource_spatial[res_id] >= 0; }
+  double GetResource(int res_id) const { return m_resources[res_id]; }
+  const double* GetSpatialResource(int res_id) const
+  {
+    return m_spatial_resources + (long long)m_resource_spatial[res_id] * m_num_resource_cells;
+  }
+
+  int GetVersion() const { return m_version; }
+  bool GetRNGSeed(int& seed) const;
+
+  int GetNumSchedulePriorities() const { return m_num_schedule_priorities; }
+  const double* GetSchedulePriorities() const { return m_schedule_priorities; }
+
+  int GetNumEvents() const { return m_num_events; }
+  void GetEvents(Apto::Array<int>& triggers, Apto::Array<double>& original_starts, Apto::Array<double>& intervals,
+                 Apto::Array<double>& starts) const;
+};
+
+#endif
@@ -23,6 +23,7 @@
 #include "cResourceCount.h"
 #include "cResource.h"
 #include "cGradientCount.h"
+#include "cRowBandPool.h"
 #include "cWorld.h"
 #include "cStats.h"
 
@@ -102,6 +103,10 @@ cResourceCount::cResourceCount(int num_resources)
   , spatial_update_time(0.0)
   , m_last_updated(0)
   , m_spatial_update(0)
+  , m_shared_clock(NULL)
+  , m_shared_clock_mark(0.0)
+  , m_band_pool(NULL)
+  , m_band_threads(0)
 {
   if(num_resources > 0) {
     SetSize(num_resources);
@@ -110,7 +115,8 @@ cResourceCount::cResourceCount(int num_resources)
   return;
 }
 
-cResourceCount::cResourceCount(const cResourceCount &rc) {
+cResourceCount::cResourceCount(const cResourceCount &rc)
+  : m_shared_clock(NULL), m_shared_clock_mark(0.0), m_band_pool(NULL), m_band_threads(0) {
   *this = rc;
 
   return;
@@ -133,8 +139,10 @@ const cResourceCount &cResourceCount::operator=(const cResourceCount &rc) {
   
   curr_grid_res_cnt = rc.curr_grid_res_cnt;
   curr_spatial_res_cnt = rc.curr_spatial_res_cnt;
-  update_time = rc.update_time;
-  spatial_update_time = rc.spatial_update_time;
+  // The shared clock belongs to the owner of this count, so only the elapsed time that is pending on it is copied over
+  update_time = rc.update_time + rc.pendingClockTime();
+  spatial_update_time = rc.spatial_update_time + rc.pendingClockTime();
+  m_shared_clock_mark = (m_shared_clock) ? *m_shared_clock : 0.0;
   cell_lists = rc.cell_lists;
 
   return *this;
@@ -539,6 +547,25 @@ void cResourceCount::Update(double in_time)
   spatial_update_time += in_time;
  }
 
+void cResourceCount::syncClock() const
+{
+  if (m_shared_clock) {
+    const double elapsed = *m_shared_clock - m_shared_clock_mark;
+    update_time += elapsed;
+    spatial_update_time += elapsed;
+    m_shared_clock_mark = *m_shared_clock;
+  }
+}
+
+// Attaching a clock makes this count advance lazily: any time the clock has moved since the last access is folded into
+// update_time the next time the resources are calculated.  The clock is marked at its current value, so callers that
+// restart a clock should SyncClock first.
+void cResourceCount::AttachClock(const double* clock)
+{
+  m_shared_clock = clock;
+  m_shared_clock_mark = (clock) ? *clock : 0.0;
+}
+
  
 const Apto::Array<double> & cResourceCount::GetResources(cAvidaContext& ctx) const
 {
@@ -773,6 +800,9 @@ void cResourceCount::DoUpdates(cAvidaContext& ctx, bool global_only) const
      it just is not used.)
    */
   
+  // Fold in any time accumulated on the shared clock since the last update
+  syncClock();
+  
   // Make sure that our fraction of an update remaining is greater than twice
   // the roundoff error.
   assert(update_time >= -EPSILON);
@@ -798,13 +828,22 @@ void cResourceCount::DoUpdates(cAvidaContext& ctx, bool global_only) const
   
   
   // DO UPDATE FOR EACH RESOURCE ================================================
+  // Spatial resources on a regular grid are collected and advanced together in a single pass, see DoFusedSpatialUpdates
+  m_fused_res_ids.Resize(0);
   for (int res_id = 0; res_id < resource_count.GetSize(); res_id++) {
     if (!IsSpatialResource(res_id)) {
       DoNonSpatialUpdates(ctx, res_id, num_steps);
-    } else if (!global_only){
-      DoSpatialUpdates(ctx, res_id, num_spatial_updates);
+    } else if (!global_only && num_spatial_updates > 0) {
+      const cSpatialResCount* res = spatial_resource_count[res_id];
+      const cSpatialResCount* first = (m_fused_res_ids.GetSize()) ? spatial_resource_count[m_fused_res_ids[0]] : res;
+      if (res->SupportsBandedFlow() && res->GetX() == first->GetX() && res->GetY() == first->GetY()) {
+        m_fused_res_ids.Push(res_id);
+      } else {
+        DoSpatialUpdates(ctx, res_id, num_spatial_updates);
+      }
     }
   }
+  if (m_fused_res_ids.GetSize()) DoFusedSpatialUpdates(ctx, num_spatial_updates);
   
   if (!global_only){
     m_last_updated = m_spatial_update;
@@ -845,6 +884,67 @@ void cResourceCount::DoSpatialUpdates(cAvidaContext& ctx, const int res_id, int
 
 
 
+class cFusedFlowJob : public cRowBandPool::cJob
+{
+public:
+  enum { GATHER = 0, COMPUTE, APPLY };
+
+private:
+  const Apto::Array<cSpatialResCount*>& m_res;
+  int m_phase;
+
+public:
+  cFusedFlowJob(const Apto::Array<cSpatialResCount*>& res) : m_res(res), m_phase(GATHER) { ; }
+
+  void SetPhase(int phase) { m_phase = phase; }
+
+  void ProcessBand(int row_begin, int row_end)
+  {
+    for (int i = 0; i < m_res.GetSize(); i++) {
+      cSpatialResCount* res = m_res[i];
+      switch (m_phase) {
+        case GATHER:  if (res->HasFlow()) res->GatherFlowBand(row_begin, row_end); break;
+        case COMPUTE: if (res->HasFlow()) res->ComputeFlowBand(row_begin, row_end); break;
+        case APPLY:   res->ApplyFlowBand(row_begin, row_end, true); break;
+      }
+    }
+  }
+};
+
+// Advances every resource in m_fused_res_ids through the same steps as DoSpatialUpdates.  Inflow, outflow and cell
+// sources only touch their own rectangles and cell lists and are still applied per resource.  Flow and state, which
+// sweep the whole grid, are done for all resources at once, band by band, on up to m_band_threads of the workers of
+// m_band_pool if one has been set.
+void cResourceCount::DoFusedSpatialUpdates(cAvidaContext& ctx, int num_updates) const
+{
+  Apto::Array<cSpatialResCount*> res(m_fused_res_ids.GetSize());
+  for (int i = 0; i < res.GetSize(); i++) res[i] = spatial_resource_count[m_fused_res_ids[i]];
+  const int num_rows = res[0]->GetY();
+
+  cFusedFlowJob job(res);
+  for (int kk = 0; kk < num_updates; kk++) {
+    for (int i = 0; i < res.GetSize(); i++) {
+      const int res_id = m_fused_res_ids[i];
+      res[i]->UpdateCount(ctx);
+      res[i]->Source(inflow_rate[res_id]);
+      res[i]->Sink(decay_rate[res_id]);
+      if (res[i]->GetCellListSize() > 0) {
+        res[i]->CellInflow();
+        res[i]->CellOutflow();
+      }
+      if (res[i]->HasFlow()) res[i]->PrepareFlow();
+    }
+
+    for (int phase = cFusedFlowJob::GATHER; phase <= cFusedFlowJob::APPLY; phase++) {
+      job.SetPhase(phase);
+      if (m_band_pool) m_band_pool->Run(job, num_rows, 0, m_band_threads);
+      else job.ProcessBand(0, num_rows);
+    }
+  }
+}
+
+
+
 void cResourceCount::ReinitializeResources(cAvidaContext& ctx, double additional_resource)
 {
   for(int i = 0; i < resource_name.GetSize(); i++) {
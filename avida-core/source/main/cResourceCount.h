@@ -31,6 +31,7 @@
 #include "tMatrix.h"
 #include "nGeometry.h"
 
+class cRowBandPool;
 class cWorld;
 
 
@@ -81,10 +82,23 @@ private:
   mutable int m_last_updated;
   mutable int m_spatial_update;
 
+  // Optional shared clock, advanced externally (see AttachClock) instead of calling Update on every step
+  const double* m_shared_clock;
+  mutable double m_shared_clock_mark;
+
+  // Optional worker pool used to split the fused spatial pass into bands of rows (see SetBandPool)
+  cRowBandPool* m_band_pool;
+  int m_band_threads;
+  mutable Apto::Array<int> m_fused_res_ids;
+
+  inline double pendingClockTime() const { return (m_shared_clock) ? (*m_shared_clock - m_shared_clock_mark) : 0.0; }
+  void syncClock() const;
+
   void DoUpdates(cAvidaContext& ctx, bool global_only = false) const;         // Update resource count based on update time
   
   void DoNonSpatialUpdates(cAvidaContext& ctx, const int res_id, int num_steps) const;
   void DoSpatialUpdates(cAvidaContext& ctx, const int res_id, int num_updates) const;
+  void DoFusedSpatialUpdates(cAvidaContext& ctx, int num_updates) const;
 
   // A few constants to describe update process...
   static const double UPDATE_STEP;   // Fraction of an update per step
@@ -154,6 +168,9 @@ public:
   void SetDecay(const cString& name, const double _decay);
   
   void Update(double in_time);
+  void AttachClock(const double* clock);
+  void SyncClock() const { syncClock(); }
+  void SetBandPool(cRowBandPool* pool, int num_threads) { m_band_pool = pool; m_band_threads = num_threads; }
 
   int GetSize(void) const { return resource_count.GetSize(); }
   const Apto::Array<double>& ReadResources(void) const { return resource_count; }
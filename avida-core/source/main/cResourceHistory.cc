@@ -21,11 +21,22 @@
 
 #include "cResourceHistory.h"
 
+#include "apto/core/Mutex.h"
+
 #include "cInitFile.h"
 #include "cResourceCount.h"
 #include "cStringList.h"
 
 
+int cResourceHistory::nextStateID()
+{
+  static Apto::Mutex s_mutex;
+  static int s_next_id = 0;
+  
+  Apto::MutexAutoLock lock(s_mutex);
+  return ++s_next_id;
+}
+
 int cResourceHistory::getEntryForUpdate(int update, bool exact) const
 {
   int entry = -1;
@@ -87,6 +98,7 @@ void cResourceHistory::AddEntry(int update, const Apto::Array<double>& values)
   m_entries.Resize(new_entry + 1);
   m_entries[new_entry].update = update;
   m_entries[new_entry].values = values;
+  m_state_id = nextStateID();
 }
 
 bool cResourceHistory::LoadFile(const cString& filename, const cString& working_dir)
@@ -112,6 +124,7 @@ bool cResourceHistory::LoadFile(const cString& filename, const cString& working_
     m_entries[line].values.Resize(num_values);
     for (int i = 0; i < num_values; i++) m_entries[line].values[i] = cur_line.Pop().AsDouble();
   }
+  m_state_id = nextStateID();
   
   return true;
 }
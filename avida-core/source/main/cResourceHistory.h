@@ -38,21 +38,25 @@ private:
   };
   
   Apto::Array<sResourceHistoryEntry> m_entries;
+  int m_state_id;  // unique across all histories in the process, reassigned whenever the entries change (see cGenomeTestCache)
   
   
   int getEntryForUpdate(int update, bool exact) const;
+  static int nextStateID();
   
   
   cResourceHistory(const cResourceHistory&); // @not_implemented
   cResourceHistory& operator=(const cResourceHistory&); // @not_implemented
   
 public:
-  cResourceHistory() { ; }
+  cResourceHistory() : m_state_id(nextStateID()) { ; }
   
   bool GetResourceCountForUpdate(cAvidaContext& ctx, int update, cResourceCount& rc, bool exact = false) const;
   bool GetResourceLevelsForUpdate(int update, Apto::Array<double>& levels, bool exact = false) const;
   void AddEntry(int update, const Apto::Array<double>& values);
   
+  int GetStateID() const { return m_state_id; }
+  
   bool LoadFile(const cString& filename, const cString& working_dir);
 };
 
@@ -0,0 +1,147 @@
+/*
+ *  cRowBandPool.cc
+ *  Avida
+ *
+ *  Copyright 2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "cRowBandPool.h"
+
+#include "apto/platform.h"
+
+
+// Bands handed out per thread, enough to balance rows that differ in cost without making the bands too thin
+static const int BANDS_PER_THREAD = 4;
+
+
+cRowBandPool::cRowBandPool(int num_threads)
+: m_job(NULL), m_num_rows(0), m_band_size(1), m_active(0), m_phase(0), m_next_band(0), m_pending(0), m_terminate(false)
+{
+  num_threads = ThreadsFor(num_threads);
+
+  if (num_threads > 1) {
+    m_workers.Resize(num_threads);
+    for (int i = 0; i < m_workers.GetSize(); i++) {
+      m_workers[i] = new cWorker(this, i);
+      m_workers[i]->Start();
+    }
+  }
+}
+
+cRowBandPool::~cRowBandPool()
+{
+  m_mutex.Lock();
+  m_terminate = true;
+  m_mutex.Unlock();
+  m_cond.Broadcast();
+
+  for (int i = 0; i < m_workers.GetSize(); i++) {
+    m_workers[i]->Join();
+    delete m_workers[i];
+  }
+}
+
+
+int cRowBandPool::ThreadsFor(int requested)
+{
+  if (requested < 0 || requested > Apto::Platform::AvailableCPUs()) return Apto::Platform::AvailableCPUs();
+  return requested;
+}
+
+
+void cRowBandPool::Run(cJob& job, int num_rows, int band_size, int max_threads)
+{
+  if (num_rows <= 0) return;
+
+  const int active = (max_threads > 0 && max_threads < m_workers.GetSize()) ? max_threads : m_workers.GetSize();
+
+  // Single threaded, or too few rows to be worth waking the workers
+  if (active < 2 || (band_size <= 0 && num_rows < 2 * active)) {
+    job.ProcessBand(0, num_rows);
+    return;
+  }
+
+  if (band_size <= 0) {
+    const int num_bands = active * BANDS_PER_THREAD;
+    band_size = (num_rows + num_bands - 1) / num_bands;
+  }
+
+  m_mutex.Lock();
+  m_job = &job;
+  m_num_rows = num_rows;
+  m_band_size = band_size;
+  m_next_band = 0;
+  m_active = active;
+  m_pending = active;
+  m_phase++;
+  m_mutex.Unlock();
+
+  m_cond.Broadcast();
+
+  // Barrier - wait for all workers to drain the band list
+  m_mutex.Lock();
+  while (m_pending > 0) m_term_cond.Wait(m_mutex);
+  m_job = NULL;
+  m_mutex.Unlock();
+}
+
+
+int cRowBandPool::claimBand()
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  if (m_next_band * m_band_size < m_num_rows) return m_next_band++;
+  return -1;
+}
+
+
+void cRowBandPool::processBand(int band)
+{
+  const int row_begin = band * m_band_size;
+  const int row_end = (row_begin + m_band_size < m_num_rows) ? row_begin + m_band_size : m_num_rows;
+  m_job->ProcessBand(row_begin, row_end);
+}
+
+
+void cRowBandPool::cWorker::Run()
+{
+  int last_phase = 0;
+
+  while (1) {
+    m_pool->m_mutex.Lock();
+    while (!m_pool->m_terminate && m_pool->m_phase == last_phase) {
+      m_pool->m_cond.Wait(m_pool->m_mutex);
+    }
+    if (m_pool->m_terminate) {
+      m_pool->m_mutex.Unlock();
+      break;
+    }
+    last_phase = m_pool->m_phase;
+    const bool active = (m_index < m_pool->m_active);
+    m_pool->m_mutex.Unlock();
+
+    // Workers past the thread count of the current job sit it out
+    if (!active) continue;
+
+    int band;
+    while ((band = m_pool->claimBand()) >= 0) m_pool->processBand(band);
+
+    m_pool->m_mutex.Lock();
+    int pending = --m_pool->m_pending;
+    m_pool->m_mutex.Unlock();
+    if (!pending) m_pool->m_term_cond.Signal();
+  }
+}
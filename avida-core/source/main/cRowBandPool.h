@@ -0,0 +1,105 @@
+/*
+ *  cRowBandPool.h
+ *  Avida
+ *
+ *  Copyright 2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef cRowBandPool_h
+#define cRowBandPool_h
+
+#include "apto/core.h"
+#include "apto/core/Thread.h"
+
+
+// cRowBandPool
+//
+// A small pool of worker threads that splits the rows of a grid into contiguous bands and runs a job over each of them.
+// Run blocks until every band has been processed, so consecutive calls act as a barrier between dependent phases.  Jobs
+// must only write state belonging to the rows of the band they are given; bands are claimed dynamically, so the result
+// must not depend on which thread processes which band.
+//
+// cPopulation owns a single pool per world, sized for the largest thread count configured for any pass, which the
+// spatial resource sweep runs over cell rows, cParallelUpdateEngine over its tiles (one tile per band) and cOrgStatSweep
+// over its chunks of organisms.  The passes never overlap, and each limits itself to its own thread count, so the world never has more busy workers than
+// the largest of them.
+
+class cRowBandPool
+{
+public:
+  class cJob
+  {
+  public:
+    virtual ~cJob() { ; }
+    virtual void ProcessBand(int row_begin, int row_end) = 0;
+  };
+
+private:
+  class cWorker : public Apto::Thread
+  {
+  private:
+    cRowBandPool* m_pool;
+    int m_index;
+
+    void Run();
+
+  public:
+    cWorker(cRowBandPool* pool, int index) : m_pool(pool), m_index(index) { ; }
+  };
+  friend class cWorker;
+
+
+  Apto::Mutex m_mutex;
+  Apto::ConditionVariable m_cond;
+  Apto::ConditionVariable m_term_cond;
+
+  cJob* m_job;
+  int m_num_rows;
+  int m_band_size;
+  int m_active;             // workers taking part in the current job, the first m_active of m_workers
+
+  volatile int m_phase;     // incremented to release the workers on a new job
+  volatile int m_next_band; // next unclaimed band of the current job
+  volatile int m_pending;   // count of workers still processing the current job
+  volatile bool m_terminate;
+
+  Apto::Array<cWorker*> m_workers;
+
+
+  int claimBand();
+  void processBand(int band);
+
+
+  cRowBandPool(); // @not_implemented
+  cRowBandPool(const cRowBandPool&); // @not_implemented
+  cRowBandPool& operator=(const cRowBandPool&); // @not_implemented
+
+public:
+  cRowBandPool(int num_threads);
+  ~cRowBandPool();
+
+  // Resolves a configured thread count, where -1 (or more than are available) asks for all available CPUs
+  static int ThreadsFor(int requested);
+
+  int GetNumThreads() const { return (m_workers.GetSize()) ? m_workers.GetSize() : 1; }
+
+  // band_size of zero picks a band size from the number of threads; an explicit band size always uses the workers.
+  // max_threads limits the job to that many of the workers (zero or less for all of them).
+  void Run(cJob& job, int num_rows, int band_size = 0, int max_threads = 0);
+};
+
+#endif
@@ -28,6 +28,7 @@
 #include "cAvidaContext.h"
 #include "cSpatialCountElem.h"
 #include "cResource.h"
+#include "nGeometry.h"
 
 
 class cSpatialResCount
@@ -49,6 +50,15 @@ private:
   /* instead of creating a new array use the existing one from cResource */
   Apto::Array<cCellResource> *cell_list_ptr;
   bool m_modified;
+
+  // Contiguous working storage for the stencil flow kernel: cell amounts and the flow out of each cell towards its E, SE,
+  // S and SW neighbors (zero where the neighbor does not exist)
+  Apto::Array<double> m_flow_amount;
+  Apto::Array<double> m_flow_out[4];
+  double m_flow_diffuse[4], m_flow_src_gravity[4], m_flow_dst_gravity[4], m_flow_scale[4];
+
+  void flowElements();
+  void flowStencil();
   
 public:
   cSpatialResCount();
@@ -76,6 +86,16 @@ public:
   void RateAll(double ratein); 
   virtual void StateAll();
   void FlowAll(); 
+  bool HasFlow() const { return (xdiffuse != 0.0) || (ydiffuse != 0.0) || (xgravity != 0.0) || (ygravity != 0.0); }
+
+  // Row banded flow, used to advance several resources sharing a grid in a single pass.  PrepareFlow must be called
+  // first, then each phase must complete over all rows before the next starts: GatherFlowBand, ComputeFlowBand,
+  // ApplyFlowBand.  Within a phase, bands touch only their own rows and may be processed concurrently.
+  virtual bool SupportsBandedFlow() const { return geometry == nGeometry::GRID || geometry == nGeometry::TORUS; }
+  void PrepareFlow();
+  void GatherFlowBand(int row_begin, int row_end);
+  void ComputeFlowBand(int row_begin, int row_end);
+  void ApplyFlowBand(int row_begin, int row_end, bool commit_state);
   double SumAll() const;
   void Source(double amount) const;
   void CellInflow() const;
@@ -30,6 +30,7 @@
 #include "avida/output/File.h"
 
 #include "cEnvironment.h"
+#include "cGenomeTestCache.h"
 #include "cHardwareBase.h"
 #include "cHardwareManager.h"
 #include "cInstSet.h"
@@ -37,6 +38,7 @@
 #include "cPopulationCell.h"
 #include "cDeme.h"
 #include "cMigrationMatrix.h"
+#include "cOrganismPool.h"
 #include "cStringUtil.h"
 #include "cWorld.h"
 #include "tDataEntry.h"
@@ -59,6 +61,7 @@ using namespace AvidaTools;
 cStats::cStats(cWorld* world)
 : m_world(world)
 , m_data_manager(this, "population_data")
+, m_bound_buffer(NULL)
 , m_num_genotypes(0)
 //, m_threshold_genotypes(0)
 , m_update(-1)
@@ -126,7 +129,8 @@ cStats::cStats(cWorld* world)
   task_cur_count.Resize(num_tasks);
   task_last_count.Resize(num_tasks);
   task_test_count.Resize(num_tasks);
-  m_collect_env_test_stats = false;
+  
+  m_active_stats = (m_world->GetConfig().STATS_ON_DEMAND.Get()) ? 0 : STATS_ALL;
   
   tasks_host_current.Resize(num_tasks);
   tasks_host_last.Resize(num_tasks);
@@ -273,9 +277,44 @@ Data::ConstDataSetPtr cStats::Provides() const
   return m_provides;
 }
 
+void cStats::SnapshotProvidedValues(Update)
+{
+  // Statistics are all handled by ProcessUpdate(), just capture the provided values before the next update changes them
+  for (int i = 0; i < m_snapshot_entries.GetSize(); i++) {
+    const ProvidedData& entry = m_snapshot_entries[i];
+    if (entry.int_func) m_snapshot_values[i] = (this->*entry.int_func)();
+    else if (entry.double_func) m_snapshot_values[i] = (this->*entry.double_func)();
+    else m_snapshot_values[i] = (this->*entry.int_arg_func)(entry.arg);
+  }
+}
+
 void cStats::UpdateProvidedValues(Update)
 {
-  // Nothing for now, all handled by ProcessUpdate()
+  // Write out bound values from the snapshot, possibly on the data manager's background thread
+  for (int i = 0; i < m_bound_values.GetSize(); i++) {
+    const BoundValue& bv = m_bound_values[i];
+    const double value = m_snapshot_values[bv.data.index];
+    if (bv.data.double_func) m_bound_buffer->SetDouble(bv.slot, value);
+    else m_bound_buffer->SetInt(bv.slot, (int)value);
+  }
+}
+
+bool cStats::BindProvidedValue(const Data::DataID& data_id, Data::ValueBuffer& buffer, Data::ValueSlot& slot)
+{
+  ProvidedData data_entry;
+  if (!m_provided_data.Get(data_id, data_entry)) return false;
+  if (m_bound_buffer && m_bound_buffer != &buffer) return false;
+  m_bound_buffer = &buffer;
+  
+  if (data_entry.stats) RequireStats(data_entry.stats, (const char*)data_id);
+  
+  BoundValue bv;
+  bv.slot = (data_entry.double_func) ? buffer.AddDouble() : buffer.AddInt();
+  bv.data = data_entry;
+  m_bound_values.Push(bv);
+  
+  slot = bv.slot;
+  return true;
 }
 
 Data::PackagePtr cStats::GetProvidedValueForArgument(const Apto::String& data_id, const Data::Argument&) const
@@ -284,11 +323,11 @@ Data::PackagePtr cStats::GetProvidedValueForArgument(const Apto::String& data_id
   
   if (Data::IsStandardID(data_id)) {
     ProvidedData data_entry;
-    if (data_id.GetSize() > 16 && data_id.Substring(0, 16) == "core.environment") {
-      m_collect_env_test_stats = true;
-    }
     if (m_provided_data.Get(data_id, data_entry)) {
-      rtn = data_entry.GetData();
+      if (data_entry.stats) RequireStats(data_entry.stats, (const char*)data_id);
+      const double value = m_snapshot_values[data_entry.index];
+      if (data_entry.double_func) rtn = Data::PackagePtr(new Data::Wrap<double>(value));
+      else rtn = Data::PackagePtr(new Data::Wrap<int>((int)value));
     }
     assert(rtn);
   } else if (Data::IsArgumentedID(data_id)) {
@@ -337,14 +376,62 @@ bool cStats::IsValidArgument(const Data::DataID& data_id, Data::Argument) const
 }
 
 
-template <class T> Data::PackagePtr cStats::packageData(T (cStats::*func)() const) const
+int cStats::GetTestCacheHits() const
 {
-  return Data::PackagePtr(new Data::Wrap<T>((this->*func)()));
+  cGenomeTestCache* cache = m_world->GetHardwareManager().GetTestCache();
+  return (cache) ? cache->GetHits() : 0;
 }
 
-template <class T, class U> Data::PackagePtr cStats::packageArgData(T (cStats::*func)(U) const, U arg) const
+int cStats::GetTestCacheMisses() const
 {
-  return Data::PackagePtr(new Data::Wrap<T>((this->*func)(arg)));
+  cGenomeTestCache* cache = m_world->GetHardwareManager().GetTestCache();
+  return (cache) ? cache->GetMisses() : 0;
+}
+
+int cStats::GetTestCacheSize() const
+{
+  cGenomeTestCache* cache = m_world->GetHardwareManager().GetTestCache();
+  return (cache) ? cache->GetSize() : 0;
+}
+
+int cStats::GetTestCPUsCreated() const
+{
+  return m_world->GetHardwareManager().GetTestCPUsCreated();
+}
+
+int cStats::GetTestCPUsReused() const
+{
+  return m_world->GetHardwareManager().GetTestCPUsReused();
+}
+
+int cStats::GetTestOrganismsCreated() const
+{
+  return m_world->GetHardwareManager().GetTestOrganismsCreated();
+}
+
+int cStats::GetTestOrganismsReset() const
+{
+  return m_world->GetHardwareManager().GetTestOrganismsReset();
+}
+
+double cStats::GetOrganismsAllocated() const
+{
+  return (double)m_world->GetOrganismPool().GetOrganismStats().allocated;
+}
+
+double cStats::GetOrganismsRecycled() const
+{
+  return (double)m_world->GetOrganismPool().GetOrganismStats().recycled;
+}
+
+double cStats::GetHardwareAllocated() const
+{
+  return (double)m_world->GetOrganismPool().GetHardwareStats().allocated;
+}
+
+double cStats::GetHardwareRecycled() const
+{
+  return (double)m_world->GetOrganismPool().GetHardwareStats().recycled;
 }
 
 
@@ -356,12 +443,10 @@ void cStats::setupProvidedData()
   // Setup functors and references for use in the PROVIDE macro
   Data::ProviderActivateFunctor activate(m_world, &cWorld::GetStatsProvider);
   Data::ManagerPtr mgr = m_world->GetDataManager();
-  Apto::Functor<Data::PackagePtr, Apto::TL::Create<int (cStats::*)() const> > intStat(this, &cStats::packageData<int>);
-  Apto::Functor<Data::PackagePtr, Apto::TL::Create<double (cStats::*)() const> > doubleStat(this, &cStats::packageData<double>);
   
   // Define PROVIDE macro to simplify instantiating new provided data
 #define PROVIDE(name, desc, type, func) { \
-m_provided_data[name] = ProvidedData(desc, Apto::BindFirst(type ## Stat, &cStats::func));\
+m_provided_data[name] = ProvidedData(desc, &cStats::func);\
 mgr->Register(name, activate); \
 }
   
@@ -417,6 +502,41 @@ mgr->Register(name, activate); \
   PROVIDE("core.world.ave_fitness",        "Average Fitness",                      double, GetAveFitness);
   
   
+  // Test CPU result cache (see TEST_CPU_CACHE_SIZE)
+  m_data_manager.Add("test_cache_hits",   "Test CPU Cache Hits",    &cStats::GetTestCacheHits);
+  m_data_manager.Add("test_cache_misses", "Test CPU Cache Misses",  &cStats::GetTestCacheMisses);
+  m_data_manager.Add("test_cache_size",   "Test CPU Cache Entries", &cStats::GetTestCacheSize);
+  
+  PROVIDE("core.testcpu.cache_hits",       "Test CPU Cache Hits",                  int,    GetTestCacheHits);
+  PROVIDE("core.testcpu.cache_misses",     "Test CPU Cache Misses",                int,    GetTestCacheMisses);
+  PROVIDE("core.testcpu.cache_size",       "Test CPU Cache Entries",               int,    GetTestCacheSize);
+  
+  // Pooled test CPUs (see cHardwareManager::AcquireTestCPU)
+  m_data_manager.Add("test_cpus_created", "Test CPUs Allocated",    &cStats::GetTestCPUsCreated);
+  m_data_manager.Add("test_cpus_reused",  "Test CPUs Reused",       &cStats::GetTestCPUsReused);
+  
+  PROVIDE("core.testcpu.created",          "Test CPUs Allocated",                  int,    GetTestCPUsCreated);
+  PROVIDE("core.testcpu.reused",           "Test CPUs Reused",                     int,    GetTestCPUsReused);
+  
+  // Pooled test organisms (see cHardwareManager::AcquireTestOrganism)
+  m_data_manager.Add("test_orgs_created", "Test Organisms Allocated", &cStats::GetTestOrganismsCreated);
+  m_data_manager.Add("test_orgs_reset",   "Test Organisms Reset",     &cStats::GetTestOrganismsReset);
+  
+  PROVIDE("core.testcpu.orgs_created",     "Test Organisms Allocated",             int,    GetTestOrganismsCreated);
+  PROVIDE("core.testcpu.orgs_reset",       "Test Organisms Reset",                 int,    GetTestOrganismsReset);
+  
+  // Organism and hardware allocation (see cOrganismPool)
+  m_data_manager.Add("orgs_allocated", "Organisms Allocated",      &cStats::GetOrganismsAllocated);
+  m_data_manager.Add("orgs_recycled",  "Organisms Recycled",       &cStats::GetOrganismsRecycled);
+  m_data_manager.Add("hw_allocated",   "Hardware Allocated",       &cStats::GetHardwareAllocated);
+  m_data_manager.Add("hw_recycled",    "Hardware Recycled",        &cStats::GetHardwareRecycled);
+  
+  PROVIDE("core.alloc.organisms",          "Organisms Allocated",                  double, GetOrganismsAllocated);
+  PROVIDE("core.alloc.organisms_recycled", "Organisms Recycled",                   double, GetOrganismsRecycled);
+  PROVIDE("core.alloc.hardware",           "Hardware Allocated",                   double, GetHardwareAllocated);
+  PROVIDE("core.alloc.hardware_recycled",  "Hardware Recycled",                    double, GetHardwareRecycled);
+  
+  
   // Maximums
   m_data_manager.Add("max_fitness", "Maximum Fitness in Population", &cStats::GetMaxFitness);
   m_data_manager.Add("max_merit",   "Maximum Merit in Population",   &cStats::GetMaxMerit);
@@ -428,24 +548,25 @@ mgr->Register(name, activate); \
   
   
   const cEnvironment& env = m_world->GetEnvironment();
-  Apto::Functor<Data::PackagePtr, Apto::TL::Create<int> > taskLastCount(
-                                                                        Apto::BindFirst(
-                                                                                        Apto::Functor<Data::PackagePtr, Apto::TL::Create<int (cStats::*)(int) const, int> >(
-                                                                                                                                                                            this, &cStats::packageArgData<int, int>
-                                                                                                                                                                            ),
-                                                                                        &cStats::GetTaskTestCount
-                                                                                        )
-                                                                        );
   for(int i = 0; i < task_names.GetSize(); i++) {
     Apto::String task_id(Apto::FormatStr("core.environment.triggers.%s.test_organisms", (const char*)env.GetTask(i).GetName()));
     Apto::String task_desc(task_names[i]);
     
-    m_provided_data[task_id] = ProvidedData(task_desc, Apto::BindFirst(taskLastCount, i));
+    m_provided_data[task_id] = ProvidedData(task_desc, &cStats::GetTaskTestCount, i, STATS_ENV_TEST);
     mgr->Register(task_id, activate);
 	}
   
   
 #undef PROVIDE
+  
+  // Lay out the snapshot of the provided values
+  for (Apto::Map<Apto::String, ProvidedData>::KeyIterator it = m_provided_data.Keys(); it.Next();) {
+    ProvidedData& entry = m_provided_data[*it.Get()];
+    entry.index = m_snapshot_entries.GetSize();
+    m_snapshot_entries.Push(entry);
+  }
+  m_snapshot_values.Resize(m_snapshot_entries.GetSize());
+  m_snapshot_values.SetAll(0.0);
 }
 
 
@@ -466,6 +587,18 @@ void cStats::NotifyData(Update current_update, Data::DataRetrievalFunctor retrie
   m_threshold_genotypes = retrieve_data("systematics.genotype.current_threshold")->IntValue();
 }
 
+void cStats::BindRequestedData(const Data::DataID& data_id, const Data::ValueSlot& slot)
+{
+  if (data_id == "systematics.genotype.current") m_num_genotypes_slot = slot;
+  else if (data_id == "systematics.genotype.current_threshold") m_threshold_genotypes_slot = slot;
+}
+
+void cStats::NotifyValues(Update, const Data::ValueBuffer& values)
+{
+  m_num_genotypes = values.IntValue(m_num_genotypes_slot);
+  m_threshold_genotypes = values.IntValue(m_threshold_genotypes_slot);
+}
+
 
 
 void cStats::ZeroTasks()
@@ -655,6 +788,85 @@ void cStats::PrintDataFile(const cString& filename, const cString& format, char
 }
 
 
+// Records that consumer (an output action or provided data id) uses the given STATS_* groups, and starts gathering them
+void cStats::RequireStats(int stats, const cString& consumer) const
+{
+  if (!stats) return;
+  m_active_stats |= stats;
+  
+  for (int i = 0; i < m_stats_consumers.GetSize(); i++) {
+    if (m_stats_consumers[i] == consumer) {
+      m_stats_consumer_groups[i] |= stats;
+      return;
+    }
+  }
+  m_stats_consumers.Push(consumer);
+  m_stats_consumer_groups.Push(stats);
+}
+
+
+void cStats::PrintEnabledStats(const cString& filename)
+{
+  static const char* group_names[STATS_NUM_GROUPS] = {
+    "tasks", "reactions", "mutation_rates", "forage_targets", "mating_types", "env_test"
+  };
+  
+  Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
+  
+  df->WriteComment("Organism statistics gathered at the end of each update");
+  df->WriteComment(m_world->GetConfig().STATS_ON_DEMAND.Get() ? "STATS_ON_DEMAND is set, only requested statistics are gathered"
+                                                              : "STATS_ON_DEMAND is not set, all statistics are gathered");
+  df->WriteTimeStamp();
+  
+  for (int g = 0; g < STATS_NUM_GROUPS; g++) {
+    const int group = 1 << g;
+    cString consumers;
+    for (int i = 0; i < m_stats_consumers.GetSize(); i++) {
+      if (!(m_stats_consumer_groups[i] & group)) continue;
+      if (consumers.GetSize()) consumers += ",";
+      consumers += m_stats_consumers[i];
+    }
+    if (!consumers.GetSize()) consumers = "-";
+    
+    df->Write(m_update, "Update");
+    df->Write(group_names[g], "Statistics");
+    df->Write(ShouldCollectStats(group) ? 1 : 0, "Gathered");
+    df->Write((const char*)consumers, "Requested By");
+    df->Endl();
+  }
+}
+
+
+void cStats::PrintAllocationData(const cString& filename)
+{
+  Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
+  
+  df->WriteComment("Organism, hardware and phenotype allocation");
+  df->WriteComment(m_world->GetConfig().ORGANISM_POOL.Get() ? "ORGANISM_POOL is set, allocations are served from slab pools"
+                                                            : "ORGANISM_POOL is not set, allocations come from the heap");
+  df->WriteTimeStamp();
+  
+  const cOrganismPool::sStats orgs = m_world->GetOrganismPool().GetOrganismStats();
+  const cOrganismPool::sStats hw = m_world->GetOrganismPool().GetHardwareStats();
+  
+  df->Write(m_update,                  "Update");
+  df->Write((long)orgs.allocated,      "Organisms Allocated");
+  df->Write((long)orgs.recycled,       "Organisms Allocated from Recycled Memory");
+  df->Write(orgs.live,                 "Organisms Live");
+  df->Write(orgs.peak_live,            "Organisms Peak Live");
+  df->Write(orgs.slabs,                "Organism Slabs");
+  df->Write((long)orgs.bytes_reserved, "Organism Bytes Reserved");
+  df->Write((long)hw.allocated,        "Hardware Allocated");
+  df->Write((long)hw.recycled,         "Hardware Allocated from Recycled Memory");
+  df->Write(hw.live,                   "Hardware Live");
+  df->Write(hw.peak_live,              "Hardware Peak Live (sum over hardware types)");
+  df->Write(hw.slabs,                  "Hardware Slabs");
+  df->Write((long)hw.bytes_reserved,   "Hardware Bytes Reserved");
+  df->Write((long)m_world->GetOrganismPool().GetPhenotypesRecycled(), "Phenotypes Recycled");
+  df->Endl();
+}
+
+
 void cStats::PrintAverageData(const cString& filename)
 {
   Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
@@ -1082,6 +1294,9 @@ void cStats::PrintCountData(const cString& filename)
 {
   Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
   
+  // Genotype counts are delivered by the data manager, possibly from its background thread
+  Data::Manager::Of(m_world->GetNewWorld())->Synchronize();
+  
   df->WriteComment("Avida count data");
   df->WriteTimeStamp();
   
@@ -1178,7 +1393,7 @@ void cStats::PrintTotalsData(const cString& filename)
 {
   Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
   df->Write(m_update, "Update");
-  df->Write((tot_executed+num_executed), "Total Instructions Executed");
+  df->Write((long)GetTotalExecuted(), "Total Instructions Executed");
   df->Write(num_executed, "Instructions Executed This Update");
   df->Write(tot_organisms, "Total Organisms");
   df->Write(0, "(deprecated) Total Genotypes");
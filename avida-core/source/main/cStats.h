@@ -30,6 +30,7 @@
 #include "avida/core/InstructionSequence.h"
 #include "avida/data/Provider.h"
 #include "avida/data/Recorder.h"
+#include "avida/data/ValueBuffer.h"
 
 #include "apto/stat/Accumulator.h"
 
@@ -88,6 +89,23 @@ struct s_inst_circumstances {
 
 class cStats : public Data::ArgumentedProvider, public Data::Recorder
 {
+  friend class cOrgStatSweep; // gathers the organism task and reaction stats in bulk
+
+public:
+  // Groups of statistics gathered from every organism at the end of each update.  With STATS_ON_DEMAND set, a group is
+  // only gathered once some output has asked for it through RequireStats.
+  enum {
+    STATS_TASKS = 0x01,
+    STATS_REACTIONS = 0x02,
+    STATS_MUTATION_RATES = 0x04,
+    STATS_FORAGE_TARGETS = 0x08,
+    STATS_MATING_TYPES = 0x10,
+    STATS_ENV_TEST = 0x20,  // test CPU task counts, never gathered unless requested
+    
+    STATS_ALL = 0x1F,
+    STATS_NUM_GROUPS = 6
+  };
+  
 private:
   cWorld* m_world;
 
@@ -98,21 +116,53 @@ private:
   struct ProvidedData
   {
     Apto::String description;
-    Apto::Functor<Data::PackagePtr, Apto::NullType> GetData;
+    int (cStats::*int_func)() const;
+    double (cStats::*double_func)() const;
+    int (cStats::*int_arg_func)(int) const;
+    int arg;
+    int stats;  // STATS_* groups the value is calculated from
+    int index;  // Position of the value in m_snapshot_values
     
-    ProvidedData() { ; }
-    ProvidedData(const Apto::String& desc, Apto::Functor<Data::PackagePtr, Apto::NullType> func)
-      : description(desc), GetData(func) { ; } 
+    ProvidedData() : int_func(NULL), double_func(NULL), int_arg_func(NULL), arg(0), stats(0), index(-1) { ; }
+    ProvidedData(const Apto::String& desc, int (cStats::*f)() const)
+      : description(desc), int_func(f), double_func(NULL), int_arg_func(NULL), arg(0), stats(0), index(-1) { ; }
+    ProvidedData(const Apto::String& desc, double (cStats::*f)() const)
+      : description(desc), int_func(NULL), double_func(f), int_arg_func(NULL), arg(0), stats(0), index(-1) { ; }
+    ProvidedData(const Apto::String& desc, int (cStats::*f)(int) const, int in_arg, int in_stats = 0)
+      : description(desc), int_func(NULL), double_func(NULL), int_arg_func(f), arg(in_arg), stats(in_stats), index(-1) { ; }
   };
   Apto::Map<Apto::String, ProvidedData> m_provided_data;
   mutable Data::ConstDataSetPtr m_provides;
+  
+  // Every provided value as captured by SnapshotProvidedValues.  Bound values and packages are produced from these
+  // rather than from the live statistics, so that the data manager can do so on its background thread while the next
+  // update runs.
+  Apto::Array<ProvidedData> m_snapshot_entries;
+  Apto::Array<double> m_snapshot_values;
+  
+  // Values bound to the data manager's value buffer, written on each UpdateProvidedValues
+  struct BoundValue
+  {
+    Data::ValueSlot slot;
+    ProvidedData data;
+  };
+  Data::ValueBuffer* m_bound_buffer;
+  Apto::Array<BoundValue> m_bound_values;
 
   
   // --------  Data Provider Support  ---------
   mutable Data::DataSetPtr m_requested;
+  Data::ValueSlot m_num_genotypes_slot;
+  Data::ValueSlot m_threshold_genotypes_slot;
   int m_num_genotypes;
   int m_threshold_genotypes;
   
+  
+  // --------  Statistics Registry  ---------
+  mutable int m_active_stats;                     // STATS_* groups currently being gathered
+  mutable Apto::Array<cString> m_stats_consumers; // outputs that have called RequireStats, with the groups they need
+  mutable Apto::Array<int> m_stats_consumer_groups;
+  
 
   // --------  Time scales  ---------
   int m_update;
@@ -206,7 +256,7 @@ private:
   int num_modified;
 
   int tot_organisms;
-  int tot_executed;
+  long long tot_executed;
 
   // --------  Parasite Task Stats  ---------
   Apto::Array<int> tasks_host_current;
@@ -240,7 +290,6 @@ private:
 
 
   // --------  Organism Task Stats  ---------
-  mutable bool m_collect_env_test_stats;
   Apto::Array<int> task_cur_count;
   Apto::Array<int> task_last_count;
   Apto::Array<int> task_test_count;
@@ -422,7 +471,10 @@ public:
   // Data::Provider
   Data::ConstDataSetPtr Provides() const;
   void UpdateProvidedValues(Update current_update);
+  bool SupportsBackgroundUpdate() const { return true; }
+  void SnapshotProvidedValues(Update current_update);
   Apto::String DescribeProvidedValue(const Apto::String& data_id) const;
+  bool BindProvidedValue(const Data::DataID& data_id, Data::ValueBuffer& buffer, Data::ValueSlot& slot);
 
   // Data::ArgumentedProvider
   void SetActiveArguments(const Data::DataID& data_id, Data::ConstArgumentSetPtr args);
@@ -435,9 +487,18 @@ public:
   // Data::Recorder
   Data::ConstDataSetPtr RequestedData() const;
   void NotifyData(Update current_update, Data::DataRetrievalFunctor retrieve_data);
+  bool SupportsIndexedData() const { return true; }
+  void BindRequestedData(const Data::DataID& data_id, const Data::ValueSlot& slot);
+  void NotifyValues(Update current_update, const Data::ValueBuffer& values);
+  bool SupportsBackgroundNotify() const { return true; }
   
   // cStats
   void ProcessUpdate();
+  
+  // Statistics registry
+  void RequireStats(int stats, const cString& consumer) const;
+  bool ShouldCollectStats(int stats) const { return (m_active_stats & stats) != 0; }
+  int GetActiveStats() const { return m_active_stats; }
 
   inline void SetCurrentUpdate(int new_update) { m_update = new_update; }
   inline void IncCurrentUpdate() { m_update++; }
@@ -650,6 +711,7 @@ public:
   void RecordDeath() { num_deaths++; }
 
   void IncExecuted() { num_executed++; }
+  long long GetTotalExecuted() const { return tot_executed + num_executed; }
 
   void AddNumOrgsKilled(long num) { sum_orgs_killed.Add(num); }
 	void AddNumUnoccupiedCellAttemptedToKill(long num) { sum_unoccupied_cell_kill_attempts.Add(num); }
@@ -670,7 +732,7 @@ public:
   void AddLastHostTask(int task_num) { tasks_host_last[task_num]++; }
   void AddLastParasiteTask(int task_num) { tasks_parasite_last[task_num]++; }
   
-  bool ShouldCollectEnvTestStats() const { return m_collect_env_test_stats; }
+  bool ShouldCollectEnvTestStats() const { return (m_active_stats & STATS_ENV_TEST) != 0; }
 
   void AddLastTaskQuality(int task_num, double quality)
   {
@@ -815,6 +877,18 @@ public:
   double GetAveSpeculative() const { return (m_spec_num) ? ((double)m_spec_total / (double)m_spec_num) : 0.0; }
   int GetSpeculativeWaste() const { return m_spec_waste; }
 
+  int GetTestCacheHits() const;
+  int GetTestCacheMisses() const;
+  int GetTestCacheSize() const;
+  int GetTestCPUsCreated() const;
+  int GetTestCPUsReused() const;
+  int GetTestOrganismsCreated() const;
+  int GetTestOrganismsReset() const;
+  double GetOrganismsAllocated() const;
+  double GetOrganismsRecycled() const;
+  double GetHardwareAllocated() const;
+  double GetHardwareRecycled() const;
+
   double GetAvgNumOrgsKilled() const { return sum_orgs_killed.Mean(); }
   double GetAvgNumCellsScannedAtKill() const { return sum_cells_scanned_at_kill.Mean(); }
   int GetNumMigrations() const { return num_migrations; }
@@ -837,6 +911,8 @@ public:
   void PrintDataFile(const cString& filename, const cString& format, char sep=' ');
 
   // Public calls to output data files (for events)
+  void PrintEnabledStats(const cString& filename);
+  void PrintAllocationData(const cString& filename);
   void PrintAverageData(const cString& filename);
   void PrintDemeAverageData(const cString& filename);
   void PrintFlowRateTuples(const cString& filename);
@@ -1325,10 +1401,6 @@ public:
 private:
   // Initialization
   void setupProvidedData();
-  
-  // Helper Methods
-  template <class T> Data::PackagePtr packageData(T (cStats::*)() const) const;
-  template <class T, class U> Data::PackagePtr packageArgData(T (cStats::*)(U arg) const, U arg) const;
 };
 
 
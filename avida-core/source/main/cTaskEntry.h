@@ -42,12 +42,14 @@ private:
   int m_id;
   tTaskTest m_test_fun;
   cArgContainer* m_args;
+  bool m_logic_id_only;
   Apto::String m_prop_id_ave;
   Apto::String m_prop_id_count;
 
 public:
-  cTaskEntry(const cString& name, const cString& desc, int in_id, tTaskTest fun, cArgContainer* args)
-    : m_name(name), m_desc(desc), m_id(in_id), m_test_fun(fun), m_args(args)
+  cTaskEntry(const cString& name, const cString& desc, int in_id, tTaskTest fun, cArgContainer* args,
+             bool logic_id_only = false)
+    : m_name(name), m_desc(desc), m_id(in_id), m_test_fun(fun), m_args(args), m_logic_id_only(logic_id_only)
   {
     m_prop_id_ave = Apto::FormatStr("environment.triggers.%s.average", (const char*)name);
     m_prop_id_count = Apto::FormatStr("environment.triggers.%s.count", (const char*)name);
@@ -62,6 +64,9 @@ public:
   int GetID() const { return m_id; }
   tTaskTest GetTestFun() const { return m_test_fun; }
   
+  // True if the task's quality depends on nothing but the logic ID of the output (cTaskContext::GetLogicId)
+  bool IsLogicIdOnly() const { return m_logic_id_only; }
+  
   const Apto::String& AveragePropertyID() const { return m_prop_id_ave; }
   const Apto::String& CountPropertyID() const { return m_prop_id_count; }
   
@@ -48,7 +48,7 @@ private:
   {
     REQ_NEIGHBOR_INPUT=1,
     REQ_NEIGHBOR_OUTPUT=2, 
-    UNUSED_REQ_C=4,
+    REQ_LOGIC_ID=4,       // Quality is determined by the logic ID alone (see cTaskEntry::IsLogicIdOnly)
     UNUSED_REQ_D=8
   };
   
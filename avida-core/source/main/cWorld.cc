@@ -38,6 +38,7 @@
 #include "cEventList.h"
 #include "cHardwareManager.h"
 #include "cMigrationMatrix.h"  
+#include "cOrganismPool.h"
 #include "cInstSet.h"
 #include "cPopulation.h"
 #include "cStats.h"
@@ -51,7 +52,7 @@ using namespace AvidaTools;
 
 cWorld::cWorld(cAvidaConfig* cfg, const cString& wd)
   : m_working_dir(wd), m_analyze(NULL), m_conf(cfg), m_ctx(NULL)
-  , m_env(NULL), m_event_list(NULL), m_hw_mgr(NULL), m_pop(NULL), m_stats(NULL), m_mig_mat(NULL), m_driver(NULL), m_data_mgr(NULL)
+  , m_env(NULL), m_event_list(NULL), m_hw_mgr(NULL), m_pop(NULL), m_stats(NULL), m_mig_mat(NULL), m_org_pool(NULL), m_driver(NULL), m_data_mgr(NULL)
   , m_own_driver(false)
 {
 }
@@ -70,6 +71,9 @@ cWorld::~cWorld()
 {
   // m_actlib is not owned by cWorld, DO NOT DELETE
   
+  // Stop any background data update before its providers are torn down
+  if (m_new_world) Data::Manager::Of(m_new_world)->SetBackgroundUpdate(false);
+  
   // These must be deleted first
   delete m_analyze; m_analyze = NULL;
   
@@ -82,6 +86,9 @@ cWorld::~cWorld()
 
   delete m_mig_mat; 
   
+  // Organisms still referenced past this point release their pooled memory as they are freed
+  delete m_org_pool; m_org_pool = NULL;
+  
   // Delete Last
   delete m_conf; m_conf = NULL;
 
@@ -114,7 +121,9 @@ bool cWorld::setup(World* new_world, cUserFeedback* feedback, const Apto::Map<Ap
     
     // Output Manager
     Apto::String opath = Apto::FileSystem::GetAbsolutePath(Apto::String(m_conf->DATA_DIR.Get()), Apto::String(m_working_dir));
-    Output::ManagerPtr(new Output::Manager(opath))->AttachTo(new_world);
+    Output::ManagerPtr output_mgr(new Output::Manager(opath));
+    output_mgr->SetColumnarFiles(m_conf->DATA_FORMAT.Get() > 0, m_conf->DATA_FORMAT.Get() > 1);
+    output_mgr->AttachTo(new_world);
   }
   
 
@@ -151,8 +160,12 @@ bool cWorld::setup(World* new_world, cUserFeedback* feedback, const Apto::Map<Ap
   // Setup Stats Object
   m_stats = Apto::SmartPtr<cStats, Apto::InternalRCObject>(new cStats(this));
   Data::Manager::Of(m_new_world)->AttachRecorder(m_stats);
+  if (m_conf->DATA_BACKGROUND_UPDATE.Get()) Data::Manager::Of(m_new_world)->SetBackgroundUpdate(true);
 
   
+  // Organism and hardware allocation pools, these must exist before any organism is created
+  m_org_pool = new cOrganismPool(m_conf->ORGANISM_POOL.Get());
+  
   // Initialize the hardware manager, loading all of the instruction sets
   m_hw_mgr = new cHardwareManager(this);
   if (m_conf->INST_SET_LOAD_LEGACY.Get()) {
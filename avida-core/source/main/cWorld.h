@@ -39,6 +39,7 @@ class cEventList;
 class cHardwareManager;
 class cMigrationMatrix; 
 class cOrganism;
+class cOrganismPool;
 class cPopulation;
 class cMerit;
 class cPopulationCell;
@@ -65,6 +66,7 @@ protected:
   Apto::SmartPtr<cPopulation, Apto::InternalRCObject> m_pop;
   Apto::SmartPtr<cStats, Apto::InternalRCObject> m_stats;
   cMigrationMatrix* m_mig_mat;  
+  cOrganismPool* m_org_pool;
   WorldDriver* m_driver;
   
   Data::ManagerPtr m_data_mgr;
@@ -94,6 +96,7 @@ public:
   cEnvironment& GetEnvironment() { return *m_env; }
   cHardwareManager& GetHardwareManager() { return *m_hw_mgr; }
   cMigrationMatrix& GetMigrationMatrix(){ return *m_mig_mat; };
+  cOrganismPool& GetOrganismPool() { return *m_org_pool; }
   cPopulation& GetPopulation() { return *m_pop; }
   Apto::Random& GetRandom() { return m_rng; }
   cStats& GetStats() { return *m_stats; }
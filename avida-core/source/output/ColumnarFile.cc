@@ -0,0 +1,482 @@
+/*
+ *  output/ColumnarFile.cc
+ *  avida-core
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "avida/output/ColumnarFile.h"
+
+#include <cassert>
+#include <cstring>
+
+
+static const char COLUMNAR_MAGIC[8] = { 'A', 'V', 'I', 'D', 'A', 'C', 'O', 'L' };
+static const unsigned int COLUMNAR_VERSION = 1;
+static const unsigned int COLUMNAR_FLAG_COMPRESSED = 0x1;
+
+static const unsigned int RECORD_SCHEMA = 0x414d4353; // "SCMA"
+static const unsigned int RECORD_BLOCK = 0x4b4c4f42;  // "BLOK"
+
+
+// Encoding helpers
+// --------------------------------------------------------------------------------------------------------------
+
+static inline void putU8(std::string& buf, unsigned int v) { buf.push_back((char)(v & 0xff)); }
+
+static inline void putU32(std::string& buf, unsigned int v)
+{
+  for (int i = 0; i < 4; i++) buf.push_back((char)((v >> (8 * i)) & 0xff));
+}
+
+static inline void putU64(std::string& buf, unsigned long long v)
+{
+  for (int i = 0; i < 8; i++) buf.push_back((char)((v >> (8 * i)) & 0xff));
+}
+
+static inline void putVarint(std::string& buf, unsigned long long v)
+{
+  while (v >= 0x80) {
+    buf.push_back((char)((v & 0x7f) | 0x80));
+    v >>= 7;
+  }
+  buf.push_back((char)v);
+}
+
+static inline void putString(std::string& buf, const char* str, int len)
+{
+  putVarint(buf, (unsigned long long)len);
+  buf.append(str, len);
+}
+
+static inline unsigned long long doubleBits(double x)
+{
+  unsigned long long bits;
+  memcpy(&bits, &x, sizeof(bits));
+  return bits;
+}
+
+static inline double bitsDouble(unsigned long long bits)
+{
+  double x;
+  memcpy(&x, &bits, sizeof(x));
+  return x;
+}
+
+
+static bool readVarint(std::istream& in, unsigned long long& v)
+{
+  v = 0;
+  char ch;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (!in.get(ch)) return false;
+    v |= ((unsigned long long)((unsigned char)ch & 0x7f)) << shift;
+    if (!((unsigned char)ch & 0x80)) return true;
+  }
+  return false;
+}
+
+static bool readString(std::istream& in, Apto::String& str)
+{
+  unsigned long long len;
+  if (!readVarint(in, len)) return false;
+  std::string buf(len, '\0');
+  if (len && !in.read(&buf[0], len)) return false;
+  str = buf.c_str();
+  return true;
+}
+
+
+// Decoding helpers, all bounds checked against the end of the buffer
+class cByteReader
+{
+private:
+  const unsigned char* m_cur;
+  const unsigned char* m_end;
+  bool m_ok;
+
+public:
+  cByteReader(const char* data, size_t size)
+    : m_cur((const unsigned char*)data), m_end((const unsigned char*)data + size), m_ok(true) { ; }
+
+  bool OK() const { return m_ok; }
+  bool AtEnd() const { return m_cur == m_end; }
+  size_t Remaining() const { return m_end - m_cur; }
+
+  unsigned int U8()
+  {
+    if (m_cur >= m_end) { m_ok = false; return 0; }
+    return *m_cur++;
+  }
+
+  unsigned long long Bytes(int n)
+  {
+    if ((int)Remaining() < n) { m_ok = false; m_cur = m_end; return 0; }
+    unsigned long long v = 0;
+    for (int i = 0; i < n; i++) v |= ((unsigned long long)*m_cur++) << (8 * i);
+    return v;
+  }
+
+  unsigned long long Varint()
+  {
+    unsigned long long v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      const unsigned int b = U8();
+      v |= ((unsigned long long)(b & 0x7f)) << shift;
+      if (!(b & 0x80)) return v;
+    }
+    m_ok = false;
+    return 0;
+  }
+
+  Apto::String String()
+  {
+    const unsigned long long len = Varint();
+    if (len > Remaining()) { m_ok = false; m_cur = m_end; return ""; }
+    std::string str((const char*)m_cur, len);
+    m_cur += len;
+    return Apto::String(str.c_str());
+  }
+
+  const char* Skip(size_t n)
+  {
+    if (Remaining() < n) { m_ok = false; m_cur = m_end; return NULL; }
+    const char* start = (const char*)m_cur;
+    m_cur += n;
+    return start;
+  }
+};
+
+
+
+// Output::ColumnarWriter
+// --------------------------------------------------------------------------------------------------------------
+
+Avida::Output::ColumnarWriter::ColumnarWriter(bool compress, int block_rows)
+  : m_out(NULL), m_compress(compress), m_block_rows((block_rows > 0) ? block_rows : 1), m_next_col(0), m_num_rows(0)
+{
+}
+
+
+void Avida::Output::ColumnarWriter::AddColumn(ColumnType type, const Apto::String& descr)
+{
+  assert(m_out == NULL);
+  m_cols.Resize(m_cols.GetSize() + 1);
+  m_cols[m_cols.GetSize() - 1].type = type;
+  m_cols[m_cols.GetSize() - 1].descr = descr;
+}
+
+
+void Avida::Output::ColumnarWriter::Begin(std::ostream& out, const Apto::String& filetype, const Apto::String& format,
+                                          const Apto::String& header)
+{
+  m_out = &out;
+
+  m_buffer.clear();
+  m_buffer.append(COLUMNAR_MAGIC, sizeof(COLUMNAR_MAGIC));
+  putU32(m_buffer, COLUMNAR_VERSION);
+  putU32(m_buffer, (m_compress) ? COLUMNAR_FLAG_COMPRESSED : 0);
+
+  putU32(m_buffer, RECORD_SCHEMA);
+  putString(m_buffer, filetype, filetype.GetSize());
+  putString(m_buffer, format, format.GetSize());
+  putString(m_buffer, header, header.GetSize());
+  putVarint(m_buffer, m_cols.GetSize());
+  for (int i = 0; i < m_cols.GetSize(); i++) {
+    putU8(m_buffer, m_cols[i].type);
+    putString(m_buffer, m_cols[i].descr, m_cols[i].descr.GetSize());
+  }
+
+  m_out->write(m_buffer.data(), m_buffer.size());
+}
+
+
+bool Avida::Output::ColumnarWriter::Append(long long value)
+{
+  if (m_next_col >= m_cols.GetSize() || m_cols[m_next_col].type != COLUMN_INT) return false;
+  m_cols[m_next_col++].ints.Push(value);
+  return true;
+}
+
+bool Avida::Output::ColumnarWriter::Append(double value)
+{
+  if (m_next_col >= m_cols.GetSize() || m_cols[m_next_col].type != COLUMN_DOUBLE) return false;
+  m_cols[m_next_col++].doubles.Push(value);
+  return true;
+}
+
+bool Avida::Output::ColumnarWriter::Append(const char* value)
+{
+  if (m_next_col >= m_cols.GetSize() || m_cols[m_next_col].type != COLUMN_STRING) return false;
+  m_cols[m_next_col++].strings.Push(value);
+  return true;
+}
+
+
+bool Avida::Output::ColumnarWriter::EndRow()
+{
+  if (m_next_col != m_cols.GetSize()) return false;
+  m_next_col = 0;
+
+  if (++m_num_rows >= m_block_rows) writeBlock();
+  return true;
+}
+
+
+void Avida::Output::ColumnarWriter::TakeRow(std::ostream& out)
+{
+  for (int c = 0; c < m_next_col; c++) {
+    Column& col = m_cols[c];
+    switch (col.type) {
+      case COLUMN_INT:
+        out << col.ints[m_num_rows] << " ";
+        col.ints.Resize(m_num_rows);
+        break;
+      case COLUMN_DOUBLE:
+        out << col.doubles[m_num_rows] << " ";
+        col.doubles.Resize(m_num_rows);
+        break;
+      case COLUMN_STRING:
+        out << col.strings[m_num_rows] << " ";
+        col.strings.Resize(m_num_rows);
+        break;
+    }
+  }
+  m_next_col = 0;
+}
+
+
+void Avida::Output::ColumnarWriter::Flush()
+{
+  if (m_num_rows) writeBlock();
+  if (m_out) m_out->flush();
+}
+
+
+void Avida::Output::ColumnarWriter::writeBlock()
+{
+  assert(m_out);
+
+  std::string payload;
+  std::string column;
+  for (int c = 0; c < m_cols.GetSize(); c++) {
+    Column& col = m_cols[c];
+    column.clear();
+
+    switch (col.type) {
+      case COLUMN_INT:
+        if (m_compress) {
+          unsigned long long prev = 0;
+          for (int r = 0; r < m_num_rows; r++) {
+            const unsigned long long cur = (unsigned long long)col.ints[r];
+            const long long delta = (long long)(cur - prev);
+            putVarint(column, ((unsigned long long)delta << 1) ^ (unsigned long long)(delta >> 63));
+            prev = cur;
+          }
+        } else {
+          for (int r = 0; r < m_num_rows; r++) putU64(column, (unsigned long long)col.ints[r]);
+        }
+        col.ints.Resize(0);
+        break;
+
+      case COLUMN_DOUBLE:
+        if (m_compress) {
+          // Control byte holds the number of leading (low nibble) and trailing (high nibble) zero bytes of the XOR
+          unsigned long long prev = 0;
+          for (int r = 0; r < m_num_rows; r++) {
+            const unsigned long long cur = doubleBits(col.doubles[r]);
+            const unsigned long long x = cur ^ prev;
+            prev = cur;
+            if (x == 0) {
+              putU8(column, 8);
+              continue;
+            }
+            int lz = 0;
+            while (!(x >> (56 - 8 * lz) & 0xff)) lz++;
+            int tz = 0;
+            while (!(x >> (8 * tz) & 0xff)) tz++;
+            putU8(column, (tz << 4) | lz);
+            for (int i = tz; i < 8 - lz; i++) putU8(column, (unsigned int)(x >> (8 * i)));
+          }
+        } else {
+          for (int r = 0; r < m_num_rows; r++) putU64(column, doubleBits(col.doubles[r]));
+        }
+        col.doubles.Resize(0);
+        break;
+
+      case COLUMN_STRING:
+        for (int r = 0; r < m_num_rows; r++) putString(column, col.strings[r], col.strings[r].GetSize());
+        col.strings.Resize(0);
+        break;
+    }
+
+    putU64(payload, column.size());
+    payload.append(column);
+  }
+
+  m_buffer.clear();
+  putU32(m_buffer, RECORD_BLOCK);
+  putU32(m_buffer, m_num_rows);
+  putU64(m_buffer, payload.size());
+  m_out->write(m_buffer.data(), m_buffer.size());
+  m_out->write(payload.data(), payload.size());
+
+  m_num_rows = 0;
+}
+
+
+
+// Output::ColumnarReader
+// --------------------------------------------------------------------------------------------------------------
+
+Avida::Output::ColumnarReader::ColumnarReader(std::istream& in)
+  : m_in(in), m_compressed(false), m_valid(false), m_num_rows(0)
+{
+  char magic[sizeof(COLUMNAR_MAGIC)];
+  char fields[8];
+  if (!m_in.read(magic, sizeof(magic)) || memcmp(magic, COLUMNAR_MAGIC, sizeof(magic)) != 0) return;
+  if (!m_in.read(fields, sizeof(fields))) return;
+
+  cByteReader reader(fields, sizeof(fields));
+  if (reader.Bytes(4) != COLUMNAR_VERSION) return;
+  m_compressed = (reader.Bytes(4) & COLUMNAR_FLAG_COMPRESSED);
+
+  m_valid = readSchema();
+}
+
+
+bool Avida::Output::ColumnarReader::readSchema()
+{
+  // The schema is variable length and not size prefixed, read it in pieces
+  char tag[4];
+  if (!m_in.read(tag, sizeof(tag))) return false;
+  cByteReader tag_reader(tag, sizeof(tag));
+  if (tag_reader.Bytes(4) != RECORD_SCHEMA) return false;
+
+  if (!readString(m_in, m_filetype) || !readString(m_in, m_format) || !readString(m_in, m_header)) return false;
+
+  unsigned long long num_cols;
+  if (!readVarint(m_in, num_cols)) return false;
+  m_cols.Resize((int)num_cols);
+  for (int i = 0; i < m_cols.GetSize(); i++) {
+    char type;
+    if (!m_in.get(type)) return false;
+    if (type < COLUMN_INT || type > COLUMN_STRING) return false;
+    m_cols[i].type = (ColumnType)type;
+    if (!readString(m_in, m_cols[i].descr)) return false;
+  }
+
+  return true;
+}
+
+
+bool Avida::Output::ColumnarReader::NextBlock()
+{
+  m_num_rows = 0;
+  if (!m_valid) return false;
+
+  char head[16];
+  if (!m_in.read(head, sizeof(head))) {
+    // A clean end of file falls exactly on a block boundary
+    if (m_in.gcount() != 0) m_valid = false;
+    return false;
+  }
+  cByteReader head_reader(head, sizeof(head));
+  if (head_reader.Bytes(4) != RECORD_BLOCK) { m_valid = false; return false; }
+  const int num_rows = (int)head_reader.Bytes(4);
+  const unsigned long long size = head_reader.Bytes(8);
+
+  std::string payload;
+  payload.resize(size);
+  if (size && !m_in.read(&payload[0], size)) { m_valid = false; return false; }
+
+  cByteReader reader(payload.data(), payload.size());
+  for (int c = 0; c < m_cols.GetSize(); c++) {
+    Column& col = m_cols[c];
+    const unsigned long long col_size = reader.Bytes(8);
+    const char* col_data = reader.Skip(col_size);
+    if (!reader.OK()) { m_valid = false; return false; }
+    cByteReader col_reader(col_data, col_size);
+
+    switch (col.type) {
+      case COLUMN_INT:
+        col.ints.Resize(num_rows);
+        if (m_compressed) {
+          unsigned long long prev = 0;
+          for (int r = 0; r < num_rows; r++) {
+            const unsigned long long zz = col_reader.Varint();
+            const unsigned long long delta = (zz >> 1) ^ (~(zz & 1) + 1);
+            prev += delta;
+            col.ints[r] = (long long)prev;
+          }
+        } else {
+          for (int r = 0; r < num_rows; r++) col.ints[r] = (long long)col_reader.Bytes(8);
+        }
+        break;
+
+      case COLUMN_DOUBLE:
+        col.doubles.Resize(num_rows);
+        if (m_compressed) {
+          unsigned long long prev = 0;
+          for (int r = 0; r < num_rows; r++) {
+            const unsigned int control = col_reader.U8();
+            const int lz = control & 0x0f;
+            const int tz = control >> 4;
+            if (lz + tz > 8) { m_valid = false; return false; }
+            const unsigned long long x = (lz + tz == 8) ? 0 : (col_reader.Bytes(8 - lz - tz) << (8 * tz));
+            prev ^= x;
+            col.doubles[r] = bitsDouble(prev);
+          }
+        } else {
+          for (int r = 0; r < num_rows; r++) col.doubles[r] = bitsDouble(col_reader.Bytes(8));
+        }
+        break;
+
+      case COLUMN_STRING:
+        col.strings.Resize(num_rows);
+        for (int r = 0; r < num_rows; r++) col.strings[r] = col_reader.String();
+        break;
+    }
+
+    if (!col_reader.OK() || !col_reader.AtEnd()) { m_valid = false; return false; }
+  }
+
+  m_num_rows = num_rows;
+  return true;
+}
+
+
+bool Avida::Output::ColumnarReader::WriteText(std::ostream& out)
+{
+  if (!m_valid) return false;
+
+  out << m_header;
+  while (NextBlock()) {
+    for (int r = 0; r < m_num_rows; r++) {
+      for (int c = 0; c < m_cols.GetSize(); c++) {
+        switch (m_cols[c].type) {
+          case COLUMN_INT:    out << m_cols[c].ints[r] << " "; break;
+          case COLUMN_DOUBLE: out << m_cols[c].doubles[r] << " "; break;
+          case COLUMN_STRING: out << m_cols[c].strings[r] << " "; break;
+        }
+      }
+      out << std::endl;
+    }
+  }
+
+  return m_valid;
+}
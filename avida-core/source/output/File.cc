@@ -25,8 +25,10 @@
 #include "avida/output/File.h"
 
 #include "avida/core/Feedback.h"
+#include "avida/output/ColumnarFile.h"
 #include "avida/output/Manager.h"
 
+#include <cstdio>
 #include <ctime>
 
 
@@ -89,21 +91,36 @@ Avida::Output::FilePtr Avida::Output::File::StaticWithPath(World* world, Apto::S
 
 
 Avida::Output::File::File(World* world, const OutputID& name, bool append)
-  : Socket(world, name), m_descr_written(false), m_num_cols(0)
+  : Socket(world, name), m_descr_written(false), m_num_cols(0), m_columnar(NULL), m_columnar_active(false)
 {
   m_fp.open(name, (append) ? (std::ios::out | std::ios::app) : std::ios::out);
   assert(m_fp.good());
+  
+  Output::ManagerPtr mgr = Output::Manager::Of(world);
+  if (!append && mgr && mgr->ColumnarFiles()) m_columnar = new ColumnarWriter(mgr->CompressColumnarFiles());
 }
 
-Avida::Output::File::~File() { ; }
+Avida::Output::File::~File()
+{
+  if (m_columnar_active) m_columnar->Finish();
+  delete m_columnar;
+}
 
 
 
 void Avida::Output::File::Write(double x, const char* descr, const char* format)
 {
+  if (m_columnar_active) {
+    if (m_columnar->Append(x)) return;
+    useTextOutput();
+  }
   if (!m_descr_written) {
+    if (m_columnar) {
+      m_columnar->AddColumn(COLUMN_DOUBLE, descr);
+      m_columnar->Append(x);
+    }
     m_data << x << " ";
-    WriteColumnDesc(descr, format);
+    addColumn(descr, format);
   } else {
     m_fp << x << " ";
   }
@@ -112,9 +129,17 @@ void Avida::Output::File::Write(double x, const char* descr, const char* format)
 
 void Avida::Output::File::Write(int i, const char* descr, const char* format)
 {
+  if (m_columnar_active) {
+    if (m_columnar->Append((long long)i)) return;
+    useTextOutput();
+  }
   if (!m_descr_written) {
+    if (m_columnar) {
+      m_columnar->AddColumn(COLUMN_INT, descr);
+      m_columnar->Append((long long)i);
+    }
     m_data << i << " ";
-    WriteColumnDesc(descr, format);
+    addColumn(descr, format);
   } else {
     m_fp << i << " ";
   }
@@ -123,9 +148,17 @@ void Avida::Output::File::Write(int i, const char* descr, const char* format)
 
 void Avida::Output::File::Write(long i, const char* descr, const char* format)
 {
+  if (m_columnar_active) {
+    if (m_columnar->Append((long long)i)) return;
+    useTextOutput();
+  }
   if (!m_descr_written) {
+    if (m_columnar) {
+      m_columnar->AddColumn(COLUMN_INT, descr);
+      m_columnar->Append((long long)i);
+    }
     m_data << i << " ";
-    WriteColumnDesc(descr, format);
+    addColumn(descr, format);
   } else {
     m_fp << i << " ";
   }
@@ -133,9 +166,17 @@ void Avida::Output::File::Write(long i, const char* descr, const char* format)
 
 void Avida::Output::File::Write(unsigned int i, const char* descr, const char*)
 {
+  if (m_columnar_active) {
+    if (m_columnar->Append((long long)i)) return;
+    useTextOutput();
+  }
   if (!m_descr_written) {
+    if (m_columnar) {
+      m_columnar->AddColumn(COLUMN_INT, descr);
+      m_columnar->Append((long long)i);
+    }
     m_data << i << " ";
-    WriteColumnDesc(descr);
+    addColumn(descr, "");
   } else {
     m_fp << i << " ";
   }
@@ -144,9 +185,17 @@ void Avida::Output::File::Write(unsigned int i, const char* descr, const char*)
 
 void Avida::Output::File::Write(const char* data_str, const char* descr, const char* format)
 {
+  if (m_columnar_active) {
+    if (m_columnar->Append(data_str)) return;
+    useTextOutput();
+  }
   if (!m_descr_written) {
+    if (m_columnar) {
+      m_columnar->AddColumn(COLUMN_STRING, descr);
+      m_columnar->Append(data_str);
+    }
     m_data << data_str << " ";
-    WriteColumnDesc(descr, format);
+    addColumn(descr, format);
   } else {
     m_fp << data_str << " ";
   }
@@ -154,12 +203,15 @@ void Avida::Output::File::Write(const char* data_str, const char* descr, const c
 
 void Avida::Output::File::Write(Apto::Array<int> list, const char* descr, const char* format)
 {
+  // Variable length rows cannot be stored by column
+  useText();
+  
   //Anya is trying to make a commant to write vectors for Kaboom data
   if (!m_descr_written) {
     for (int i=0; i< (int)list.GetSize();i++) {
       m_data << list[i] << " ";
     }
-    WriteColumnDesc(descr, format);
+    addColumn(descr, format);
   } else {
     for (int i =0; i < (int)list.GetSize(); i++) {
       m_fp << list[i] << " ";
@@ -170,17 +222,26 @@ void Avida::Output::File::Write(Apto::Array<int> list, const char* descr, const
 
 void Avida::Output::File::WriteBlockElement(double x, int element, int x_size)
 {
+  useText();
   m_fp << x << " ";
   if (((element + 1) % x_size) == 0) m_fp << "\n";
 }
 
 void Avida::Output::File::WriteBlockElement(int i, int element, int x_size)
 {
+  useText();
   m_fp << i << " ";
   if (((element + 1) % x_size) == 0) m_fp << "\n";
 }
 
 void Avida::Output::File::WriteColumnDesc(const char* descr, const char* format)
+{
+  // Column described without a value, the caller will be writing the data itself
+  useText();
+  addColumn(descr, format);
+}
+
+void Avida::Output::File::addColumn(const char* descr, const char* format)
 {
   if (!m_descr_written) {
     m_num_cols++;
@@ -203,6 +264,7 @@ void Avida::Output::File::WriteRawComment(const char* comment)
 
 void Avida::Output::File::WriteRaw(const char* str)
 {
+  useText();
   m_fp << str << "\n";
 }
 
@@ -220,6 +282,7 @@ void Avida::Output::File::WriteTimeStamp()
 void Avida::Output::File::FlushComments()
 {
   if (!m_descr_written) {
+    useText();
     m_fp << m_descr;
     m_descr = "";
     
@@ -231,7 +294,14 @@ void Avida::Output::File::FlushComments()
 
 void Avida::Output::File::Endl()
 {
-  if (!m_descr_written) {
+  if (m_columnar_active) {
+    if (m_columnar->EndRow()) return;
+    useTextOutput();
+  }
+  if (m_columnar) {
+    beginColumnar();
+    m_columnar->EndRow();
+  } else if (!m_descr_written) {
     // Handle filetype and format first
     if (m_filetype != "") m_fp << "#filetype " << m_filetype << std::endl;
     if (m_format != "") m_fp << "#format " << m_format << std::endl;
@@ -254,5 +324,57 @@ void Avida::Output::File::Endl()
 
 void Avida::Output::File::Flush()
 {
+  if (m_columnar_active) m_columnar->Flush();
   m_fp.flush();
 }
+
+
+void Avida::Output::File::useTextOutput()
+{
+  if (m_columnar_active) {
+    // Raw output, or a row that does not match the columns of the first, cannot be stored by column.  Rewrite the rows
+    // so far as the text file and carry on in text from the pending row.
+    std::ostringstream row;
+    m_columnar->TakeRow(row);
+    m_columnar->Finish();
+    m_fp.close();
+    m_columnar_active = false;
+    
+    Apto::String col_path(m_output_id + ".col");
+    std::ifstream in(col_path, std::ios::in | std::ios::binary);
+    ColumnarReader reader(in);
+    m_fp.open(m_output_id, std::ios::out | std::ios::trunc);
+    const bool converted = reader.WriteText(m_fp);
+    in.close();
+    
+    // Should the conversion fail, keep the columnar file so that no data is lost
+    if (converted) std::remove(col_path);
+    m_fp << row.str();
+  }
+  
+  delete m_columnar;
+  m_columnar = NULL;
+}
+
+
+void Avida::Output::File::beginColumnar()
+{
+  // Capture the header exactly as Endl would have written it in text
+  Apto::String header;
+  if (m_filetype != "") header += Apto::FormatStr("#filetype %s\n", (const char*)m_filetype);
+  if (m_format != "") header += Apto::FormatStr("#format %s\n", (const char*)m_format);
+  header += m_descr;
+  header += "\n";
+  m_descr = "";
+  m_data.clear();
+  m_data.str("");
+  
+  // Replace the (still empty) text file with the columnar one
+  m_fp.close();
+  std::remove(m_output_id);
+  m_fp.open(Apto::String(m_output_id + ".col"), std::ios::out | std::ios::trunc | std::ios::binary);
+  
+  m_columnar->Begin(m_fp, m_filetype, m_format, header);
+  m_columnar_active = true;
+  m_descr_written = true;
+}
@@ -26,7 +26,8 @@
 
 #include "avida/output/Socket.h"
 
-Avida::Output::Manager::Manager(const Apto::String& output_path) : m_world(NULL)
+Avida::Output::Manager::Manager(const Apto::String& output_path)
+  : m_world(NULL), m_columnar(false), m_columnar_compress(false)
 {
   m_output_path = output_path;
   m_output_path.Trim();
@@ -24,10 +24,10 @@
 #include "avida/private/systematics/GenomeTestMetrics.h"
 
 #include "avida/core/Genome.h"
+#include "avida/private/systematics/Genotype.h"
 
 #include "cAvidaContext.h"
 #include "cHardwareManager.h"
-#include "cPhenotype.h"
 #include "cTestCPU.h"
 #include "cWorld.h"
 
@@ -37,21 +37,26 @@ const Apto::String Avida::Systematics::GenomeTestMetrics::ObjectKey("Avida::Syst
 
 Avida::Systematics::GenomeTestMetrics::GenomeTestMetrics(cWorld* world, cAvidaContext& ctx, GroupPtr g)
 {
-  Apto::SmartPtr<cTestCPU> testcpu(world->GetHardwareManager().CreateTestCPU(ctx));
+  cTestCPU* testcpu = world->GetHardwareManager().AcquireTestCPU(ctx);
   
   cCPUTestInfo test_info;
-  testcpu->TestGenome(ctx, test_info, Genome(g->Properties().Get("genome").StringValue()));
+  cGenomeTestCache::sResult result;
+  // Genotypes hand over their genome directly, sharing its sites, rather than re-parsing the genome property string
+  GenotypePtr genotype;
+  genotype.DynamicCastFrom(g);
+  if (genotype) testcpu->TestGenomeCached(ctx, test_info, genotype->GroupGenome(), result);
+  else testcpu->TestGenomeCached(ctx, test_info, Genome(g->Properties().Get("genome").StringValue()), result);
+  world->GetHardwareManager().ReleaseTestCPU(testcpu);
   
-  m_is_viable = test_info.IsViable();
+  m_is_viable = result.is_viable;
   
-  cPhenotype& phenotype = test_info.GetTestPhenotype();
-  m_fitness = test_info.GetGenotypeFitness();
-  m_colony_fitness = test_info.GetColonyFitness();
-  m_merit = phenotype.GetMerit().GetDouble();
-  m_executed_size = phenotype.GetExecutedSize();
-  m_copied_size = phenotype.GetCopiedSize();
-  m_gestation_time = phenotype.GetGestationTime();
-  m_task_counts = phenotype.GetLastTaskCount();
+  m_fitness = result.fitness;
+  m_colony_fitness = result.colony_fitness;
+  m_merit = result.merit;
+  m_executed_size = result.executed_size;
+  m_copied_size = result.copied_size;
+  m_gestation_time = result.gestation_time;
+  m_task_counts = result.task_counts;
 }
 
 
@@ -129,6 +129,7 @@ Avida::Systematics::Genotype::Genotype(GenotypeArbiterPtr mgr, GroupID in_id, Un
   : Group(in_id)
   , m_mgr(mgr)
   , m_handle(NULL)
+  , m_genome_hash(0)
   , m_src(founder->UnitSource())
   , m_genome(founder->UnitGenome())
   , m_name("001-no_name")
@@ -187,6 +188,7 @@ Avida::Systematics::Genotype::Genotype(GenotypeArbiterPtr mgr, GroupID in_id, vo
 : Group(in_id)
 , m_mgr(mgr)
 , m_handle(NULL)
+, m_genome_hash(0)
 , m_name("001-no_name")
 , m_threshold(false)
 , m_active(false)
@@ -379,6 +381,42 @@ bool Avida::Systematics::Genotype::LegacySave(void* dfp) const
   return false;
 }
 
+bool Avida::Systematics::Genotype::LegacySaveProperties(Apto::Array<Apto::String>& names,
+                                                        Apto::Array<Apto::String>& values) const
+{
+  // Mirrors the columns written by LegacySave, in the same order, so that either form can be loaded by
+  // cPopulation::LoadPopulation
+  cString parents("");
+  for (int i = 0; i < m_parents.GetSize(); i++) {
+    parents += cStringUtil::Stringf((i) ? ",%d" : "%d", m_parents[i]->ID());
+  }
+  
+  ConstInstructionSequencePtr seq;
+  seq.DynamicCastFrom(m_genome.Representation());
+  
+#define LEGACY_PROP(NAME, VALUE) names.Push(NAME); values.Push(VALUE);
+  LEGACY_PROP("id", Apto::FormatStr("%d", m_id));
+  LEGACY_PROP("src", m_src.AsString());
+  LEGACY_PROP("src_args", (m_src.arguments.GetSize()) ? (const char*)m_src.arguments : "(none)");
+  LEGACY_PROP("parents", (parents.GetSize()) ? (const char*)parents : "(none)");
+  LEGACY_PROP("num_units", Apto::FormatStr("%d", m_num_organisms));
+  LEGACY_PROP("total_units", Apto::FormatStr("%d", m_total_organisms));
+  LEGACY_PROP("length", Apto::FormatStr("%d", seq->GetSize()));
+  LEGACY_PROP("merit", Apto::FormatStr("%.17g", m_merit.Average()));
+  LEGACY_PROP("gest_time", Apto::FormatStr("%.17g", m_gestation_time.Average()));
+  LEGACY_PROP("fitness", Apto::FormatStr("%.17g", m_fitness.Average()));
+  LEGACY_PROP("gen_born", Apto::FormatStr("%d", m_generation_born));
+  LEGACY_PROP("update_born", Apto::FormatStr("%d", m_update_born));
+  LEGACY_PROP("update_deactivated", Apto::FormatStr("%d", m_update_deactivated));
+  LEGACY_PROP("depth", Apto::FormatStr("%d", m_depth));
+  LEGACY_PROP("hw_type", Apto::FormatStr("%d", m_genome.HardwareType()));
+  LEGACY_PROP("inst_set", m_genome.Properties().Get("instset").StringValue());
+  LEGACY_PROP("sequence", m_genome.Representation()->AsString());
+#undef LEGACY_PROP
+  
+  return true;
+}
+
 
 void Avida::Systematics::Genotype::RemoveActiveReference() const
 {
@@ -40,6 +40,8 @@ Avida::Systematics::GenotypeArbiter::GenotypeArbiter(World* world, const RoleID&
   : Arbiter(role)
   , m_threshold(threshold)
   , m_disable_class(disable_class)
+  , m_active_hash(INITIAL_HASH_SIZE)
+  , m_num_hashed(0)
   , m_active_sz(1)
   , m_coalescent(NULL)
   , m_best(0)
@@ -48,7 +50,18 @@ Avida::Systematics::GenotypeArbiter::GenotypeArbiter(World* world, const RoleID&
   , m_dom_time(0)
   , m_cur_update(-1)
   , m_tot_genotypes(0)
+  , m_num_genotypes(0)
+  , m_num_historic_genotypes(0)
+  , m_num_threshold(0)
+  , m_tot_threshold(0)
   , m_coalescent_depth(-1)
+  , m_dom_id(-1)
+  , m_num_samples(0)
+  , m_provided_tot_genotypes(0)
+  , m_provided_num_threshold(0)
+  , m_provided_tot_threshold(0)
+  , m_provided_coalescent_depth(-1)
+  , m_bound_buffer(NULL)
 {
   Avida::Environment::ManagerPtr env = Avida::Environment::Manager::Of(world);
   Avida::Environment::ConstActionTriggerIDSetPtr trigger_ids = env->GetActionTriggerIDs();
@@ -86,13 +99,13 @@ void Avida::Systematics::GenotypeArbiter::PerformUpdate(Context&, Update current
 {
   m_cur_update = current_update + 1; // +1 since PerformUpdate happens at end of updates, but m_cur_update is used during
   
-  if (m_active_sz.GetSize() < HASH_SIZE) {
+  if (m_active_sz.GetSize() < m_active_hash.GetSize()) {
     for (int i = 0; i < m_active_sz.GetSize(); i++) {
       Apto::List<GenotypePtr, Apto::SparseVector>::Iterator list_it(m_active_sz[i].Begin());
       while (list_it.Next() != NULL) if ((*list_it.Get())->IsThreshold()) (*list_it.Get())->UpdateReset();
     }
   } else {
-    for (int i = 0; i < HASH_SIZE; i++) {
+    for (int i = 0; i < m_active_hash.GetSize(); i++) {
       Apto::List<GenotypePtr, Apto::SparseVector>::Iterator list_it(m_active_hash[i].Begin());
       while (list_it.Next() != NULL) if ((*list_it.Get())->IsThreshold()) (*list_it.Get())->UpdateReset();
     }    
@@ -134,6 +147,7 @@ Avida::Systematics::GroupPtr Avida::Systematics::GenotypeArbiter::LegacyLoad(voi
 {
   GenotypePtr g(new Genotype(thisPtr(), m_next_id++, props));
   m_historic.Push(g, &g->m_handle);
+  m_genotype_ids.Set(g->ID(), g);
   return g;
 }
 
@@ -141,14 +155,8 @@ Avida::Systematics::GroupPtr Avida::Systematics::GenotypeArbiter::LegacyLoad(voi
 
 Avida::Systematics::GroupPtr Avida::Systematics::GenotypeArbiter::Group(GroupID g_id)
 {
-  for (int i = m_best; i >= 0; i--) {
-    Apto::List<GenotypePtr, Apto::SparseVector>::Iterator list_it(m_active_sz[i].Begin());
-    while (list_it.Next() != NULL) if ((*list_it.Get())->ID() == g_id) return *list_it.Get();
-  }
-  
-  Apto::List<GenotypePtr, Apto::SparseVector>::Iterator list_it(m_historic.Begin());
-  while (list_it.Next() != NULL) if ((*list_it.Get())->ID() == g_id) return *list_it.Get();
-  
+  GenotypePtr found;
+  if (m_genotype_ids.Get(g_id, found)) return found;
   return GroupPtr(NULL);
 }
 
@@ -174,59 +182,85 @@ Avida::Data::ConstDataSetPtr Avida::Systematics::GenotypeArbiter::Provides() con
   return m_provides;
 }
 
-void Avida::Systematics::GenotypeArbiter::UpdateProvidedValues(Update current_update)
+void Avida::Systematics::GenotypeArbiter::SnapshotProvidedValues(Update)
 {
-  cDoubleSum sum_age;
-  cDoubleSum sum_abundance;
-  cDoubleSum sum_depth;
-  cDoubleSum sum_size;
-  cDoubleSum sum_threshold_age;
-  
-  // Pre-calculate the total number of units that are currently active (used in entropy calculation)
-  int tot_units = 0;
-  for (int i = 1; i < m_active_sz.GetSize(); i++) {
-    Apto::List<GenotypePtr, Apto::SparseVector>::Iterator list_it(m_active_sz[i].Begin());
-    while (list_it.Next()) tot_units += (*list_it.Get())->NumUnits();
-  }
-  
-  // Loop through all genotypes collecting statistics
-  m_entropy = 0.0;
+  // Copy out everything the statistics are calculated from, so that UpdateProvidedValues can run on a background thread
+  // while classification continues
   int active_count = 0;
+  for (int i = 1; i < m_active_sz.GetSize(); i++) active_count += m_active_sz[i].GetSize();
+  if (m_samples.GetSize() < active_count) m_samples.Resize(active_count);
+  
+  int idx = 0;
   for (int i = 1; i < m_active_sz.GetSize(); i++) {
-    active_count += m_active_sz[i].GetSize();
     Apto::List<GenotypePtr, Apto::SparseVector>::Iterator list_it(m_active_sz[i].Begin());
     while (list_it.Next()) {
       GenotypePtr bg = *list_it.Get();
-      const int abundance = bg->NumUnits();
-      
-      // Update stats...
-      const int age = current_update - bg->GetUpdateBorn();
-      sum_age.Add(age, abundance);
-      sum_abundance.Add(abundance);
-      sum_depth.Add(bg->Depth(), abundance);
+      GenotypeSample& sample = m_samples[idx++];
+      sample.abundance = bg->NumUnits();
+      sample.update_born = bg->GetUpdateBorn();
+      sample.depth = bg->Depth();
+      sample.threshold = bg->IsThreshold();
       
       ConstInstructionSequencePtr seq;
       seq.DynamicCastFrom(bg->GroupGenome().Representation());
       assert(seq);
-      sum_size.Add(seq->GetSize(), abundance);
-      
-      // Calculate this genotype's contribution to entropy
-      // - when p = 1.0, partial_ent calculation would return -0.0. This may propagate
-      //   to the output stage, but behavior is dependent on compiler used and optimization
-      //   level.  For consistent output, ensures that 0.0 is returned.
-      const double p = ((double) abundance) / (double) tot_units;
-      const double partial_ent = (abundance == tot_units) ? 0.0 : -(p * log(p)); 
-      m_entropy += partial_ent;
-      
-      // Do any special calculations for threshold genotypes.
-      if (bg->IsThreshold()) sum_threshold_age.Add(age, abundance);
+      sample.size = seq->GetSize();
     }
   }
+  m_num_samples = active_count;
   
-  // Stash all stats so that the can be retrieved using the provider mechanisms
   m_num_genotypes = active_count;
   m_num_historic_genotypes = m_historic.GetSize();
+  m_provided_tot_genotypes = m_tot_genotypes;
+  m_provided_num_threshold = m_num_threshold;
+  m_provided_tot_threshold = m_tot_threshold;
+  m_provided_coalescent_depth = m_coalescent_depth;
+  m_dom_id = (getBest()) ? getBest()->ID() : -1;  
+}
+
+bool Avida::Systematics::GenotypeArbiter::SupportsBackgroundUpdate() const
+{
+  return true;
+}
+
+void Avida::Systematics::GenotypeArbiter::UpdateProvidedValues(Update current_update)
+{
+  cDoubleSum sum_age;
+  cDoubleSum sum_abundance;
+  cDoubleSum sum_depth;
+  cDoubleSum sum_size;
+  cDoubleSum sum_threshold_age;
   
+  // Pre-calculate the total number of units that are currently active (used in entropy calculation)
+  int tot_units = 0;
+  for (int i = 0; i < m_num_samples; i++) tot_units += m_samples[i].abundance;
+  
+  // Loop through all genotypes collecting statistics
+  m_entropy = 0.0;
+  for (int i = 0; i < m_num_samples; i++) {
+    const GenotypeSample& sample = m_samples[i];
+    const int abundance = sample.abundance;
+    
+    // Update stats...
+    const int age = current_update - sample.update_born;
+    sum_age.Add(age, abundance);
+    sum_abundance.Add(abundance);
+    sum_depth.Add(sample.depth, abundance);
+    sum_size.Add(sample.size, abundance);
+    
+    // Calculate this genotype's contribution to entropy
+    // - when p = 1.0, partial_ent calculation would return -0.0. This may propagate
+    //   to the output stage, but behavior is dependent on compiler used and optimization
+    //   level.  For consistent output, ensures that 0.0 is returned.
+    const double p = ((double) abundance) / (double) tot_units;
+    const double partial_ent = (abundance == tot_units) ? 0.0 : -(p * log(p)); 
+    m_entropy += partial_ent;
+    
+    // Do any special calculations for threshold genotypes.
+    if (sample.threshold) sum_threshold_age.Add(age, abundance);
+  }
+  
+  // Stash all stats so that the can be retrieved using the provider mechanisms
   m_ave_age = sum_age.Average();
   m_ave_abundance = sum_abundance.Average();
   m_ave_depth = sum_depth.Average();
@@ -245,7 +279,12 @@ void Avida::Systematics::GenotypeArbiter::UpdateProvidedValues(Update current_up
   m_var_size = sum_size.Variance();
   m_var_threshold_age = sum_threshold_age.Variance();
   
-  m_dom_id = (getBest()) ? getBest()->ID() : -1;  
+  // Write out bound values
+  for (int i = 0; i < m_bound_values.GetSize(); i++) {
+    const BoundValue& bv = m_bound_values[i];
+    if (bv.int_value) m_bound_buffer->SetInt(bv.slot, *bv.int_value);
+    else m_bound_buffer->SetDouble(bv.slot, *bv.double_value);
+  }
 }
 
 
@@ -262,6 +301,27 @@ Avida::Data::PackagePtr Avida::Systematics::GenotypeArbiter::GetProvidedValue(co
 }
 
 
+bool Avida::Systematics::GenotypeArbiter::BindProvidedValue(const Data::DataID& data_id, Data::ValueBuffer& buffer,
+                                                            Data::ValueSlot& slot)
+{
+  ProvidedData data_entry;
+  if (!m_provided_data.Get(data_id, data_entry)) return false;
+  
+  // All bound values must live in the same buffer
+  if (m_bound_buffer && m_bound_buffer != &buffer) return false;
+  m_bound_buffer = &buffer;
+  
+  BoundValue bv;
+  bv.slot = (data_entry.int_value) ? buffer.AddInt() : buffer.AddDouble();
+  bv.int_value = data_entry.int_value;
+  bv.double_value = data_entry.double_value;
+  m_bound_values.Push(bv);
+  
+  slot = bv.slot;
+  return true;
+}
+
+
 Apto::String Avida::Systematics::GenotypeArbiter::DescribeProvidedValue(const Data::DataID& data_id) const
 {
   ProvidedData data_entry;
@@ -283,7 +343,7 @@ Avida::Systematics::GenotypePtr Avida::Systematics::GenotypeArbiter::ClassifyNew
   ConstInstructionSequencePtr seq;
   seq.DynamicCastFrom(u->UnitGenome().Representation());
   assert(seq);
-  int list_num = hashGenome(*seq);
+  const unsigned long long hash = hashGenome(*seq);
   
   GenotypePtr found;
 
@@ -291,41 +351,30 @@ Avida::Systematics::GenotypePtr Avida::Systematics::GenotypeArbiter::ClassifyNew
   if (hints && hints->Get("id", gid_str)) {
     int gid = Apto::StrAs(gid_str);
     
-    // Search all lists attempting to locate the referenced genotype by ID
-    for (int i = 0; i < m_active_sz.GetSize() && !found; i++) {
-      Apto::List<GenotypePtr, Apto::SparseVector>::Iterator list_it(m_active_sz[i].Begin());
-      while (list_it.Next() != NULL) {
-        if ((*list_it.Get())->ID() == gid) {
-          found = *list_it.Get();
-          found->NotifyNewUnit(u);
-          break;
-        }
-      }
-    }
-    
-    if (!found) {
-      Apto::List<GenotypePtr, Apto::SparseVector>::Iterator list_it(m_historic.Begin());
-      while (list_it.Next() != NULL) {
-        if ((*list_it.Get())->ID() == gid) {
-          found = *list_it.Get();
+    // Locate the referenced genotype by ID
+    GenotypePtr hinted;
+    if (m_genotype_ids.Get(gid, hinted) && hinted->m_handle) {
+      found = hinted;
+      if (found->IsActive()) {
+        found->NotifyNewUnit(u);
+      } else {
+        // Reactivate a historic genotype
+        addToHash(found);
+        found->m_handle->Remove(); // Remove from historic list
+        resizeActiveList(found->NumUnits());
+        m_active_sz[found->NumUnits()].PushRear(found, &found->m_handle);
+        found->Reactivate();
+        found->NotifyNewUnit(u);
+        m_tot_genotypes++;
+        if (found->NumUnits() > m_best) {
+          m_best = found->NumUnits();
+          found->SetThreshold();
           seq.DynamicCastFrom(found->GroupGenome().Representation());
           assert(seq);
-          
-          m_active_hash[hashGenome(*seq)].Push(found);
-          found->m_handle->Remove(); // Remove from historic list
-          resizeActiveList(found->NumUnits());
-          m_active_sz[found->NumUnits()].PushRear(found, &found->m_handle);
-          found->Reactivate();
-          found->NotifyNewUnit(u);
-          m_tot_genotypes++;
-          if (found->NumUnits() > m_best) {
-            m_best = found->NumUnits();
-            found->SetThreshold();
-            found->SetName(nameGenotype(seq->GetSize()));
-            m_num_threshold++;
-            m_tot_threshold++;
-            notifyListeners(found, EVENT_ADD_THRESHOLD);
-          }          
+          found->SetName(nameGenotype(seq->GetSize()));
+          m_num_threshold++;
+          m_tot_threshold++;
+          notifyListeners(found, EVENT_ADD_THRESHOLD);
         }
       }
     }
@@ -333,9 +382,9 @@ Avida::Systematics::GenotypePtr Avida::Systematics::GenotypeArbiter::ClassifyNew
   
   // No hints or unable to locate hinted genome, search for a matching genotype
   if (!found) {
-    Apto::List<GenotypePtr, Apto::SparseVector>::Iterator list_it(m_active_hash[list_num].Begin());
+    Apto::List<GenotypePtr, Apto::SparseVector>::Iterator list_it(m_active_hash[(int)(hash & (m_active_hash.GetSize() - 1))].Begin());
     while (list_it.Next() != NULL) {
-      if ((*list_it.Get())->Matches(u)) {
+      if ((*list_it.Get())->m_genome_hash == hash && (*list_it.Get())->Matches(u)) {
         found = *list_it.Get();
         found->NotifyNewUnit(u);
         break;
@@ -350,7 +399,8 @@ Avida::Systematics::GenotypePtr Avida::Systematics::GenotypeArbiter::ClassifyNew
     } else {
       found = GenotypePtr(new Genotype(thisPtr(), m_next_id++, u, m_cur_update, ConstGroupMembershipPtr(NULL)));
     }
-    m_active_hash[list_num].Push(found);
+    m_genotype_ids.Set(found->ID(), found);
+    addToHash(found);
     resizeActiveList(found->NumUnits());
     m_active_sz[found->NumUnits()].PushRear(found, &found->m_handle);
     m_tot_genotypes++;
@@ -430,18 +480,18 @@ void Avida::Systematics::GenotypeArbiter::setupProvidedData(World* world)
 
   // Define PROVIDE macro to simplify instantiating new provided data
 #define PROVIDE(name, desc, type, val) { Apto::String pvn = Apto::String("systematics.") + Role() + "." + name; \
-  m_provided_data[pvn] = ProvidedData(desc, Apto::BindFirst(type ## Stat, val));\
+  m_provided_data[pvn] = ProvidedData(desc, Apto::BindFirst(type ## Stat, val), val);\
   mgr->Register(pvn, activate); \
 }
 
-  PROVIDE("total", "Total Number of Genotypes", int, m_tot_genotypes);
+  PROVIDE("total", "Total Number of Genotypes", int, m_provided_tot_genotypes);
   PROVIDE("current", "Number of Current Genotypes", int, m_num_genotypes);
   PROVIDE("ancestral", "Number of Ancestral Genotypes", int, m_num_historic_genotypes);
 
-  PROVIDE("total_threshold", "Total Number of Threshold Genotypes", int, m_tot_threshold);
-  PROVIDE("current_threshold", "Number of Current Threshold Genotypes", int, m_num_threshold);
+  PROVIDE("total_threshold", "Total Number of Threshold Genotypes", int, m_provided_tot_threshold);
+  PROVIDE("current_threshold", "Number of Current Threshold Genotypes", int, m_provided_num_threshold);
 
-  PROVIDE("coalescent_depth", "Coalescent Depth", int, m_coalescent_depth);
+  PROVIDE("coalescent_depth", "Coalescent Depth", int, m_provided_coalescent_depth);
   
   PROVIDE("ave_age", "Average Age", double, m_ave_age);
   PROVIDE("ave_abundance", "Average Abundance", double, m_ave_abundance);
@@ -468,15 +518,44 @@ void Avida::Systematics::GenotypeArbiter::setupProvidedData(World* world)
 
 
 
-unsigned int Avida::Systematics::GenotypeArbiter::hashGenome(const InstructionSequence& genome) const
+// Bucket hash of a genome.  The sequence hash is cached by the sequence itself and kept current through point
+// mutations (see InstructionSequence::SetInst), so each genome is hashed in full at most once.
+unsigned long long Avida::Systematics::GenotypeArbiter::hashGenome(const InstructionSequence& genome)
 {
-  unsigned int total = 0;
+  return genome.GetHash() ^ ((unsigned long long)genome.GetSize() * 0x9e3779b97f4a7c15ULL);
+}
+
+void Avida::Systematics::GenotypeArbiter::addToHash(GenotypePtr genotype)
+{
+  ConstInstructionSequencePtr seq;
+  seq.DynamicCastFrom(genotype->GroupGenome().Representation());
+  assert(seq);
+  genotype->m_genome_hash = hashGenome(*seq);
   
-  for (int i = 0; i < genome.GetSize(); i++) {
-    total += (genome[i].GetOp() + 3) * i;
+  // Keep the load factor at or below two genotypes per bucket
+  if (++m_num_hashed > 2 * m_active_hash.GetSize()) resizeHash(m_active_hash.GetSize() * 2);
+  m_active_hash[(int)(genotype->m_genome_hash & (m_active_hash.GetSize() - 1))].Push(genotype);
+}
+
+void Avida::Systematics::GenotypeArbiter::removeFromHash(GenotypePtr genotype)
+{
+  m_active_hash[(int)(genotype->m_genome_hash & (m_active_hash.GetSize() - 1))].Remove(genotype);
+  m_num_hashed--;
+}
+
+void Avida::Systematics::GenotypeArbiter::resizeHash(int size)
+{
+  Apto::Array<GenotypePtr> genotypes;
+  for (int i = 0; i < m_active_hash.GetSize(); i++) {
+    Apto::List<GenotypePtr, Apto::SparseVector>::Iterator list_it(m_active_hash[i].Begin());
+    while (list_it.Next() != NULL) genotypes.Push(*list_it.Get());
   }
   
-  return total % HASH_SIZE;
+  // Rehash, preserving the relative order of genotypes within each bucket
+  m_active_hash.ResizeClear(size);
+  for (int i = 0; i < genotypes.GetSize(); i++) {
+    m_active_hash[(int)(genotypes[i]->m_genome_hash & (size - 1))].PushRear(genotypes[i]);
+  }
 }
 
 Apto::String Avida::Systematics::GenotypeArbiter::nameGenotype(int size)
@@ -500,10 +579,7 @@ void Avida::Systematics::GenotypeArbiter::removeGenotype(GenotypePtr genotype)
   if (genotype->ActiveReferenceCount()) return;    
   
   if (genotype->IsActive()) {
-    ConstInstructionSequencePtr seq;
-    seq.DynamicCastFrom(genotype->GroupGenome().Representation());
-    int list_num = hashGenome(*seq);
-    m_active_hash[list_num].Remove(genotype);
+    removeFromHash(genotype);
     genotype->Deactivate(m_cur_update);
     m_historic.Push(genotype, &genotype->m_handle);
   }
@@ -530,6 +606,8 @@ void Avida::Systematics::GenotypeArbiter::removeGenotype(GenotypePtr genotype)
   
   delete genotype->m_handle;
   genotype->m_handle = NULL;
+  
+  m_genotype_ids.Remove(genotype->ID());
 }
 
 void Avida::Systematics::GenotypeArbiter::updateCoalescent()
@@ -0,0 +1,130 @@
+/*
+ *  targets/avida-dat/main.cc
+ *  avida-core
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// avida-dat - converts columnar data files (DATA_FORMAT 1 or 2) back into text .dat files
+//
+//   avida-dat file.dat.col ...         writes file.dat alongside each input
+//   avida-dat -o out.dat file.dat.col  writes a single input to out.dat ('-' for standard output)
+//   avida-dat -s file.dat.col ...      prints the schema (file type, format and column descriptions) of each input
+
+#include "avida/output/ColumnarFile.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+
+static void usage()
+{
+  std::cerr << "usage: avida-dat [-s] file.dat.col ..." << std::endl;
+  std::cerr << "       avida-dat -o output.dat file.dat.col" << std::endl;
+}
+
+static bool printSchema(const char* path)
+{
+  std::ifstream in(path, std::ios::in | std::ios::binary);
+  Avida::Output::ColumnarReader reader(in);
+  if (!reader.IsValid()) {
+    std::cerr << "error: '" << path << "' is not a columnar data file" << std::endl;
+    return false;
+  }
+  
+  static const char* type_names[] = { "", "int", "double", "string" };
+  std::cout << path << ":" << std::endl;
+  if (reader.GetFileType() != "") std::cout << "  filetype " << reader.GetFileType() << std::endl;
+  if (reader.GetFormat() != "") std::cout << "  format " << reader.GetFormat() << std::endl;
+  for (int i = 0; i < reader.GetNumColumns(); i++) {
+    std::cout << "  " << (i + 1) << ": " << reader.GetColumnDescription(i)
+              << " (" << type_names[reader.GetColumnType(i)] << ")" << std::endl;
+  }
+  if (reader.IsCompressed()) std::cout << "  compressed" << std::endl;
+  return true;
+}
+
+static bool convert(const char* path, const char* output)
+{
+  std::ifstream in(path, std::ios::in | std::ios::binary);
+  Avida::Output::ColumnarReader reader(in);
+  if (!reader.IsValid()) {
+    std::cerr << "error: '" << path << "' is not a columnar data file" << std::endl;
+    return false;
+  }
+  
+  bool success;
+  if (strcmp(output, "-") == 0) {
+    success = reader.WriteText(std::cout);
+  } else {
+    std::ofstream out(output);
+    if (!out.good()) {
+      std::cerr << "error: unable to open '" << output << "' for writing" << std::endl;
+      return false;
+    }
+    success = reader.WriteText(out);
+  }
+  
+  if (!success) std::cerr << "warning: '" << path << "' is truncated or damaged, converted up to the last full block" << std::endl;
+  return success;
+}
+
+
+int main(int argc, char* argv[])
+{
+  const char* output = NULL;
+  bool schema = false;
+  
+  int arg = 1;
+  for (; arg < argc && argv[arg][0] == '-' && argv[arg][1] != '\0'; arg++) {
+    if (strcmp(argv[arg], "-o") == 0 && arg + 1 < argc) {
+      output = argv[++arg];
+    } else if (strcmp(argv[arg], "-s") == 0) {
+      schema = true;
+    } else {
+      usage();
+      return 1;
+    }
+  }
+  
+  if (arg == argc || (output && argc - arg != 1)) {
+    usage();
+    return 1;
+  }
+  
+  bool success = true;
+  for (; arg < argc; arg++) {
+    if (schema) {
+      success &= printSchema(argv[arg]);
+    } else if (output) {
+      success &= convert(argv[arg], output);
+    } else {
+      std::string path(argv[arg]);
+      const size_t ext = path.rfind(".col");
+      if (ext == std::string::npos || ext + 4 != path.size()) {
+        std::cerr << "error: '" << path << "' does not end in .col, use -o to name the output" << std::endl;
+        success = false;
+        continue;
+      }
+      success &= convert(path.c_str(), path.substr(0, ext).c_str());
+    }
+  }
+  
+  return (success) ? 0 : 1;
+}
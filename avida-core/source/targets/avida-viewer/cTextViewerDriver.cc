@@ -40,6 +40,7 @@ cTextViewerDriver::cTextViewerDriver(cWorld* world)
 {
   m_view = new cView(world, this);
   m_view->SetViewMode(-1);    // Set the view mode to its default value.
+  world->GetStats().RequireStats(cStats::STATS_ALL, "viewer");  // the stats screens show everything
 
   GlobalObjectManager::Register(this);
   world->SetDriver(this);
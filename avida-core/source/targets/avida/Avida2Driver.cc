@@ -33,6 +33,8 @@
 #include "cHardwareBase.h"
 #include "cHardwareManager.h"
 #include "cOrganism.h"
+#include "cParallelUpdateEngine.h"
+#include "cPointMutationScheduler.h"
 #include "cPopulation.h"
 #include "cPopulationCell.h"
 #include "cStats.h"
@@ -88,6 +90,20 @@ void Avida2Driver::Run()
   cAvidaContext& ctx = m_world->GetDefaultContext();
   Avida::Context new_ctx(this, &m_world->GetRandom());
   
+  cPointMutationScheduler point_mutations(m_world);
+  
+  cParallelUpdateEngine* parallel_engine = NULL;
+  if (m_world->GetConfig().UPDATE_THREADS.Get() != 0) {
+    if (ActiveProcessStep == &cPopulation::ProcessStepSpeculative && cParallelUpdateEngine::IsSupported(m_world)) {
+      parallel_engine = new cParallelUpdateEngine(m_world, m_world->GetConfig().UPDATE_THREADS.Get());
+      if (m_world->GetVerbosity() >= VERBOSE_ON) {
+        cout << "Parallel update: " << parallel_engine->GetNumTiles() << " tiles on " << parallel_engine->GetNumThreads() << " threads" << endl;
+      }
+    } else {
+      cerr << "warning: UPDATE_THREADS requires speculative execution without implicit repro or point mutations, running serially" << endl;
+    }
+  }
+  
   while (!m_done) {
     m_world->GetEvents(ctx);
     if(m_done == true) break;
@@ -108,6 +124,8 @@ void Avida2Driver::Run()
     const int UD_size = m_world->CalculateUpdateSize();
     const double step_size = 1.0 / (double) UD_size;
     
+    if (parallel_engine) parallel_engine->PreExecute(ctx);
+    
     for (int i = 0; i < UD_size; i++) {
       if(population.GetNumOrganisms() == 0) {
         break;
@@ -144,14 +162,7 @@ void Avida2Driver::Run()
     
     
     // Do Point Mutations
-    if (point_mut_prob > 0 ) {
-      for (int i = 0; i < population.GetSize(); i++) {
-        if (population.GetCell(i).IsOccupied()) {
-          int num_mut = population.GetCell(i).GetOrganism()->GetHardware().PointMutate(ctx);
-          population.GetCell(i).GetOrganism()->IncPointMutations(num_mut);
-        }
-      }
-    }
+    if (point_mut_prob > 0 ) point_mutations.Run(ctx);
     
     m_new_world->PerformUpdate(new_ctx, stats.GetUpdate());
     
@@ -160,6 +171,8 @@ void Avida2Driver::Run()
 			m_done = true;
 		}
   }
+  
+  delete parallel_engine;
 }
 
 void Avida2Driver::Abort(Avida::AbortCondition condition)
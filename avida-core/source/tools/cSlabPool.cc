@@ -0,0 +1,254 @@
+/*
+ *  cSlabPool.cc
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cSlabPool.h"
+
+#include <cassert>
+#include <new>
+
+#if defined(_MSC_VER)
+# define SLAB_THREAD_LOCAL __declspec(thread)
+#else
+# define SLAB_THREAD_LOCAL __thread
+#endif
+
+
+cSlabPool::cSlabPool(size_t object_size, int blocks_per_slab)
+  : m_object_size(object_size)
+  , m_block_size(sizeof(uHeader) + ((object_size + sizeof(uHeader) - 1) / sizeof(uHeader)) * sizeof(uHeader))
+  , m_blocks_per_slab((blocks_per_slab > 0) ? blocks_per_slab : 1)
+  , m_free_list(NULL), m_slab_used(0), m_num_caches(0), m_released(false)
+  , m_num_allocated(0), m_num_recycled(0), m_num_live(0), m_peak_live(0)
+{
+}
+
+cSlabPool::~cSlabPool()
+{
+  assert(m_num_live == 0 && m_num_caches == 0);
+  for (int i = 0; i < m_slabs.GetSize(); i++) delete [] m_slabs[i];
+}
+
+
+void cSlabPool::Release()
+{
+  // Hand back this thread's free list first, the owner is not going to allocate from the pool again
+  unbind(threadCache());
+  
+  bool destroy = false;
+  {
+    Apto::MutexAutoLock lock(m_mutex);
+    m_released = true;
+    destroy = (m_num_live == 0 && m_num_caches == 0);
+  }
+  if (destroy) delete this;
+}
+
+
+cSlabPool::sThreadCache* cSlabPool::threadCache()
+{
+  static SLAB_THREAD_LOCAL sThreadCache caches[NUM_THREAD_CACHES];
+  static SLAB_THREAD_LOCAL int next_evict;
+  
+  sThreadCache* empty = NULL;
+  for (int i = 0; i < NUM_THREAD_CACHES; i++) {
+    if (caches[i].pool == this) return &caches[i];
+    if (!empty && !caches[i].pool) empty = &caches[i];
+  }
+  
+  if (!empty) {
+    empty = &caches[next_evict];
+    next_evict = (next_evict + 1) % NUM_THREAD_CACHES;
+    cSlabPool* evicted = empty->pool;
+    if (evicted->unbind(empty)) delete evicted;
+  }
+  
+  Apto::MutexAutoLock lock(m_mutex);
+  m_num_caches++;
+  empty->pool = this;
+  empty->free_list = NULL;
+  empty->num_free = 0;
+  empty->fresh = NULL;
+  empty->num_fresh = 0;
+  empty->num_allocated = 0;
+  empty->num_recycled = 0;
+  empty->live_change = 0;
+  empty->num_ops = 0;
+  return empty;
+}
+
+
+void* cSlabPool::Allocate()
+{
+  sThreadCache* cache = threadCache();
+  if (!cache->free_list && !cache->num_fresh) refill(cache);
+  
+  uHeader* block = cache->free_list;
+  if (block) {
+    cache->free_list = block->next_free;
+    cache->num_free--;
+    cache->num_recycled++;
+  } else {
+    block = reinterpret_cast<uHeader*>(cache->fresh);
+    cache->fresh += m_block_size;
+    cache->num_fresh--;
+  }
+  
+  block->pool = this;
+  cache->num_allocated++;
+  cache->live_change++;
+  if (++cache->num_ops >= FLUSH_OPS) {
+    Apto::MutexAutoLock lock(m_mutex);
+    foldCounts(cache);
+  }
+  
+  return block + 1;
+}
+
+
+void* cSlabPool::AllocateUnpooled(size_t size)
+{
+  uHeader* block = static_cast<uHeader*>(::operator new(sizeof(uHeader) + size));
+  block->pool = NULL;
+  return block + 1;
+}
+
+
+void cSlabPool::Free(void* ptr)
+{
+  if (!ptr) return;
+  
+  uHeader* block = static_cast<uHeader*>(ptr) - 1;
+  if (block->pool) block->pool->freeBlock(block);
+  else ::operator delete(block);
+}
+
+
+void cSlabPool::refill(sThreadCache* cache)
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  foldCounts(cache);
+  
+  // Previously freed blocks first, only reserving fresh ones from the slabs when there are none
+  while (m_free_list && cache->num_free < CACHE_BATCH) {
+    uHeader* block = m_free_list;
+    m_free_list = block->next_free;
+    block->next_free = cache->free_list;
+    cache->free_list = block;
+    cache->num_free++;
+  }
+  if (cache->num_free) return;
+  
+  if (m_slabs.GetSize() == 0 || m_slab_used == m_blocks_per_slab) {
+    m_slabs.Push(new char[m_block_size * m_blocks_per_slab]);
+    m_slab_used = 0;
+  }
+  const int num_fresh = (m_blocks_per_slab - m_slab_used < CACHE_BATCH) ? m_blocks_per_slab - m_slab_used : CACHE_BATCH;
+  cache->fresh = m_slabs[m_slabs.GetSize() - 1] + m_block_size * m_slab_used;
+  cache->num_fresh = num_fresh;
+  m_slab_used += num_fresh;
+}
+
+
+void cSlabPool::drain(sThreadCache* cache, int num_blocks)
+{
+  // m_mutex must be held
+  while (num_blocks-- > 0 && cache->free_list) {
+    uHeader* block = cache->free_list;
+    cache->free_list = block->next_free;
+    cache->num_free--;
+    block->next_free = m_free_list;
+    m_free_list = block;
+  }
+}
+
+
+void cSlabPool::foldCounts(sThreadCache* cache)
+{
+  // m_mutex must be held
+  m_num_allocated += cache->num_allocated;
+  m_num_recycled += cache->num_recycled;
+  m_num_live += cache->live_change;
+  if (m_num_live > m_peak_live) m_peak_live = m_num_live;
+  cache->num_allocated = 0;
+  cache->num_recycled = 0;
+  cache->live_change = 0;
+  cache->num_ops = 0;
+}
+
+
+bool cSlabPool::unbind(sThreadCache* cache)
+{
+  // Returns true when the pool should now be deleted
+  if (cache->pool != this) return false;
+  
+  Apto::MutexAutoLock lock(m_mutex);
+  foldCounts(cache);
+  drain(cache, cache->num_free);
+  while (cache->num_fresh) {
+    uHeader* block = reinterpret_cast<uHeader*>(cache->fresh);
+    cache->fresh += m_block_size;
+    cache->num_fresh--;
+    block->next_free = m_free_list;
+    m_free_list = block;
+  }
+  cache->pool = NULL;
+  m_num_caches--;
+  return (m_released && m_num_live == 0 && m_num_caches == 0);
+}
+
+
+void cSlabPool::freeBlock(uHeader* block)
+{
+  if (m_released) {
+    // Straight back to the shared list, so the pool goes away with its last block
+    bool destroy = false;
+    {
+      Apto::MutexAutoLock lock(m_mutex);
+      block->next_free = m_free_list;
+      m_free_list = block;
+      m_num_live--;
+      destroy = (m_num_live == 0 && m_num_caches == 0);
+    }
+    if (destroy) delete this;
+    return;
+  }
+  
+  sThreadCache* cache = threadCache();
+  block->next_free = cache->free_list;
+  cache->free_list = block;
+  cache->num_free++;
+  cache->live_change--;
+  
+  if (cache->num_free > 2 * CACHE_BATCH) {
+    Apto::MutexAutoLock lock(m_mutex);
+    foldCounts(cache);
+    drain(cache, CACHE_BATCH);
+  } else if (++cache->num_ops >= FLUSH_OPS) {
+    Apto::MutexAutoLock lock(m_mutex);
+    foldCounts(cache);
+  }
+}
+
+
+long long cSlabPool::GetBytesReserved() const
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  return (long long)m_slabs.GetSize() * m_blocks_per_slab * m_block_size;
+}
@@ -0,0 +1,126 @@
+/*
+ *  cSlabPool.h
+ *  Avida
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cSlabPool_h
+#define cSlabPool_h
+
+#include "apto/core.h"
+
+#include <cstddef>
+
+
+// cSlabPool
+//
+// Hands out fixed size blocks carved from large slabs, recycling freed blocks through an intrusive free list.  Every
+// block is preceded by a small header naming the pool it came from, so Free needs nothing but the pointer; blocks
+// obtained from AllocateUnpooled carry a NULL pool and go straight back to the heap.
+//
+// Each thread keeps a short free list of its own for every pool it uses, so most allocations and frees never take the
+// pool's lock.  Blocks move between a thread's list and the shared one in batches, and the thread's allocation counts
+// are folded into the pool's at the same time (or every FLUSH_OPS operations), so the statistics may trail the calling
+// threads by that much.  A thread keeps lists for up to NUM_THREAD_CACHES pools, handing them back in turn to make
+// room for another.
+//
+// Objects may outlive their owner's interest in the pool (reference counted organisms, for instance), so the owner
+// calls Release instead of deleting the pool.  The slabs are returned to the heap once the last live block is freed and
+// no thread holds a free list for the pool; a thread that exits while holding one keeps the pool's slabs alive.
+
+class cSlabPool
+{
+private:
+  union uHeader
+  {
+    cSlabPool* pool;
+    uHeader* next_free;
+    double align_double;
+    long long align_long;
+    void* align_ptr;
+    char align_max[16];
+  };
+
+  // A thread's free list for one pool, along with the counts not yet folded into the pool's
+  struct sThreadCache
+  {
+    cSlabPool* pool;
+    uHeader* free_list;
+    int num_free;
+    char* fresh;           // Never used blocks reserved from the current slab
+    int num_fresh;
+    int num_allocated;
+    int num_recycled;
+    int live_change;
+    int num_ops;
+  };
+
+  static const int NUM_THREAD_CACHES = 8;
+  static const int CACHE_BATCH = 32;       // Blocks moved between a thread's free list and the shared one at a time
+  static const int FLUSH_OPS = 256;
+
+  const size_t m_object_size;
+  const size_t m_block_size;
+  const int m_blocks_per_slab;
+
+  mutable Apto::Mutex m_mutex;
+  Apto::Array<char*, Apto::Smart> m_slabs;
+  uHeader* m_free_list;
+  int m_slab_used;           // Blocks handed out from the most recent slab
+  int m_num_caches;          // Threads holding a free list for this pool
+  volatile bool m_released;
+
+  long long m_num_allocated;  // Total allocations served
+  long long m_num_recycled;   // Allocations served from previously freed blocks
+  int m_num_live;
+  int m_peak_live;
+
+
+  cSlabPool(); // @not_implemented
+  cSlabPool(const cSlabPool&); // @not_implemented
+  cSlabPool& operator=(const cSlabPool&); // @not_implemented
+
+  ~cSlabPool();
+
+  sThreadCache* threadCache();
+  void refill(sThreadCache* cache);
+  void drain(sThreadCache* cache, int num_blocks);
+  void foldCounts(sThreadCache* cache);
+  bool unbind(sThreadCache* cache);
+  void freeBlock(uHeader* block);
+
+public:
+  cSlabPool(size_t object_size, int blocks_per_slab = 256);
+
+  // The owner is done with the pool; it deletes itself once every outstanding block has been freed
+  void Release();
+
+  inline size_t GetObjectSize() const { return m_object_size; }
+
+  void* Allocate();
+  static void* AllocateUnpooled(size_t size);
+  static void Free(void* ptr);
+
+  long long GetNumAllocated() const { Apto::MutexAutoLock lock(m_mutex); return m_num_allocated; }
+  long long GetNumRecycled() const { Apto::MutexAutoLock lock(m_mutex); return m_num_recycled; }
+  int GetNumLive() const { Apto::MutexAutoLock lock(m_mutex); return m_num_live; }
+  int GetPeakLive() const { Apto::MutexAutoLock lock(m_mutex); return m_peak_live; }
+  int GetNumSlabs() const { Apto::MutexAutoLock lock(m_mutex); return m_slabs.GetSize(); }
+  long long GetBytesReserved() const;
+};
+
+#endif
@@ -0,0 +1,120 @@
+/*
+ *  cStateBuffer.h
+ *  Avida
+ *
+ *  Copyright 2012 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cStateBuffer_h
+#define cStateBuffer_h
+
+#include "apto/core.h"
+
+#include "cString.h"
+
+#include <cstring>
+
+
+// cStateBuffer
+//
+// Binary buffer used to save and restore the exact execution state of organisms.  The same transfer code is used in
+// both directions; each operator& call appends the value when saving, or reads it back into place when loading:
+//
+//   void TransferState(cStateBuffer& state) { state & m_a & m_b & m_array; }
+//
+// Values must be plain data, Apto::Arrays of transferable values, or cStrings.  Bit-field members must be copied through
+// a local variable.  Reads that run past the end of the buffer mark it as failed, see IsOK().
+
+class cStateBuffer
+{
+private:
+  Apto::Array<char> m_data;
+  int m_size;
+  int m_pos;
+  bool m_loading;
+  bool m_ok;
+
+  void transfer(void* value, int bytes)
+  {
+    if (m_loading) {
+      if (!m_ok || m_pos + bytes > m_size) {
+        m_ok = false;
+        memset(value, 0, bytes);
+        return;
+      }
+      memcpy(value, &m_data[m_pos], bytes);
+      m_pos += bytes;
+    } else {
+      if (m_size + bytes > m_data.GetSize()) {
+        int new_size = (m_data.GetSize()) ? m_data.GetSize() : 1024;
+        while (new_size < m_size + bytes) new_size *= 2;
+        m_data.Resize(new_size);
+      }
+      memcpy(&m_data[m_size], value, bytes);
+      m_size += bytes;
+    }
+  }
+
+public:
+  cStateBuffer() : m_size(0), m_pos(0), m_loading(false), m_ok(true) { ; }
+  cStateBuffer(const char* data, int size) : m_data(size), m_size(size), m_pos(0), m_loading(true), m_ok(true)
+  {
+    if (size) memcpy(&m_data[0], data, size);
+  }
+
+  bool IsLoading() const { return m_loading; }
+  bool IsOK() const { return m_ok; }
+  void SetFailed() { m_ok = false; }
+
+  const char* GetData() const { return (m_size) ? &m_data[0] : NULL; }
+  int GetSize() const { return m_size; }
+
+  template <class T> cStateBuffer& operator&(T& value) { transfer(&value, sizeof(T)); return *this; }
+
+  template <class T, template <class> class SP> cStateBuffer& operator&(Apto::Array<T, SP>& arr)
+  {
+    int size = arr.GetSize();
+    transfer(&size, sizeof(int));
+    if (m_loading) {
+      if (!m_ok || size < 0 || size > m_size - m_pos) {
+        m_ok = false;
+        return *this;
+      }
+      arr.Resize(size);
+    }
+    for (int i = 0; i < size; i++) *this & arr[i];
+    return *this;
+  }
+
+  cStateBuffer& operator&(cString& str)
+  {
+    int size = str.GetSize();
+    transfer(&size, sizeof(int));
+    if (m_loading) {
+      if (!m_ok || size < 0 || m_pos + size > m_size) {
+        m_ok = false;
+        return *this;
+      }
+      str = cString(&m_data[m_pos], size);
+      m_pos += size;
+    } else if (size) {
+      transfer(const_cast<char*>((const char*)str), size);
+    }
+    return *this;
+  }
+};
+
+#endif
@@ -81,6 +81,9 @@ public:
   int GetTotal() const { return total; }
   int GetNumStored() const { return (total <= data.GetSize()) ? total : data.GetSize(); }
   int GetNum() const { return total - last_total; }
+
+  // Save or restore the buffer contents (see cStateBuffer)
+  template <class S> void TransferState(S& state) { state & data & offset & total & last_total; }
 };
 
 #endif
@@ -0,0 +1,200 @@
+/*
+ *  unittests/core/InstructionSequence.cc
+ *  avida-core
+ *
+ *  Copyright 2012 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "avida/core/InstructionSequence.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+using namespace Avida;
+
+
+TEST(InstructionSequence, HashTracksPointMutations)
+{
+  InstructionSequence seq("rucavccccccccccccccccccccccutycasvab");
+  const unsigned long long original = seq.GetHash();
+
+  // Incremental update must agree with hashing the mutated sequence from scratch
+  seq.SetInst(7, Instruction(3));
+  InstructionSequence fresh(seq.AsString());
+  EXPECT_EQ(fresh.GetHash(), seq.GetHash());
+  EXPECT_NE(original, seq.GetHash());
+
+  seq.SetInst(7, Instruction("c"));
+  EXPECT_EQ(original, seq.GetHash());
+}
+
+
+TEST(InstructionSequence, HashInvalidatedByEdits)
+{
+  InstructionSequence seq("rucavccccccccccccccccccccccutycasvab");
+  seq.GetHash();
+
+  seq.Insert(3, Instruction("a"));
+  EXPECT_EQ(InstructionSequence(seq.AsString()).GetHash(), seq.GetHash());
+  seq.Remove(10, 4);
+  EXPECT_EQ(InstructionSequence(seq.AsString()).GetHash(), seq.GetHash());
+  seq[0] = Instruction("b");
+  EXPECT_EQ(InstructionSequence(seq.AsString()).GetHash(), seq.GetHash());
+}
+
+
+TEST(InstructionSequence, HashFollowsSizeChanges)
+{
+  InstructionSequence seq("rucavccccccccccccccccccccccutycasvab");
+  seq.GetHash();
+
+  seq.Resize(50);
+  EXPECT_EQ(InstructionSequence(seq.AsString()).GetHash(), seq.GetHash());
+  seq.Insert(40, InstructionSequence("xyz"));
+  EXPECT_EQ(InstructionSequence(seq.AsString()).GetHash(), seq.GetHash());
+  seq.Copy(45, 2);
+  EXPECT_EQ(InstructionSequence(seq.AsString()).GetHash(), seq.GetHash());
+  seq.Remove(30, 12);
+  EXPECT_EQ(InstructionSequence(seq.AsString()).GetHash(), seq.GetHash());
+  seq.Resize(20);
+  EXPECT_EQ(InstructionSequence(seq.AsString()).GetHash(), seq.GetHash());
+}
+
+
+TEST(InstructionSequence, CropOfGrownSitesIsHashed)
+{
+  // Replication: grow the memory, copy the genome into the new sites and crop the copy back off
+  const InstructionSequence genome("rucavccccccccccccccccccccccutycasvab");
+  InstructionSequence memory(genome);
+  const int size = genome.GetSize();
+  memory.Resize(2 * size);
+  for (int i = 0; i < size; i++) memory.SetInst(size + i, genome[i]);
+  memory.SetInst(size + 4, Instruction("q"));
+  memory.Insert(size + 10, Instruction("b"));
+  memory.Remove(size + 20, 2);
+
+  InstructionSequence offspring = memory.Crop(size, memory.GetSize());
+  EXPECT_EQ(InstructionSequence(offspring.AsString()).GetHash(), offspring.GetHash());
+  InstructionSequence trimmed = memory.Crop(size + 1, memory.GetSize() - 1);
+  EXPECT_EQ(InstructionSequence(trimmed.AsString()).GetHash(), trimmed.GetHash());
+
+  // An exact copy has the genome's hash
+  InstructionSequence copier(genome);
+  copier.Resize(2 * size);
+  const InstructionSequence& parent = copier;
+  for (int i = 0; i < size; i++) copier.SetInst(size + i, parent[i]);
+  EXPECT_EQ(genome, copier.Crop(size, 2 * size));
+  EXPECT_EQ(genome.GetHash(), copier.Crop(size, 2 * size).GetHash());
+}
+
+
+TEST(InstructionSequence, EqualityWithHashes)
+{
+  InstructionSequence a("rucavccccccccccccccccccccccutycasvab");
+  InstructionSequence b(a);
+  a.GetHash();
+  b.GetHash();
+  EXPECT_TRUE(a == b);
+
+  b.SetInst(20, Instruction("a"));
+  EXPECT_FALSE(a == b);
+  b.SetInst(20, Instruction("c"));
+  EXPECT_TRUE(a == b);
+}
+
+
+TEST(InstructionSequence, CopiesShareUntilModified)
+{
+  InstructionSequence original("rucavccccccccccccccccccccccutycasvab");
+  InstructionSequence copy(original);
+  InstructionSequence assigned;
+  assigned = original;
+
+  copy[0] = Instruction("b");
+  assigned.Insert(5, Instruction("z"));
+  EXPECT_EQ(InstructionSequence("rucavccccccccccccccccccccccutycasvab"), original);
+  EXPECT_EQ(InstructionSequence("bucavccccccccccccccccccccccutycasvab"), copy);
+  EXPECT_EQ(InstructionSequence("rucavzccccccccccccccccccccccutycasvab"), assigned);
+
+  // Writing to the original must not show through a copy taken before the write, either
+  InstructionSequence second(original);
+  original.SetInst(1, Instruction("a"));
+  EXPECT_EQ(Instruction("u"), second[1]);
+  EXPECT_EQ(InstructionSequence(second.AsString()).GetHash(), second.GetHash());
+}
+
+
+static int naiveEditDistance(const InstructionSequence& seq1, const InstructionSequence& seq2)
+{
+  const int size1 = seq1.GetSize();
+  const int size2 = seq2.GetSize();
+  std::vector<int> row(size2 + 1);
+  for (int j = 0; j <= size2; j++) row[j] = j;
+  for (int i = 1; i <= size1; i++) {
+    int diag = row[0];
+    row[0] = i;
+    for (int j = 1; j <= size2; j++) {
+      const int up = row[j];
+      row[j] = std::min(std::min(up, row[j - 1]) + 1, diag + ((seq1[i - 1] == seq2[j - 1]) ? 0 : 1));
+      diag = up;
+    }
+  }
+  return row[size2];
+}
+
+static void randomizeSimilar(InstructionSequence& seq, const InstructionSequence& base, int edits)
+{
+  seq = base;
+  for (int i = 0; i < edits && seq.GetSize() > 1; i++) {
+    const int pos = rand() % seq.GetSize();
+    switch (rand() % 3) {
+      case 0: seq[pos] = Instruction(rand() % 26); break;
+      case 1: seq.Insert(pos, Instruction(rand() % 26)); break;
+      case 2: seq.Remove(pos); break;
+    }
+  }
+}
+
+
+TEST(InstructionSequence, DistancesMatchDynamicProgramming)
+{
+  srand(7);
+  for (int trial = 0; trial < 500; trial++) {
+    // Lengths straddle the 64 site blocks of the bit-parallel kernel
+    InstructionSequence base(rand() % 200);
+    for (int i = 0; i < base.GetSize(); i++) base[i] = Instruction(rand() % 26);
+    InstructionSequence seq1, seq2;
+    randomizeSimilar(seq1, base, rand() % 30);
+    randomizeSimilar(seq2, base, rand() % 30);
+
+    const int dist = naiveEditDistance(seq1, seq2);
+    EXPECT_EQ(dist, InstructionSequence::FindEditDistance(seq1, seq2));
+    EXPECT_EQ(dist, InstructionSequence::FindEditDistance(seq2, seq1));
+
+    const int bound = rand() % 40;
+    EXPECT_EQ(std::min(dist, bound + 1), InstructionSequence::FindBoundedEditDistance(seq1, seq2, bound));
+
+    if (seq1.GetSize() == seq2.GetSize() && seq1.GetSize() > 0) {
+      int mismatches = 0;
+      for (int i = 0; i < seq1.GetSize(); i++) if (!(seq1[i] == seq2[i])) mismatches++;
+      EXPECT_EQ(mismatches, InstructionSequence::FindHammingDistance(seq1, seq2));
+    }
+  }
+}
@@ -0,0 +1,67 @@
+/*
+ *  unittests/cpu/cCPUStack.cc
+ *  avida-core
+ *
+ *  Copyright 2012 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cCPUStack.h"
+#include "cStateBuffer.h"
+#include "tBuffer.h"
+
+#include "gtest/gtest.h"
+
+
+TEST(CPUStack, TransferStateRoundTrip)
+{
+  cCPUStack stack;
+  for (int i = 0; i < 5; i++) stack.Push(i * 7);
+  tBuffer<int> inputs(3);
+  for (int i = 0; i < 4; i++) inputs.Add(100 + i);
+
+  cStateBuffer saved;
+  stack.TransferState(saved);
+  inputs.TransferState(saved);
+  ASSERT_TRUE(saved.IsOK());
+
+  cCPUStack restored_stack;
+  tBuffer<int> restored_inputs(1);
+  cStateBuffer loaded(saved.GetData(), saved.GetSize());
+  restored_stack.TransferState(loaded);
+  restored_inputs.TransferState(loaded);
+  ASSERT_TRUE(loaded.IsOK());
+
+  for (int i = 4; i >= 0; i--) EXPECT_EQ(i * 7, restored_stack.Pop());
+  ASSERT_EQ(inputs.GetCapacity(), restored_inputs.GetCapacity());
+  EXPECT_EQ(inputs.GetTotal(), restored_inputs.GetTotal());
+  for (int i = 0; i < inputs.GetNumStored(); i++) EXPECT_EQ(inputs[i], restored_inputs[i]);
+}
+
+
+TEST(CPUStack, TransferStateDetectsTruncation)
+{
+  cCPUStack stack;
+  stack.Push(42);
+
+  cStateBuffer saved;
+  stack.TransferState(saved);
+
+  cCPUStack restored;
+  cStateBuffer loaded(saved.GetData(), saved.GetSize() - 1);
+  restored.TransferState(loaded);
+  EXPECT_FALSE(loaded.IsOK());
+}
@@ -0,0 +1,83 @@
+/*
+ *  unittests/cpu/cGenomeTestCache.cc
+ *  avida-core
+ *
+ *  Copyright 2012 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cGenomeTestCache.h"
+
+#include "gtest/gtest.h"
+
+
+static cGenomeTestCache::sResult makeResult(double fitness)
+{
+  cGenomeTestCache::sResult result;
+  result.is_viable = true;
+  result.fitness = fitness;
+  result.colony_fitness = fitness;
+  result.task_counts.Resize(2);
+  result.task_counts[0] = 1;
+  result.task_counts[1] = 0;
+  return result;
+}
+
+
+TEST(GenomeTestCache, HitsAndMisses)
+{
+  cGenomeTestCache cache(4);
+  cGenomeTestCache::sResult result;
+
+  EXPECT_FALSE(cache.Lookup("a", result));
+  cache.Insert("a", makeResult(0.5));
+  EXPECT_TRUE(cache.Lookup("a", result));
+  EXPECT_TRUE(result.is_viable);
+  EXPECT_DOUBLE_EQ(0.5, result.fitness);
+  EXPECT_EQ(2, result.task_counts.GetSize());
+  EXPECT_EQ(1, result.task_counts[0]);
+
+  EXPECT_EQ(1, cache.GetHits());
+  EXPECT_EQ(1, cache.GetMisses());
+  EXPECT_EQ(1, cache.GetSize());
+}
+
+
+TEST(GenomeTestCache, EvictsLeastRecentlyUsed)
+{
+  cGenomeTestCache cache(3);
+  cGenomeTestCache::sResult result;
+
+  cache.Insert("a", makeResult(1.0));
+  cache.Insert("b", makeResult(2.0));
+  cache.Insert("c", makeResult(3.0));
+
+  // Touch "a" so that "b" becomes the oldest entry
+  EXPECT_TRUE(cache.Lookup("a", result));
+  cache.Insert("d", makeResult(4.0));
+
+  EXPECT_EQ(3, cache.GetSize());
+  EXPECT_EQ(1, cache.GetEvictions());
+  EXPECT_FALSE(cache.Lookup("b", result));
+  EXPECT_TRUE(cache.Lookup("a", result));
+  EXPECT_TRUE(cache.Lookup("c", result));
+  EXPECT_TRUE(cache.Lookup("d", result));
+  EXPECT_DOUBLE_EQ(4.0, result.fitness);
+
+  cache.Clear();
+  EXPECT_EQ(0, cache.GetSize());
+  EXPECT_FALSE(cache.Lookup("a", result));
+}
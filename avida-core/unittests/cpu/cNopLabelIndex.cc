@@ -0,0 +1,113 @@
+/*
+ *  unittests/cpu/cNopLabelIndex.cc
+ *  avida-core
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cNopLabelIndex.h"
+#include "cCodeLabel.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+
+using namespace Avida;
+
+
+// Ops 0-2 are nop-A to nop-C, op 3 is a label instruction and ops 4-7 are anything else
+static const int NUM_OPS = 8;
+static const int LABEL_OP = 3;
+
+static bool matchesAt(const InstructionSequence& seq, const cCodeLabel& label, int pos)
+{
+  if (pos < 0 || pos + label.GetSize() > seq.GetSize()) return false;
+  for (int i = 0; i < label.GetSize(); i++) if (seq[pos + i].GetOp() != label[i]) return false;
+  return true;
+}
+
+static bool labeledAt(const InstructionSequence& seq, const cCodeLabel& label, int pos)
+{
+  return seq[pos].GetOp() == LABEL_OP && matchesAt(seq, label, pos + 1);
+}
+
+
+TEST(NopLabelIndex, MatchesLinearSearch)
+{
+  Apto::Array<int> op_nop_mods(NUM_OPS);
+  Apto::Array<bool> op_labels(NUM_OPS);
+  for (int op = 0; op < NUM_OPS; op++) {
+    op_nop_mods[op] = (op < LABEL_OP) ? op : -1;
+    op_labels[op] = (op == LABEL_OP);
+  }
+
+  srand(11);
+  for (int trial = 0; trial < 2000; trial++) {
+    // Nop heavy sequences, so that runs of nops hold plenty of overlapping occurrences
+    const int size = 1 + rand() % 60;
+    InstructionSequence seq(size);
+    for (int i = 0; i < size; i++) seq[i].SetOp((rand() % 10 < 7) ? rand() % 3 : LABEL_OP + rand() % 5);
+
+    cNopLabelIndex index;
+    index.Build(seq, op_nop_mods, op_labels);
+    ASSERT_EQ(size, index.GetSize());
+
+    for (int q = 0; q < 10; q++) {
+      cCodeLabel label;
+      const int label_size = 1 + rand() % 4;
+      for (int i = 0; i < label_size; i++) label.AddNop(rand() % 3);
+      const int from = rand() % size;
+
+      int next = -1;
+      for (int pos = from; pos < size && next < 0; pos++) if (matchesAt(seq, label, pos)) next = pos;
+      EXPECT_EQ(next, index.FindNext(label, from));
+
+      int previous = -1;
+      for (int pos = from; pos >= 0 && previous < 0; pos--) if (matchesAt(seq, label, pos)) previous = pos;
+      EXPECT_EQ(previous, index.FindPrevious(label, from));
+
+      int first = -1;
+      for (int pos = 0; pos < size && first < 0; pos++) if (labeledAt(seq, label, pos)) first = pos;
+      EXPECT_EQ(first, index.FindFirstLabeled(label));
+
+      // Circularly from the site after from; neither the label instruction nor its nops may land on from itself
+      int circular = -1;
+      for (int step = 1; step < size && circular < 0; step++) {
+        const int pos = (from + step) % size;
+        if (seq[pos].GetOp() != LABEL_OP || step + label_size >= size) continue;
+        bool match = true;
+        for (int i = 0; i < label_size && match; i++) match = (seq[(pos + 1 + i) % size].GetOp() == label[i]);
+        if (match) circular = pos;
+      }
+      EXPECT_EQ(circular, index.FindLabeledCircular(label, from));
+    }
+  }
+}
+
+
+TEST(NopLabelIndex, RevisionTracksWrites)
+{
+  InstructionSequence seq(5);
+  const unsigned int revision = seq.GetRevision();
+
+  const InstructionSequence& const_seq = seq;
+  EXPECT_EQ(0, const_seq[2].GetOp());
+  EXPECT_EQ(revision, seq.GetRevision());
+
+  seq[2].SetOp(4);
+  EXPECT_NE(revision, seq.GetRevision());
+}
@@ -0,0 +1,349 @@
+/*
+ *  unittests/data/Manager.cc
+ *  avida-core
+ *
+ *  Copyright 2012 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "avida/core/Context.h"
+#include "avida/core/Feedback.h"
+#include "avida/core/WorldDriver.h"
+#include "avida/data/Manager.h"
+#include "avida/data/Package.h"
+#include "avida/data/Provider.h"
+#include "avida/data/Recorder.h"
+#include "avida/data/ValueBuffer.h"
+
+#include "gtest/gtest.h"
+
+#include <ctime>
+
+using namespace Avida;
+
+
+static const int NUM_VALUES = 500;
+static const int NUM_UPDATES = 50;
+static const int NUM_PERF_UPDATES = 1000;
+static const int NUM_PERF_RUNS = 3;
+
+
+class TestFeedback : public Feedback
+{
+public:
+  void Error(const char*, ...) { ; }
+  void Warning(const char*, ...) { ; }
+  void Notify(const char*, ...) { ; }
+};
+
+class TestDriver : public WorldDriver
+{
+private:
+  TestFeedback m_feedback;
+  
+public:
+  void Pause() { ; }
+  void Finish() { ; }
+  void Abort(AbortCondition) { ; }
+  Avida::Feedback& Feedback() { return m_feedback; }
+  void RegisterCallback(DriverCallback) { ; }
+};
+
+
+// Provides NUM_VALUES double values, optionally writing them straight into the value buffer
+class TestProvider : public Data::Provider
+{
+private:
+  bool m_direct;
+  Data::DataSetPtr m_provides;
+  Apto::Map<Data::DataID, int> m_index;
+  Apto::Array<double> m_values;
+  Data::ValueBuffer* m_buffer;
+  Apto::Array<Data::ValueSlot> m_slots;
+  
+public:
+  explicit TestProvider(bool direct)
+    : m_direct(direct), m_provides(new Data::DataSet), m_values(NUM_VALUES), m_buffer(NULL)
+  {
+    m_slots.Resize(NUM_VALUES);
+    for (int i = 0; i < NUM_VALUES; i++) {
+      Data::DataID data_id = Apto::FormatStr("test.value.%d", i);
+      m_provides->Insert(data_id);
+      m_index[data_id] = i;
+    }
+  }
+  
+  Data::ConstDataSetPtr Provides() const { return m_provides; }
+  void UpdateProvidedValues(Update current_update)
+  {
+    for (int i = 0; i < NUM_VALUES; i++) m_values[i] = current_update * 0.5 + i;
+    if (m_buffer) for (int i = 0; i < NUM_VALUES; i++) m_buffer->SetDouble(m_slots[i], m_values[i]);
+  }
+  Data::PackagePtr GetProvidedValue(const Data::DataID& data_id) const
+  {
+    return Data::PackagePtr(new Data::Wrap<double>(m_values[m_index.GetWithDefault(data_id, 0)]));
+  }
+  Apto::String DescribeProvidedValue(const Data::DataID&) const { return "test value"; }
+  
+  bool BindProvidedValue(const Data::DataID& data_id, Data::ValueBuffer& buffer, Data::ValueSlot& slot)
+  {
+    if (!m_direct) return false;
+    m_buffer = &buffer;
+    slot = m_slots[m_index.GetWithDefault(data_id, 0)] = buffer.AddDouble();
+    return true;
+  }
+};
+
+static Data::ProviderPtr s_provider;
+static Data::ProviderPtr activateTestProvider(World*) { return s_provider; }
+
+
+// Sums every requested value, either by data id lookup or by compiled slot
+class TestRecorder : public Data::Recorder
+{
+private:
+  bool m_indexed;
+  Data::DataSetPtr m_requested;
+  Apto::Array<Data::DataID> m_ids;
+  Apto::Array<Data::ValueSlot> m_slots;
+  
+public:
+  double total;
+  
+  explicit TestRecorder(bool indexed)
+    : m_indexed(indexed), m_requested(new Data::DataSet), total(0.0)
+  {
+    for (int i = 0; i < NUM_VALUES; i++) {
+      m_ids.Push(Apto::FormatStr("test.value.%d", i));
+      m_requested->Insert(m_ids[i]);
+    }
+  }
+  
+  Data::ConstDataSetPtr RequestedData() const { return m_requested; }
+  void NotifyData(Update, Data::DataRetrievalFunctor retrieve_data)
+  {
+    for (int i = 0; i < m_ids.GetSize(); i++) total += retrieve_data(m_ids[i])->DoubleValue();
+  }
+  
+  bool SupportsIndexedData() const { return m_indexed; }
+  void BindRequestedData(const Data::DataID&, const Data::ValueSlot& slot) { m_slots.Push(slot); }
+  void NotifyValues(Update, const Data::ValueBuffer& values)
+  {
+    for (int i = 0; i < m_slots.GetSize(); i++) total += values.DoubleValue(m_slots[i]);
+  }
+};
+
+
+static double runUpdates(bool direct, bool indexed, int num_updates = NUM_UPDATES, double* seconds = NULL)
+{
+  s_provider = Data::ProviderPtr(new TestProvider(direct));
+  
+  Data::ManagerPtr manager(new Data::Manager);
+  Data::ProviderActivateFunctor activate(activateTestProvider);
+  for (int i = 0; i < NUM_VALUES; i++) manager->Register(Apto::FormatStr("test.value.%d", i), activate);
+  
+  TestRecorder* recorder = new TestRecorder(indexed);
+  Data::RecorderPtr recorder_ptr(recorder);
+  EXPECT_TRUE(manager->AttachRecorder(recorder_ptr));
+  
+  TestDriver driver;
+  Context ctx(&driver, NULL);
+  
+  const clock_t start = clock();
+  for (int u = 0; u < num_updates; u++) manager->PerformUpdate(ctx, u);
+  manager->Synchronize();
+  if (seconds) *seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+  
+  s_provider = Data::ProviderPtr();
+  return recorder->total;
+}
+
+
+// Every way of delivering values to a recorder must see the same values as lookup by data id
+TEST(DataManager, CompiledValues)
+{
+  const double lookup = runUpdates(false, false);
+  const double gathered = runUpdates(false, true);
+  const double direct = runUpdates(true, true);
+  
+  double expected = 0.0;
+  for (int u = 0; u < NUM_UPDATES; u++) for (int i = 0; i < NUM_VALUES; i++) expected += u * 0.5 + i;
+  
+  EXPECT_DOUBLE_EQ(expected, lookup);
+  EXPECT_DOUBLE_EQ(expected, gathered);
+  EXPECT_DOUBLE_EQ(expected, direct);
+}
+
+
+// Best of NUM_PERF_RUNS timings of NUM_PERF_UPDATES updates delivering every value
+static double timeUpdates(bool direct, bool indexed)
+{
+  double best = -1.0;
+  for (int run = 0; run < NUM_PERF_RUNS; run++) {
+    double seconds = 0.0;
+    runUpdates(direct, indexed, NUM_PERF_UPDATES, &seconds);
+    if (best < 0.0 || seconds < best) best = seconds;
+  }
+  return best;
+}
+
+
+// The compiled value buffer exists to take the per value lookup and package allocation out of every update; it must
+// beat retrieval through GetCurrentValue.  Timings are recorded as test properties (microseconds) in the XML report.
+TEST(DataManager, CompiledValuesPerformance)
+{
+  const double lookup = timeUpdates(false, false);
+  const double gathered = timeUpdates(false, true);
+  const double direct = timeUpdates(true, true);
+  
+  RecordProperty("lookup_usec", (int)(lookup * 1.0e6));
+  RecordProperty("gathered_usec", (int)(gathered * 1.0e6));
+  RecordProperty("direct_usec", (int)(direct * 1.0e6));
+  
+  EXPECT_LT(gathered, lookup);
+  EXPECT_LT(direct, lookup);
+}
+
+
+// Provides the running sum of a live counter array that the "world" keeps changing between updates.  The sums are
+// reduced from a snapshot, so they can be computed on the background thread while the next update changes the counters.
+class CounterProvider : public Data::Provider
+{
+private:
+  Data::DataSetPtr m_provides;
+  Apto::Array<int> m_snapshot;
+  int m_sum;
+  Data::ValueBuffer* m_buffer;
+  Data::ValueSlot m_slot;
+  
+public:
+  Apto::Array<int> counters;
+  
+  CounterProvider() : m_provides(new Data::DataSet), m_sum(0), m_buffer(NULL), counters(NUM_VALUES)
+  {
+    m_provides->Insert("test.counter.sum");
+    m_provides->Insert("test.counter.first");
+    counters.SetAll(0);
+  }
+  
+  Data::ConstDataSetPtr Provides() const { return m_provides; }
+  void SnapshotProvidedValues(Update) { m_snapshot = counters; }
+  bool SupportsBackgroundUpdate() const { return true; }
+  void UpdateProvidedValues(Update)
+  {
+    m_sum = 0;
+    for (int i = 0; i < m_snapshot.GetSize(); i++) m_sum += m_snapshot[i];
+    if (m_buffer) m_buffer->SetInt(m_slot, m_sum);
+  }
+  Data::PackagePtr GetProvidedValue(const Data::DataID& data_id) const
+  {
+    return Data::PackagePtr(new Data::Wrap<int>((data_id == "test.counter.sum") ? m_sum : m_snapshot[0]));
+  }
+  Apto::String DescribeProvidedValue(const Data::DataID&) const { return "test counter"; }
+  
+  bool BindProvidedValue(const Data::DataID& data_id, Data::ValueBuffer& buffer, Data::ValueSlot& slot)
+  {
+    if (data_id != "test.counter.sum") return false;
+    m_buffer = &buffer;
+    slot = m_slot = buffer.AddInt();
+    return true;
+  }
+};
+
+static Data::ProviderPtr s_counter_provider;
+static Data::ProviderPtr activateCounterProvider(World*) { return s_counter_provider; }
+
+// Records both values for every update, through the value buffer
+class CounterRecorder : public Data::Recorder
+{
+private:
+  Data::DataSetPtr m_requested;
+  Data::ValueSlot m_sum_slot;
+  Data::ValueSlot m_first_slot;
+  
+public:
+  Apto::Array<int> sums;
+  Apto::Array<int> firsts;
+  
+  CounterRecorder() : m_requested(new Data::DataSet)
+  {
+    m_requested->Insert("test.counter.sum");
+    m_requested->Insert("test.counter.first");
+  }
+  
+  Data::ConstDataSetPtr RequestedData() const { return m_requested; }
+  void NotifyData(Update, Data::DataRetrievalFunctor) { ; }
+  
+  bool SupportsIndexedData() const { return true; }
+  void BindRequestedData(const Data::DataID& data_id, const Data::ValueSlot& slot)
+  {
+    if (data_id == "test.counter.sum") m_sum_slot = slot;
+    else m_first_slot = slot;
+  }
+  void NotifyValues(Update, const Data::ValueBuffer& values)
+  {
+    sums.Push(values.IntValue(m_sum_slot));
+    firsts.Push(values.PackageValue(m_first_slot)->IntValue());
+  }
+  bool SupportsBackgroundNotify() const { return true; }
+};
+
+
+static void recordCounters(bool background, Data::RecorderPtr recorder)
+{
+  CounterProvider* provider = new CounterProvider;
+  s_counter_provider = Data::ProviderPtr(provider);
+  
+  Data::ManagerPtr manager(new Data::Manager);
+  Data::ProviderActivateFunctor activate(activateCounterProvider);
+  manager->Register("test.counter.sum", activate);
+  manager->Register("test.counter.first", activate);
+  EXPECT_TRUE(manager->AttachRecorder(recorder));
+  manager->SetBackgroundUpdate(background);
+  
+  TestDriver driver;
+  Context ctx(&driver, NULL);
+  
+  for (int u = 0; u < NUM_UPDATES; u++) {
+    // The next update runs while the previous one may still be recorded in the background
+    for (int i = 0; i < NUM_VALUES; i++) provider->counters[i] += (u * 7 + i) % 13;
+    manager->PerformUpdate(ctx, u);
+  }
+  manager->Synchronize();
+  manager->SetBackgroundUpdate(false);
+  
+  s_counter_provider = Data::ProviderPtr();
+}
+
+
+// Values recorded with the background update enabled must be exactly those recorded synchronously
+TEST(DataManager, BackgroundUpdateMatchesSynchronous)
+{
+  CounterRecorder* synchronous = new CounterRecorder;
+  Data::RecorderPtr synchronous_ptr(synchronous);
+  recordCounters(false, synchronous_ptr);
+  
+  CounterRecorder* background = new CounterRecorder;
+  Data::RecorderPtr background_ptr(background);
+  recordCounters(true, background_ptr);
+  
+  ASSERT_EQ(NUM_UPDATES, synchronous->sums.GetSize());
+  ASSERT_EQ(NUM_UPDATES, background->sums.GetSize());
+  for (int u = 0; u < NUM_UPDATES; u++) {
+    EXPECT_EQ(synchronous->sums[u], background->sums[u]);
+    EXPECT_EQ(synchronous->firsts[u], background->firsts[u]);
+  }
+}
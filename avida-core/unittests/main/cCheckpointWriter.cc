@@ -0,0 +1,84 @@
+/*
+ *  unittests/main/cCheckpointWriter.cc
+ *  avida-core
+ *
+ *  Copyright 2012 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cCheckpointWriter.h"
+#include "cPopulationCheckpoint.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+
+
+static cPopulationCheckpoint* makeCheckpoint(int update)
+{
+  cPopulationCheckpoint* checkpoint = new cPopulationCheckpoint;
+  checkpoint->SetUpdate(update);
+  checkpoint->SetWorldSize(10, 10);
+  checkpoint->SetRNGSeed(update);
+  return checkpoint;
+}
+
+
+TEST(CheckpointWriter, WritesEverySubmittedCheckpoint)
+{
+  {
+    cCheckpointWriter writer(1);
+    for (int i = 0; i < 4; i++) {
+      writer.Submit(makeCheckpoint(i), cString("writer_test-") + cString(Apto::FormatStr("%d", i)) + ".ckpt", i % 2);
+      EXPECT_LE(writer.GetNumPending(), 1);
+    }
+    writer.Flush();
+    EXPECT_EQ(0, writer.GetNumPending());
+
+    Apto::Array<cString> failed;
+    writer.TakeFailures(failed);
+    EXPECT_EQ(0, failed.GetSize());
+  }
+
+  for (int i = 0; i < 4; i++) {
+    const cString filename = cString("writer_test-") + cString(Apto::FormatStr("%d", i)) + ".ckpt";
+    {
+      cPopulationCheckpointView view;
+      ASSERT_TRUE(view.Open(filename));
+      EXPECT_EQ(i, view.GetUpdate());
+    }
+
+    // No temporary file is left behind
+    FILE* fp = fopen(filename + ".tmp", "rb");
+    EXPECT_TRUE(fp == NULL);
+    if (fp) fclose(fp);
+
+    remove(filename);
+  }
+}
+
+
+TEST(CheckpointWriter, ReportsFailedWrites)
+{
+  cCheckpointWriter writer(2);
+  writer.Submit(makeCheckpoint(1), "no_such_directory/writer_test.ckpt", false);
+  writer.Flush();
+
+  Apto::Array<cString> failed;
+  writer.TakeFailures(failed);
+  ASSERT_EQ(1, failed.GetSize());
+  EXPECT_STREQ("no_such_directory/writer_test.ckpt", (const char*)failed[0]);
+}
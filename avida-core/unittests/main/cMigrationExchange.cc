@@ -0,0 +1,242 @@
+/*
+ *  unittests/main/cMigrationExchange.cc
+ *  avida-core
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cMigrationExchange.h"
+
+#include "avida/core/InstructionSequence.h"
+
+#include "cHardwareManager.h"
+
+#include "gtest/gtest.h"
+
+
+// Each world runs on its own thread, connected through a cLocalMigrationHub, and migrates a fixed pattern of organisms
+// every update.  The pattern is known up front, so every world can check exactly what it should have received.
+
+static const int NUM_WORLDS = 4;
+static const int NUM_UPDATES = 150;
+
+static int numMigrants(int world, int update) { return (world + update) % 4; }
+static int destination(int world, int update, int i) { return (world * 7 + update * 3 + i * 5) % NUM_WORLDS; }
+
+static Genome migrantGenome(const PropertyMap& props, int world, int update, int i)
+{
+  Apto::String seq;
+  for (int site = 0; site < 10 + i; site++) seq += (char)('a' + (world + update + site) % 26);
+  return Genome(0, props, GeneticRepresentationPtr(new InstructionSequence((const char*)seq)));
+}
+
+// Migrants sent to dst from updates up to and including through, in the order they must arrive
+static int expectedArrivals(int dst, int through)
+{
+  int count = 0;
+  for (int update = 0; update <= through; update++) {
+    for (int src = 0; src < NUM_WORLDS; src++) {
+      for (int i = 0; i < numMigrants(src, update); i++) if (destination(src, update, i) == dst) count++;
+    }
+  }
+  return count;
+}
+
+
+class WorldThread : public Apto::Thread
+{
+private:
+  cMigrationTransport* m_transport;
+  const PropertyMap* m_props;
+  int m_lag;
+
+public:
+  Apto::Array<cMigrationExchange::sMigrant, Apto::Smart> arrivals;
+  bool lag_respected;
+  int waits;
+
+  WorldThread() : m_transport(NULL), m_props(NULL), m_lag(0), lag_respected(true), waits(0) { ; }
+  void Setup(cMigrationTransport* transport, const PropertyMap* props, int lag)
+  {
+    m_transport = transport;
+    m_props = props;
+    m_lag = lag;
+  }
+
+protected:
+  void Run()
+  {
+    cMigrationExchange exchange(m_transport, m_lag);
+    const int id = exchange.GetWorldID();
+
+    for (int update = 0; update < NUM_UPDATES; update++) {
+      for (int i = 0; i < numMigrants(id, update); i++) {
+        cMigrationExchange::sMigrant migrant;
+        migrant.genome = migrantGenome(*m_props, id, update, i);
+        migrant.merit = update + 0.25;
+        migrant.lineage = i;
+        migrant.x = id;
+        migrant.y = 2 * id;
+        migrant.generation = update;
+        exchange.Add(destination(id, update, i), migrant);
+      }
+      exchange.FinishUpdate(update);
+      exchange.Collect(arrivals);
+
+      // Everything sent more than the maximum lag ago must have been delivered
+      if (arrivals.GetSize() < expectedArrivals(id, update - m_lag)) lag_respected = false;
+    }
+
+    // The final exchange receives the migrants still in flight
+    exchange.Drain(arrivals);
+    waits = exchange.GetNumWaits();
+  }
+};
+
+
+static void runWorlds(int lag)
+{
+  HashPropertyMap props;
+  cHardwareManager::SetupPropertyMap(props, "heads_default");
+
+  cLocalMigrationHub hub(NUM_WORLDS);
+  WorldThread worlds[NUM_WORLDS];
+  for (int w = 0; w < NUM_WORLDS; w++) worlds[w].Setup(hub.GetTransport(w), &props, lag);
+  for (int w = 0; w < NUM_WORLDS; w++) worlds[w].Start();
+  for (int w = 0; w < NUM_WORLDS; w++) worlds[w].Join();
+
+  for (int dst = 0; dst < NUM_WORLDS; dst++) {
+    const Apto::Array<cMigrationExchange::sMigrant, Apto::Smart>& arrivals = worlds[dst].arrivals;
+    EXPECT_TRUE(worlds[dst].lag_respected);
+    ASSERT_EQ(expectedArrivals(dst, NUM_UPDATES - 1), arrivals.GetSize());
+
+    // Every migrant exactly once, ordered by update, then source world, then send order
+    int next = 0;
+    for (int update = 0; update < NUM_UPDATES; update++) {
+      for (int src = 0; src < NUM_WORLDS; src++) {
+        for (int i = 0; i < numMigrants(src, update); i++) {
+          if (destination(src, update, i) != dst) continue;
+          const cMigrationExchange::sMigrant& migrant = arrivals[next++];
+          EXPECT_EQ(src, migrant.src_world);
+          EXPECT_EQ(update, migrant.src_update);
+          EXPECT_EQ(i, migrant.lineage);
+          EXPECT_EQ(update + 0.25, migrant.merit);
+          EXPECT_EQ(src, migrant.x);
+          EXPECT_EQ(2 * src, migrant.y);
+          EXPECT_EQ(update, migrant.generation);
+          EXPECT_EQ(migrantGenome(props, src, update, i).AsString(), migrant.genome.AsString());
+        }
+      }
+    }
+  }
+}
+
+
+TEST(MigrationExchange, Synchronized)
+{
+  runWorlds(0);
+}
+
+
+TEST(MigrationExchange, BoundedLag)
+{
+  runWorlds(3);
+}
+
+
+TEST(MigrationExchange, SingleWorld)
+{
+  HashPropertyMap props;
+  cHardwareManager::SetupPropertyMap(props, "heads_default");
+
+  cLocalMigrationHub hub(1);
+  cMigrationExchange exchange(hub.GetTransport(0), 0);
+
+  cMigrationExchange::sMigrant migrant;
+  migrant.genome = migrantGenome(props, 0, 0, 0);
+  migrant.merit = 1.0;
+  migrant.lineage = 3;
+  migrant.x = migrant.y = migrant.generation = 0;
+  exchange.Add(0, migrant);
+  exchange.FinishUpdate(0);
+
+  Apto::Array<cMigrationExchange::sMigrant, Apto::Smart> arrivals;
+  exchange.Collect(arrivals);
+  ASSERT_EQ(1, arrivals.GetSize());
+  EXPECT_EQ(3, arrivals[0].lineage);
+  EXPECT_EQ(migrant.genome.AsString(), arrivals[0].genome.AsString());
+
+  // Nothing sent, nothing waited for
+  exchange.FinishUpdate(1);
+  exchange.Collect(arrivals);
+  EXPECT_EQ(1, arrivals.GetSize());
+  EXPECT_EQ(0, exchange.GetNumWaits());
+  EXPECT_EQ(1, exchange.GetMigrantsSent());
+  EXPECT_EQ(1, exchange.GetMigrantsReceived());
+}
+
+
+TEST(MigrationExchange, ReportsCorruptBatch)
+{
+  cLocalMigrationHub hub(1);
+  cMigrationExchange exchange(hub.GetTransport(0), 0);
+
+  // An instset name that runs past the end of the batch, delivered ahead of the exchange's own (empty) batch
+  Apto::Array<unsigned char> batch(2);
+  batch[0] = 0;
+  batch[1] = 0x7e;
+  hub.GetTransport(0)->Send(0, 0, batch);
+  exchange.FinishUpdate(0);
+
+  Apto::Array<cMigrationExchange::sMigrant, Apto::Smart> arrivals;
+  exchange.Collect(arrivals);
+  EXPECT_EQ(0, arrivals.GetSize());
+  EXPECT_EQ(0, exchange.GetMigrantsReceived());
+  EXPECT_EQ(1, exchange.GetNumCorruptBatches());
+}
+
+
+// A hub endpoint that only keeps batches up to five updates apart
+class LimitedTransport : public cMigrationTransport
+{
+private:
+  cMigrationTransport* m_transport;
+
+public:
+  LimitedTransport(cMigrationTransport* transport) : m_transport(transport) { ; }
+
+  int GetWorldID() const { return m_transport->GetWorldID(); }
+  int GetNumWorlds() const { return m_transport->GetNumWorlds(); }
+  void Send(int dst_world, int update, Apto::Array<unsigned char>& batch) { m_transport->Send(dst_world, update, batch); }
+  bool Receive(int src_world, int update, Apto::Array<unsigned char>& batch, bool block)
+  {
+    return m_transport->Receive(src_world, update, batch, block);
+  }
+  int GetMaxLag() const { return 5; }
+};
+
+
+TEST(MigrationExchange, ClampsLagToTransport)
+{
+  cLocalMigrationHub hub(1);
+  LimitedTransport transport(hub.GetTransport(0));
+
+  EXPECT_EQ(5, cMigrationExchange(&transport, 100).GetMaxLag());
+  EXPECT_EQ(3, cMigrationExchange(&transport, 3).GetMaxLag());
+  EXPECT_EQ(0, cMigrationExchange(&transport, -2).GetMaxLag());
+  EXPECT_EQ(100, cMigrationExchange(hub.GetTransport(0), 100).GetMaxLag());
+}
@@ -0,0 +1,72 @@
+/*
+ *  unittests/main/cOrganismPool.cc
+ *  avida-core
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cOrganismPool.h"
+
+#include "gtest/gtest.h"
+
+
+TEST(OrganismPool, RecyclesFreedBlocks)
+{
+  cOrganismPool pool(true);
+
+  void* first = pool.AllocateOrganism(200);
+  void* second = pool.AllocateOrganism(200);
+  EXPECT_NE(first, second);
+
+  cOrganismPool::Free(first);
+  EXPECT_EQ(first, pool.AllocateOrganism(200));
+
+  cOrganismPool::sStats stats = pool.GetOrganismStats();
+  EXPECT_EQ(3, stats.allocated);
+  EXPECT_EQ(1, stats.recycled);
+  EXPECT_EQ(2, stats.live);
+  EXPECT_EQ(2, stats.peak_live);
+  EXPECT_EQ(1, stats.slabs);
+
+  // Each hardware size gets its own pool
+  void* cpu = pool.AllocateHardware(300);
+  void* smt = pool.AllocateHardware(500);
+  EXPECT_EQ(2, pool.GetHardwareStats().slabs);
+
+  cOrganismPool::Free(first);
+  cOrganismPool::Free(second);
+  cOrganismPool::Free(cpu);
+  cOrganismPool::Free(smt);
+  EXPECT_EQ(0, pool.GetOrganismStats().live);
+  EXPECT_EQ(0, pool.GetHardwareStats().live);
+}
+
+
+TEST(OrganismPool, OutlivedByItsObjects)
+{
+  // Reference counted organisms may still be held (by systematics, for instance) once the world is torn down
+  cOrganismPool* pool = new cOrganismPool(true);
+  void* org = pool->AllocateOrganism(200);
+  void* hw = pool->AllocateHardware(300);
+  delete pool;
+
+  static_cast<char*>(org)[199] = 1;
+  static_cast<char*>(hw)[299] = 1;
+  cOrganismPool::Free(org);
+  cOrganismPool::Free(hw);
+}
+
@@ -0,0 +1,124 @@
+/*
+ *  unittests/main/cPointMutationScheduler.cc
+ *  avida-core
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cPointMutationScheduler.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+
+
+static double binomialPMF(int n, double p, int k)
+{
+  return exp(lgamma(n + 1.0) - lgamma(k + 1.0) - lgamma(n - k + 1.0) + k * log(p) + (n - k) * log(1.0 - p));
+}
+
+// Pearson's chi-square statistic of per-block hit counts against Binomial(n, p), pooling the upper tail into the last
+// bin so every bin expects at least 20 blocks
+static double chiSquare(const Apto::Array<int>& counts, int n, double p, int& dof)
+{
+  int total = 0;
+  for (int k = 0; k < counts.GetSize(); k++) total += counts[k];
+
+  double stat = 0.0;
+  double remaining = 1.0;
+  int observed_remaining = total;
+  dof = 0;
+  for (int k = 0; k < counts.GetSize(); k++) {
+    const double expected = total * binomialPMF(n, p, k);
+    if (total * (remaining - binomialPMF(n, p, k)) < 20.0) break;
+    stat += (counts[k] - expected) * (counts[k] - expected) / expected;
+    remaining -= binomialPMF(n, p, k);
+    observed_remaining -= counts[k];
+    dof++;
+  }
+  const double expected = total * remaining;
+  stat += (observed_remaining - expected) * (observed_remaining - expected) / expected;
+  return stat;
+}
+
+
+// The number of mutations landing in each organism must be distributed exactly as the per-organism binomial draw it
+// replaces, whatever the genome lengths and however the sites are split among organisms.
+TEST(PointMutationScheduler, HitsAreBinomialPerBlock)
+{
+  Apto::RNG::AvidaRNG rng(17);
+  const int NUM_BLOCKS = 200000;
+  const int lengths[] = { 100, 37, 163 };
+  const double probs[] = { 0.02, 0.0025 };
+
+  for (int pi = 0; pi < 2; pi++) {
+    cSiteSkipSampler sampler;
+    sampler.SetProbability(probs[pi]);
+
+    // Interleave blocks of several lengths, as organisms of different sizes would be; only the length 100 blocks are
+    // tallied, the others must simply not disturb them
+    Apto::Array<int> counts(40);
+    counts.SetAll(0);
+    double sum = 0.0;
+    double sum_sq = 0.0;
+    for (int b = 0; b < NUM_BLOCKS; b++) {
+      for (int l = 0; l < 3; l++) {
+        const int hits = sampler.Hits(rng, lengths[l]);
+        ASSERT_GE(hits, 0);
+        ASSERT_LE(hits, lengths[l]);
+        if (l != 0) continue;
+        counts[(hits < counts.GetSize()) ? hits : counts.GetSize() - 1]++;
+        sum += hits;
+        sum_sq += hits * hits;
+      }
+    }
+
+    const double n = lengths[0];
+    const double p = probs[pi];
+    const double mean = sum / NUM_BLOCKS;
+    const double var = sum_sq / NUM_BLOCKS - mean * mean;
+    EXPECT_NEAR(n * p, mean, 5.0 * sqrt(n * p * (1.0 - p) / NUM_BLOCKS));
+    EXPECT_NEAR(n * p * (1.0 - p), var, 0.03 * n * p * (1.0 - p));
+
+    // Critical values for p = 0.001 at the degrees of freedom these bins produce
+    int dof = 0;
+    const double stat = chiSquare(counts, lengths[0], p, dof);
+    const double critical[] = { 10.83, 13.82, 16.27, 18.47, 20.52, 22.46, 24.32, 26.12, 27.88, 29.59 };
+    ASSERT_GE(dof, 1);
+    ASSERT_LE(dof, 10);
+    EXPECT_LT(stat, critical[dof - 1]) << "p = " << p << ", " << dof << " degrees of freedom";
+  }
+}
+
+
+TEST(PointMutationScheduler, EdgeProbabilities)
+{
+  Apto::RNG::AvidaRNG rng(3);
+  cSiteSkipSampler sampler;
+
+  EXPECT_EQ(0, sampler.Hits(rng, 1000));
+
+  sampler.SetProbability(1.0);
+  EXPECT_EQ(50, sampler.Hits(rng, 50));
+  EXPECT_EQ(0, sampler.Hits(rng, 0));
+
+  // Tiny rates over a large population: the total matches the expected count without visiting sites one at a time
+  sampler.SetProbability(1e-5);
+  long long total = 0;
+  for (int i = 0; i < 1000000; i++) total += sampler.Hits(rng, 1000);
+  EXPECT_NEAR(10000.0, (double)total, 5.0 * sqrt(10000.0));
+}
@@ -0,0 +1,192 @@
+/*
+ *  unittests/main/cPopulationCheckpoint.cc
+ *  avida-core
+ *
+ *  Copyright 2012 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cPopulationCheckpoint.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <cstring>
+
+
+static void buildCheckpoint(cPopulationCheckpoint& checkpoint)
+{
+  checkpoint.SetUpdate(1234);
+  checkpoint.SetWorldSize(60, 40);
+
+  Apto::Array<Apto::String> names;
+  names.Push("id");
+  names.Push("merit");
+  names.Push("sequence");
+
+  for (int g = 0; g < 3; g++) {
+    Apto::Array<Apto::String> values;
+    values.Push(Apto::FormatStr("%d", 10 + g));
+    values.Push(Apto::FormatStr("%d", 100 * (g + 1)));
+    values.Push((g == 2) ? "" : "rucavcccccccccccccccccccccccccccccccccccccccccccccccccccccccccccccutycasvab");
+    checkpoint.AddGenotype(names, values, g == 1);
+  }
+
+  // Mostly default columns, which is the case run-length coding is meant for
+  int columns[cPopulationCheckpoint::NUM_CELL_COLUMNS] = { 0, 0, 0, -1, -1, 0, -1, -1, -1, 0 };
+  for (int cell = 0; cell < 2400; cell += 3) {
+    columns[cPopulationCheckpoint::CELL_ID] = cell;
+    columns[cPopulationCheckpoint::CELL_GEST_OFFSET] = cell % 17;
+    checkpoint.AddCell(cell % 3 == 0 ? 0 : 2, columns, 1.0, 0.5 * cell);
+  }
+
+  Apto::Array<double> levels;
+  levels.Push(25.0);
+  levels.Push(0.0);
+  Apto::Array<int> spatial;
+  spatial.Push(0);
+  spatial.Push(1);
+  Apto::Array<Apto::Array<double> > spatial_levels(2);
+  spatial_levels[1].Resize(2400);
+  for (int i = 0; i < 2400; i++) spatial_levels[1][i] = (i < 100) ? 2.0 : 0.0;
+  checkpoint.SetResources(levels, spatial, spatial_levels);
+
+  checkpoint.SetRNGSeed(4321);
+
+  Apto::Array<double> priorities(2400);
+  for (int i = 0; i < 2400; i++) priorities[i] = (i % 3 == 0) ? 0.5 * i : 0.0;
+  checkpoint.SetSchedulePriorities(priorities);
+
+  Apto::Array<int> triggers;
+  Apto::Array<double> original_starts, intervals, starts;
+  triggers.Push(0);
+  original_starts.Push(0.0);
+  intervals.Push(100.0);
+  starts.Push(1300.0);
+  checkpoint.SetEvents(triggers, original_starts, intervals, starts);
+}
+
+
+static void checkView(const cPopulationCheckpointView& view)
+{
+  EXPECT_EQ(1234, view.GetUpdate());
+  EXPECT_EQ(60, view.GetWorldX());
+  EXPECT_EQ(40, view.GetWorldY());
+
+  ASSERT_EQ(3, view.GetNumGenotypes());
+  ASSERT_EQ(3, view.GetNumFields());
+  EXPECT_STREQ("merit", view.GetFieldName(1));
+  EXPECT_STREQ("11", view.GetField(1, "id"));
+  EXPECT_STREQ("300", view.GetField(2, 1));
+  EXPECT_STREQ("", view.GetField(2, "sequence"));
+  EXPECT_TRUE(view.IsParasite(1));
+  EXPECT_FALSE(view.IsParasite(0));
+
+  ASSERT_EQ(800, view.GetNumCells());
+  for (int row = 0; row < view.GetNumCells(); row++) {
+    const int cell = row * 3;
+    EXPECT_EQ(cell, view.GetCellColumn(cPopulationCheckpoint::CELL_ID)[row]);
+    EXPECT_EQ(cell % 17, view.GetCellColumn(cPopulationCheckpoint::CELL_GEST_OFFSET)[row]);
+    EXPECT_EQ(-1, view.GetCellColumn(cPopulationCheckpoint::CELL_GROUP_ID)[row]);
+    EXPECT_EQ(cell % 3 == 0 ? 0 : 2, view.GetCellGenotypes()[row]);
+    EXPECT_DOUBLE_EQ(0.5 * cell, view.GetCellMerits()[row]);
+  }
+
+  ASSERT_EQ(2, view.GetNumResources());
+  EXPECT_FALSE(view.IsSpatialResource(0));
+  EXPECT_DOUBLE_EQ(25.0, view.GetResource(0));
+  ASSERT_TRUE(view.IsSpatialResource(1));
+  ASSERT_EQ(2400, view.GetNumResourceCells());
+  EXPECT_DOUBLE_EQ(2.0, view.GetSpatialResource(1)[99]);
+  EXPECT_DOUBLE_EQ(0.0, view.GetSpatialResource(1)[100]);
+
+  EXPECT_EQ(cPopulationCheckpoint::VERSION, view.GetVersion());
+  int seed = 0;
+  ASSERT_TRUE(view.GetRNGSeed(seed));
+  EXPECT_EQ(4321, seed);
+
+  ASSERT_EQ(2400, view.GetNumSchedulePriorities());
+  EXPECT_DOUBLE_EQ(0.0, view.GetSchedulePriorities()[1]);
+  EXPECT_DOUBLE_EQ(1.5, view.GetSchedulePriorities()[3]);
+
+  Apto::Array<int> triggers;
+  Apto::Array<double> original_starts, intervals, starts;
+  view.GetEvents(triggers, original_starts, intervals, starts);
+  ASSERT_EQ(1, triggers.GetSize());
+  EXPECT_DOUBLE_EQ(1300.0, starts[0]);
+}
+
+
+TEST(PopulationCheckpoint, RoundTrip)
+{
+  cPopulationCheckpoint checkpoint;
+  buildCheckpoint(checkpoint);
+  ASSERT_TRUE(checkpoint.Save("checkpoint_roundtrip.ckpt", false));
+
+  cPopulationCheckpointView view;
+  ASSERT_TRUE(view.Open("checkpoint_roundtrip.ckpt"));
+  checkView(view);
+
+  remove("checkpoint_roundtrip.ckpt");
+}
+
+
+TEST(PopulationCheckpoint, CompressedRoundTrip)
+{
+  cPopulationCheckpoint checkpoint;
+  buildCheckpoint(checkpoint);
+  ASSERT_TRUE(checkpoint.Save("checkpoint_raw.ckpt", false));
+  ASSERT_TRUE(checkpoint.Save("checkpoint_rle.ckpt", true));
+
+  FILE* raw = fopen("checkpoint_raw.ckpt", "rb");
+  FILE* rle = fopen("checkpoint_rle.ckpt", "rb");
+  ASSERT_TRUE(raw && rle);
+  fseek(raw, 0, SEEK_END);
+  fseek(rle, 0, SEEK_END);
+  EXPECT_LT(ftell(rle), ftell(raw));
+  fclose(raw);
+  fclose(rle);
+
+  cPopulationCheckpointView view;
+  ASSERT_TRUE(view.Open("checkpoint_rle.ckpt"));
+  checkView(view);
+
+  remove("checkpoint_raw.ckpt");
+  remove("checkpoint_rle.ckpt");
+}
+
+
+TEST(PopulationCheckpoint, RejectsTruncatedFile)
+{
+  cPopulationCheckpoint checkpoint;
+  buildCheckpoint(checkpoint);
+  ASSERT_TRUE(checkpoint.Save("checkpoint_trunc.ckpt", false));
+
+  FILE* fp = fopen("checkpoint_trunc.ckpt", "rb");
+  ASSERT_TRUE(fp != NULL);
+  char buffer[256];
+  const size_t count = fread(buffer, 1, sizeof(buffer), fp);
+  fclose(fp);
+
+  fp = fopen("checkpoint_trunc.ckpt", "wb");
+  fwrite(buffer, 1, count, fp);
+  fclose(fp);
+
+  cPopulationCheckpointView view;
+  EXPECT_FALSE(view.Open("checkpoint_trunc.ckpt"));
+
+  remove("checkpoint_trunc.ckpt");
+}
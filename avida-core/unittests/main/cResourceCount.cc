@@ -0,0 +1,86 @@
+/*
+ *  unittests/main/cResourceCount.cc
+ *  avida-core
+ *
+ *  Copyright 2012 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cAvidaContext.h"
+#include "cResourceCount.h"
+
+#include "apto/rng.h"
+
+#include "gtest/gtest.h"
+
+
+// Deme resources used to be advanced eagerly by cPopulation::ProcessStep on every executed instruction.  They now share
+// a single clock that each count catches up with lazily.  Both must produce the same resource levels, within the size
+// of a single resource step, at any point where the resource is read.
+TEST(ResourceCount, SharedClockMatchesEagerUpdate)
+{
+  Apto::RNG::AvidaRNG rng(101);
+  cAvidaContext ctx(NULL, rng);
+
+  cResourceCount eager(1);
+  cResourceCount lazy(1);
+  eager.SetDecay("", 0.99);
+  eager.SetInflow("", 100.0);
+  lazy.SetDecay("", 0.99);
+  lazy.SetInflow("", 100.0);
+
+  double clock = 0.0;
+  lazy.AttachClock(&clock);
+
+  const int steps_per_update = 3000;
+  const double step_size = 1.0 / (double)steps_per_update;
+  const double tolerance = 2.0 * 100.0 / 10000.0;  // two resource steps worth of inflow
+
+  for (int update = 0; update < 100; update++) {
+    for (int step = 0; step < steps_per_update; step++) {
+      eager.Update(step_size);
+      clock += step_size;
+
+      // Irregular reads, mimicking CheckImplicitDemeRepro and organism resource queries
+      if ((step * 7 + update) % 113 == 0) EXPECT_NEAR(eager.Get(ctx, 0), lazy.Get(ctx, 0), tolerance);
+    }
+
+    // End of update, as in cPopulation::ResetDemeClock
+    lazy.SyncClock();
+    clock = 0.0;
+    lazy.AttachClock(&clock);
+
+    EXPECT_NEAR(eager.Get(ctx, 0), lazy.Get(ctx, 0), tolerance);
+  }
+}
+
+
+TEST(ResourceCount, CopyCarriesPendingClockTime)
+{
+  Apto::RNG::AvidaRNG rng(101);
+  cAvidaContext ctx(NULL, rng);
+
+  cResourceCount source(1);
+  source.SetDecay("", 1.0);
+  source.SetInflow("", 100.0);
+
+  double clock = 0.0;
+  source.AttachClock(&clock);
+  clock += 0.5;
+
+  cResourceCount copy(source);
+  EXPECT_DOUBLE_EQ(source.Get(ctx, 0), copy.Get(ctx, 0));
+}
@@ -0,0 +1,108 @@
+/*
+ *  unittests/main/cSpatialResCount.cc
+ *  avida-core
+ *
+ *  Copyright 2012 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cSpatialResCount.h"
+#include "nGeometry.h"
+
+#include "gtest/gtest.h"
+
+
+// Reference flow, walking the element neighbor pointers as cSpatialResCount::FlowAll did before the stencil kernel
+static void referenceFlow(cSpatialResCount& res, double xd, double yd, double xg, double yg)
+{
+  for (int i = 0; i < res.GetSize(); i++) {
+    for (int k = 3; k <= 6; k++) {
+      int ii = res.Element(i).GetElemPtr(k);
+      if (ii >= 0) {
+        FlowMatter(res.Element(i), res.Element(ii), xd, yd, xg, yg, res.Element(i).GetPtrXdist(k),
+                   res.Element(i).GetPtrYdist(k), res.Element(i).GetPtrDist(k));
+      }
+    }
+  }
+}
+
+static void checkStencil(int geometry, int world_x, int world_y, double xd, double yd, double xg, double yg)
+{
+  cSpatialResCount kernel(world_x, world_y, geometry, xd, yd, xg, yg);
+  cSpatialResCount reference(world_x, world_y, geometry, xd, yd, xg, yg);
+
+  for (int i = 0; i < kernel.GetSize(); i++) {
+    const double amount = (double)((i * 7919) % 101) + 0.25 * (i % 3);
+    kernel.SetCellAmount(i, amount);
+    reference.SetCellAmount(i, amount);
+  }
+
+  for (int step = 0; step < 50; step++) {
+    kernel.FlowAll();
+    kernel.StateAll();
+    referenceFlow(reference, xd, yd, xg, yg);
+    reference.StateAll();
+  }
+
+  for (int i = 0; i < kernel.GetSize(); i++) {
+    EXPECT_NEAR(reference.GetAmount(i), kernel.GetAmount(i), 1e-9 * (1.0 + reference.GetAmount(i)));
+  }
+  EXPECT_NEAR(reference.SumAll(), kernel.SumAll(), 1e-9 * reference.SumAll());
+}
+
+
+TEST(SpatialResCount, StencilMatchesElementFlowTorus)
+{
+  checkStencil(nGeometry::TORUS, 17, 11, 1.0, 1.0, 0.0, 0.0);
+  checkStencil(nGeometry::TORUS, 17, 11, 0.5, 1.0, 0.3, -0.2);
+  checkStencil(nGeometry::TORUS, 2, 1, 1.0, 0.5, -0.4, 0.1);
+}
+
+TEST(SpatialResCount, StencilMatchesElementFlowGrid)
+{
+  checkStencil(nGeometry::GRID, 17, 11, 1.0, 1.0, 0.0, 0.0);
+  checkStencil(nGeometry::GRID, 17, 11, 0.5, 1.0, -0.3, 0.2);
+  checkStencil(nGeometry::GRID, 1, 9, 1.0, 1.0, 0.1, 0.1);
+}
+
+
+// cResourceCount may hand the banded phases out to several threads, in any order, the result must not change
+TEST(SpatialResCount, BandedFlowMatchesFlowAll)
+{
+  const int world_x = 13, world_y = 10;
+  const int geometries[] = { nGeometry::GRID, nGeometry::TORUS };
+
+  for (int g = 0; g < 2; g++) {
+    cSpatialResCount whole(world_x, world_y, geometries[g], 0.7, 1.0, 0.2, -0.4);
+    cSpatialResCount banded(world_x, world_y, geometries[g], 0.7, 1.0, 0.2, -0.4);
+    for (int i = 0; i < whole.GetSize(); i++) {
+      whole.SetCellAmount(i, (double)((i * 31) % 17));
+      banded.SetCellAmount(i, (double)((i * 31) % 17));
+    }
+
+    for (int step = 0; step < 20; step++) {
+      whole.FlowAll();
+      whole.StateAll();
+
+      banded.PrepareFlow();
+      for (int y = world_y; y > 0; y -= 3) banded.GatherFlowBand((y > 3) ? y - 3 : 0, y);
+      for (int y = 0; y < world_y; y += 4) banded.ComputeFlowBand(y, (y + 4 < world_y) ? y + 4 : world_y);
+      for (int y = world_y; y > 0; y -= 2) banded.ApplyFlowBand((y > 2) ? y - 2 : 0, y, true);
+    }
+
+    for (int i = 0; i < whole.GetSize(); i++) EXPECT_DOUBLE_EQ(whole.GetAmount(i), banded.GetAmount(i));
+  }
+}
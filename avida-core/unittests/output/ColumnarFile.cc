@@ -0,0 +1,138 @@
+/*
+ *  unittests/output/ColumnarFile.cc
+ *  avida-core
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "avida/output/ColumnarFile.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <sstream>
+
+using namespace Avida::Output;
+
+
+static const int NUM_ROWS = 2500;
+
+static std::string writeTable(bool compress, std::string& text)
+{
+  static const char* header = "# Avida test data\n#  1: update\n#  2: merit\n#  3: name\n\n";
+  std::ostringstream expected;
+  expected << header;
+  
+  std::ostringstream out;
+  ColumnarWriter writer(compress, 1000);  // several blocks, the last one short
+  writer.AddColumn(COLUMN_INT, "update");
+  writer.AddColumn(COLUMN_DOUBLE, "merit");
+  writer.AddColumn(COLUMN_STRING, "name");
+  writer.Begin(out, "", "", header);
+  
+  for (int u = 0; u < NUM_ROWS; u++) {
+    const long long update = (u % 7 == 3) ? -u * 1000003LL : u;
+    const double merit = (u % 5 == 0) ? 0.0 : sqrt((double)u) * 1.0e6 + ((u % 11 == 0) ? NAN : 0.25);
+    const char* name = (u % 3) ? "org" : "";
+    
+    writer.Append(update);
+    writer.Append(merit);
+    writer.Append(name);
+    writer.EndRow();
+    
+    expected << update << " " << merit << " " << name << " " << std::endl;
+  }
+  writer.Finish();
+  
+  text = expected.str();
+  return out.str();
+}
+
+
+TEST(OutputColumnarFile, RoundTripsText)
+{
+  for (int compress = 0; compress < 2; compress++) {
+    std::string expected;
+    const std::string data = writeTable(compress, expected);
+    
+    std::istringstream in(data);
+    ColumnarReader reader(in);
+    ASSERT_TRUE(reader.IsValid());
+    EXPECT_EQ((bool)compress, reader.IsCompressed());
+    ASSERT_EQ(3, reader.GetNumColumns());
+    EXPECT_EQ(COLUMN_DOUBLE, reader.GetColumnType(1));
+    EXPECT_TRUE(reader.GetColumnDescription(2) == "name");
+    
+    std::ostringstream text;
+    EXPECT_TRUE(reader.WriteText(text));
+    EXPECT_EQ(expected, text.str());
+  }
+}
+
+TEST(OutputColumnarFile, DetectsTruncation)
+{
+  std::string expected;
+  const std::string data = writeTable(true, expected);
+  
+  std::istringstream in(data.substr(0, data.size() - 10));
+  ColumnarReader reader(in);
+  ASSERT_TRUE(reader.IsValid());
+  
+  int rows = 0;
+  while (reader.NextBlock()) rows += reader.GetNumRows();
+  EXPECT_FALSE(reader.IsValid());
+  EXPECT_EQ(2000, rows);
+}
+
+TEST(OutputColumnarFile, RejectsMismatchedRows)
+{
+  std::ostringstream out;
+  ColumnarWriter writer(false);
+  writer.AddColumn(COLUMN_INT, "update");
+  writer.AddColumn(COLUMN_DOUBLE, "merit");
+  writer.Begin(out, "", "", "\n");
+  
+  EXPECT_TRUE(writer.Append(1LL));
+  EXPECT_TRUE(writer.Append(0.5));
+  EXPECT_TRUE(writer.EndRow());
+  
+  // Too few columns
+  EXPECT_TRUE(writer.Append(2LL));
+  EXPECT_FALSE(writer.EndRow());
+  std::ostringstream row;
+  writer.TakeRow(row);
+  EXPECT_EQ("2 ", row.str());
+  
+  // Too many columns, and the wrong type
+  EXPECT_TRUE(writer.Append(3LL));
+  EXPECT_TRUE(writer.Append(1.5));
+  EXPECT_FALSE(writer.Append(4LL));
+  EXPECT_FALSE(writer.Append("org"));
+  row.str("");
+  writer.TakeRow(row);
+  EXPECT_EQ("3 1.5 ", row.str());
+  
+  EXPECT_FALSE(writer.Append(0.25));
+  writer.Finish();
+  
+  // Only the complete row is stored
+  std::istringstream in(out.str());
+  ColumnarReader reader(in);
+  std::ostringstream text;
+  EXPECT_TRUE(reader.WriteText(text));
+  EXPECT_EQ("\n1 0.5 \n", text.str());
+}